@@ -8,9 +8,14 @@
 #define BEHOLDER_CAMERA_H
 
 #include "beholder/camera/Camera.h"
+#include "beholder/camera/CameraArray.h"
 #include "beholder/camera/Exception.h"
+#include "beholder/camera/Frame.h"
 #include "beholder/camera/ParamEntry.h"
 #include "beholder/camera/PylonAPI.h"
+#include "beholder/camera/SensorROI.h"
+#include "beholder/camera/Stream.h"
 #include "beholder/camera/TransportLayer.h"
+#include "beholder/camera/Trigger.h"
 
 #endif	// BEHOLDER_CAMERA_H
@@ -4,7 +4,9 @@
 
 #include "beholder/camera/Camera.h"
 
+#include <GenApi/IInteger.h>
 #include <GenApi/INode.h>
+#include <GenApi/Pointer.h>
 #include <pylon/Device.h>
 #include <pylon/ECleanup.h>
 #include <pylon/ERegistrationMode.h>
@@ -12,23 +14,129 @@
 #include <pylon/GrabResultPtr.h>
 #include <pylon/InstantCamera.h>
 #include <pylon/Parameter.h>
-#include <pylon/PixelType.h>
 
+#include <algorithm>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <iostream>
+#include <iterator>
+#include <memory>
+#include <mutex>
 #include <optional>
+#include <string>
+#include <system_error>
+#include <thread>
 #include <utility>
 
 #include "beholder/camera/Exception.h"
+#include "beholder/camera/Frame.h"
 #include "beholder/camera/ParamEntry.h"
+#include "beholder/camera/SensorROI.h"
+#include "beholder/camera/Stream.h"
+#include "beholder/camera/TransportLayer.h"
+#include "beholder/camera/Trigger.h"
+#include "beholder/camera/internal/ClockSync.h"
 #include "beholder/camera/internal/DefaultConfigurator.h"
+#include "beholder/camera/internal/FrameGrabber.h"
 #include "beholder/camera/internal/GenAPIUtils.h"
+#include "beholder/camera/internal/GrabResult.h"
+#include "beholder/camera/internal/NodeCache.h"
+#include "beholder/camera/internal/TriggerScheduler.h"
 #include "beholder/capi/Image.h"
 #include "beholder/util/Enums.h"
 
 namespace beholder {
 
+namespace {
+// The number of grab buffers kept available to pylon on top of the ones
+// held by the frame ring, so grabbing never stalls.
+constexpr std::int64_t ringHeadroom{2};
+
+// Get the node through which images are binned along 'axis', i.e.
+// "Horizontal" or "Vertical", preferring binning over decimation,
+// or nullptr if images can't be binned.
+GenApi::INode* binningNode(internal::NodeCache& nodes,
+						   const std::string& axis) {
+	for (const std::string kind : {"Binning", "Decimation"}) {
+		if (auto* n{nodes.get(kind + axis)}; GenApi::IsAvailable(n)) {
+			return n;
+		}
+	}
+	return nullptr;
+}
+
+// Get the factor by which images are binned, 1 if they aren't.
+std::int64_t getBinning(internal::NodeCache& nodes) {
+	GenApi::CIntegerPtr n{binningNode(nodes, "Horizontal")};
+	if (!n || !GenApi::IsReadable(n)) {
+		return 1;
+	}
+	return std::max<std::int64_t>(n->GetValue(), 1);
+}
+
+// Align 'v' down onto the increments of an integer node.
+std::int64_t alignDown(const GenApi::CIntegerPtr& n, std::int64_t v) {
+	const auto lo{n->GetMin()};
+	const auto inc{std::max<std::int64_t>(n->GetInc(), 1)};
+	return v <= lo ? lo : lo + (v - lo) / inc * inc;
+}
+
+// Align 'v' up onto the increments of an integer node, up to 'hi'.
+std::int64_t alignUp(const GenApi::CIntegerPtr& n, std::int64_t v,
+					 std::int64_t hi) {
+	const auto lo{n->GetMin()};
+	const auto inc{std::max<std::int64_t>(n->GetInc(), 1)};
+	hi = alignDown(n, hi);
+	return v <= lo ? lo : std::min(lo + (v - lo + inc - 1) / inc * inc, hi);
+}
+
+// Check if 'roi', once aligned, is the region already set, so that
+// acquisition needn't be restarted to set it, see Camera::setROI.
+bool isROISet(internal::NodeCache& nodes, const SensorROI& roi) {
+	const GenApi::CIntegerPtr x{nodes.get("OffsetX")};
+	const GenApi::CIntegerPtr y{nodes.get("OffsetY")};
+	const GenApi::CIntegerPtr w{nodes.get("Width")};
+	const GenApi::CIntegerPtr h{nodes.get("Height")};
+	const GenApi::CIntegerPtr wMax{nodes.get("WidthMax")};
+	const GenApi::CIntegerPtr hMax{nodes.get("HeightMax")};
+	if (!x || !y || !w || !h || !wMax || !hMax ||
+		getBinning(nodes) != roi.binning) {
+		return false;
+	}
+	const auto b{roi.binning};
+	const auto x0{alignDown(x, roi.offsetX / b)};
+	const auto y0{alignDown(y, roi.offsetY / b)};
+	const auto wv{alignUp(w, (roi.offsetX + roi.width + b - 1) / b - x0,
+						  wMax->GetValue())};
+	const auto hv{alignUp(h, (roi.offsetY + roi.height + b - 1) / b - y0,
+						  hMax->GetValue())};
+	return w->GetValue() == wv && h->GetValue() == hv &&
+		   x->GetValue() ==
+			   std::min(x0, alignDown(x, wMax->GetValue() - wv)) &&
+		   y->GetValue() == std::min(y0, alignDown(y, hMax->GetValue() - hv));
+}
+
+// Clear the sensor offsets, so that any size fits.
+void clearOffsets(internal::NodeCache& nodes) {
+	for (const std::string name : {"OffsetX", "OffsetY"}) {
+		if (auto* n{nodes.get(name)}; GenApi::IsWritable(n)) {
+			internal::writeIfChanged(n, "0");
+		}
+	}
+}
+
+// Check if 'p' is a sensor offset, whose limits depend on the size.
+bool isOffset(const ParamEntry& p) {
+	return p.name == "OffsetX" || p.name == "OffsetY";
+}
+
+// Get an integer parameter entry of a node.
+ParamEntry intParam(GenApi::INode* n, std::int64_t v) {
+	return ParamEntry{n->GetName().c_str(), std::to_string(v), ParamType::Int};
+}
+}  // namespace
+
 void Camera::Deleter::operator()(Pylon::CInstantCamera* cam) noexcept {
 	if (static_cast<bool>(cam)) {
 		cam->DestroyDevice();
@@ -36,6 +144,75 @@ void Camera::Deleter::operator()(Pylon::CInstantCamera* cam) noexcept {
 	}
 }
 
+void Camera::remember(const ParamEntry& p) {
+	auto found{std::find_if(
+		params_.begin(), params_.end(),
+		[&p](const ParamEntry& q) -> bool { return q.name == p.name; })};
+	if (found == params_.end()) {
+		params_.push_back(p);
+	} else {
+		found->value = p.value;
+	}
+}
+
+bool Camera::applyROI(const SensorROI& roi) {
+	auto* x{nodes_->get("OffsetX")};
+	auto* y{nodes_->get("OffsetY")};
+	auto* w{nodes_->get("Width")};
+	auto* h{nodes_->get("Height")};
+	if (!x || !y || !w || !h) {
+		throw Exception{"no ROI parameters"};
+	}
+	auto* binH{binningNode(*nodes_, "Horizontal")};
+	auto* binV{binningNode(*nodes_, "Vertical")};
+	if (roi.binning > 1 && (!binH || !binV)) {
+		throw Exception{"binning not supported"};
+	}
+	const auto b{roi.binning};
+
+	// the offsets are cleared first, so that any size fits
+	clearOffsets(*nodes_);
+	bool ok{true};
+	if (binH && binV) {
+		ok = setParams({intParam(binH, b), intParam(binV, b)});
+	}
+	// the size's limits depend on the binning, and the offsets' limits
+	// depend on the size, hence the order
+	const GenApi::CIntegerPtr xp{x};
+	const GenApi::CIntegerPtr yp{y};
+	const GenApi::CIntegerPtr wp{w};
+	const GenApi::CIntegerPtr hp{h};
+	// the region is grown, so that it still covers 'roi' once aligned
+	const auto x0{alignDown(xp, roi.offsetX / b)};
+	const auto y0{alignDown(yp, roi.offsetY / b)};
+	const auto right{(roi.offsetX + roi.width + b - 1) / b};
+	const auto bottom{(roi.offsetY + roi.height + b - 1) / b};
+	ok = setParams({intParam(w, alignUp(wp, right - x0, wp->GetMax())),
+					intParam(h, alignUp(hp, bottom - y0, hp->GetMax()))}) &&
+		 ok;
+	const auto maxX{alignDown(xp, xp->GetMax())};
+	const auto maxY{alignDown(yp, yp->GetMax())};
+	ok = setParams({intParam(x, std::min(x0, maxX)),
+					intParam(y, std::min(y0, maxY))}) &&
+		 ok;
+	return ok;
+}
+
+void Camera::reserveBuffers() {
+	const auto nBuffers{std::max(
+		static_cast<std::int64_t>(getRingSize()) + ringHeadroom,
+		maxNumBuffer_)};
+	if (cam_->MaxNumBuffer.GetValue() < nBuffers) {
+		cam_->MaxNumBuffer.SetValue(nBuffers);
+	}
+}
+
+void Camera::resetStreamStats() noexcept {
+	lastBlock_ = 0;
+	nSkipped_.store(0, std::memory_order_relaxed);
+	nTimeouts_.store(0, std::memory_order_relaxed);
+}
+
 bool Camera::triggerImpl(TriggerType typ) {
 	switch (typ) {
 		case TriggerType::Software: {
@@ -53,14 +230,24 @@ bool Camera::triggerImpl(TriggerType typ) {
 
 Camera::Camera()
 	: cam_{new Pylon::CInstantCamera{}, Deleter{}},
-	  res_{new Pylon::CGrabResultPtr{}} {
-	cam_->RegisterConfiguration(new internal::DefaultConfigurator,
-								Pylon::RegistrationMode_ReplaceAll,
+	  res_{new Pylon::CGrabResultPtr{}},
+	  ring_(DfltRingSize),
+	  clk_{std::make_unique<internal::ClockSync>()},
+	  trig_{std::make_unique<internal::TriggerScheduler>(
+		  [this]() -> bool { return isAcquiring() && trigger(); })},
+	  cfg_{new internal::DefaultConfigurator},
+	  nodes_{std::make_unique<internal::NodeCache>()} {
+	cam_->RegisterConfiguration(cfg_, Pylon::RegistrationMode_ReplaceAll,
 								Pylon::Cleanup_Delete);
 }
 
-// NOLINTNEXTLINE(*-use-equals-default): incomplete type; must be defined here
-Camera::~Camera(){};
+Camera::~Camera() {
+	trig_->stop();
+	if (grabber_) {
+		stopAcquisition();
+		cam_->DeregisterImageEventHandler(grabber_.get());
+	}
+}
 
 bool Camera::acquire(std::chrono::milliseconds timeout) {
 	if (!isAttached()) {
@@ -73,6 +260,11 @@ bool Camera::acquire(std::chrono::milliseconds timeout) {
 
 	const bool success{cam_->RetrieveResult(timeout.count(), res,
 											Pylon::TimeoutHandling_Return)};
+	if (success) {
+		nSkipped_.fetch_add(internal::countSkipped(lastBlock_,
+												   res->GetBlockID()),
+							std::memory_order_relaxed);
+	}
 	if (success && res->GrabSucceeded()) {
 		if (res->HasCRC() && !res->CheckCRC()) {
 			std::cerr << "CRC check failed" << std::endl;
@@ -83,11 +275,44 @@ bool Camera::acquire(std::chrono::milliseconds timeout) {
 		std::cerr << "error code: " << res->GetErrorCode() << '\t'
 				  << res->GetErrorDescription() << std::endl;
 	} else {
+		nTimeouts_.fetch_add(1, std::memory_order_relaxed);
 		std::cerr << "acquisition timed out" << std::endl;
 	}
 	return false;
 }
 
+std::optional<FrameSlot>
+Camera::acquireFrame(std::chrono::milliseconds timeout) {
+	auto isFree = [](const RingSlot& s) -> bool { return !s.frame.isValid(); };
+	{
+		const std::lock_guard lock{ringMtx_};
+		if (std::none_of(ring_.begin(), ring_.end(), isFree)) {
+			std::cerr << "no free frame slots" << std::endl;
+			return std::nullopt;
+		}
+	}
+	if (!acquire(timeout)) {
+		return std::nullopt;
+	}
+	Frame f{*res_, clk_.get()};
+	res_->Release();  // the ring holds the only reference now
+	if (!f.isValid()) {
+		return std::nullopt;
+	}
+	// slots are only filled here, so the free slot should still be there
+	const std::lock_guard lock{ringMtx_};
+	const auto slot{std::find_if(ring_.begin(), ring_.end(), isFree)};
+	if (slot == ring_.end()) {
+		std::cerr << "no free frame slots" << std::endl;
+		return std::nullopt;
+	}
+	slot->frame = std::move(f);
+	slot->generation = ++ringGen_;
+	return FrameSlot{
+		static_cast<std::size_t>(std::distance(ring_.begin(), slot)),
+		slot->generation};
+}
+
 bool Camera::cmdExecute(const std::string& cmd) noexcept {
 	return cmdExecute(cmd.c_str());
 }
@@ -120,29 +345,54 @@ bool Camera::cmdIsDone(const char* cmd) noexcept {
 	return false;
 }
 
-std::optional<Image> Camera::getImage() noexcept {
-	// not sure if this can throw, so we're being careful
+std::optional<Frame> Camera::getFrame() noexcept {
+	if (!res_->IsValid()) {
+		return std::nullopt;
+	}
+	Frame f{*res_, clk_.get()};
+	if (!f.isValid()) {
+		return std::nullopt;
+	}
+	return f;
+}
+
+const Frame& Camera::getFrame(const FrameSlot& slot) const {
+	const std::lock_guard lock{ringMtx_};
+	if (slot.index >= ring_.size()) {
+		throw Exception{"frame slot out of range"};
+	}
+	const auto& s{ring_[slot.index]};
+	if (slot.generation == 0 || s.generation != slot.generation ||
+		!s.frame.isValid()) {
+		throw Exception{"stale frame slot"};
+	}
+	return s.frame;
+}
+
+std::optional<SensorROI> Camera::getFullROI() const noexcept {
+	if (!isInitialized()) {
+		return std::nullopt;
+	}
 	try {
-		auto& res{*res_};
-		if (!res.IsValid()) {
+		const GenApi::CIntegerPtr w{nodes_->get("WidthMax")};
+		const GenApi::CIntegerPtr h{nodes_->get("HeightMax")};
+		if (!GenApi::IsReadable(w) || !GenApi::IsReadable(h)) {
 			return std::nullopt;
 		}
-		std::size_t step{0UL};
-		return std::optional{Image{
-			static_cast<std::size_t>(res->GetID()),
-			static_cast<int>(res->GetHeight()),
-			static_cast<int>(res->GetWidth()),
-			static_cast<std::int64_t>(res->GetPixelType()), res->GetBuffer(),
-			res->GetStride(step) ? step : 0UL,
-			static_cast<std::size_t>(Pylon::BitPerPixel(res->GetPixelType()))}};
+		const auto b{getBinning(*nodes_)};
+		return SensorROI{0, 0, w->GetValue() * b, h->GetValue() * b, b};
 	} catch (const Pylon::GenericException& e) {
-		std::cerr << "could get raw image data: " << e.what() << std::endl;
+		std::cerr << "could not get sensor size: " << e.what() << std::endl;
 	} catch (...) {
-		std::cerr << "could get raw image data" << std::endl;
+		std::cerr << "could not get sensor size" << std::endl;
 	}
 	return std::nullopt;
 }
 
+std::optional<Image> Camera::getImage() noexcept {
+	return internal::toImage(*res_, clk_.get());
+}
+
 ParamList Camera::getParams(ParamAccessMode mode) {
 	ParamList params;
 	bool (*condition)(GenApi::INode*){nullptr};
@@ -190,6 +440,109 @@ ParamList Camera::getParams(ParamAccessMode mode) {
 	return params;
 }
 
+std::optional<std::chrono::milliseconds>
+Camera::getIdleTime() const noexcept {
+	if (!grabber_) {
+		return std::nullopt;
+	}
+	return std::chrono::duration_cast<std::chrono::milliseconds>(
+		grabber_->getIdleTime());
+}
+
+std::size_t Camera::getNoDroppedFrames() const noexcept {
+	return grabber_ ? grabber_->getNoDropped() : 0;
+}
+
+std::size_t Camera::getNoParamWrites() const noexcept {
+	return nParamWrites_;
+}
+
+std::size_t Camera::getRingSize() const noexcept {
+	const std::lock_guard lock{ringMtx_};
+	return ring_.size();
+}
+
+std::optional<SensorROI> Camera::getROI() const noexcept {
+	if (!isInitialized()) {
+		return std::nullopt;
+	}
+	try {
+		const GenApi::CIntegerPtr x{nodes_->get("OffsetX")};
+		const GenApi::CIntegerPtr y{nodes_->get("OffsetY")};
+		const GenApi::CIntegerPtr w{nodes_->get("Width")};
+		const GenApi::CIntegerPtr h{nodes_->get("Height")};
+		if (!GenApi::IsReadable(x) || !GenApi::IsReadable(y) ||
+			!GenApi::IsReadable(w) || !GenApi::IsReadable(h)) {
+			return std::nullopt;
+		}
+		const auto b{getBinning(*nodes_)};
+		return SensorROI{x->GetValue() * b, y->GetValue() * b,
+						 w->GetValue() * b, h->GetValue() * b, b};
+	} catch (const Pylon::GenericException& e) {
+		std::cerr << "could not get sensor ROI: " << e.what() << std::endl;
+	} catch (...) {
+		std::cerr << "could not get sensor ROI" << std::endl;
+	}
+	return std::nullopt;
+}
+
+std::optional<StreamStats> Camera::getStreamStats() const noexcept {
+	if (!isInitialized()) {
+		return std::nullopt;
+	}
+	try {
+		// the statistics available depend on the transport layer
+		auto& map{cam_->GetStreamGrabberNodeMap()};
+		auto get = [&map](const char* name) -> std::uint64_t {
+			GenApi::CIntegerPtr n{map.GetNode(name)};
+			if (!n || !GenApi::IsReadable(n)) {
+				return 0;
+			}
+			return static_cast<std::uint64_t>(n->GetValue());
+		};
+		StreamStats s;
+		s.totalBuffers = get("Statistic_Total_Buffer_Count");
+		s.failedBuffers = get("Statistic_Failed_Buffer_Count");
+		s.bufferUnderruns = get("Statistic_Buffer_Underrun_Count");
+		s.totalPackets = get("Statistic_Total_Packet_Count");
+		s.failedPackets = get("Statistic_Failed_Packet_Count");
+		s.resendRequests = get("Statistic_Resend_Request_Count");
+		s.resendPackets = get("Statistic_Resend_Packet_Count");
+		s.missedFrames = get("Statistic_Missed_Frame_Count");
+		s.skippedFrames = nSkipped_.load(std::memory_order_relaxed) +
+						  (grabber_ ? grabber_->getNoSkipped() : 0);
+		s.droppedFrames = getNoDroppedFrames();
+		s.timeouts = nTimeouts_.load(std::memory_order_relaxed);
+		return s;
+	} catch (const Pylon::GenericException& e) {
+		std::cerr << "could not get stream statistics: " << e.what()
+				  << std::endl;
+	} catch (...) {
+		std::cerr << "could not get stream statistics" << std::endl;
+	}
+	return std::nullopt;
+}
+
+std::string Camera::getSerialNumber() const noexcept {
+	try {
+		if (cam_->IsPylonDeviceAttached()) {
+			return cam_->GetDeviceInfo().GetSerialNumber().c_str();
+		}
+	} catch (...) {
+		std::cerr << "could not get serial number" << std::endl;
+	}
+	return {};
+}
+
+TriggerStats Camera::getTriggerStats() const noexcept {
+	try {
+		return trig_->getStats();
+	} catch (...) {
+		std::cerr << "could not get trigger statistics" << std::endl;
+	}
+	return TriggerStats{};
+}
+
 bool Camera::isAcquiring() const noexcept { return cam_->IsGrabbing(); }
 
 bool Camera::init(Pylon::IPylonDevice* d) noexcept {
@@ -200,6 +553,12 @@ bool Camera::init(Pylon::IPylonDevice* d) noexcept {
 	try {
 		cam_->Attach(d, Pylon::Cleanup_Delete);
 		cam_->Open();
+		nodes_->reset(&cam_->GetNodeMap());
+		sn_ = cam_->GetDeviceInfo().GetSerialNumber().c_str();
+		// not all devices can latch their timestamp counter, and images
+		// are acquired just fine without host times
+		clk_->reset();
+		syncClock();
 		return true;
 	} catch (const Pylon::GenericException& e) {
 		std::cerr << "could not initialize camera: " << e.what() << std::endl;
@@ -219,6 +578,100 @@ bool Camera::isAttached() const noexcept {
 	return cam_->IsPylonDeviceAttached() && !cam_->IsCameraDeviceRemoved();
 }
 
+std::optional<Frame> Camera::nextFrame(std::chrono::milliseconds timeout) {
+	if (!grabber_) {
+		return std::nullopt;
+	}
+	auto f{grabber_->next(timeout)};
+	if (!f && !grabber_->isStopped()) {
+		nTimeouts_.fetch_add(1, std::memory_order_relaxed);
+	}
+	return f;
+}
+
+void Camera::releaseFrame(const FrameSlot& slot) noexcept {
+	const std::lock_guard lock{ringMtx_};
+	if (slot.index >= ring_.size()) {
+		std::cerr << "could not release frame: slot out of range"
+				  << std::endl;
+		return;
+	}
+	auto& s{ring_[slot.index]};
+	if (slot.generation == 0 || s.generation != slot.generation ||
+		!s.frame.isValid()) {
+		std::cerr << "could not release frame: stale frame slot" << std::endl;
+		return;
+	}
+	s.frame.release();
+}
+
+bool Camera::reconnect(const TransportLayer& tl,
+					   std::chrono::milliseconds timeout,
+					   std::size_t retries) noexcept {
+	if (sn_.empty()) {
+		std::cerr << "could not reconnect: camera was never initialized"
+				  << std::endl;
+		return false;
+	}
+	try {
+		// release everything acquired from the removed device
+		stopAcquisition();
+		{
+			const std::lock_guard lock{ringMtx_};
+			for (auto& s : ring_) {
+				s.frame.release();
+			}
+		}
+		res_->Release();
+		nodes_->reset(nullptr);
+		cam_->DestroyDevice();
+
+		for (auto i{0UL}; i <= retries; ++i) {
+			if (i > 0) {
+				std::this_thread::sleep_for(timeout);
+			}
+			auto* d{tl.createDevice(sn_, DeviceDesignator::SN, false)};
+			if (!static_cast<bool>(d)) {
+				continue;
+			}
+			// the device keeps its configuration unless it was power
+			// cycled, and the parameters are reapplied either way,
+			// so loading the default user set is just a waste of time
+			cfg_->setApply(false);
+			const bool ok{init(d)};
+			cfg_->setApply(true);
+			if (!ok) {
+				return false;
+			}
+			// parameters are replayed in the order they were first set,
+			// which needn't be the order the region was set in, so the
+			// offsets are cleared first and set last, as in applyROI
+			ParamList params{params_};
+			std::stable_partition(
+				params.begin(), params.end(),
+				[](const ParamEntry& p) -> bool { return !isOffset(p); });
+			clearOffsets(*nodes_);
+			return setParams(params);
+		}
+		std::cerr << "could not reconnect: retry limit reached" << std::endl;
+	} catch (const Pylon::GenericException& e) {
+		std::cerr << "could not reconnect: " << e.what() << std::endl;
+	} catch (...) {
+		std::cerr << "could not reconnect" << std::endl;
+	}
+	cfg_->setApply(true);
+	return false;
+}
+
+bool Camera::requestTrigger() noexcept {
+	try {
+		return trig_->request();
+	} catch (...) {
+		std::cerr << "could not request trigger" << std::endl;
+	}
+	return false;
+}
+
 bool Camera::setParams(const ParamList& params) noexcept {
 	if (!isInitialized()) {
 		std::cerr << "could not set parameters, camera uninitialized"
@@ -228,8 +681,17 @@ bool Camera::setParams(const ParamList& params) noexcept {
 	bool ok{true};
 	for (const auto& p : params) {
 		try {
-			Pylon::CParameter par{cam_->GetNodeMap(), p.name.c_str()};
-			par.FromString(p.value.c_str());
+			auto* n{nodes_->get(p.name)};
+			if (!static_cast<bool>(n)) {
+				ok = false;
+				std::cerr << "could not set \"" << p.name
+						  << "\": no such parameter" << std::endl;
+				continue;
+			}
+			if (internal::writeIfChanged(n, p.value)) {
+				++nParamWrites_;
+			}
+			remember(p);
 		} catch (const Pylon::GenericException& e) {
 			ok = false;
 			std::cerr << "could not set \"" << p.name << ": " << e.what()
@@ -242,12 +704,110 @@ bool Camera::setParams(const ParamList& params) noexcept {
 	return ok;
 }
 
+bool Camera::setROI(const SensorROI& roi) noexcept {
+	if (!isInitialized()) {
+		std::cerr << "could not set sensor ROI, camera uninitialized"
+				  << std::endl;
+		return false;
+	}
+	if (roi.binning < 1 || roi.offsetX < 0 || roi.offsetY < 0 ||
+		roi.width <= 0 || roi.height <= 0) {
+		std::cerr << "could not set sensor ROI: bad region" << std::endl;
+		return false;
+	}
+	try {
+		if (isROISet(*nodes_, roi)) {
+			return true;
+		}
+	} catch (...) {
+		// set it anyway
+	}
+	// acquisition is restarted with the same signal, so that a camera
+	// array keeps waiting on all of its cameras
+	const bool acquiring{isAcquiring()};
+	std::shared_ptr<internal::GrabSignal> sig;
+	if (acquiring && grabber_ && !grabber_->isStopped()) {
+		sig = grabber_->getSignal();
+	}
+	bool ok{false};
+	try {
+		if (acquiring) {
+			stopAcquisition();
+		}
+		ok = applyROI(roi);
+	} catch (const Pylon::GenericException& e) {
+		std::cerr << "could not set sensor ROI: " << e.what() << std::endl;
+	} catch (const Exception& e) {
+		std::cerr << "could not set sensor ROI: " << e.what() << std::endl;
+	} catch (...) {
+		std::cerr << "could not set sensor ROI" << std::endl;
+	}
+	// restart regardless, the previous region might still be set
+	if (sig) {
+		ok = startGrabbing(0, std::move(sig)) && ok;
+	} else if (acquiring) {
+		ok = startAcquisition() && ok;
+	}
+	return ok;
+}
+
+bool Camera::setRingSize(std::size_t n) noexcept {
+	if (isAcquiring()) {
+		std::cerr << "could not set frame ring size: acquisition running"
+				  << std::endl;
+		return false;
+	}
+	if (n == 0) {
+		std::cerr << "could not set frame ring size: bad size: 0" << std::endl;
+		return false;
+	}
+	const std::lock_guard lock{ringMtx_};
+	ring_.resize(n);
+	return true;
+}
+
+bool Camera::setStreamConfig(const StreamConfig& cfg) noexcept {
+	if (!isInitialized()) {
+		std::cerr << "could not set stream configuration, camera uninitialized"
+				  << std::endl;
+		return false;
+	}
+	bool ok{true};
+	if (cfg.maxNumBuffer) {
+		if (*cfg.maxNumBuffer > 0) {
+			maxNumBuffer_ = *cfg.maxNumBuffer;
+		} else {
+			ok = false;
+			std::cerr << "could not set \"MaxNumBuffer\": bad value: "
+					  << *cfg.maxNumBuffer << std::endl;
+		}
+	}
+	ParamList params;
+	auto add = [&params](const char* name,
+						 const std::optional<std::int64_t>& v) {
+		if (v) {
+			params.emplace_back(name, std::to_string(*v), ParamType::Int);
+		}
+	};
+	add("GevSCPSPacketSize", cfg.packetSize);
+	add("GevSCPD", cfg.interPacketDelay);
+	add("GevSCFTD", cfg.frameTransmissionDelay);
+	return setParams(params) && ok;
+}
+
 bool Camera::startAcquisition(std::size_t nImages) noexcept {
 	// XXX: not sure what happens here if the camera gets disconnected
 	if (isAcquiring()) {
 		return true;
 	}
 	try {
+		// the frame grabber of a previous startGrabbing would otherwise
+		// take the frames retrieved by polling, see acquire
+		if (grabber_) {
+			cam_->DeregisterImageEventHandler(grabber_.get());
+		}
+		reserveBuffers();
+		resetStreamStats();
 		if (nImages == 0) {
 			cam_->StartGrabbing();
 		} else {
@@ -262,7 +822,85 @@ bool Camera::startAcquisition(std::size_t nImages) noexcept {
 	return false;
 }
 
-void Camera::stopAcquisition() noexcept { cam_->StopGrabbing(); }
+bool Camera::startGrabbing(std::size_t nImages) noexcept {
+	return startGrabbing(nImages, nullptr);
+}
+
+bool Camera::startGrabbing(std::size_t nImages,
+						   std::shared_ptr<internal::GrabSignal> sig) noexcept {
+	if (isAcquiring()) {
+		return static_cast<bool>(grabber_);
+	}
+	try {
+		// the queue is sized like the ring, so the same number of buffers
+		// can be held by the consumer
+		reserveBuffers();
+		resetStreamStats();
+		if (grabber_) {
+			cam_->DeregisterImageEventHandler(grabber_.get());
+		}
+		grabber_ = std::make_unique<internal::FrameGrabber>(
+			getRingSize(), std::move(sig), clk_.get(), trig_.get());
+		cam_->RegisterImageEventHandler(grabber_.get(),
+										Pylon::RegistrationMode_Append,
+										Pylon::Cleanup_None);
+		if (nImages == 0) {
+			cam_->StartGrabbing(Pylon::GrabStrategy_OneByOne,
+								Pylon::GrabLoop_ProvidedByInstantCamera);
+		} else {
+			cam_->StartGrabbing(nImages, Pylon::GrabStrategy_OneByOne,
+								Pylon::GrabLoop_ProvidedByInstantCamera);
+		}
+		return true;
+	} catch (const Pylon::GenericException& e) {
+		std::cerr << "could not start grabbing: " << e.what() << std::endl;
+	} catch (...) {
+		std::cerr << "could not start grabbing" << std::endl;
+	}
+	return false;
+}
+
+bool Camera::startTriggering(const TriggerSchedule& sched) noexcept {
+	if (sched.period.count() < 0) {
+		std::cerr << "could not start triggering: negative period" << std::endl;
+		return false;
+	}
+	try {
+		trig_->start(sched);
+		return true;
+	} catch (const std::system_error& e) {
+		std::cerr << "could not start triggering: " << e.what() << std::endl;
+	} catch (...) {
+		std::cerr << "could not start triggering" << std::endl;
+	}
+	return false;
+}
+
+void Camera::stopAcquisition() noexcept {
+	cam_->StopGrabbing();
+	if (grabber_) {
+		grabber_->stop();
+		// kept around, so that its statistics can still be read
+		cam_->DeregisterImageEventHandler(grabber_.get());
+	}
+}
+
+void Camera::stopTriggering() noexcept { trig_->stop(); }
+
+bool Camera::syncClock() noexcept {
+	if (!isInitialized()) {
+		std::cerr << "could not sync clock, camera uninitialized" << std::endl;
+		return false;
+	}
+	try {
+		return clk_->sync(cam_->GetNodeMap());
+	} catch (const Pylon::GenericException& e) {
+		std::cerr << "could not sync clock: " << e.what() << std::endl;
+	} catch (...) {
+		std::cerr << "could not sync clock" << std::endl;
+	}
+	return false;
+}
 
 bool Camera::trigger(TriggerType typ) noexcept {
 	try {
@@ -8,15 +8,26 @@
 #define BEHOLDER_CAMERA_CAMERA_H
 
 #include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <iostream>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <ratio>
+#include <string>
+#include <vector>
 
 #include "beholder/BeholderExport.h"
 #include "beholder/camera/Exception.h"
+#include "beholder/camera/Frame.h"
 #include "beholder/camera/ParamEntry.h"
+#include "beholder/camera/SensorROI.h"
+#include "beholder/camera/Stream.h"
+#include "beholder/camera/TransportLayer.h"
+#include "beholder/camera/Trigger.h"
 #include "beholder/capi/Image.h"
 
 namespace Pylon {
@@ -27,6 +38,17 @@ class IPylonDevice;
 
 namespace beholder {
 
+namespace internal {
+class ClockSync;
+class DefaultConfigurator;
+class FrameGrabber;
+class NodeCache;
+class TriggerScheduler;
+struct GrabSignal;
+}  // namespace internal
+
+class CameraArray;
+
 // Supported camera acquisition trigger types.
 enum class BH_API TriggerType { Software, Unknown = -1 };
 
@@ -36,8 +58,24 @@ inline static constexpr std::chrono::milliseconds DfltAcqTimeout{1000};
 // The default trigger timeout.
 inline static constexpr std::chrono::milliseconds DfltTriggerTimeout{100};
 
+// The default number of acquisition results which can be held at once,
+// see Camera::acquireFrame.
+inline static constexpr std::size_t DfltRingSize{4};
+
+// FrameSlot is a handle to a frame held in a slot of a camera's frame ring,
+// see Camera::acquireFrame.
+// A handle goes stale once its frame is released, since the slot may
+// be filled by another acquisition afterwards.
+struct FrameSlot {
+	std::size_t index{0};		  // slot of the frame ring
+	std::uint64_t generation{0};  // acquisition which filled the slot
+};
+
 // Camera represents a physical camera device.
 class BH_API Camera {
+	// CameraArray waits on the frame grabbers of several cameras at once.
+	friend class CameraArray;
+
 private:
 	// Deleter is a helper class for releasing the underlying camera device
 	// resources.
@@ -49,6 +87,65 @@ private:
 	std::unique_ptr<Pylon::CInstantCamera, Deleter> cam_;
 	// Underlying camera acquisition result.
 	std::unique_ptr<Pylon::CGrabResultPtr> res_;
+	// RingSlot is a slot of the frame ring.
+	struct RingSlot {
+		Frame frame;				  // empty if the slot is free
+		std::uint64_t generation{0};  // acquisition which filled the slot
+	};
+
+	// Acquisition results held by the caller.
+	// Guarded by ringMtx_, since frames may be released on other threads.
+	std::vector<RingSlot> ring_;
+	mutable std::mutex ringMtx_;
+	// Generation of the last acquisition into the frame ring.
+	std::uint64_t ringGen_{0};
+	// Maps device timestamps onto the host's clock, see syncClock.
+	// Outlives the frame grabber, which refers to it.
+	std::unique_ptr<internal::ClockSync> clk_;
+	// Executes triggers on a schedule, see startTriggering.
+	// Outlives the frame grabber, which refers to it.
+	std::unique_ptr<internal::TriggerScheduler> trig_;
+	// Receives frames on pylon's grab loop thread, see startGrabbing.
+	std::unique_ptr<internal::FrameGrabber> grabber_;
+	// The default configuration, owned by the camera device.
+	internal::DefaultConfigurator* cfg_{nullptr};
+	// Parameter nodes resolved so far, see setParams.
+	std::unique_ptr<internal::NodeCache> nodes_;
+	// Serial number of the device the camera was initialized with.
+	std::string sn_;
+	// Parameters set on the device, in the order in which they were
+	// first set, see reconnect.
+	ParamList params_;
+	// Minimum number of buffers pylon grabs into, see setStreamConfig.
+	std::int64_t maxNumBuffer_{0};
+	// Block ID of the last result acquired, see acquire.
+	std::uint64_t lastBlock_{0};
+	// Frames skipped by the stream, see acquire.
+	std::atomic<std::size_t> nSkipped_{0};
+	// Acquisition timeouts, see acquire and nextFrame.
+	std::atomic<std::size_t> nTimeouts_{0};
+	// Parameter values written to the device, see setParams.
+	std::size_t nParamWrites_{0};
+
+	// Set the sensor region, with acquisition stopped, see setROI.
+	// Returns false if a parameter could not be set.
+	// Throws if the device has no ROI parameters, or can't bin images.
+	bool applyROI(const SensorROI& roi);
+
+	// Remember a parameter which was set, see reconnect.
+	void remember(const ParamEntry& p);
+
+	// Make sure pylon has enough buffers to grab into while the frame
+	// ring is full.
+	void reserveBuffers();
+
+	// Reset the stream statistics kept by the camera, see getStreamStats.
+	void resetStreamStats() noexcept;
+
+	// Start grabbing, with the frame grabber waking up consumers
+	// through 'sig', see startGrabbing(std::size_t).
+	bool startGrabbing(std::size_t nImages,
+					   std::shared_ptr<internal::GrabSignal> sig) noexcept;
 
 protected:
 	// Execute a trigger.
@@ -62,7 +159,8 @@ public:
 	Camera(const Camera&) = delete;
 	Camera(Camera&&) = delete;
 
-	// Default destructor.
+	// Destructor, stops grabbing first, so the grab loop thread
+	// doesn't outlive the frame grabber.
 	// Defined in the source because unique_ptr complains about
 	// incomplete types.
 	~Camera();
@@ -76,6 +174,20 @@ public:
 	//	number of images has been acquired.
 	bool acquire(std::chrono::milliseconds timeout = DfltAcqTimeout);
 
+	// Acquire an image into a free slot of the frame ring, and return
+	// a handle to the slot, or nothing if no slot is free or acquisition
+	// failed.
+	//
+	// The frame stays pinned until the slot is released, see releaseFrame,
+	// so up to getRingSize() frames can be acquired ahead of processing.
+	// The acquisition result is moved into the ring, i.e. getImage() and
+	// getFrame() return nothing afterwards.
+	//
+	// NOTE: frames may be released on other threads in the meantime,
+	// but acquireFrame itself must not be called concurrently.
+	std::optional<FrameSlot>
+	acquireFrame(std::chrono::milliseconds timeout = DfltAcqTimeout);
+
 	// Execute a GenICam command on the camera device.
 	// Returns false if there was an error.
 	//
@@ -96,17 +208,72 @@ public:
 	// Report if command execution finished.
 	bool cmdIsDone(const char* cmd) noexcept;
 
+	// Get the acquired result as a frame, which pins the underlying
+	// acquisition result, i.e. keeps the buffer from being reused by
+	// subsequent acquisitions until the frame is released.
+	std::optional<Frame> getFrame() noexcept;
+
+	// Get the frame held in a slot of the frame ring.
+	// Throws if the handle is stale, i.e. if the frame was released.
+	//
+	// WARNING: the frame must not be used after it is released.
+	[[nodiscard]] const Frame& getFrame(const FrameSlot& slot) const;
+
+	// Get the whole sensor as a region of interest, at the current
+	// binning factor, or nothing if the camera is not initialized or
+	// the region could not be read.
+	[[nodiscard]] std::optional<SensorROI> getFullROI() const noexcept;
+
 	// Get the acquired result as a raw image.
 	//
 	// NOTE: this does not transfer ownership of the underlying
 	// acquisition result.
 	// The receiver should copy the returned buffer if data persistence
-	// is required.
+	// is required, or use getFrame() instead.
 	std::optional<Image> getImage() noexcept;
 
 	// Get camera parameters
 	ParamList getParams(ParamAccessMode mode = ParamAccessMode::ReadWrite);
 
+	// Get the time since the grab thread last delivered a frame,
+	// or since grabbing was last started if no frame has been delivered yet.
+	// Returns nothing if grabbing was never started.
+	[[nodiscard]] std::optional<std::chrono::milliseconds>
+	getIdleTime() const noexcept;
+
+	// Get the number of frames dropped since grabbing was last started,
+	// because the consumer fell behind, see startGrabbing.
+	[[nodiscard]] std::size_t getNoDroppedFrames() const noexcept;
+
+	// Get the number of parameter values written to the device by
+	// setParams, i.e. not counting values which were already set.
+	// Mostly for debugging and internal use.
+	[[nodiscard]] std::size_t getNoParamWrites() const noexcept;
+
+	// Get the number of slots in the frame ring.
+	[[nodiscard]] std::size_t getRingSize() const noexcept;
+
+	// Get the sensor region images are acquired with, or nothing if
+	// the camera is not initialized or the region could not be read.
+	[[nodiscard]] std::optional<SensorROI> getROI() const noexcept;
+
+	// Get the statistics of the image data stream, or nothing if
+	// the camera is not initialized or they could not be read.
+	// All counters are reset whenever acquisition starts.
+	//
+	// NOTE: since packets are lost and resent on the link, rather than
+	// on the device, they are best watched while tuning the stream of
+	// several GigE cameras sharing a link, see setStreamConfig.
+	[[nodiscard]] std::optional<StreamStats> getStreamStats() const noexcept;
+
+	// Get the serial number of the attached camera device,
+	// or an empty string if no device is attached.
+	[[nodiscard]] std::string getSerialNumber() const noexcept;
+
+	// Get the statistics of the triggers executed by the trigger scheduler
+	// since it was last started, see startTriggering.
+	[[nodiscard]] TriggerStats getTriggerStats() const noexcept;
+
 	// Initialize camera device.
 	// The device is attached and open after initialization.
 	//
@@ -133,17 +300,145 @@ public:
 	// Check if the camera device is attached.
 	[[nodiscard]] bool isAttached() const noexcept;
 
+	// Get the next frame grabbed by the grab loop thread, waiting up to
+	// 'timeout' for one to arrive, see startGrabbing.
+	// Returns nothing on timeout, if grabbing was not started or once
+	// acquisition has been stopped and all queued frames have been taken.
+	//
+	// WARNING: must only be called from a single (consumer) thread.
+	std::optional<Frame>
+	nextFrame(std::chrono::milliseconds timeout = DfltAcqTimeout);
+
+	// Reconnect to the device the camera was initialized with,
+	// eg. after it was removed because of a connection glitch.
+	//
+	// The device is looked up on 'tl' (its cached enumeration is used
+	// first), reattached and reopened without loading the default
+	// configuration, and the parameters set so far are reapplied in
+	// the order in which they were first set. Up to 'retries' further
+	// attempts are made 'timeout' apart, if the device is not found.
+	// Acquisition is stopped and has to be restarted by the caller.
+	// Returns false if the device could not be reattached, or the
+	// parameters could not be reapplied.
+	//
+	// WARNING: frames acquired from the removed device are released, and
+	// any frames or pins held elsewhere must be released beforehand.
+	bool reconnect(const TransportLayer& tl,
+				   std::chrono::milliseconds timeout = DfltDevConnTimeout,
+				   std::size_t retries = DfltDevNRetries) noexcept;
+
+	// Release a slot of the frame ring, handing the frame back to pylon
+	// once it is no longer pinned elsewhere.
+	// Stale handles, eg. of frames which were already released, are
+	// ignored, so a slot filled since is never released by mistake.
+	// Thread-safe.
+	void releaseFrame(const FrameSlot& slot) noexcept;
+
+	// Request a trigger from the trigger scheduler, eg. on a tick of
+	// an external timing source, which the scheduler thread executes as
+	// soon as possible, see startTriggering.
+	// Returns false if the scheduler is not running without a period.
+	bool requestTrigger() noexcept;
+
 	// Set camera parameters in the order provided.
+	// Parameters which were set are remembered, see reconnect.
 	// Returns true if no errors ocurred.
+	//
+	// Parameter nodes are looked up once and cached, and only parameters
+	// whose current value differs are written, so re-applying a mostly
+	// unchanged list, eg. when switching between product variants,
+	// only costs the writes which actually change something.
 	bool setParams(const ParamList& params) noexcept;
 
+	// Set the sensor region images are acquired with, so that only
+	// the part of the sensor which is of interest is read out and
+	// transmitted, which raises the achievable frame rate and cuts
+	// bandwidth and processing per frame.
+	//
+	// The region is grown to the device's size and offset increments,
+	// so it always covers 'roi', and clamped to the sensor, see getROI
+	// for the region actually set. Nothing is done if the region, once
+	// grown, is already set.
+	// Binning is used if the device supports it, decimation otherwise.
+	// The image size can't change while acquiring, so acquisition is
+	// stopped and restarted in the same mode, i.e. grabbing or not, but
+	// without an image limit. Frames queued by the grab thread beforehand
+	// are released. Parameters set are remembered, as with setParams.
+	// Returns false if a parameter could not be set, or acquisition could
+	// not be restarted.
+	//
+	// WARNING: must not be called while a consumer is waiting
+	// in nextFrame(...).
+	bool setROI(const SensorROI& roi) noexcept;
+
+	// Set the number of slots in the frame ring, i.e. the number of
+	// acquisition results which can be held at once.
+	// Frames held in removed slots are released.
+	// Returns false if 'n' is 0, or if acquisition is running, since
+	// the number of buffers pylon allocates for grabbing is adjusted to
+	// the ring size when acquisition starts.
+	bool setRingSize(std::size_t n) noexcept;
+
+	// Tune the image data stream, see StreamConfig.
+	// Device parameters are set, and remembered, as with setParams.
+	// The number of buffers takes effect when acquisition starts.
+	// Returns false if a value could not be set, eg. because the device
+	// is not a GigE device.
+	bool setStreamConfig(const StreamConfig& cfg) noexcept;
+
 	// Start image acquisition and stop after nImages have been acquired.
 	// If nImages is 0, the camera will keep acquiring indefinitely.
 	bool startAcquisition(std::size_t nImages = 0UL) noexcept;
 
+	// Start image acquisition on pylon's grab loop thread and stop after
+	// nImages have been acquired. If nImages is 0, the camera will keep
+	// acquiring indefinitely.
+	//
+	// Acquired frames are queued without locking until taken with
+	// nextFrame(...), so acquisition is decoupled from processing.
+	// Up to getRingSize() frames are queued, frames arriving while the
+	// queue is full are dropped, see getNoDroppedFrames.
+	// acquire(...) and acquireFrame(...) must not be used while grabbing.
+	//
+	// WARNING: grabbing must not be (re)started while a consumer is
+	// waiting in nextFrame(...).
+	bool startGrabbing(std::size_t nImages = 0UL) noexcept;
+
+	// Start the trigger scheduler, which executes software triggers on
+	// a thread of its own, either every 'sched.period', or on request
+	// if the period is 0, see requestTrigger. A running scheduler is
+	// restarted, and the trigger statistics are reset.
+	//
+	// Periodic triggers are executed on absolute deadlines, so the cadence
+	// doesn't drift, and deadlines which are missed, eg. because
+	// the trigger command took longer than a period, are skipped.
+	// Triggers are timestamped when executed, and, while grabbing,
+	// matched in order with the frames which arrive, to measure
+	// the latency from trigger to frame, see getTriggerStats.
+	// Triggers are counted as missed while the camera is not acquiring.
+	//
+	// NOTE: the device has to be configured for software triggering,
+	// see TriggerType::Software.
+	bool startTriggering(const TriggerSchedule& sched) noexcept;
+
 	// Stop image acquisition.
+	// Frames already queued can still be taken with nextFrame(...),
+	// waiting consumers are woken up.
 	void stopAcquisition() noexcept;
 
+	// Stop the trigger scheduler, see startTriggering.
+	void stopTriggering() noexcept;
+
+	// Estimate the offset, and drift, between the device's timestamp
+	// counter and the host's system clock, so that acquired images carry
+	// the host time of their exposure, see Image::hostTime.
+	//
+	// The clock is synced when the camera is initialized, but device
+	// clocks drift, so it should be resynced periodically, eg. every few
+	// minutes, preferably while the link is idle.
+	// Returns false if the device cannot latch its timestamp counter.
+	bool syncClock() noexcept;
+
 	// Execute a trigger.
 	bool trigger(TriggerType typ = TriggerType::Software) noexcept;
 
@@ -0,0 +1,188 @@
+// beholder - Copyright © 2024 Philipp Milovic
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "beholder/camera/CameraArray.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "beholder/camera/Camera.h"
+#include "beholder/camera/Exception.h"
+#include "beholder/camera/ParamEntry.h"
+#include "beholder/camera/TransportLayer.h"
+#include "beholder/camera/internal/FrameGrabber.h"
+
+namespace beholder {
+
+CameraArray::CameraArray(std::vector<Camera*> cams) : cams_{std::move(cams)} {
+	// dropping them would shift the indices of the cameras which follow
+	if (std::find(cams_.begin(), cams_.end(), nullptr) != cams_.end()) {
+		throw Exception{"null camera"};
+	}
+}
+
+std::vector<std::size_t>
+CameraArray::getStalled(std::chrono::milliseconds timeout) const noexcept {
+	std::vector<std::size_t> stalled;
+	for (std::size_t i{0}; i < cams_.size(); ++i) {
+		const auto idle{cams_[i]->getIdleTime()};
+		if (!idle || *idle > timeout) {
+			stalled.push_back(i);
+		}
+	}
+	return stalled;
+}
+
+bool CameraArray::init(const std::vector<Pylon::IPylonDevice*>& devs,
+					   const std::vector<ParamList>& params) noexcept {
+	if (devs.size() != cams_.size() ||
+		(!params.empty() && params.size() != cams_.size())) {
+		std::cerr << "could not initialize camera array: "
+				  << "device/parameter count mismatch" << std::endl;
+		return false;
+	}
+	auto initOne = [&](std::size_t i) noexcept -> bool {
+		if (!devs[i]) {
+			std::cerr << "could not initialize camera " << i << ": no device"
+					  << std::endl;
+			return false;
+		}
+		if (!cams_[i]->init(devs[i])) {
+			return false;
+		}
+		return params.empty() || cams_[i]->setParams(params[i]);
+	};
+	try {
+		// the first camera is initialized on the calling thread
+		std::vector<std::future<bool>> tasks;
+		tasks.reserve(cams_.size());
+		for (std::size_t i{1}; i < cams_.size(); ++i) {
+			tasks.emplace_back(std::async(std::launch::async, initOne, i));
+		}
+		bool ok{cams_.empty() || initOne(0)};
+		for (auto& t : tasks) {
+			ok = t.get() && ok;
+		}
+		return ok;
+	} catch (const std::exception& e) {
+		std::cerr << "could not initialize camera array: " << e.what()
+				  << std::endl;
+	} catch (...) {
+		std::cerr << "could not initialize camera array" << std::endl;
+	}
+	return false;
+}
+
+std::optional<ArrayFrame>
+CameraArray::nextFrame(std::chrono::milliseconds timeout) {
+	// all grabbers share the signal if grabbing was started by the array
+	if (cams_.empty() || !cams_.front()->grabber_) {
+		return std::nullopt;
+	}
+	const auto sig{cams_.front()->grabber_->getSignal()};
+
+	// find the camera whose next frame arrived first
+	const auto first = [this]() -> std::optional<std::size_t> {
+		std::optional<std::size_t> idx;
+		std::uint64_t seq{0};
+		for (std::size_t i{0}; i < cams_.size(); ++i) {
+			const auto& g{cams_[i]->grabber_};
+			if (!g) {
+				continue;
+			}
+			if (const auto s{g->peek()}; s && (!idx || *s < seq)) {
+				idx = i;
+				seq = *s;
+			}
+		}
+		return idx;
+	};
+	const auto stopped = [this]() -> bool {
+		return std::all_of(cams_.begin(), cams_.end(),
+						   [](const Camera* c) -> bool {
+							   return !c->grabber_ || c->grabber_->isStopped();
+						   });
+	};
+
+	auto idx{first()};
+	if (!idx) {
+		std::unique_lock lock{sig->mutex};
+		sig->cv.wait_for(lock, timeout, [&]() -> bool {
+			idx = first();
+			return idx || stopped();
+		});
+	}
+	if (!idx) {
+		return std::nullopt;
+	}
+	auto* cam{cams_[*idx]};
+	auto f{cam->grabber_->tryNext()};
+	if (!f) {
+		return std::nullopt;
+	}
+	return ArrayFrame{std::move(f).value(), *idx, cam->getSerialNumber()};
+}
+
+bool CameraArray::reconnect(std::size_t i, const TransportLayer& tl,
+							std::chrono::milliseconds timeout,
+							std::size_t retries) noexcept {
+	if (i >= cams_.size()) {
+		std::cerr << "could not reconnect camera " << i << ": out of range"
+				  << std::endl;
+		return false;
+	}
+	auto* c{cams_[i]};
+	// the other cameras of the array still wake up the consumer through
+	// the signal of the camera's old grabber
+	std::shared_ptr<internal::GrabSignal> sig;
+	if (c->grabber_ && !c->grabber_->isStopped()) {
+		sig = c->grabber_->getSignal();
+	}
+	if (!c->reconnect(tl, timeout, retries)) {
+		return false;
+	}
+	return !sig || c->startGrabbing(0UL, std::move(sig));
+}
+
+std::size_t CameraArray::size() const noexcept { return cams_.size(); }
+
+bool CameraArray::startGrabbing(std::size_t nImages) noexcept {
+	std::shared_ptr<internal::GrabSignal> sig;
+	try {
+		sig = std::make_shared<internal::GrabSignal>();
+	} catch (...) {
+		std::cerr << "could not start grabbing" << std::endl;
+		return false;
+	}
+	for (auto* c : cams_) {
+		// cameras already acquiring on their own can't be waited on
+		// together with the others
+		if (c->isAcquiring()) {
+			c->stopAcquisition();
+		}
+		if (!c->startGrabbing(nImages, sig)) {
+			stopAcquisition();
+			return false;
+		}
+	}
+	return true;
+}
+
+void CameraArray::stopAcquisition() noexcept {
+	for (auto* c : cams_) {
+		c->stopAcquisition();
+	}
+}
+
+}  // namespace beholder
@@ -0,0 +1,130 @@
+// beholder - Copyright © 2024 Philipp Milovic
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// Camera array class definitions.
+
+#ifndef BEHOLDER_CAMERA_CAMERA_ARRAY_H
+#define BEHOLDER_CAMERA_CAMERA_ARRAY_H
+
+#include <chrono>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "beholder/BeholderExport.h"
+#include "beholder/camera/Camera.h"
+#include "beholder/camera/Frame.h"
+#include "beholder/camera/ParamEntry.h"
+#include "beholder/camera/TransportLayer.h"
+
+namespace Pylon {
+class IPylonDevice;
+}  // namespace Pylon
+
+namespace beholder {
+
+// ArrayFrame is a frame tagged with the camera it came from.
+struct BH_API ArrayFrame {
+	Frame frame;		// the acquired frame
+	std::size_t index;	// index of the source camera within the array
+	std::string sn;		// serial number of the source camera
+};
+
+// CameraArray acquires frames from several cameras at once, in the order
+// in which they arrive.
+//
+// Each camera grabs on its own grab loop thread, see Camera::startGrabbing,
+// and all of them wake up the same consumer, so waiting on the array costs
+// as much as waiting on the fastest camera, rather than on all of them
+// in turn. A camera which misses a frame does not hold up the others.
+//
+// NOTE: the array does not own the cameras, they must outlive it.
+// The array holds no state of its own, so it can be constructed
+// on the fly from the same cameras, eg. once to start grabbing and
+// once for each frame taken.
+class BH_API CameraArray {
+private:
+	// The cameras of the array.
+	std::vector<Camera*> cams_;
+
+public:
+	// Default constructor, constructs an empty array.
+	CameraArray() = default;
+
+	// Construct an array from a set of cameras, which are indexed
+	// in the supplied order, see ArrayFrame::index.
+	// Throws if any of the cameras is a nullptr.
+	explicit CameraArray(std::vector<Camera*> cams);
+
+	CameraArray(const CameraArray&) = default;
+	CameraArray(CameraArray&&) = default;
+
+	~CameraArray() = default;
+
+	CameraArray& operator=(const CameraArray&) = default;
+	CameraArray& operator=(CameraArray&&) = default;
+
+	// Get the indices of the cameras which have not delivered a frame
+	// within 'timeout', or which are not grabbing at all.
+	[[nodiscard]] std::vector<std::size_t>
+	getStalled(std::chrono::milliseconds timeout) const noexcept;
+
+	// Initialize the cameras of the array with the supplied devices,
+	// and set their parameters, see Camera::init and Camera::setParams.
+	// The cameras are opened and configured concurrently, each on its own
+	// thread, so the default configuration (user set load, packet size
+	// probe) of one camera doesn't wait on the others.
+	// 'devs' and 'params' are matched to cameras by index; 'params' may be
+	// empty, in which case no parameters are set.
+	// Cameras whose device is a nullptr, eg. because it could not be
+	// created, see TransportLayer::createDevices, are left uninitialized.
+	// Returns false if any camera could not be initialized, or
+	// its parameters could not be set.
+	//
+	// NOTE: takes ownership of the supplied devices, see Camera::init.
+	bool init(const std::vector<Pylon::IPylonDevice*>& devs,
+			  const std::vector<ParamList>& params = {}) noexcept;
+
+	// Get the next frame from any camera of the array, waiting up to
+	// 'timeout' for one to arrive.
+	// Frames are returned in the order in which they arrived, regardless
+	// of which camera they came from.
+	// Returns nothing on timeout, or once acquisition has been stopped
+	// on all cameras and all queued frames have been taken.
+	//
+	// WARNING: must only be called from a single (consumer) thread, and
+	// the cameras' Camera::nextFrame must not be used at the same time.
+	std::optional<ArrayFrame>
+	nextFrame(std::chrono::milliseconds timeout = DfltAcqTimeout);
+
+	// Reattach the device of the i-th camera of the array, see
+	// Camera::reconnect, and, if the array was grabbing, restart grabbing
+	// on the camera, so that it wakes up the array's consumer again.
+	// Returns false if the camera could not be reconnected, or grabbing
+	// could not be restarted.
+	//
+	// WARNING: must be called from the consumer thread, see nextFrame.
+	bool reconnect(std::size_t i, const TransportLayer& tl,
+				   std::chrono::milliseconds timeout = DfltDevConnTimeout,
+				   std::size_t retries = DfltDevNRetries) noexcept;
+
+	// Get the number of cameras in the array.
+	[[nodiscard]] std::size_t size() const noexcept;
+
+	// Start grabbing on all cameras of the array, see
+	// Camera::startGrabbing, and stop after nImages have been acquired
+	// by each of them. If nImages is 0, the cameras keep acquiring
+	// indefinitely.
+	// Returns false, and stops acquisition, if grabbing could not be
+	// started on any of the cameras.
+	bool startGrabbing(std::size_t nImages = 0UL) noexcept;
+
+	// Stop acquisition on all cameras of the array.
+	void stopAcquisition() noexcept;
+};
+
+}  // namespace beholder
+
+#endif	// BEHOLDER_CAMERA_CAMERA_ARRAY_H
@@ -0,0 +1,40 @@
+// beholder - Copyright © 2024 Philipp Milovic
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "beholder/camera/Frame.h"
+
+#include <pylon/GrabResultPtr.h>
+
+#include <memory>
+#include <utility>
+
+#include "beholder/camera/internal/GrabResult.h"
+#include "beholder/capi/Image.h"
+
+namespace beholder {
+
+Frame::Frame(const Pylon::CGrabResultPtr& res,
+			 const internal::ClockSync* clk)
+	// copying the smart pointer bumps the result's reference count
+	: res_{std::make_shared<const Pylon::CGrabResultPtr>(res)} {
+	auto img{internal::toImage(*res_, clk)};
+	if (img) {
+		img_ = std::move(img).value();
+	} else {
+		res_.reset();
+	}
+}
+
+const Image& Frame::getImage() const noexcept { return img_; }
+
+bool Frame::isValid() const noexcept { return static_cast<bool>(res_); }
+
+std::shared_ptr<const void> Frame::pin() const noexcept { return res_; }
+
+void Frame::release() noexcept {
+	res_.reset();
+	img_ = Image{};
+}
+
+}  // namespace beholder
@@ -0,0 +1,82 @@
+// beholder - Copyright © 2024 Philipp Milovic
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// A camera acquisition result handle.
+
+#ifndef BEHOLDER_CAMERA_FRAME_H
+#define BEHOLDER_CAMERA_FRAME_H
+
+#include <memory>
+
+#include "beholder/BeholderExport.h"
+#include "beholder/capi/Image.h"
+
+namespace Pylon {
+class CGrabResultPtr;
+}  // namespace Pylon
+
+namespace beholder {
+
+namespace internal {
+class ClockSync;
+}  // namespace internal
+
+// Frame is a handle to a camera acquisition result, which pins the result,
+// i.e. keeps its buffer from being handed back to pylon and reused,
+// for as long as the frame (or any copy of it, or any pin taken
+// from it) is alive.
+//
+// This lets the buffer be processed in place, eg. wrapped by
+// Processor::viewRawImage(...), instead of being copied out of the way
+// of the next acquisition.
+//
+// NOTE: pinned buffers are not available to pylon, so the number of frames
+// pinned at any one time should be kept well below the number of buffers
+// pylon allocates for grabbing (MaxNumBuffer), otherwise acquisition
+// will stall.
+class BH_API Frame {
+private:
+	// The pinned acquisition result.
+	std::shared_ptr<const Pylon::CGrabResultPtr> res_;
+	// A view of the acquisition result.
+	Image img_;
+
+public:
+	// Default constructor, constructs an empty frame.
+	Frame() = default;
+
+	// Construct a frame which pins an acquisition result.
+	// The device timestamp is mapped onto the host's clock through 'clk',
+	// if set, see Image::hostTime.
+	explicit Frame(const Pylon::CGrabResultPtr& res,
+				   const internal::ClockSync* clk = nullptr);
+
+	Frame(const Frame&) = default;
+	Frame(Frame&&) = default;
+
+	~Frame() = default;
+
+	Frame& operator=(const Frame&) = default;
+	Frame& operator=(Frame&&) = default;
+
+	// Get a view of the acquisition result as a raw image.
+	// The buffer is valid until the frame is released.
+	[[nodiscard]] const Image& getImage() const noexcept;
+
+	// Check if the frame holds a valid acquisition result.
+	[[nodiscard]] bool isValid() const noexcept;
+
+	// Get a type-erased pin of the acquisition result, which keeps it
+	// alive independently of the frame, eg. for as long as the buffer
+	// is used by a Processor.
+	[[nodiscard]] std::shared_ptr<const void> pin() const noexcept;
+
+	// Release the frame. The acquisition result is handed back to pylon
+	// once all pins have been released as well.
+	void release() noexcept;
+};
+
+}  // namespace beholder
+
+#endif	// BEHOLDER_CAMERA_FRAME_H
@@ -0,0 +1,33 @@
+// beholder - Copyright © 2024 Philipp Milovic
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// A camera sensor's region of interest.
+
+#ifndef BEHOLDER_CAMERA_SENSOR_ROI_H
+#define BEHOLDER_CAMERA_SENSOR_ROI_H
+
+#include <cstdint>
+
+#include "beholder/BeholderExport.h"
+
+namespace beholder {
+
+// SensorROI is the region of a camera's sensor which is read out and
+// transmitted, along with the factor by which it is binned, or decimated.
+//
+// The region is in sensor pixels, i.e. before binning, so that it keeps
+// its meaning when the binning factor changes. A point (x, y) of an image
+// acquired with the region maps onto the sensor point
+// (offsetX + x * binning, offsetY + y * binning).
+struct BH_API SensorROI {
+	std::int64_t offsetX{0};  // left edge
+	std::int64_t offsetY{0};  // top edge
+	std::int64_t width{0};	  // width
+	std::int64_t height{0};	  // height
+	std::int64_t binning{1};  // binning/decimation factor, both axes
+};
+
+}  // namespace beholder
+
+#endif	// BEHOLDER_CAMERA_SENSOR_ROI_H
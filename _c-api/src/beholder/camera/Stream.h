@@ -0,0 +1,57 @@
+// beholder - Copyright © 2024 Philipp Milovic
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// Stream grabber statistics and tuning.
+
+#ifndef BEHOLDER_CAMERA_STREAM_H
+#define BEHOLDER_CAMERA_STREAM_H
+
+#include <cstdint>
+#include <optional>
+
+#include "beholder/BeholderExport.h"
+
+namespace beholder {
+
+// StreamStats are the statistics of a camera's image data stream.
+//
+// All counters are reset whenever acquisition starts. Counters which
+// the transport layer doesn't keep are 0, eg. packet counters are kept
+// only for GigE devices.
+struct BH_API StreamStats {
+	std::uint64_t totalBuffers{0};	   // buffers grabbed
+	std::uint64_t failedBuffers{0};	   // buffers grabbed incompletely
+	std::uint64_t bufferUnderruns{0};  // no free buffer to grab into
+	std::uint64_t totalPackets{0};	   // packets received, GigE
+	std::uint64_t failedPackets{0};	   // packets lost, GigE
+	std::uint64_t resendRequests{0};   // resend requests sent, GigE
+	std::uint64_t resendPackets{0};	   // packets requested again, GigE
+	std::uint64_t missedFrames{0};	   // frames missed by the device, USB
+	std::uint64_t skippedFrames{0};	   // gaps in block IDs, by the camera
+	std::uint64_t droppedFrames{0};	   // grab queue full, see startGrabbing
+	std::uint64_t timeouts{0};		   // acquisition timeouts
+};
+
+// StreamConfig tunes a camera's image data stream.
+// Unset values are left as they are.
+//
+// On a GigE link shared by several cameras, the packet size, the delay
+// between packets and the delay of the transmission of each frame are
+// used to spread the cameras' bandwidth, so that their bursts don't
+// overflow the switch's or the NIC's buffers.
+struct BH_API StreamConfig {
+	// Minimum number of buffers pylon grabs into, see Camera::setRingSize.
+	std::optional<std::int64_t> maxNumBuffer;
+	// Packet size in bytes, GigE only ('GevSCPSPacketSize').
+	std::optional<std::int64_t> packetSize;
+	// Delay between packets in timestamp ticks, GigE only ('GevSCPD').
+	std::optional<std::int64_t> interPacketDelay;
+	// Delay of each frame's transmission in timestamp ticks,
+	// GigE only ('GevSCFTD').
+	std::optional<std::int64_t> frameTransmissionDelay;
+};
+
+}  // namespace beholder
+
+#endif	// BEHOLDER_CAMERA_STREAM_H
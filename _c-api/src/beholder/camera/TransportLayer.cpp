@@ -15,14 +15,108 @@
 
 #include <algorithm>
 #include <chrono>
+#include <cstddef>
 #include <cstring>
+#include <future>
 #include <iostream>
 #include <memory>
+#include <mutex>
+#include <sstream>
 #include <string>
 #include <thread>
+#include <utility>
+#include <vector>
 
 namespace beholder {
 
+namespace {
+// Enumerate the devices available on a transport layer.
+Pylon::DeviceInfoList_t enumerate(Pylon::ITransportLayer& tl, DeviceClass dc) {
+	Pylon::DeviceInfoList_t devices{};
+	if (dc == DeviceClass::GigE) {
+		// NOLINTNEXTLINE(cppcoreguidelines-pro-type-static-cast-downcast)
+		static_cast<Pylon::IGigETransportLayer&>(tl).EnumerateAllDevices(
+			devices);
+	} else {
+		tl.EnumerateDevices(devices);
+	}
+	return devices;
+}
+
+// Find the device with the provided designator among enumerated devices.
+// Returns nullptr if the device is not found.
+const Pylon::CDeviceInfo* findDevice(const Pylon::DeviceInfoList_t& devices,
+									 const char* designator,
+									 DeviceDesignator ddt) {
+	auto selector = [ddt, designator](const auto& info) -> bool {
+		switch (ddt) {
+			case DeviceDesignator::MAC: {
+				return std::strcmp(designator,
+								   info.GetMacAddress().c_str()) == 0;
+			}
+			case DeviceDesignator::SN: {
+				return std::strcmp(designator,
+								   info.GetSerialNumber().c_str()) == 0;
+			}
+			case DeviceDesignator::Unknown: {
+				return false;
+			}
+		}
+		return false;
+	};
+	auto found{std::find_if(devices.begin(), devices.end(), selector)};
+	if (found == devices.end()) {
+		return nullptr;
+	}
+	return &(*found);
+}
+
+// Reboot/reset a device, destroying it in the process.
+// Returns true if the device was reset.
+bool resetDevice(Pylon::ITransportLayer& tl, Pylon::IPylonDevice* d) {
+	// no try-catch here because if we throw, we have actual issues
+	d->Open();
+	const bool reset{
+		Pylon::CCommandParameter(d->GetNodeMap(), "DeviceReset").TryExecute()};
+	// probably unnecessary, but just in case the device is
+	// in an invalid state
+	tl.DestroyDevice(d);
+	return reset;
+}
+}  // namespace
+
+// Cache holds the devices found by the last enumeration.
+struct TransportLayer::Cache {
+	using Clock = std::chrono::steady_clock;
+
+	// Guards the cache.
+	std::mutex mutex;
+	// Devices found by the last enumeration.
+	Pylon::DeviceInfoList_t devices;
+	// Time of the last enumeration.
+	Clock::time_point stamp;
+	// False if devices must be enumerated anew.
+	bool valid{false};
+	// Interval after which the cache is stale.
+	std::chrono::milliseconds refresh{DfltEnumRefresh};
+
+	// Get the enumerated devices, enumerating them anew if the cache
+	// is stale or 'force' is true.
+	// The second element reports whether devices were enumerated anew.
+	std::pair<Pylon::DeviceInfoList_t, bool>
+	get(Pylon::ITransportLayer& tl, DeviceClass dc, bool force = false) {
+		const std::lock_guard lock{mutex};
+		const auto now{Clock::now()};
+		if (!force && valid && now - stamp < refresh) {
+			return {devices, false};
+		}
+		devices = enumerate(tl, dc);
+		stamp = now;
+		valid = true;
+		return {devices, true};
+	}
+};
+
 void TransportLayer::Deleter::operator()(Pylon::ITransportLayer* tl) {
 	if (static_cast<bool>(tl)) {
 		Pylon::CTlFactory::GetInstance().ReleaseTl(tl);
@@ -38,37 +132,19 @@ TransportLayer::createDeviceImpl(const char* designator,
 		return nullptr;
 	}
 	try {
-		Pylon::DeviceInfoList_t devices{};
-		if (dc_ == DeviceClass::GigE) {
-			// NOLINTNEXTLINE(cppcoreguidelines-pro-type-static-cast-downcast)
-			auto* ptr{static_cast<Pylon::IGigETransportLayer*>(tl_.get())};
-			ptr->EnumerateAllDevices(devices);
-		} else {
-			tl_->EnumerateDevices(devices);
+		auto [devices, fresh]{cache_->get(*tl_, dc_)};
+		const auto* found{findDevice(devices, designator, ddt)};
+		// the device might have (re)appeared since the last enumeration
+		if (!static_cast<bool>(found) && !fresh) {
+			devices = cache_->get(*tl_, dc_, true).first;
+			found = findDevice(devices, designator, ddt);
 		}
 		if (devices.empty()) {
 			std::cerr << "could not create device: "
 					  << "no devices available" << std::endl;
 			return nullptr;
 		}
-		auto selector = [ddt, designator](const auto& info) -> bool {
-			switch (ddt) {
-				case DeviceDesignator::MAC: {
-					return std::strcmp(designator,
-									   info.GetMacAddress().c_str()) == 0;
-				}
-				case DeviceDesignator::SN: {
-					return std::strcmp(designator,
-									   info.GetSerialNumber().c_str()) == 0;
-				}
-				case DeviceDesignator::Unknown: {
-					return false;
-				}
-			}
-			return false;
-		};
-		auto found{std::find_if(devices.begin(), devices.end(), selector)};
-		if (found == devices.end()) {
+		if (!static_cast<bool>(found)) {
 			std::cerr << "could not create device: "
 					  << "could not find specified device" << std::endl;
 			return nullptr;
@@ -82,6 +158,8 @@ TransportLayer::createDeviceImpl(const char* designator,
 	return nullptr;
 }
 
+TransportLayer::TransportLayer() : cache_{std::make_unique<Cache>()} {}
+
 // NOLINTNEXTLINE(*-use-equals-default): incomplete type; must be defined here
 TransportLayer::~TransportLayer(){};
 
@@ -139,18 +217,13 @@ TransportLayer::createDevice(const char* designator, DeviceDesignator ddt,
 	try {
 		std::cout << "trying to reset device: " << formatDeviceDesignator(ddt)
 				  << " : " << designator << std::endl;
-		// no try-catch here because if we throw, we have actual issues
-		d->Open();
-		const bool reset{
-			Pylon::CCommandParameter(d->GetNodeMap(), "DeviceReset")
-				.TryExecute()};
-		// probably unnecessary, but just in case the device is
-		// in an invalid state
-		tl_->DestroyDevice(d);
-		if (reset) {
+		if (resetDevice(*tl_, d)) {
 			std::cout << "waiting for device on-line" << std::endl;
 			for (auto i{0UL}; i < retries; ++i) {
 				std::this_thread::sleep_for(timeout);
+				// the cached enumeration still lists the device as it was
+				// before the reset
+				invalidateCache();
 				// FIXME: mute log output here, we only care about failure
 				// after all attempts have been made
 				d = createDeviceImpl(designator, ddt);
@@ -174,16 +247,133 @@ TransportLayer::createDevice(const char* designator, DeviceDesignator ddt,
 	return nullptr;
 }
 
-std::string TransportLayer::getFirstSN() const noexcept {
+std::vector<Pylon::IPylonDevice*>
+TransportLayer::createDevices(const std::vector<std::string>& designators,
+							  DeviceDesignator ddt, bool reboot,
+							  std::chrono::milliseconds timeout,
+							  std::size_t retries) const noexcept {
+	std::vector<Pylon::IPylonDevice*> devs(designators.size(), nullptr);
+	if (!tl_) {
+		std::cerr << "could not create devices: "
+				  << "transport layer uninitialized" << std::endl;
+		return devs;
+	}
 	try {
-		Pylon::DeviceInfoList_t devices{};
-		if (dc_ == DeviceClass::GigE) {
-			// NOLINTNEXTLINE(cppcoreguidelines-pro-type-static-cast-downcast)
-			auto* ptr{static_cast<Pylon::IGigETransportLayer*>(tl_.get())};
-			ptr->EnumerateAllDevices(devices);
-		} else {
-			tl_->EnumerateDevices(devices);
+		// a single enumeration is shared by all devices, it's refreshed
+		// if any of them is missing from the cached one
+		auto cached{cache_->get(*tl_, dc_)};
+		auto devices{std::move(cached.first)};
+		const bool missing{std::any_of(
+			designators.begin(), designators.end(),
+			[&devices, ddt](const std::string& d) -> bool {
+				return !static_cast<bool>(findDevice(devices, d.c_str(), ddt));
+			})};
+		if (missing && !cached.second) {
+			devices = cache_->get(*tl_, dc_, true).first;
 		}
+
+		// devices which were reset, and have to be waited on
+		// NOTE: not a vector<bool>, since it's written to concurrently
+		std::vector<char> pending(designators.size(), 0);
+		// messages of each device, printed once all threads are done,
+		// so that the lines of different devices don't interleave
+		std::vector<std::ostringstream> outs(designators.size());
+		std::vector<std::ostringstream> errs(designators.size());
+
+		auto create = [&](std::size_t i) noexcept {
+			const auto& des{designators[i]};
+			auto& out{outs[i]};
+			auto& err{errs[i]};
+			try {
+				const auto* info{findDevice(devices, des.c_str(), ddt)};
+				if (!static_cast<bool>(info)) {
+					err << "could not create device: "
+						<< formatDeviceDesignator(ddt) << " : " << des
+						<< "; could not find specified device\n";
+					return;
+				}
+				auto* d{tl_->CreateDevice(*info)};
+				if (!reboot) {
+					devs[i] = d;
+					return;
+				}
+				out << "trying to reset device: " << formatDeviceDesignator(ddt)
+					<< " : " << des << '\n';
+				if (resetDevice(*tl_, d)) {
+					pending[i] = 1;
+					return;
+				}
+				err << "could not reset device: " << formatDeviceDesignator(ddt)
+					<< " : " << des << "; continuing without reset\n";
+				devs[i] = tl_->CreateDevice(*info);
+			} catch (const Pylon::GenericException& e) {
+				err << "could not create device: "
+					<< formatDeviceDesignator(ddt) << " : " << des << "; "
+					<< e.what() << '\n';
+			} catch (...) {
+				err << "could not create device: "
+					<< formatDeviceDesignator(ddt) << " : " << des << '\n';
+			}
+		};
+		// connect to and reset all devices concurrently, the first one
+		// on the calling thread
+		std::vector<std::future<void>> tasks;
+		tasks.reserve(designators.size());
+		for (std::size_t i{1}; i < designators.size(); ++i) {
+			tasks.emplace_back(std::async(std::launch::async, create, i));
+		}
+		if (!designators.empty()) {
+			create(0);
+		}
+		for (auto& t : tasks) {
+			t.get();
+		}
+		for (std::size_t i{0}; i < designators.size(); ++i) {
+			std::cout << outs[i].str() << std::flush;
+			std::cerr << errs[i].str() << std::flush;
+		}
+
+		// wait for the reset devices to come back on-line, one
+		// enumeration per attempt is shared by all of them
+		auto nPending{std::count(pending.begin(), pending.end(), 1)};
+		if (nPending > 0) {
+			std::cout << "waiting for devices on-line" << std::endl;
+		}
+		for (auto n{0UL}; n < retries && nPending > 0; ++n) {
+			std::this_thread::sleep_for(timeout);
+			const auto online{cache_->get(*tl_, dc_, true).first};
+			for (std::size_t i{0}; i < designators.size(); ++i) {
+				if (pending[i] == 0) {
+					continue;
+				}
+				const auto* info{
+					findDevice(online, designators[i].c_str(), ddt)};
+				if (static_cast<bool>(info)) {
+					devs[i] = tl_->CreateDevice(*info);
+					pending[i] = 0;
+					--nPending;
+				}
+			}
+		}
+		for (std::size_t i{0}; i < designators.size(); ++i) {
+			if (pending[i] != 0) {
+				std::cerr << "could not create device: "
+						  << formatDeviceDesignator(ddt) << " : "
+						  << designators[i]
+						  << "; retry limit reached after reset" << std::endl;
+			}
+		}
+	} catch (const Pylon::GenericException& e) {
+		std::cerr << "could not create devices: " << e.what() << std::endl;
+	} catch (...) {
+		std::cerr << "could not create devices" << std::endl;
+	}
+	return devs;
+}
+
+std::string TransportLayer::getFirstSN() const noexcept {
+	try {
+		const auto devices{cache_->get(*tl_, dc_).first};
 		if (devices.empty()) {
 			std::cerr << "could not find a device: "
 					  << "no devices available" << std::endl;
@@ -198,6 +388,17 @@ std::string TransportLayer::getFirstSN() const noexcept {
 	return {};
 }
 
+void TransportLayer::invalidateCache() noexcept {
+	const std::lock_guard lock{cache_->mutex};
+	cache_->valid = false;
+}
+
+void TransportLayer::setRefreshInterval(
+	std::chrono::milliseconds interval) noexcept {
+	const std::lock_guard lock{cache_->mutex};
+	cache_->refresh = interval;
+}
+
 std::string formatDeviceDesignator(DeviceDesignator ddt) {
 	switch (ddt) {
 		case DeviceDesignator::MAC:
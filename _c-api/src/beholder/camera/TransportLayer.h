@@ -10,6 +10,7 @@
 #include <chrono>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "beholder/BeholderExport.h"
 
@@ -42,6 +43,10 @@ inline static constexpr std::chrono::milliseconds DfltDevConnTimeout{3000};
 // The default number of retry attempts for connecting to a camera device.
 inline static constexpr std::size_t DfltDevNRetries{5UL};
 
+// The default interval after which the cached device enumeration
+// is refreshed.
+inline static constexpr std::chrono::milliseconds DfltEnumRefresh{5000};
+
 // TransportLayer handles communication with physical (camera) devices.
 class BH_API TransportLayer {
 private:
@@ -51,13 +56,21 @@ private:
 		void operator()(Pylon::ITransportLayer* tl);
 	};
 
+	// Cache is the cached device enumeration, defined in the source,
+	// so that pylon headers aren't needed here.
+	struct Cache;
+
 	// Underlying transport layer.
 	std::unique_ptr<Pylon::ITransportLayer, Deleter> tl_;
+	// Cached device enumeration.
+	std::unique_ptr<Cache> cache_;
 	// Class of device supported by the transport layer.
 	DeviceClass dc_{DeviceClass::Unknown};
 
 protected:
 	// Find and create a device with the provided designator.
+	// The cached enumeration is used, unless the device can't be found
+	// in it, in which case devices are enumerated anew.
 	[[nodiscard]] Pylon::IPylonDevice* createDeviceImpl(
 		const char* designator,
 		DeviceDesignator ddt = DeviceDesignator::SN) const noexcept;
@@ -66,7 +79,7 @@ public:
 	// Default constructor.
 	// The transport layer must be initialized with TransportLayer::init
 	// before use.
-	TransportLayer() = default;
+	TransportLayer();
 
 	TransportLayer(const TransportLayer&) = delete;
 	TransportLayer(TransportLayer&&) = delete;
@@ -117,8 +130,36 @@ public:
 				 std::chrono::milliseconds timeout = DfltDevConnTimeout,
 				 std::size_t retries = DfltDevNRetries) const noexcept;
 
+	// Find and establish connections to devices with the provided
+	// designators, concurrently.
+	// If reboot is true, the devices will be rebooted/reset during creation.
+	// Returns the devices in the order of the designators, where devices
+	// which could not be created are nullptr.
+	//
+	// Unlike calling createDevice for each designator, all devices are
+	// found with a single enumeration, they are reset concurrently and
+	// waited on together, so bringing up N devices takes about as long as
+	// bringing up one.
+	//
+	// NOTE: see createDevice for notes on the returned pointers.
+	[[nodiscard]] std::vector<Pylon::IPylonDevice*>
+	createDevices(const std::vector<std::string>& designators,
+				  DeviceDesignator ddt = DeviceDesignator::SN,
+				  bool reboot = true,
+				  std::chrono::milliseconds timeout = DfltDevConnTimeout,
+				  std::size_t retries = DfltDevNRetries) const noexcept;
+
 	// Get the serial number of the first device found
 	[[nodiscard]] std::string getFirstSN() const noexcept;
+
+	// Invalidate the cached device enumeration, so that devices are
+	// enumerated anew on the next lookup.
+	void invalidateCache() noexcept;
+
+	// Set the interval after which the cached device enumeration is
+	// considered stale and devices are enumerated anew.
+	// An interval of 0 disables caching.
+	void setRefreshInterval(std::chrono::milliseconds interval) noexcept;
 };
 
 // Return a formatted string of the device designator
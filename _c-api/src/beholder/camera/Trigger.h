@@ -0,0 +1,56 @@
+// beholder - Copyright © 2024 Philipp Milovic
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// Scheduled software triggering.
+
+#ifndef BEHOLDER_CAMERA_TRIGGER_H
+#define BEHOLDER_CAMERA_TRIGGER_H
+
+#include <chrono>
+#include <cstdint>
+
+#include "beholder/BeholderExport.h"
+
+namespace beholder {
+
+// TriggerSchedule configures the trigger scheduler, see
+// Camera::startTriggering.
+struct BH_API TriggerSchedule {
+	// The time between triggers. If 0, triggers are executed when
+	// requested by an external timing source, see Camera::requestTrigger.
+	std::chrono::microseconds period{0};
+	// The time spent spinning, rather than sleeping, before each trigger,
+	// since sleeps overshoot by the OS scheduler's wake-up latency.
+	// Trades CPU time for a steadier cadence.
+	std::chrono::microseconds spin{200};  // NOLINT(*-magic-numbers)
+	// The time a trigger waits for its frame, after which it is counted
+	// as unanswered, eg. because the device ignored it.
+	std::chrono::milliseconds maxLatency{1000};	 // NOLINT(*-magic-numbers)
+};
+
+// TriggerStats are the statistics of scheduled triggers.
+//
+// Jitter is the time by which a trigger was executed after it was due,
+// i.e. after its deadline or after it was requested. Latency is the time
+// from a trigger's execution until its frame arrived on the host.
+// All times are in microseconds, and all statistics are reset whenever
+// the scheduler starts.
+struct BH_API TriggerStats {
+	std::uint64_t triggers{0};	 // triggers executed
+	std::uint64_t missed{0};	 // triggers not executed, late or failed
+	std::uint64_t frames{0};	 // frames matched to a trigger
+	std::uint64_t unanswered{0};  // triggers without a frame
+	double intervalMean{0.0};	 // mean time between triggers
+	double intervalStd{0.0};	 // std. deviation of the above
+	double jitterMean{0.0};		 // mean jitter
+	double jitterStd{0.0};		 // std. deviation of the jitter
+	double jitterMax{0.0};		 // max. jitter
+	double latencyMean{0.0};	 // mean latency
+	double latencyStd{0.0};		 // std. deviation of the latency
+	double latencyMax{0.0};		 // max. latency
+};
+
+}  // namespace beholder
+
+#endif	// BEHOLDER_CAMERA_TRIGGER_H
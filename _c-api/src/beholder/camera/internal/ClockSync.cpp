@@ -0,0 +1,129 @@
+// beholder - Copyright © 2024 Philipp Milovic
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "beholder/camera/internal/ClockSync.h"
+
+#include <GenApi/ICommand.h>
+#include <GenApi/IInteger.h>
+#include <GenApi/INode.h>
+#include <GenApi/INodeMap.h>
+#include <GenApi/Pointer.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <optional>
+
+namespace beholder {
+namespace internal {
+
+namespace {
+// Drift estimates further than this from the nominal tick rate are
+// assumed to be wrong, crystals are usually within 100 ppm.
+constexpr double maxDrift{1e-3};  // NOLINT(*-magic-numbers)
+
+// Minimum time between the sync points drift is estimated from.
+constexpr std::chrono::seconds minDriftSpan{1};
+
+// Get the current host time in ns since the epoch.
+std::int64_t hostNow() noexcept {
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(
+			   std::chrono::system_clock::now().time_since_epoch())
+		.count();
+}
+
+// Get a node which is available, or nullptr.
+GenApi::INode* find(GenApi::INodeMap& map, const char* name) {
+	auto* n{map.GetNode(name)};
+	return GenApi::IsAvailable(n) ? n : nullptr;
+}
+}  // namespace
+
+std::optional<std::chrono::nanoseconds>
+ClockSync::getUncertainty() const noexcept {
+	const std::lock_guard lock{mtx_};
+	if (!ref_) {
+		return std::nullopt;
+	}
+	return uncertainty_;
+}
+
+void ClockSync::reset() noexcept {
+	const std::lock_guard lock{mtx_};
+	anchor_.reset();
+	ref_.reset();
+	nominal_ = 1.0;
+	nsPerTick_ = 1.0;
+	uncertainty_ = std::chrono::nanoseconds{0};
+}
+
+bool ClockSync::sync(GenApi::INodeMap& map, std::size_t n) {
+	// SFNC names first, then the older GigE Vision ones
+	GenApi::CCommandPtr latch{find(map, "TimestampLatch")};
+	GenApi::CIntegerPtr value{find(map, "TimestampLatchValue")};
+	if (!latch || !value) {
+		latch = find(map, "GevTimestampControlLatch");
+		value = find(map, "GevTimestampValue");
+	}
+	if (!latch || !value || !GenApi::IsWritable(latch) || n == 0) {
+		return false;
+	}
+	// devices without a tick frequency count in ns
+	double nominal{1.0};
+	if (GenApi::CIntegerPtr freq{find(map, "GevTimestampTickFrequency")};
+		freq && GenApi::IsReadable(freq) && freq->GetValue() > 0) {
+		constexpr double nsPerSec{1e9};	 // NOLINT(*-magic-numbers)
+		nominal = nsPerSec / static_cast<double>(freq->GetValue());
+	}
+
+	Point best;
+	auto rtt{std::numeric_limits<std::int64_t>::max()};
+	for (auto i{0UL}; i < n; ++i) {
+		const auto t0{hostNow()};
+		latch->Execute();
+		const auto t1{hostNow()};
+		const auto ticks{static_cast<std::uint64_t>(
+			value->GetValue(false, true))};	 // bypass the node cache
+		if (t1 - t0 < rtt) {
+			rtt = t1 - t0;
+			best = Point{ticks, t0 + rtt / 2};
+		}
+	}
+
+	const std::lock_guard lock{mtx_};
+	if (!anchor_ || nominal != nominal_) {
+		anchor_ = best;
+		nominal_ = nominal;
+		nsPerTick_ = nominal;
+	} else if (best.host - anchor_->host >=
+				   std::chrono::nanoseconds{minDriftSpan}.count() &&
+			   best.ticks > anchor_->ticks) {
+		const auto rate{static_cast<double>(best.host - anchor_->host) /
+						static_cast<double>(best.ticks - anchor_->ticks)};
+		nsPerTick_ = std::clamp(rate, nominal_ * (1.0 - maxDrift),
+								nominal_ * (1.0 + maxDrift));
+	}
+	ref_ = best;
+	uncertainty_ = std::chrono::nanoseconds{rtt / 2};
+	return true;
+}
+
+std::optional<std::int64_t>
+ClockSync::toHost(std::uint64_t ticks) const noexcept {
+	const std::lock_guard lock{mtx_};
+	if (!ref_) {
+		return std::nullopt;
+	}
+	// frames may be stamped before the latest sync
+	const auto dt{static_cast<std::int64_t>(ticks - ref_->ticks)};
+	return ref_->host +
+		   std::llround(static_cast<double>(dt) * nsPerTick_);
+}
+
+}  // namespace internal
+}  // namespace beholder
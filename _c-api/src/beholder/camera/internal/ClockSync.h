@@ -0,0 +1,72 @@
+// beholder - Copyright © 2024 Philipp Milovic
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef BEHOLDER_CAMERA_INTERNAL_CLOCK_SYNC_H
+#define BEHOLDER_CAMERA_INTERNAL_CLOCK_SYNC_H
+
+#include <GenApi/INodeMap.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+
+namespace beholder {
+namespace internal {
+
+// ClockSync maps device timestamps, i.e. timestamp counter ticks, onto
+// the host's system clock.
+//
+// The offset is estimated by latching the device's timestamp counter
+// several times and keeping the sample with the shortest round trip,
+// whose midpoint is taken as the host time of the latch.
+// Once two syncs lie at least a second apart, the device clock's drift
+// is estimated from them as well, so the mapping stays accurate
+// in between syncs.
+//
+// NOTE: all member functions are thread-safe, toHost(...) is called
+// on pylon's grab loop thread.
+class ClockSync {
+private:
+	// A device timestamp and the host time at which it was latched.
+	struct Point {
+		std::uint64_t ticks{0};	 // device timestamp
+		std::int64_t host{0};	 // ns since the epoch
+	};
+
+	mutable std::mutex mtx_;
+	std::optional<Point> anchor_;  // first sync point, for drift estimation
+	std::optional<Point> ref_;	   // latest sync point
+	double nominal_{1.0};		   // nominal ns per tick
+	double nsPerTick_{1.0};		   // estimated ns per tick
+	std::chrono::nanoseconds uncertainty_{0};  // half the best round trip
+
+public:
+	// Default number of latches per sync.
+	static constexpr std::size_t DfltNoSamples{8};
+
+	// Get the uncertainty of the latest sync, i.e. half the round trip
+	// of its best sample, or nothing if not synced.
+	[[nodiscard]] std::optional<std::chrono::nanoseconds>
+	getUncertainty() const noexcept;
+
+	// Forget all sync points, eg. when the device is reattached.
+	void reset() noexcept;
+
+	// Sync with the device whose node map is 'map', taking 'n' samples.
+	// Returns false if the device cannot latch its timestamp counter.
+	// Throws if the device could not be accessed.
+	bool sync(GenApi::INodeMap& map, std::size_t n = DfltNoSamples);
+
+	// Map a device timestamp onto the host's system clock, in ns since
+	// the epoch, or nothing if not synced.
+	[[nodiscard]] std::optional<std::int64_t>
+	toHost(std::uint64_t ticks) const noexcept;
+};
+
+}  // namespace internal
+}  // namespace beholder
+
+#endif	// BEHOLDER_CAMERA_INTERNAL_CLOCK_SYNC_H
@@ -54,7 +54,9 @@ void DefaultConfigurator::applyConfiguration(GenApi::INodeMap& nodemap) const {
 
 void DefaultConfigurator::OnOpened(Pylon::CInstantCamera& cam) {
 	try {
-		applyConfiguration(cam.GetNodeMap());
+		if (apply_) {
+			applyConfiguration(cam.GetNodeMap());
+		}
 		// Probe max packet size
 		Pylon::CConfigurationHelper::ProbePacketSize(
 			cam.GetStreamGrabberNodeMap());
@@ -67,5 +69,7 @@ void DefaultConfigurator::OnOpened(Pylon::CInstantCamera& cam) {
 	}
 }
 
+void DefaultConfigurator::setApply(bool apply) noexcept { apply_ = apply; }
+
 }  // namespace internal
 }  // namespace beholder
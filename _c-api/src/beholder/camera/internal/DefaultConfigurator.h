@@ -15,6 +15,10 @@ namespace internal {
 // DefaultConfigurator is the default configuration used for all camera devices
 // when they are initialized.
 class DefaultConfigurator : public Pylon::CConfigurationEventHandler {
+private:
+	// Whether to apply the configuration when the camera device is opened.
+	bool apply_{true};
+
 protected:
 	// Apply the configuration.
 	virtual void applyConfiguration(GenApi::INodeMap& nodemap) const;
@@ -32,6 +36,12 @@ public:
 
 	// Apply configuration right after the camera device is opened.
 	void OnOpened(Pylon::CInstantCamera& cam) override;
+
+	// Set whether the configuration is applied when the camera device
+	// is opened, eg. to skip loading the default user set when
+	// reconnecting to a device whose configuration is restored otherwise.
+	// The packet size is probed regardless.
+	void setApply(bool apply) noexcept;
 };
 
 }  // namespace internal
@@ -0,0 +1,125 @@
+// beholder - Copyright © 2024 Philipp Milovic
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "beholder/camera/internal/FrameGrabber.h"
+
+#include <pylon/GrabResultPtr.h>
+#include <pylon/InstantCamera.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+#include "beholder/camera/Frame.h"
+#include "beholder/camera/internal/GrabResult.h"
+#include "beholder/camera/internal/TriggerScheduler.h"
+
+namespace beholder {
+namespace internal {
+
+FrameGrabber::FrameGrabber(std::size_t capacity,
+						   std::shared_ptr<GrabSignal> sig,
+						   const ClockSync* clk,
+						   TriggerScheduler* trig)
+	: queue_{capacity},
+	  sig_{sig ? std::move(sig) : std::make_shared<GrabSignal>()},
+	  clk_{clk},
+	  trig_{trig},
+	  last_{Clock::now().time_since_epoch().count()} {}
+
+FrameGrabber::Clock::duration FrameGrabber::getIdleTime() const noexcept {
+	const Clock::time_point last{
+		Clock::duration{last_.load(std::memory_order_relaxed)}};
+	return Clock::now() - last;
+}
+
+std::size_t FrameGrabber::getNoDropped() const noexcept {
+	return nDropped_.load(std::memory_order_relaxed);
+}
+
+std::size_t FrameGrabber::getNoSkipped() const noexcept {
+	return nSkipped_.load(std::memory_order_relaxed);
+}
+
+const std::shared_ptr<GrabSignal>& FrameGrabber::getSignal() const noexcept {
+	return sig_;
+}
+
+bool FrameGrabber::isStopped() const noexcept {
+	return stopped_.load(std::memory_order_acquire);
+}
+
+std::optional<Frame> FrameGrabber::next(std::chrono::milliseconds timeout) {
+	if (auto f{tryNext()}; f) {
+		return f;
+	}
+	std::unique_lock lock{sig_->mutex};
+	sig_->cv.wait_for(lock, timeout, [this]() -> bool {
+		return !queue_.empty() || isStopped();
+	});
+	return tryNext();
+}
+
+void FrameGrabber::OnImageGrabbed([[maybe_unused]] Pylon::CInstantCamera& cam,
+								  const Pylon::CGrabResultPtr& res) {
+	const auto now{Clock::now()};
+	// failed grabs are counted by the stream grabber, not as skips
+	const auto n{countSkipped(lastBlock_, res->GetBlockID())};
+	if (n > 0) {
+		nSkipped_.fetch_add(n, std::memory_order_relaxed);
+	}
+	// failed grabs answered their triggers as well
+	if (trig_) {
+		trig_->onFrame(now, static_cast<std::size_t>(n + 1));
+	}
+	if (!res->GrabSucceeded()) {
+		std::cerr << "error code: " << res->GetErrorCode() << '\t'
+				  << res->GetErrorDescription() << std::endl;
+		return;
+	}
+	if (res->HasCRC() && !res->CheckCRC()) {
+		std::cerr << "CRC check failed" << std::endl;
+		return;
+	}
+	last_.store(now.time_since_epoch().count(), std::memory_order_relaxed);
+	Grabbed g{Frame{res, clk_},
+			  sig_->seq.fetch_add(1, std::memory_order_relaxed)};
+	if (!queue_.push(std::move(g))) {
+		nDropped_.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+	// lock briefly, so the consumer can't miss the wake-up between
+	// checking the queue and going to sleep
+	{ const std::lock_guard lock{sig_->mutex}; }
+	sig_->cv.notify_all();
+}
+
+std::optional<std::uint64_t> FrameGrabber::peek() const noexcept {
+	if (const auto* g{queue_.front()}; g) {
+		return g->seq;
+	}
+	return std::nullopt;
+}
+
+void FrameGrabber::stop() noexcept {
+	stopped_.store(true, std::memory_order_release);
+	{ const std::lock_guard lock{sig_->mutex}; }
+	sig_->cv.notify_all();
+}
+
+std::optional<Frame> FrameGrabber::tryNext() {
+	auto g{queue_.pop()};
+	if (!g) {
+		return std::nullopt;
+	}
+	return std::move(g->frame);
+}
+
+}  // namespace internal
+}  // namespace beholder
@@ -0,0 +1,125 @@
+// beholder - Copyright © 2024 Philipp Milovic
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef BEHOLDER_CAMERA_INTERNAL_FRAME_GRABBER_H
+#define BEHOLDER_CAMERA_INTERNAL_FRAME_GRABBER_H
+
+#include <pylon/GrabResultPtr.h>
+#include <pylon/ImageEventHandler.h>
+#include <pylon/InstantCamera.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+
+#include "beholder/camera/Frame.h"
+#include "beholder/util/SPSCQueue.h"
+
+namespace beholder {
+namespace internal {
+
+class ClockSync;
+class TriggerScheduler;
+
+// GrabSignal wakes up a consumer waiting on frames, and can be shared
+// by several grabbers, so that one consumer can wait on several cameras.
+struct GrabSignal {
+	std::mutex mutex;					  // guards waiting only
+	std::condition_variable cv;			  // signals new frames
+	std::atomic<std::uint64_t> seq{0};	  // next arrival ticket
+};
+
+// Grabbed is a queued frame, tagged with its arrival ticket.
+struct Grabbed {
+	Frame frame;
+	std::uint64_t seq{0};
+};
+
+// FrameGrabber receives acquisition results on pylon's grab loop thread
+// and hands them over to a consumer thread through a bounded queue.
+//
+// The grab loop thread is the only producer, so the queue is lock-free.
+// The signal's mutex and condition variable are used only to put
+// the consumer to sleep while the queue is empty.
+// Results arriving while the queue is full are dropped, i.e. handed
+// straight back to pylon, so a slow consumer never stalls acquisition.
+class FrameGrabber : public Pylon::CImageEventHandler {
+public:
+	using Clock = std::chrono::steady_clock;
+
+private:
+	SPSCQueue<Grabbed> queue_;				// acquired frames
+	std::shared_ptr<GrabSignal> sig_;		// wakes up the consumer
+	const ClockSync* clk_{nullptr};			// maps device timestamps
+	TriggerScheduler* trig_{nullptr};		// matches frames to triggers
+	std::atomic<bool> stopped_{false};		// grabbing was stopped
+	std::atomic<std::size_t> nDropped_{0};	// frames dropped, queue full
+	std::atomic<std::size_t> nSkipped_{0};	// gaps in block IDs
+	std::uint64_t lastBlock_{0};			// last block ID, grab thread only
+	std::atomic<Clock::rep> last_;			// last arrival time
+
+public:
+	// Construct a grabber which holds up to 'capacity' frames.
+	// A new signal is created if 'sig' is empty.
+	// Device timestamps are mapped onto the host's clock through 'clk',
+	// if set, and frames are matched to the triggers of 'trig', if set,
+	// both of which must outlive the grabber.
+	explicit FrameGrabber(std::size_t capacity,
+						  std::shared_ptr<GrabSignal> sig = {},
+						  const ClockSync* clk = nullptr,
+						  TriggerScheduler* trig = nullptr);
+
+	FrameGrabber(const FrameGrabber&) = delete;
+	FrameGrabber(FrameGrabber&&) = delete;
+
+	~FrameGrabber() override = default;
+
+	FrameGrabber& operator=(const FrameGrabber&) = delete;
+	FrameGrabber& operator=(FrameGrabber&&) = delete;
+
+	// Get the time since the last frame arrived, or since construction
+	// if none has arrived yet.
+	[[nodiscard]] Clock::duration getIdleTime() const noexcept;
+
+	// Get the number of frames dropped because the queue was full.
+	[[nodiscard]] std::size_t getNoDropped() const noexcept;
+
+	// Get the number of frames skipped by the stream, i.e. the number of
+	// block IDs missing between consecutive frames, see countSkipped.
+	[[nodiscard]] std::size_t getNoSkipped() const noexcept;
+
+	// Get the signal used to wake up the consumer.
+	[[nodiscard]] const std::shared_ptr<GrabSignal>& getSignal() const noexcept;
+
+	// Check if grabbing was stopped.
+	[[nodiscard]] bool isStopped() const noexcept;
+
+	// Get the next frame, waiting up to 'timeout' for one to arrive.
+	// Returns nothing on timeout, or once stopped and drained.
+	std::optional<Frame> next(std::chrono::milliseconds timeout);
+
+	// Queue a successfully grabbed frame, called on the grab loop thread.
+	void OnImageGrabbed(Pylon::CInstantCamera& cam,
+						const Pylon::CGrabResultPtr& res) override;
+
+	// Get the arrival ticket of the next frame without taking it,
+	// or nothing if the queue is empty.
+	[[nodiscard]] std::optional<std::uint64_t> peek() const noexcept;
+
+	// Mark grabbing as stopped and wake up the consumer.
+	void stop() noexcept;
+
+	// Take the next frame without waiting, if any.
+	std::optional<Frame> tryNext();
+};
+
+}  // namespace internal
+}  // namespace beholder
+
+#endif	// BEHOLDER_CAMERA_INTERNAL_FRAME_GRABBER_H
@@ -0,0 +1,109 @@
+// beholder - Copyright © 2024 Philipp Milovic
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "beholder/camera/internal/GrabResult.h"
+
+#include <GenApi/IFloat.h>
+#include <GenApi/IInteger.h>
+#include <GenApi/INode.h>
+#include <GenApi/INodeMap.h>
+#include <GenApi/Pointer.h>
+#include <pylon/GrabResultPtr.h>
+#include <pylon/PixelType.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iostream>
+#include <optional>
+#include <utility>
+
+#include "beholder/camera/internal/ClockSync.h"
+#include "beholder/capi/Image.h"
+
+namespace beholder {
+namespace internal {
+
+namespace {
+// Get the value of the first readable integer chunk out of 'names'.
+// Chunk names differ between device families.
+std::optional<std::uint64_t>
+intChunk(GenApi::INodeMap& map, std::initializer_list<const char*> names) {
+	for (const auto* name : names) {
+		if (GenApi::CIntegerPtr n{map.GetNode(name)};
+			n && GenApi::IsReadable(n)) {
+			return static_cast<std::uint64_t>(n->GetValue());
+		}
+	}
+	return std::nullopt;
+}
+
+// Fill in the metadata of 'img' from the chunk data of 'res', if any.
+void fromChunks(const Pylon::CGrabResultPtr& res, capi::Image& img) {
+	if (!res->IsChunkDataAvailable()) {
+		return;
+	}
+	auto& map{res->GetChunkDataNodeMap()};
+	if (const auto v{intChunk(map, {"ChunkFrameID", "ChunkFramecounter"})}) {
+		img.frameCounter = *v;
+	}
+	if (const auto v{intChunk(map, {"ChunkLineTriggerCounter",
+									"ChunkTriggerinputcounter",
+									"ChunkCounterValue"})}) {
+		img.triggerCounter = *v;
+	}
+	if (GenApi::CFloatPtr n{map.GetNode("ChunkExposureTime")};
+		n && GenApi::IsReadable(n)) {
+		img.exposureTime = n->GetValue();
+	}
+}
+}  // namespace
+
+std::uint64_t countSkipped(std::uint64_t& last, std::uint64_t id) noexcept {
+	if (id == 0) {
+		return 0;
+	}
+	const auto skipped{last != 0 && id > last ? id - last - 1 : 0};
+	last = id;
+	return skipped;
+}
+
+std::optional<Image> toImage(const Pylon::CGrabResultPtr& res,
+							 const ClockSync* clk) noexcept {
+	// not sure if this can throw, so we're being careful
+	try {
+		if (!res.IsValid()) {
+			return std::nullopt;
+		}
+		std::size_t step{0UL};
+		Image img{
+			static_cast<std::size_t>(res->GetID()),
+			static_cast<int>(res->GetHeight()),
+			static_cast<int>(res->GetWidth()),
+			static_cast<std::int64_t>(res->GetPixelType()), res->GetBuffer(),
+			res->GetStride(step) ? step : 0UL,
+			static_cast<std::size_t>(Pylon::BitPerPixel(res->GetPixelType())),
+			0UL,
+			0,
+			0UL,
+			0UL,
+			0.0};
+		auto& ref{img.ref()};
+		ref.timestamp = res->GetTimeStamp();
+		ref.frameCounter = res->GetBlockID();
+		if (clk) {
+			ref.hostTime = clk->toHost(ref.timestamp).value_or(0);
+		}
+		fromChunks(res, ref);
+		return std::optional{std::move(img)};
+	} catch (const Pylon::GenericException& e) {
+		std::cerr << "could get raw image data: " << e.what() << std::endl;
+	} catch (...) {
+		std::cerr << "could get raw image data" << std::endl;
+	}
+	return std::nullopt;
+}
+
+}  // namespace internal
+}  // namespace beholder
@@ -0,0 +1,45 @@
+// beholder - Copyright © 2024 Philipp Milovic
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// Utility functions for working with pylon grab results.
+
+#ifndef BEHOLDER_CAMERA_INTERNAL_GRAB_RESULT_H
+#define BEHOLDER_CAMERA_INTERNAL_GRAB_RESULT_H
+
+#include <pylon/GrabResultPtr.h>
+
+#include <cstdint>
+#include <optional>
+
+#include "beholder/capi/Image.h"
+
+namespace beholder {
+namespace internal {
+
+class ClockSync;
+
+// Get a view of a grab result as a raw image.
+//
+// Along with the buffer, the device timestamp, frame counter and, if chunk
+// data was enabled on the device, the exposure time and trigger counter
+// are filled in. The device timestamp is mapped onto the host's clock
+// if 'clk' is set and synced.
+//
+// NOTE: the image does not own the buffer, which is valid only for as long
+// as some grab result pointer refers to it.
+std::optional<Image> toImage(const Pylon::CGrabResultPtr& res,
+							 const ClockSync* clk = nullptr) noexcept;
+
+// Get the number of frames skipped between the frame with block ID 'last'
+// and the one with block ID 'id', and set 'last' to 'id'.
+//
+// A block ID of 0 is unknown. Block IDs going backwards, eg. when the
+// device restarts or its (16-bit) block IDs wrap around, are not counted
+// as skips.
+std::uint64_t countSkipped(std::uint64_t& last, std::uint64_t id) noexcept;
+
+}  // namespace internal
+}  // namespace beholder
+
+#endif	// BEHOLDER_CAMERA_INTERNAL_GRAB_RESULT_H
@@ -0,0 +1,150 @@
+// beholder - Copyright © 2024 Philipp Milovic
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "beholder/camera/internal/NodeCache.h"
+
+#include <GenApi/IEnumEntry.h>
+#include <GenApi/IEnumeration.h>
+#include <GenApi/IFloat.h>
+#include <GenApi/IInteger.h>
+#include <GenApi/INode.h>
+#include <GenApi/INodeMap.h>
+#include <GenApi/IValue.h>
+#include <GenApi/Pointer.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <optional>
+#include <string>
+#include <system_error>
+
+namespace beholder {
+namespace internal {
+
+namespace {
+// Relative tolerance within which float values are considered equal,
+// for nodes which don't report an increment.
+constexpr double floatRelTol{1e-9};
+
+// Parse an integer, the whole string must be consumed.
+std::optional<std::int64_t> parseInt(const std::string& s) {
+	std::int64_t v{0};
+	const auto* end{s.data() + s.size()};
+	const auto [ptr, ec]{std::from_chars(s.data(), end, v)};
+	if (ec != std::errc{} || ptr != end) {
+		return std::nullopt;
+	}
+	return v;
+}
+
+// Parse a floating point number, the whole string must be consumed.
+std::optional<double> parseFloat(const std::string& s) {
+	if (s.empty()) {
+		return std::nullopt;
+	}
+	char* end{nullptr};
+	errno = 0;
+	const double v{std::strtod(s.c_str(), &end)};
+	if (errno != 0 || end != s.c_str() + s.size()) {
+		return std::nullopt;
+	}
+	return v;
+}
+}  // namespace
+
+GenApi::INode* NodeCache::get(const std::string& name) {
+	if (const auto found{nodes_.find(name)}; found != nodes_.end()) {
+		return found->second;
+	}
+	GenApi::INode* n{map_ ? map_->GetNode(name.c_str()) : nullptr};
+	if (map_) {
+		nodes_.emplace(name, n);
+	}
+	return n;
+}
+
+void NodeCache::reset(GenApi::INodeMap* map) noexcept {
+	nodes_.clear();
+	map_ = map;
+}
+
+bool writeIfChanged(GenApi::INode* n, const std::string& value) {
+	// values of unreadable nodes can't be compared, so they're
+	// always written
+	const bool readable{GenApi::IsReadable(n)};
+	switch (n->GetPrincipalInterfaceType()) {
+		case GenApi::intfIInteger: {
+			const auto v{parseInt(value)};
+			if (!v) {
+				break;	// eg. hex, let the node's own conversion handle it
+			}
+			GenApi::CIntegerPtr p{n};
+			// the device rounds values to its increment, so the value
+			// read back only matches within the increment
+			if (readable) {
+				const std::int64_t inc{
+					p->GetIncMode() == GenApi::fixedIncrement
+						? std::max(p->GetInc(), std::int64_t{1})
+						: std::int64_t{1}};
+				if (std::abs(p->GetValue() - *v) < inc) {
+					return false;
+				}
+			}
+			p->SetValue(*v);
+			return true;
+		}
+		case GenApi::intfIFloat: {
+			const auto v{parseFloat(value)};
+			if (!v) {
+				break;
+			}
+			GenApi::CFloatPtr p{n};
+			if (readable) {
+				// same as above, or up to rounding if there's no increment
+				const double diff{std::abs(p->GetValue() - *v)};
+				if (p->HasInc()
+						? diff < p->GetInc()
+						: diff <= floatRelTol * std::max(std::abs(*v), 1.0)) {
+					return false;
+				}
+			}
+			p->SetValue(*v);
+			return true;
+		}
+		case GenApi::intfIEnumeration: {
+			GenApi::CEnumerationPtr p{n};
+			if (readable) {
+				const auto* cur{p->GetCurrentEntry()};
+				if (cur && cur->GetSymbolic() == value.c_str()) {
+					return false;
+				}
+			}
+			const auto* e{p->GetEntryByName(value.c_str())};
+			if (!e) {
+				break;	// let the node report the bad value
+			}
+			p->SetIntValue(e->GetValue());
+			return true;
+		}
+		case GenApi::intfICommand: {
+			GenApi::CValuePtr{n}->FromString(value.c_str());
+			return true;
+		}
+		default:
+			break;
+	}
+	GenApi::CValuePtr p{n};
+	if (readable && p->ToString() == value.c_str()) {
+		return false;
+	}
+	p->FromString(value.c_str());
+	return true;
+}
+
+}  // namespace internal
+}  // namespace beholder
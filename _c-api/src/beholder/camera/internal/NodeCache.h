@@ -0,0 +1,61 @@
+// beholder - Copyright © 2024 Philipp Milovic
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef BEHOLDER_CAMERA_INTERNAL_NODE_CACHE_H
+#define BEHOLDER_CAMERA_INTERNAL_NODE_CACHE_H
+
+#include <GenApi/INode.h>
+#include <GenApi/INodeMap.h>
+
+#include <string>
+#include <unordered_map>
+
+namespace beholder {
+namespace internal {
+
+// NodeCache resolves parameter names to nodes of a node map,
+// looking each name up only once.
+//
+// NOTE: node pointers are only valid for as long as the node map is,
+// so the cache must be reset whenever the device is (re)attached.
+class NodeCache {
+private:
+	// The node map nodes are resolved from.
+	GenApi::INodeMap* map_{nullptr};
+	// Nodes resolved so far, nullptr if the node does not exist.
+	std::unordered_map<std::string, GenApi::INode*> nodes_;
+
+public:
+	NodeCache() = default;
+
+	NodeCache(const NodeCache&) = delete;
+	NodeCache(NodeCache&&) = default;
+
+	~NodeCache() = default;
+
+	NodeCache& operator=(const NodeCache&) = delete;
+	NodeCache& operator=(NodeCache&&) = default;
+
+	// Get the node named 'name', or nullptr if there is no such node.
+	[[nodiscard]] GenApi::INode* get(const std::string& name);
+
+	// Clear the cache and resolve nodes from 'map' from now on.
+	void reset(GenApi::INodeMap* map) noexcept;
+};
+
+// Write 'value' to a node, unless the node already holds it, i.e. unless
+// the value read back from the node matches it within the node's
+// increment, since devices round values written to their increment.
+// Returns true if the value was written.
+//
+// Integer, float and enumeration nodes are compared and written
+// through their typed interfaces, instead of through string conversion.
+// Commands are always executed.
+// Throws if the value could not be written.
+bool writeIfChanged(GenApi::INode* n, const std::string& value);
+
+}  // namespace internal
+}  // namespace beholder
+
+#endif	// BEHOLDER_CAMERA_INTERNAL_NODE_CACHE_H
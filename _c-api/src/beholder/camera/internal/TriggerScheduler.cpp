@@ -0,0 +1,194 @@
+// beholder - Copyright © 2024 Philipp Milovic
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "beholder/camera/internal/TriggerScheduler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include "beholder/camera/Trigger.h"
+
+namespace beholder {
+namespace internal {
+
+namespace {
+
+// Convert a duration into microseconds.
+double toUs(TriggerScheduler::Clock::duration d) noexcept {
+	return std::chrono::duration<double, std::micro>{d}.count();
+}
+
+}  // namespace
+
+void RunningStats::add(double x) noexcept {
+	++n;
+	const auto d{x - mean};
+	mean += d / static_cast<double>(n);
+	m2 += d * (x - mean);
+	max = n == 1 ? x : std::max(max, x);
+}
+
+double RunningStats::stddev() const noexcept {
+	if (n < 2) {
+		return 0.0;
+	}
+	return std::sqrt(m2 / static_cast<double>(n - 1));
+}
+
+TriggerScheduler::TriggerScheduler(Fire fire) : fire_{std::move(fire)} {}
+
+TriggerScheduler::~TriggerScheduler() { stop(); }
+
+void TriggerScheduler::execute(Clock::time_point due) {
+	// timestamped when issued, the command's round trip counts as latency
+	const auto t{Clock::now()};
+	const auto ok{fire_()};
+	const std::lock_guard lock{mtx_};
+	if (!ok) {
+		++stats_.missed;
+		return;
+	}
+	++stats_.triggers;
+	jitter_.add(toUs(t - due));
+	if (last_) {
+		interval_.add(toUs(t - *last_));
+	}
+	last_ = t;
+	pending_.push_back(t);
+}
+
+TriggerStats TriggerScheduler::getStats() const {
+	const std::lock_guard lock{mtx_};
+	auto s{stats_};
+	// triggers still waiting past the max. latency won't be answered
+	const auto expired{Clock::now() - sched_.maxLatency};
+	s.unanswered += static_cast<std::uint64_t>(
+		std::count_if(pending_.begin(), pending_.end(),
+					  [expired](const auto& t) { return t < expired; }));
+	s.intervalMean = interval_.mean;
+	s.intervalStd = interval_.stddev();
+	s.jitterMean = jitter_.mean;
+	s.jitterStd = jitter_.stddev();
+	s.jitterMax = jitter_.max;
+	s.latencyMean = latency_.mean;
+	s.latencyStd = latency_.stddev();
+	s.latencyMax = latency_.max;
+	return s;
+}
+
+bool TriggerScheduler::isRunning() const noexcept {
+	const std::lock_guard lock{mtx_};
+	return running_;
+}
+
+void TriggerScheduler::onFrame(Clock::time_point t, std::size_t n) {
+	const std::lock_guard lock{mtx_};
+	if (pending_.empty()) {
+		return;
+	}
+	while (!pending_.empty() && t - pending_.front() > sched_.maxLatency) {
+		pending_.pop_front();
+		++stats_.unanswered;
+	}
+	// the triggers of skipped frames were answered, but the frames lost
+	for (; n > 1 && !pending_.empty(); --n) {
+		pending_.pop_front();
+		++stats_.unanswered;
+	}
+	if (pending_.empty()) {
+		return;
+	}
+	latency_.add(toUs(t - pending_.front()));
+	pending_.pop_front();
+	++stats_.frames;
+}
+
+bool TriggerScheduler::request() {
+	{
+		const std::lock_guard lock{mtx_};
+		if (!running_ || sched_.period.count() != 0) {
+			return false;
+		}
+		requests_.push_back(Clock::now());
+	}
+	cv_.notify_one();
+	return true;
+}
+
+void TriggerScheduler::run() {
+	std::unique_lock lock{mtx_};
+	const auto period{sched_.period};
+	const auto spin{sched_.spin};
+	auto due{Clock::now() + period};
+	while (!stop_) {
+		if (period.count() == 0) {
+			cv_.wait(lock, [this]() -> bool {
+				return stop_ || !requests_.empty();
+			});
+			if (stop_) {
+				break;
+			}
+			const auto t{requests_.front()};
+			requests_.pop_front();
+			lock.unlock();
+			execute(t);
+			lock.lock();
+			continue;
+		}
+		// sleep until shortly before the deadline, then spin, since
+		// sleeps overshoot by the OS scheduler's wake-up latency
+		if (cv_.wait_until(lock, due - spin, [this]() { return stop_; })) {
+			break;
+		}
+		lock.unlock();
+		while (Clock::now() < due) {
+		}
+		execute(due);
+		lock.lock();
+		// deadlines which have already passed are skipped, rather than
+		// bursting triggers to catch up
+		due += period;
+		if (const auto now{Clock::now()}; now >= due) {
+			const auto n{(now - due) / period + 1};
+			stats_.missed += static_cast<std::uint64_t>(n);
+			due += n * period;
+		}
+	}
+}
+
+void TriggerScheduler::start(const TriggerSchedule& s) {
+	stop();
+	const std::lock_guard lock{mtx_};
+	sched_ = s;
+	stop_ = false;
+	requests_.clear();
+	pending_.clear();
+	last_.reset();
+	stats_ = TriggerStats{};
+	interval_ = RunningStats{};
+	jitter_ = RunningStats{};
+	latency_ = RunningStats{};
+	thread_ = std::thread{&TriggerScheduler::run, this};
+	running_ = true;
+}
+
+void TriggerScheduler::stop() noexcept {
+	{
+		const std::lock_guard lock{mtx_};
+		stop_ = true;
+		running_ = false;
+	}
+	cv_.notify_all();
+	if (thread_.joinable()) {
+		thread_.join();
+	}
+}
+
+}  // namespace internal
+}  // namespace beholder
@@ -0,0 +1,121 @@
+// beholder - Copyright © 2024 Philipp Milovic
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef BEHOLDER_CAMERA_INTERNAL_TRIGGER_SCHEDULER_H
+#define BEHOLDER_CAMERA_INTERNAL_TRIGGER_SCHEDULER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+#include "beholder/camera/Trigger.h"
+
+namespace beholder {
+namespace internal {
+
+// RunningStats accumulates the mean, variance and maximum of a series
+// of samples in a single pass (Welford's algorithm).
+struct RunningStats {
+	std::uint64_t n{0};
+	double mean{0.0};
+	double m2{0.0};	  // sum of squared deviations from the mean
+	double max{0.0};
+
+	// Add a sample.
+	void add(double x) noexcept;
+
+	// Get the standard deviation, 0 if there are less than two samples.
+	[[nodiscard]] double stddev() const noexcept;
+};
+
+// TriggerScheduler executes triggers on a thread of its own, either
+// on a fixed period or whenever an external timing source requests one,
+// so that the trigger cadence doesn't depend on the caller's scheduling.
+//
+// Each trigger is timestamped when it is executed, and matched with
+// the next frame which arrives, in order, to measure the latency from
+// trigger to frame. Frames skipped by the stream consume their triggers,
+// and triggers which wait longer than the maximum latency are dropped,
+// eg. when the device ignored them, so the matching doesn't slip.
+//
+// NOTE: start(...) and stop() must be called from a single thread,
+// all other member functions are thread-safe, onFrame(...) is called
+// on pylon's grab loop thread.
+class TriggerScheduler {
+public:
+	using Clock = std::chrono::steady_clock;
+	using Fire = std::function<bool()>;
+
+private:
+	Fire fire_;			  // executes a trigger
+	std::thread thread_;  // the scheduler thread
+
+	mutable std::mutex mtx_;		// guards everything below
+	std::condition_variable cv_;	// wakes up the scheduler thread
+	TriggerSchedule sched_;			// the running schedule
+	bool running_{false};			// the thread was started
+	bool stop_{false};				// the thread should stop
+	std::deque<Clock::time_point> requests_;  // pending external requests
+	std::deque<Clock::time_point> pending_;	  // triggers awaiting a frame
+	std::optional<Clock::time_point> last_;	  // last trigger execution
+	TriggerStats stats_;			// counters only
+	RunningStats interval_;			// time between triggers
+	RunningStats jitter_;			// trigger execution delay
+	RunningStats latency_;			// trigger to frame arrival
+
+	// Execute a trigger which was due at 'due' and record it.
+	void execute(Clock::time_point due);
+
+	// Run the scheduler, called on the scheduler thread.
+	void run();
+
+public:
+	// Construct a scheduler which executes triggers through 'fire',
+	// which returns false if the trigger was not executed.
+	explicit TriggerScheduler(Fire fire);
+
+	TriggerScheduler(const TriggerScheduler&) = delete;
+	TriggerScheduler(TriggerScheduler&&) = delete;
+
+	// Destructor, stops the scheduler thread.
+	~TriggerScheduler();
+
+	TriggerScheduler& operator=(const TriggerScheduler&) = delete;
+	TriggerScheduler& operator=(TriggerScheduler&&) = delete;
+
+	// Get the statistics of the triggers executed since the last start.
+	[[nodiscard]] TriggerStats getStats() const;
+
+	// Check if the scheduler thread is running.
+	[[nodiscard]] bool isRunning() const noexcept;
+
+	// Match 'n' frames, the last of which arrived at 't', with
+	// the oldest pending triggers, i.e. the frames skipped by the stream
+	// and the one which arrived.
+	void onFrame(Clock::time_point t, std::size_t n = 1);
+
+	// Request a trigger, which is executed as soon as possible,
+	// if the scheduler is running without a period.
+	// Returns false if it isn't.
+	bool request();
+
+	// Start the scheduler thread, and reset the statistics.
+	// A running scheduler is restarted.
+	void start(const TriggerSchedule& s);
+
+	// Stop the scheduler thread, waiting for it to exit.
+	// Pending triggers are kept, so their frames can still be matched.
+	void stop() noexcept;
+};
+
+}  // namespace internal
+}  // namespace beholder
+
+#endif	// BEHOLDER_CAMERA_INTERNAL_TRIGGER_SCHEDULER_H
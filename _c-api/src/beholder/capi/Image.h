@@ -41,6 +41,17 @@ typedef struct {  // NOLINT(modernize-use-using): C-API, so no 'using'
 	// Number of bits to store a pixel.
 	// Cameras can return packed pixel types, so bytes are inappropriate.
 	size_t bitsPerPixel;
+	// Device timestamp, in device timestamp counter ticks, 0 if unknown.
+	uint64_t timestamp;
+	// Device timestamp mapped onto the host's system clock,
+	// in ns since the epoch, 0 if unknown.
+	int64_t hostTime;
+	// Device frame counter, 0 if unknown.
+	uint64_t frameCounter;
+	// Device trigger counter, 0 if unknown.
+	uint64_t triggerCounter;
+	// Exposure time in µs, 0 if unknown.
+	double exposureTime;
 } Image;
 
 #ifdef __cplusplus
@@ -49,7 +60,8 @@ typedef struct {  // NOLINT(modernize-use-using): C-API, so no 'using'
 namespace detail {
 struct ImageCtor {
 	capi::Image operator()() {
-		return capi::Image{0UL, 0, 0, 0, nullptr, 0UL, 0UL};
+		return capi::Image{0UL, 0, 0, 0, nullptr, 0UL, 0UL, 0UL, 0, 0UL, 0UL,
+						   0.0};
 	}
 };
 }  // namespace detail
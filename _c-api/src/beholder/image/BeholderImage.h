@@ -8,8 +8,10 @@
 #define BEHOLDER_IMAGE_H
 
 #include "beholder/image/ConversionInfo.h"
+#include "beholder/image/FrameSource.h"
 #include "beholder/image/ProcessingOp.h"
 #include "beholder/image/Processor.h"
+#include "beholder/image/Recording.h"
 #include "beholder/image/ops/BeholderOps.h"
 
 #endif	// BEHOLDER_IMAGE_H
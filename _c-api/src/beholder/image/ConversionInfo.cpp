@@ -13,17 +13,17 @@ namespace beholder {
 
 const std::array<std::pair<PxType, ConversionInfo>, 49> ConversionInfoTable{{
 	// {PxType::Undefined, {CV_8UC1, 1, -1}},
-	{PxType::Mono1packed, {CV_8UC1, 1, -1}},
-	{PxType::Mono2packed, {CV_8UC1, 1, -1}},
-	{PxType::Mono4packed, {CV_8UC1, 1, -1}},
+	{PxType::Mono1packed, {CV_8UC1, 1, -1, Packing::Mono1}},
+	{PxType::Mono2packed, {CV_8UC1, 1, -1, Packing::Mono2}},
+	{PxType::Mono4packed, {CV_8UC1, 1, -1, Packing::Mono4}},
 	{PxType::Mono8, {CV_8UC1, 1, -1}},
 	{PxType::Mono8signed, {CV_8SC1, 1, -1}},
 	{PxType::Mono10, {CV_16UC1, 1, -1}},
-	{PxType::Mono10packed, {CV_16UC1, 1, -1}},
-	{PxType::Mono10p, {CV_16UC1, 1, -1}},
+	{PxType::Mono10packed, {CV_16UC1, 1, -1, Packing::Packed10}},
+	{PxType::Mono10p, {CV_16UC1, 1, -1, Packing::P10}},
 	{PxType::Mono12, {CV_16UC1, 1, -1}},
-	{PxType::Mono12packed, {CV_16UC1, 1, -1}},
-	{PxType::Mono12p, {CV_16UC1, 1, -1}},
+	{PxType::Mono12packed, {CV_16UC1, 1, -1, Packing::Packed12}},
+	{PxType::Mono12p, {CV_16UC1, 1, -1, Packing::P12}},
 	{PxType::Mono16, {CV_16UC1, 1, -1}},
 	{PxType::BayerGR8, {CV_8UC1, 3, cv::COLOR_BayerGRBG2BGR}},
 	{PxType::BayerRG8, {CV_8UC1, 3, cv::COLOR_BayerRGGB2BGR}},
@@ -32,11 +32,11 @@ const std::array<std::pair<PxType, ConversionInfo>, 49> ConversionInfoTable{{
 	{PxType::BayerGR10, {CV_16UC1, 3, cv::COLOR_BayerGRBG2BGR}},
 	{PxType::BayerRG10, {CV_16UC1, 3, cv::COLOR_BayerRGGB2BGR}},
 	{PxType::BayerGB10, {CV_16UC1, 3, cv::COLOR_BayerGBRG2BGR}},
-	{PxType::BayerBG10, {CV_16UC1, 3, cv::COLOR_BayerGBRG2BGR}},
+	{PxType::BayerBG10, {CV_16UC1, 3, cv::COLOR_BayerBGGR2BGR}},
 	{PxType::BayerGR12, {CV_16UC1, 3, cv::COLOR_BayerGRBG2BGR}},
 	{PxType::BayerRG12, {CV_16UC1, 3, cv::COLOR_BayerRGGB2BGR}},
 	{PxType::BayerGB12, {CV_16UC1, 3, cv::COLOR_BayerGBRG2BGR}},
-	{PxType::BayerBG12, {CV_16UC1, 3, cv::COLOR_BayerGBRG2BGR}},
+	{PxType::BayerBG12, {CV_16UC1, 3, cv::COLOR_BayerBGGR2BGR}},
 	{PxType::RGB8packed, {CV_8UC3, 3, cv::COLOR_RGB2BGR}},
 	{PxType::BGR8packed, {CV_8UC3, 3, -1}},
 	{PxType::RGBA8packed, {CV_8UC4, 3, cv::COLOR_RGBA2BGR}},
@@ -61,22 +61,26 @@ const std::array<std::pair<PxType, ConversionInfo>, 49> ConversionInfoTable{{
 	// {PxType::YUV420planar, {CV_8UC1, CV_8UC1, -1}},
 	// {PxType::YCbCr420_8_YY_CbCr_Semiplanar, {CV_8UC1, CV_8UC1, -1}},
 	// {PxType::YCbCr422_8_YY_CbCr_Semiplanar, {CV_8UC1, CV_8UC1, -1}},
-	{PxType::BayerGR12Packed, {CV_16UC1, 3, cv::COLOR_BayerGRBG2BGR}},
-	{PxType::BayerRG12Packed, {CV_16UC1, 3, cv::COLOR_BayerRGGB2BGR}},
-	{PxType::BayerGB12Packed, {CV_16UC1, 3, cv::COLOR_BayerGBRG2BGR}},
-	{PxType::BayerBG12Packed, {CV_16UC1, 3, cv::COLOR_BayerGBRG2BGR}},
-	{PxType::BayerGR10p, {CV_16UC1, 3, cv::COLOR_BayerGRBG2BGR}},
-	{PxType::BayerRG10p, {CV_16UC1, 3, cv::COLOR_BayerRGGB2BGR}},
-	{PxType::BayerGB10p, {CV_16UC1, 3, cv::COLOR_BayerGBRG2BGR}},
-	{PxType::BayerBG10p, {CV_16UC1, 3, cv::COLOR_BayerGBRG2BGR}},
-	{PxType::BayerGR12p, {CV_16UC1, 3, cv::COLOR_BayerGRBG2BGR}},
-	{PxType::BayerRG12p, {CV_16UC1, 3, cv::COLOR_BayerRGGB2BGR}},
-	{PxType::BayerGB12p, {CV_16UC1, 3, cv::COLOR_BayerGBRG2BGR}},
-	{PxType::BayerBG12p, {CV_16UC1, 3, cv::COLOR_BayerGBRG2BGR}},
+	{PxType::BayerGR12Packed,
+	 {CV_16UC1, 3, cv::COLOR_BayerGRBG2BGR, Packing::Packed12}},
+	{PxType::BayerRG12Packed,
+	 {CV_16UC1, 3, cv::COLOR_BayerRGGB2BGR, Packing::Packed12}},
+	{PxType::BayerGB12Packed,
+	 {CV_16UC1, 3, cv::COLOR_BayerGBRG2BGR, Packing::Packed12}},
+	{PxType::BayerBG12Packed,
+	 {CV_16UC1, 3, cv::COLOR_BayerBGGR2BGR, Packing::Packed12}},
+	{PxType::BayerGR10p, {CV_16UC1, 3, cv::COLOR_BayerGRBG2BGR, Packing::P10}},
+	{PxType::BayerRG10p, {CV_16UC1, 3, cv::COLOR_BayerRGGB2BGR, Packing::P10}},
+	{PxType::BayerGB10p, {CV_16UC1, 3, cv::COLOR_BayerGBRG2BGR, Packing::P10}},
+	{PxType::BayerBG10p, {CV_16UC1, 3, cv::COLOR_BayerBGGR2BGR, Packing::P10}},
+	{PxType::BayerGR12p, {CV_16UC1, 3, cv::COLOR_BayerGRBG2BGR, Packing::P12}},
+	{PxType::BayerRG12p, {CV_16UC1, 3, cv::COLOR_BayerRGGB2BGR, Packing::P12}},
+	{PxType::BayerGB12p, {CV_16UC1, 3, cv::COLOR_BayerGBRG2BGR, Packing::P12}},
+	{PxType::BayerBG12p, {CV_16UC1, 3, cv::COLOR_BayerBGGR2BGR, Packing::P12}},
 	{PxType::BayerGR16, {CV_16UC1, 3, cv::COLOR_BayerGRBG2BGR}},
 	{PxType::BayerRG16, {CV_16UC1, 3, cv::COLOR_BayerRGGB2BGR}},
 	{PxType::BayerGB16, {CV_16UC1, 3, cv::COLOR_BayerGBRG2BGR}},
-	{PxType::BayerBG16, {CV_16UC1, 3, cv::COLOR_BayerGBRG2BGR}}
+	{PxType::BayerBG16, {CV_16UC1, 3, cv::COLOR_BayerBGGR2BGR}}
 	// {PxType::RGB12V1packed, {CV_8UC1, CV_8UC1, -1}},
 	// {PxType::Double, {CV_8UC1, CV_8UC1, -1}},
 	// {PxType::Confidence8, {CV_8UC1, CV_8UC1, -1}},
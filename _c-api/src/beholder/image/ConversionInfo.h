@@ -21,11 +21,25 @@
 
 namespace beholder {
 
+// Bit layouts of packed pixel formats, which have to be unpacked
+// before OpenCV can handle them.
+enum class Packing : int {
+	None,	   // not packed
+	Mono1,	   // 8 pixels per byte, first pixel in the least significant bits
+	Mono2,	   // 4 pixels per byte, first pixel in the least significant bits
+	Mono4,	   // 2 pixels per byte, first pixel in the least significant bits
+	P10,	   // 10-bit little-endian bit stream, 4 pixels per 5 bytes
+	P12,	   // 12-bit little-endian bit stream, 2 pixels per 3 bytes
+	Packed10,  // GigE Vision 10-bit packed, 2 pixels per 3 bytes
+	Packed12   // GigE Vision 12-bit packed, 2 pixels per 3 bytes
+};
+
 class ConversionInfo {
 public:
-	int inputType;		// CvMat type of the (foreign) image buffer
+	int inputType;		// CvMat type of the (unpacked) image buffer
 	int outChannels;	// number of channels of the output image
 	int colorConvCode;	// CvColor conversion code.
+	Packing packing{Packing::None};	 // bit layout of the image buffer
 };
 
 enum class PxType : int64_t {
@@ -0,0 +1,361 @@
+// beholder - Copyright © 2024 Philipp Milovic
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "beholder/image/FrameSource.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <opencv2/core.hpp>
+#include <opencv2/core/mat.hpp>
+#include <opencv2/imgcodecs.hpp>
+#include <opencv2/imgproc.hpp>
+#include <opencv2/videoio.hpp>
+#include <optional>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "beholder/capi/Image.h"
+#include "beholder/image/ConversionInfo.h"
+#include "beholder/image/Recording.h"
+#include "beholder/image/internal/Bayer.h"
+#include "beholder/image/internal/Unpack.h"
+#include "beholder/util/Enums.h"
+
+namespace beholder {
+
+namespace {
+// Get the pixel type an image decoded by OpenCV naturally maps to.
+std::optional<PxType> naturalType(const cv::Mat& m) {
+	switch (m.type()) {
+		case CV_8UC1:
+			return PxType::Mono8;
+		case CV_16UC1:
+			return PxType::Mono16;
+		case CV_8UC3:
+			return PxType::BGR8packed;
+		case CV_8UC4:
+			return PxType::BGRA8packed;
+		case CV_16UC3:
+			return PxType::RGB16packed;
+		default:
+			return std::nullopt;
+	}
+}
+
+// Get the number of significant bits of a pixel type's samples,
+// once unpacked to 'depth'.
+int significantBits(PxType typ, int depth) {
+	// NOLINTBEGIN(*-magic-numbers)
+	switch (typ) {
+		case PxType::Mono10:
+		case PxType::Mono10packed:
+		case PxType::Mono10p:
+		case PxType::BayerGR10:
+		case PxType::BayerRG10:
+		case PxType::BayerGB10:
+		case PxType::BayerBG10:
+		case PxType::BayerGR10p:
+		case PxType::BayerRG10p:
+		case PxType::BayerGB10p:
+		case PxType::BayerBG10p:
+		case PxType::RGB10packed:
+		case PxType::BGR10packed:
+			return 10;
+		case PxType::Mono12:
+		case PxType::Mono12packed:
+		case PxType::Mono12p:
+		case PxType::BayerGR12:
+		case PxType::BayerRG12:
+		case PxType::BayerGB12:
+		case PxType::BayerBG12:
+		case PxType::BayerGR12Packed:
+		case PxType::BayerRG12Packed:
+		case PxType::BayerGB12Packed:
+		case PxType::BayerBG12Packed:
+		case PxType::BayerGR12p:
+		case PxType::BayerRG12p:
+		case PxType::BayerGB12p:
+		case PxType::BayerBG12p:
+		case PxType::RGB12packed:
+		case PxType::BGR12packed:
+			return 12;
+		default:
+			return depth == CV_16U ? 16 : 8;
+	}
+	// NOLINTEND(*-magic-numbers)
+}
+
+// Get the number of bits a pixel of a pixel type takes up.
+std::size_t bitsPerPixel(PxType typ) {
+	constexpr std::uint64_t mask{0xFF};	 // see PX_BIT_CNT
+	constexpr std::uint64_t shift{16};
+	return (static_cast<std::uint64_t>(enums::to(typ)) >> shift) & mask;
+}
+
+// Convert an image to BGR.
+void toBGR(const cv::Mat& src, cv::Mat& dst) {
+	switch (src.channels()) {
+		case 1:
+			cv::cvtColor(src, dst, cv::COLOR_GRAY2BGR, 3);
+			break;
+		case 4:
+			cv::cvtColor(src, dst, cv::COLOR_BGRA2BGR, 3);
+			break;
+		default:
+			dst = src;
+	}
+}
+
+// Convert an image to grayscale.
+void toGray(const cv::Mat& src, cv::Mat& dst) {
+	switch (src.channels()) {
+		case 3:
+			cv::cvtColor(src, dst, cv::COLOR_BGR2GRAY, 1);
+			break;
+		case 4:
+			cv::cvtColor(src, dst, cv::COLOR_BGRA2GRAY, 1);
+			break;
+		default:
+			dst = src;
+	}
+}
+}  // namespace
+
+double FrameSource::getRate() const noexcept { return rate_; }
+
+std::optional<Image> FrameSource::next() {
+	// read first, so that the time spent decoding counts towards
+	// the period, i.e. it shortens the wait instead of adding to it
+	auto img{read()};
+	if (!img || period_.count() == 0) {
+		return img;
+	}
+	const auto now{Clock::now()};
+	if (!due_ || now > *due_ + period_) {
+		due_ = now;
+	}
+	std::this_thread::sleep_until(*due_);
+	*due_ += period_;
+	return img;
+}
+
+void FrameSource::setRate(double hz) noexcept {
+	rate_ = hz > 0.0 ? hz : 0.0;
+	period_ = hz > 0.0 ? std::chrono::duration_cast<std::chrono::nanoseconds>(
+							 std::chrono::duration<double>{1.0 / hz})
+					   : std::chrono::nanoseconds{0};
+	due_.reset();
+}
+
+struct FileSource::Frame {
+	cv::Mat buf;  // pixel data, one row of bytes per image row if packed
+	int cols{0};  // image width in pixels
+	PxType typ{PxType::Mono8};	// pixel type of the data
+
+	// Get the frame as an Image.
+	[[nodiscard]] Image toImage(std::size_t id) const {
+		return Image{id,
+					 buf.rows,
+					 cols,
+					 enums::to(typ),
+					 static_cast<void*>(buf.data),
+					 buf.step[0],
+					 bitsPerPixel(typ),
+					 0UL,
+					 0,
+					 0UL,
+					 0UL,
+					 0.0};
+	}
+};
+
+FileSource::FileSource()
+	: current_{std::make_unique<Frame>()},
+	  decoded_{std::make_unique<cv::Mat>()} {}
+
+FileSource::~FileSource() = default;
+
+bool FileSource::convert(const cv::Mat& src, Frame& f) const {
+	const auto typ{pxType_ ? pxType_ : naturalType(src)};
+	if (!typ || (src.depth() != CV_8U && src.depth() != CV_16U)) {
+		std::cerr << "could not convert image: unsupported image type: "
+				  << cv::typeToString(src.type()) << std::endl;
+		return false;
+	}
+	const auto info{getConversionInfo(*typ)};
+	const int depth{info ? CV_MAT_DEPTH(info->inputType) : -1};
+	if (depth != CV_8U && depth != CV_16U) {
+		std::cerr << "could not convert image: unsupported pixel type: "
+				  << enums::to(*typ) << std::endl;
+		return false;
+	}
+
+	// arrange the channels as the pixel type stores them
+	cv::Mat m;
+	if (CV_MAT_CN(info->inputType) == 1) {
+		if (internal::bayerToGray(info->colorConvCode) != -1) {
+			toBGR(src, m);
+			internal::mosaicBayer(m, info->colorConvCode, m);
+		} else {
+			toGray(src, m);
+		}
+	} else {
+		toBGR(src, m);
+		if (info->colorConvCode == cv::COLOR_RGB2BGR ||
+			info->colorConvCode == cv::COLOR_RGBA2BGR) {
+			cv::cvtColor(m, m, cv::COLOR_BGR2RGB);
+		}
+		if (CV_MAT_CN(info->inputType) == 4) {
+			cv::cvtColor(m, m, cv::COLOR_BGR2BGRA, 4);
+		}
+	}
+
+	// rescale to the significant bits of the pixel type, into a new
+	// buffer, since 'm' might still share data with 'src'
+	const int from{src.depth() == CV_16U ? 16 : 8};	 // NOLINT(*-magic-numbers)
+	const int to{significantBits(*typ, depth)};
+	if (from != to || m.depth() != depth) {
+		cv::Mat scaled;
+		m.convertTo(scaled, depth, std::ldexp(1.0, to - from));
+		m = scaled;
+	}
+
+	f.typ = *typ;
+	f.cols = m.cols;
+	if (info->packing == Packing::None) {
+		f.buf = m;
+		return true;
+	}
+	f.buf.create(m.rows,
+				 static_cast<int>(internal::packedStep(info->packing, m.cols)),
+				 CV_8UC1);
+	return internal::pack(info->packing, m, f.buf.data, f.buf.step[0]);
+}
+
+std::size_t FileSource::getNoImages() const noexcept {
+	return rec_ ? rec_->getNoFrames() : frames_.size();
+}
+
+bool FileSource::open(const std::string& path) {
+	namespace fs = std::filesystem;
+
+	frames_.clear();
+	video_.reset();
+	rec_.reset();
+	pos_ = 0;
+	id_ = 0;
+
+	// decode and convert an image, appending it to the preloaded ones
+	auto load{[this](const std::string& file) -> bool {
+		const cv::Mat img{cv::imread(file, cv::IMREAD_UNCHANGED)};
+		if (img.empty()) {
+			std::cerr << "could not read image: " << file << std::endl;
+			return false;
+		}
+		Frame f;
+		if (!convert(img, f)) {
+			return false;
+		}
+		frames_.emplace_back(std::move(f));
+		return true;
+	}};
+
+	try {
+		std::error_code ec;
+		if (fs::is_directory(path, ec)) {
+			std::vector<std::string> files;
+			for (const auto& e : fs::directory_iterator{path, ec}) {
+				if (e.is_regular_file(ec) &&
+					cv::haveImageReader(e.path().string())) {
+					files.emplace_back(e.path().string());
+				}
+			}
+			std::sort(files.begin(), files.end());
+			if (files.empty()) {
+				std::cerr << "could not open frame source: no images in: "
+						  << path << std::endl;
+				return false;
+			}
+			if (!std::all_of(files.begin(), files.end(), load)) {
+				frames_.clear();
+				return false;
+			}
+			return true;
+		}
+		if (Recording::isRecording(path)) {
+			rec_ = std::make_unique<Recording>();
+			if (!rec_->open(path)) {
+				rec_.reset();
+				return false;
+			}
+			return true;
+		}
+		if (cv::haveImageReader(path)) {
+			return load(path);
+		}
+		video_ = std::make_unique<cv::VideoCapture>(path);
+		if (!video_->isOpened()) {
+			std::cerr << "could not open frame source: " << path << std::endl;
+			video_.reset();
+			return false;
+		}
+	} catch (const std::exception& e) {
+		std::cerr << "could not open frame source: " << e.what() << std::endl;
+		frames_.clear();
+		video_.reset();
+		rec_.reset();
+		return false;
+	}
+	return true;
+}
+
+std::optional<Image> FileSource::read() {
+	if (video_) {
+		return readVideo();
+	}
+	const auto n{getNoImages()};
+	if (pos_ == n) {
+		if (!loop_ || n == 0) {
+			return std::nullopt;
+		}
+		pos_ = 0;
+	}
+	if (rec_) {
+		return rec_->getFrame(pos_++);
+	}
+	return frames_[pos_++].toImage(id_++);
+}
+
+std::optional<Image> FileSource::readVideo() {
+	try {
+		if (!video_->read(*decoded_) &&
+			(!loop_ || !video_->set(cv::CAP_PROP_POS_FRAMES, 0.0) ||
+			 !video_->read(*decoded_))) {
+			return std::nullopt;
+		}
+		if (!convert(*decoded_, *current_)) {
+			return std::nullopt;
+		}
+	} catch (const std::exception& e) {
+		std::cerr << "could not read video frame: " << e.what() << std::endl;
+		return std::nullopt;
+	}
+	return current_->toImage(id_++);
+}
+
+void FileSource::setLoop(bool loop) noexcept { loop_ = loop; }
+
+void FileSource::setPixelType(PxType typ) noexcept { pxType_ = typ; }
+
+}  // namespace beholder
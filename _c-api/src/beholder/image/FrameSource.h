@@ -0,0 +1,158 @@
+// beholder - Copyright © 2024 Philipp Milovic
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// Sources of raw images which stand in for a camera.
+
+#ifndef BEHOLDER_IMAGE_FRAME_SOURCE_H
+#define BEHOLDER_IMAGE_FRAME_SOURCE_H
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "beholder/capi/Image.h"
+#include "beholder/image/ConversionInfo.h"
+
+namespace cv {
+class Mat;
+class VideoCapture;
+}  // namespace cv
+
+namespace beholder {
+
+class Recording;
+
+// FrameSource is a source of raw images, as a camera would produce them.
+//
+// Images are paced to a fixed frame rate, or handed out as fast as
+// possible if no rate is set, so that the acquisition side of a pipeline
+// can be emulated, and benchmarked, without any hardware attached.
+class FrameSource {
+private:
+	using Clock = std::chrono::steady_clock;
+
+	double rate_{0.0};					   // frame rate in Hz
+	std::chrono::nanoseconds period_{0};   // time between two frames
+	std::optional<Clock::time_point> due_;	// when the next frame is due
+
+protected:
+	// Get the next image, regardless of pacing,
+	// or nothing if the source is exhausted.
+	virtual std::optional<Image> read() = 0;
+
+public:
+	// Default constructor.
+	FrameSource() = default;
+
+	FrameSource(const FrameSource&) = delete;
+	FrameSource(FrameSource&&) = delete;
+
+	// Default destructor.
+	virtual ~FrameSource() = default;
+
+	FrameSource& operator=(const FrameSource&) = delete;
+	FrameSource& operator=(FrameSource&&) = delete;
+
+	// Get the frame rate in Hz, 0 if images are handed out
+	// as fast as possible.
+	[[nodiscard]] double getRate() const noexcept;
+
+	// Get the next image, waiting until it is due, or nothing if
+	// the source is exhausted.
+	//
+	// If the consumer falls behind by more than a whole period, the
+	// schedule restarts from the current time, rather than handing out
+	// a burst of images to catch up, as a free-running camera would.
+	// The image buffer is owned by the source, and is valid until
+	// the next call.
+	std::optional<Image> next();
+
+	// Set the frame rate in Hz, a non-positive rate hands out images
+	// as fast as possible. The schedule restarts with the next image.
+	void setRate(double hz) noexcept;
+};
+
+// FileSource is a FrameSource replaying images from disc.
+//
+// The source can be a single image, a directory of images, which are
+// replayed in lexicographic order of their file names, a video
+// (or image sequence pattern) readable by cv::VideoCapture, or a raw
+// frame recording, see Recording.
+// Images are decoded and converted once, when the source is opened,
+// so replaying them costs no more than a camera would, while video
+// frames are decoded and converted as they are read. Recorded frames are
+// replayed zero-copy, as recorded, i.e. keeping their ID and pixel type.
+//
+// Images are handed out in their natural pixel type, i.e. Mono8/16,
+// BGR8packed, BGRA8packed or RGB16packed, unless a pixel type is set,
+// in which case they are converted into it, eg. sampled into a Bayer
+// mosaic and/or packed, so that the same conversion paths a camera
+// would exercise are exercised.
+class FileSource : public FrameSource {
+private:
+	// A decoded image converted into its pixel type.
+	struct Frame;
+
+	std::vector<Frame> frames_;				   // preloaded images
+	std::unique_ptr<Frame> current_;		   // the current video frame
+	std::unique_ptr<cv::VideoCapture> video_;  // video stream, if any
+	std::unique_ptr<Recording> rec_;		   // raw recording, if any
+	std::unique_ptr<cv::Mat> decoded_;		   // scratch video frame
+	std::optional<PxType> pxType_;			   // requested pixel type
+	std::size_t pos_{0};					   // next image to replay
+	std::size_t id_{0};						   // next image ID
+	bool loop_{false};						   // restart when exhausted
+
+	// Convert 'src' into the requested pixel type, or its natural one,
+	// storing the result in 'f'.
+	bool convert(const cv::Mat& src, Frame& f) const;
+
+	// Get the next video frame, rewinding if looping.
+	std::optional<Image> readVideo();
+
+protected:
+	// Get the next image, regardless of pacing.
+	std::optional<Image> read() override;
+
+public:
+	// Default constructor.
+	// Defined in the source because unique_ptr complains about
+	// incomplete types.
+	FileSource();
+
+	FileSource(const FileSource&) = delete;
+	FileSource(FileSource&&) = delete;
+
+	// Default destructor.
+	// Defined in the source because unique_ptr complains about
+	// incomplete types.
+	~FileSource() override;
+
+	FileSource& operator=(const FileSource&) = delete;
+	FileSource& operator=(FileSource&&) = delete;
+
+	// Get the number of preloaded or recorded images,
+	// 0 if replaying a video.
+	[[nodiscard]] std::size_t getNoImages() const noexcept;
+
+	// Open an image, a directory of images, a video or a recording,
+	// see FileSource.
+	// Anything previously opened is closed, and image IDs restart from 0.
+	// Returns false if nothing could be read or converted.
+	bool open(const std::string& path);
+
+	// Set whether the source restarts from the first image once exhausted.
+	void setLoop(bool loop) noexcept;
+
+	// Set the pixel type images are converted into.
+	// Takes effect the next time the source is opened.
+	void setPixelType(PxType typ) noexcept;
+};
+
+}  // namespace beholder
+
+#endif	// BEHOLDER_IMAGE_FRAME_SOURCE_H
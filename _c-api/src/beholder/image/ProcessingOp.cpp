@@ -5,8 +5,11 @@
 #include "beholder/image/ProcessingOp.h"
 
 #include <algorithm>
+#include <array>
 #include <memory>
 #include <opencv2/core/mat.hpp>
+#include <opencv2/core/types.hpp>
+#include <opencv2/imgproc.hpp>
 #include <string>
 #include <utility>
 #include <vector>
@@ -15,6 +18,102 @@
 
 namespace beholder {
 
+namespace {
+// Static checks which enforce compliance between the default warp
+// and the OpenCV flags.
+static_assert(ProcessingOp::Warp{}.border == cv::BORDER_REPLICATE);
+static_assert(cv::INTER_NEAREST < cv::INTER_LINEAR &&
+			  cv::INTER_LINEAR < cv::INTER_CUBIC);	// we pick the max
+}  // namespace
+
+bool ProcessingOp::prepareImpl([[maybe_unused]] const cv::Size& size,
+							   [[maybe_unused]] int type) {
+	return true;
+}
+
+bool ProcessingOp::isStaleImpl() const { return false; }
+
+bool ProcessingOp::isPointwiseImpl() const { return false; }
+
+bool ProcessingOp::needsHistogramImpl() const { return false; }
+
+bool ProcessingOp::composeLUTImpl([[maybe_unused]] LUT& lut,
+								  [[maybe_unused]] const Histogram& hist) const {
+	return false;
+}
+
+bool ProcessingOp::composeWarpImpl([[maybe_unused]] Warp& w) const {
+	return false;
+}
+
+bool ProcessingOp::composeAffine(Warp& w, const std::array<double, 6>& a,
+								 int rows, int cols, int interp) {
+	// a * m, with both extended to 3x3
+	const auto& m{w.m};
+	const std::array<double, 6> am{
+		a[0] * m[0] + a[1] * m[3],		  a[0] * m[1] + a[1] * m[4],
+		a[0] * m[2] + a[1] * m[5] + a[2], a[3] * m[0] + a[4] * m[3],
+		a[3] * m[1] + a[4] * m[4],		  a[3] * m[2] + a[4] * m[5] + a[5]};
+
+	// exact maps don't affect interpolation, otherwise use the best one
+	int in{w.interp};
+	if (in == -1 || interp == cv::INTER_AREA) {
+		in = interp;
+	} else if (interp != -1 && in != cv::INTER_AREA) {
+		in = std::max(in, interp);
+	}
+	const bool aligned{am[1] == 0.0 && am[3] == 0.0};  // NOLINT
+	if (in == cv::INTER_AREA && !aligned) {
+		return false;
+	}
+
+	w.m = am;
+	w.rows = rows;
+	w.cols = cols;
+	w.interp = in;
+	return true;
+}
+
+void ProcessingOp::invalidate() noexcept {
+	prepRows_ = -1;
+	prepCols_ = -1;
+	prepType_ = -1;
+}
+
+bool ProcessingOp::prepare(const cv::Size& size, int type) {
+	if (size.height == prepRows_ && size.width == prepCols_ &&
+		type == prepType_ && !isStaleImpl()) {
+		return true;
+	}
+	if (!prepareImpl(size, type)) {
+		invalidate();
+		return false;
+	}
+	prepRows_ = size.height;
+	prepCols_ = size.width;
+	prepType_ = type;
+	return true;
+}
+
+bool ProcessingOp::isPointwise() const { return isPointwiseImpl(); }
+
+bool ProcessingOp::isStale() const { return isStaleImpl(); }
+
+bool ProcessingOp::needsHistogram() const { return needsHistogramImpl(); }
+
+bool ProcessingOp::composeLUT(LUT& lut, const Histogram& hist) const {
+	return composeLUTImpl(lut, hist);
+}
+
+bool ProcessingOp::composeWarp(Warp& w) const {
+	Warp tmp{w};
+	if (!composeWarpImpl(tmp)) {
+		return false;
+	}
+	w = tmp;
+	return true;
+}
+
 bool ProcessingOp::operator()(const cv::Mat& in, cv::Mat& out) const {
 	return execute(in, out);
 }
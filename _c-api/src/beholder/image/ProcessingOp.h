@@ -7,6 +7,8 @@
 #ifndef BEHOLDER_IMAGE_PROCESSING_OP_H
 #define BEHOLDER_IMAGE_PROCESSING_OP_H
 
+#include <array>
+#include <cstddef>
 #include <functional>
 #include <memory>
 #include <string>
@@ -14,19 +16,99 @@
 #include <vector>
 
 #include "beholder/capi/Result.h"
+#include "beholder/util/Constants.h"
 
 namespace cv {
 class Mat;
-}
+template<typename T>
+class Size_;  // for Size == Size2i == Size_<int>
+}  // namespace cv
 
 namespace beholder {
 
 class ProcessingOp {
+public:
+	// A look-up table mapping 8-bit values to 8-bit values.
+	using LUT = std::array<unsigned char, cst::max8bit + 1>;
+
+	// A histogram of 8-bit values.
+	using Histogram = std::array<std::size_t, cst::max8bit + 1>;
+
+	// A (pending) affine warp of an image, see composeWarp(...).
+	struct Warp {
+		// Row-major 2x3 matrix, mapping input to output pixel coordinates.
+		std::array<double, 6> m{1.0, 0.0, 0.0, 0.0, 1.0, 0.0};
+		int rows{0};	 // output image rows
+		int cols{0};	 // output image columns
+		int interp{-1};	 // interpolation (cv::InterpolationFlags), -1 if exact
+		int border{1};	 // border mode (cv::BorderTypes), replicate by default
+		std::array<double, 4> borderValue{};  // constant border value
+	};
+
+private:
+	// Input geometry and type for which the operation was last prepared.
+	int prepRows_{-1};
+	int prepCols_{-1};
+	int prepType_{-1};
+
 protected:
 	// Default constructor
 	ProcessingOp() = default;
 
+	// Prepare the operation for inputs of a given size and (CvMat) type,
+	// i.e. precompute any state which does not change from frame to frame.
+	//
+	// The default implementation does nothing.
+	virtual bool prepareImpl(const cv::Size_<int>& size, int type);
+
+	// Check if the prepared state is stale, i.e. if the operation's
+	// parameters changed since the state was computed.
+	//
+	// The default implementation returns false.
+	[[nodiscard]] virtual bool isStaleImpl() const;
+
+	// Check if the operation is a pointwise 8-bit mapping, i.e. if it can
+	// be expressed as a look-up table applied to each pixel value.
+	//
+	// The default implementation returns false.
+	[[nodiscard]] virtual bool isPointwiseImpl() const;
+
+	// Check if the look-up table depends on the histogram of the input.
+	//
+	// The default implementation returns false.
+	[[nodiscard]] virtual bool needsHistogramImpl() const;
+
+	// Compose the operation's mapping f onto a look-up table,
+	// i.e. set lut[i] = f(lut[i]) for all i, where 'hist' is
+	// the histogram of the operation's input.
+	//
+	// The default implementation returns false.
+	virtual bool composeLUTImpl(LUT& lut, const Histogram& hist) const;
+
+	// Compose the operation's geometric transformation onto a pending warp,
+	// whose output size is the size of the operation's input.
+	// 'w' may be modified even if false is returned.
+	//
+	// The default implementation returns false.
+	virtual bool composeWarpImpl(Warp& w) const;
+
+	// Compose an affine map 'a', from input to output pixel coordinates,
+	// which yields an output of size 'rows' x 'cols' using interpolation
+	// 'interp', onto a pending warp.
+	//
+	// Returns false, and leaves 'w' unchanged, if area interpolation would
+	// end up being combined with a rotation or shear, since the result
+	// can't be computed with a single resize, and warping with area
+	// interpolation is not supported.
+	static bool composeAffine(Warp& w, const std::array<double, 6>& a,
+							  int rows, int cols, int interp);
+
 	// Execute the (pre-)processing operation.
+	//
+	// 'out' may or may not refer to 'in', so implementations must always
+	// write their result to 'out'. Temporaries should be allocated with
+	// the allocator of 'out', so that they get drawn from the Processor's
+	// buffer pool when possible.
 	virtual bool execute(const cv::Mat& in, cv::Mat& out) const = 0;
 
 	// Execute the (post-)processing operation.
@@ -51,6 +133,51 @@ public:
 	ProcessingOp& operator=(const ProcessingOp&) = default;
 	ProcessingOp& operator=(ProcessingOp&&) = default;
 
+	// Discard the prepared state, so that it gets recomputed on the next
+	// call to prepare(...).
+	void invalidate() noexcept;
+
+	// Prepare the operation for inputs of a given size and (CvMat) type.
+	//
+	// The state is (re)computed only if the size or type differ from
+	// the ones the operation was last prepared for, or if the operation's
+	// parameters changed since, so it is cheap to call before each
+	// execution.
+	// Returns false if preparation fails.
+	bool prepare(const cv::Size_<int>& size, int type);
+
+	// Check if the operation is a pointwise 8-bit mapping,
+	// see composeLUT(...).
+	[[nodiscard]] bool isPointwise() const;
+
+	// Check if the prepared state is stale, i.e. if the operation's
+	// parameters changed since it was last prepared.
+	// Stale state is never used, the operation falls back to computing
+	// its state on the spot until it is prepared again.
+	[[nodiscard]] bool isStale() const;
+
+	// Check if the operation needs the input histogram to compose
+	// its look-up table.
+	[[nodiscard]] bool needsHistogram() const;
+
+	// Compose a pointwise operation onto a look-up table.
+	//
+	// Lets adjacent pointwise operations be collapsed into a single
+	// look-up table, and hence into a single pass over the image.
+	// 'hist' is the histogram of the operation's (single-channel) input,
+	// and is ignored unless needsHistogram() is true.
+	// Returns false if the operation is not pointwise.
+	bool composeLUT(LUT& lut, const Histogram& hist) const;
+
+	// Compose a geometric operation onto a pending warp.
+	//
+	// Lets consecutive geometric operations be collapsed into a single
+	// warp, so that the image is resampled only once.
+	// Returns false, and leaves 'w' unchanged, if the operation is not
+	// purely geometric or it can't be composed with 'w', in which case
+	// the warp should be applied and the operation executed as usual.
+	bool composeWarp(Warp& w) const;
+
 	// Execute a processing operation which does not require pipeline results,
 	// usually a pre-processing operation.
 	//
@@ -6,11 +6,14 @@
 
 #include <algorithm>
 #include <array>
+#include <cmath>
 #include <cstddef>
 #include <cstdint>
 #include <iostream>
+#include <memory>
 #include <opencv2/core/fast_math.hpp>
 #include <opencv2/core/mat.hpp>
+#include <opencv2/core/matx.hpp>
 #include <opencv2/core/types.hpp>
 #include <opencv2/imgcodecs.hpp>
 #include <opencv2/imgproc.hpp>
@@ -21,6 +24,10 @@
 #include "beholder/capi/Image.h"
 #include "beholder/capi/Result.h"
 #include "beholder/image/ConversionInfo.h"
+#include "beholder/image/internal/Bayer.h"
+#include "beholder/image/internal/BufferPool.h"
+#include "beholder/image/internal/FusedOp.h"
+#include "beholder/image/internal/Unpack.h"
 #include "beholder/util/Constants.h"
 #include "beholder/util/Enums.h"
 
@@ -35,16 +42,138 @@ static_assert(Mod::Grayscale == cv::IMREAD_GRAYSCALE);
 static_assert(Mod::Color == cv::IMREAD_COLOR);
 static_assert(Mod::AnyColor == cv::IMREAD_ANYCOLOR);
 static_assert(Mod::NoOrient == cv::IMREAD_IGNORE_ORIENTATION);
+
+// Get a view of an image as an Image.
+Image toRawImage(const cv::Mat& img, std::size_t id) {
+	// WARNING: we assume that we can only have 8-bit Mono or BGR images
+	return Image{id,
+				 img.rows,
+				 img.cols,
+				 img.elemSize() == 1UL ? enums::to(PxType::Mono8)
+									   : enums::to(PxType::BGR8packed),
+				 static_cast<void*>(img.data),
+				 img.step1(),
+				 img.elemSize() * cst::bits,
+				 0UL,
+				 0,
+				 0UL,
+				 0UL,
+				 0.0};
+}
+
+// Get a warp which leaves an image as is.
+ProcessingOp::Warp identityWarp(const cv::Mat& img) {
+	ProcessingOp::Warp w{};
+	w.rows = img.rows;
+	w.cols = img.cols;
+	return w;
+}
+
+// Get a warp which extracts a rectangle rotated by 'angle' degrees about
+// its center from an image, so that it ends up axis-aligned.
+//
+// The rotation and the crop are composed into a single affine map,
+// so only the pixels within the rectangle are resampled.
+ProcessingOp::Warp rotatedWarp(const cv::Mat& img, const Rectangle& roi,
+							   double angle) {
+	const auto& r{roi.cRef()};
+	const cv::Point2f ctr{0.5F * static_cast<float>(r.left + r.right),
+						  0.5F * static_cast<float>(r.top + r.bottom)};
+	// adjust transformation matrix by adding a translation from the
+	// center of rotation to the image center,
+	// i.e. center the text box on the image
+	cv::Matx23d rot{cv::getRotationMatrix2D_(ctr, angle, 1.0)};
+	const cv::Point2f center{0.5F * static_cast<float>(img.size().width - 1),
+							 0.5F * static_cast<float>(img.size().height - 1)};
+	const cv::Point2f shift{center - ctr};
+	rot(0, 2) += static_cast<double>(shift.x);
+	rot(1, 2) += static_cast<double>(shift.y);
+
+	cv::Rect crop{
+		cv::RotatedRect{center, cv::Size{r.right - r.left, r.bottom - r.top}, 0}
+			.boundingRect()};
+	// snap to bounds
+	crop.x = crop.x > 0 ? crop.x : 0;
+	crop.x = crop.x < img.cols ? crop.x : img.cols - 1;
+	crop.width =
+		crop.x + crop.width <= img.cols ? crop.width : img.cols - crop.x;
+
+	crop.y = crop.y > 0 ? crop.y : 0;
+	crop.y = crop.y < img.rows ? crop.y : img.rows - 1;
+	crop.height =
+		crop.y + crop.height <= img.rows ? crop.height : img.rows - crop.y;
+
+	// move the crop origin to the destination origin,
+	// so that we warp directly into a crop-sized image
+	rot(0, 2) -= static_cast<double>(crop.x);
+	rot(1, 2) -= static_cast<double>(crop.y);
+
+	ProcessingOp::Warp w{};
+	w.m = {rot(0, 0), rot(0, 1), rot(0, 2), rot(1, 0), rot(1, 1), rot(1, 2)};
+	w.rows = crop.height;
+	w.cols = crop.width;
+	w.interp = cv::INTER_LINEAR;
+	w.border = cv::BORDER_REPLICATE;
+	return w;
+}
+
+// Apply a warp to an image.
+//
+// Warps which only scale and translate the image are applied by resizing
+// the region of the input they cover, if it lies on the pixel grid,
+// so that area interpolation is supported and pure crops come for free.
+// Otherwise the image is warped.
+void applyWarp(const cv::Mat& in, const ProcessingOp::Warp& w, cv::Mat& out) {
+	const auto& m{w.m};
+	const cv::Size size{w.cols, w.rows};
+	// exact maps need no interpolation
+	const int interp{w.interp == -1 ? cv::INTER_NEAREST : w.interp};
+
+	if (m[1] == 0.0 && m[3] == 0.0 && m[0] > 0.0 && m[4] > 0.0) {  // NOLINT
+		// input region covered by the output, in pixel edge coordinates
+		const double x0{(-0.5 - m[2]) / m[0] + 0.5};
+		const double y0{(-0.5 - m[5]) / m[4] + 0.5};
+		const double x1{(w.cols - 0.5 - m[2]) / m[0] + 0.5};
+		const double y1{(w.rows - 0.5 - m[5]) / m[4] + 0.5};
+		const cv::Rect roi{cv::Point{cvRound(x0), cvRound(y0)},
+						   cv::Point{cvRound(x1), cvRound(y1)}};
+
+		constexpr double eps{1e-6};
+		const bool onGrid{std::abs(x0 - roi.x) < eps &&
+						  std::abs(y0 - roi.y) < eps};
+		const bool inside{(roi & cv::Rect{cv::Point{}, in.size()}) == roi};
+		if (onGrid && inside && !roi.empty()) {
+			if (roi.size() == size) {
+				out = in(roi);
+			} else {
+				cv::resize(in(roi), out, size, 0.0, 0.0, interp);
+			}
+			return;
+		}
+	}
+	// area interpolation is not supported when warping
+	cv::warpAffine(in, out, cv::Matx23d{m.data()}, size,
+				   interp == cv::INTER_AREA ? cv::INTER_LINEAR : interp,
+				   w.border,
+				   cv::Scalar{w.borderValue[0], w.borderValue[1],
+							  w.borderValue[2], w.borderValue[3]});
+}
 }  // namespace
 
-Processor::Processor() : img_{new cv::Mat{}}, roi_{new cv::Mat{}} {
+Processor::Processor()
+	: pool_{new internal::BufferPool{}},
+	  img_{new cv::Mat{}},
+	  roi_{new cv::Mat{}} {
 	*roi_ = *img_;
 }
 
 // NOLINTNEXTLINE(*-use-equals-default): incomplete type; must be defined here
 Processor::~Processor(){};
 
+void Processor::compile() { internal::FusedOp::fuse(preprocessing); }
+
 bool Processor::decodeImage(void* buffer, std::size_t bufSize, ReadMode mode) {
+	releaseRawImage();
 	if (bufSize > std::numeric_limits<int>::max()) {
 		std::cerr << "could not decode image: size too large" << std::endl;
 		return false;
@@ -53,35 +182,75 @@ bool Processor::decodeImage(void* buffer, std::size_t bufSize, ReadMode mode) {
 
 	*img_ = cv::Mat{1, size, CV_8UC1, buffer};
 	cv::imdecode(*img_, enums::to(mode), img_.get());  // yolo
-	*roi_ = *img_;
+	resetROI();
 	return roi_->data != nullptr;  // XXX: this should be ok
 }
 
+const std::vector<Image>&
+Processor::extractRotatedROIs(const std::vector<Rectangle>& rois,
+							  const std::vector<double>& angles) {
+	const auto n{std::min(rois.size(), angles.size())};
+	// buffers of the previous extraction go back to the pool first
+	extracted_.clear();
+	extractedRaw_.clear();
+	extracted_.reserve(n);
+	extractedRaw_.reserve(n);
+	for (auto i{0UL}; i < n; ++i) {
+		auto& out{extracted_.emplace_back(pool_->mat())};
+		applyWarp(*img_, rotatedWarp(*img_, rois[i], angles[i]), out);
+		extractedRaw_.emplace_back(toRawImage(out, id_));
+	}
+	return extractedRaw_;
+}
+
 const std::vector<unsigned char>&
 Processor::encodeImage(const std::string& ext) {
+	materialize();
 	encoding_.clear();
 	cv::imencode(ext, *roi_, encoding_);
 	return encoding_;
 }
 
-const cv::Mat& Processor::getImage() const { return *roi_; }
+const cv::Mat& Processor::getImage() const {
+	materialize();
+	return *roi_;
+}
 
 std::size_t Processor::getImageID() const { return id_; }
 
 Image Processor::getRawImage() const {
-	// WARNING: we assume that we can only have 8-bit Mono or BGR images
-	return Image{id_,
-				 roi_->rows,
-				 roi_->cols,
-				 roi_->elemSize() == 1UL ? enums::to(PxType::Mono8)
-										 : enums::to(PxType::BGR8packed),
-				 static_cast<void*>(roi_->data),
-				 roi_->step1(),
-				 roi_->elemSize() * cst::bits};
+	materialize();
+	return toRawImage(*roi_, id_);
+}
+
+std::size_t Processor::getNoAllocations() const {
+	return pool_->nAllocations();
+}
+
+void Processor::materialize() const {
+	if (!warp_) {
+		return;
+	}
+	cv::Mat out{pool_->mat()};
+	applyWarp(*roi_, *warp_, out);
+	*roi_ = out;
+	warp_.reset();
 }
 
 bool Processor::postprocess(const std::vector<Result>& res) {
+	materialize();
+	// a viewed buffer may be read by others, so it's never drawn on
+	if (viewing_ && !postprocessing.empty() &&
+		roi_->datastart == img_->datastart) {
+		cv::Mat out{pool_->mat()};
+		roi_->copyTo(out);
+		*roi_ = out;
+	}
 	for (const auto& o : postprocessing) {
+		// recomputes state only if the image geometry/type changed
+		if (!o->prepare(roi_->size(), roi_->type())) {
+			return false;
+		}
 		// FIXME: should ask weather to overwrite or use a new output image
 		if (!o->operator()(*roi_, *roi_, res)) {
 			// FIXME: should give info on what failed
@@ -93,16 +262,34 @@ bool Processor::postprocess(const std::vector<Result>& res) {
 
 bool Processor::preprocess() {
 	for (const auto& o : preprocessing) {
-		// FIXME: should ask weather to overwrite or use a new output image
-		if (!o->operator()(*roi_, *roi_)) {
+		// geometric operations are accumulated into a single warp,
+		// which is applied once the pixels are needed
+		ProcessingOp::Warp w{warp_ ? *warp_ : identityWarp(*roi_)};
+		if (o->composeWarp(w)) {
+			warp_ = w;
+			continue;
+		}
+		materialize();
+
+		// recomputes state only if the image geometry/type changed
+		if (!o->prepare(roi_->size(), roi_->type())) {
+			return false;
+		}
+		// the input buffer goes back to the pool once the ROI is replaced
+		cv::Mat out{pool_->mat()};
+		if (!o->operator()(*roi_, out)) {
 			// FIXME: should give info on what failed
 			return false;
 		}
+		*roi_ = out;
 	}
 	return true;
 }
 
-bool Processor::receiveRawImage(const Image& raw) {
+bool Processor::receiveRawImage(const Image& raw, RawOutput output) {
+	// don't write into a pinned buffer
+	releaseRawImage();
+
 	const auto& ref{raw.cRef()};
 	id_ = ref.id;
 
@@ -112,31 +299,79 @@ bool Processor::receiveRawImage(const Image& raw) {
 				  << "unknown pixel type: " << ref.pixelType << std::endl;
 		return false;
 	}
-	const cv::Mat tmp{
-		ref.rows, ref.cols, info->inputType, ref.buffer,
-		ref.step > 0UL ? ref.step : enums::to(cv::Mat::AUTO_STEP)};
 
-	// convert the color scheme if necessary
-	if (info->colorConvCode == -1) {
-		tmp.copyTo(*img_);
-		*roi_ = *img_;	// XXX: not sure
-	} else {
-		cv::cvtColor(tmp, *img_, info->colorConvCode, info->outChannels);
-		*roi_ = *img_;	// XXX: not sure
+	// unpack straight into the stored image if there's nothing else to do
+	const bool direct{info->colorConvCode == -1};
+	cv::Mat tmp{pool_->mat()};
+	if (info->packing == Packing::None) {
+		tmp = cv::Mat{
+			ref.rows, ref.cols, info->inputType, ref.buffer,
+			ref.step > 0UL ? ref.step : enums::to(cv::Mat::AUTO_STEP)};
+		if (direct) {
+			tmp.copyTo(*img_);
+		}
+	} else if (!internal::unpack(info->packing, ref.buffer, ref.rows,
+								 ref.cols, ref.step, direct ? *img_ : tmp)) {
+		return false;
 	}
+
+	// convert the color scheme if necessary, Bayer mosaics are converted
+	// directly into the requested output
+	bool binned{false};
+	if (!direct) {
+		const auto gray{internal::bayerToGray(info->colorConvCode)};
+		if (output == RawOutput::HalfColor &&
+			internal::binBayer(tmp, info->colorConvCode, *img_)) {
+			binned = true;
+		} else if (output == RawOutput::Grayscale && gray != -1) {
+			cv::cvtColor(tmp, *img_, gray, 1);
+		} else {
+			cv::cvtColor(tmp, *img_, info->colorConvCode, info->outChannels);
+		}
+	}
+
+	// handle whatever the conversion above didn't
+	if (output == RawOutput::Grayscale && img_->channels() == 3) {
+		cv::cvtColor(*img_, *img_, cv::COLOR_BGR2GRAY, 1);
+	}
+	if (output == RawOutput::HalfColor && !binned) {
+		cv::resize(*img_, *img_, cv::Size{img_->cols / 2, img_->rows / 2}, 0.0,
+				   0.0, cv::INTER_AREA);
+	}
+	if ((output == RawOutput::Color || output == RawOutput::HalfColor) &&
+		img_->channels() == 1) {
+		cv::cvtColor(*img_, *img_, cv::COLOR_GRAY2BGR, 3);
+	}
+	resetROI();
 	return true;
 }
 
 bool Processor::readImage(const std::string& path, ReadMode mode) {
+	releaseRawImage();
 	*img_ = cv::imread(path, enums::to(mode));
-	*roi_ = *img_;
+	resetROI();
 	return img_->data != nullptr;  // XXX: this should be ok
 }
 
-void Processor::resetROI() const { *roi_ = *img_; }
+void Processor::releaseRawImage() {
+	if (!viewing_) {
+		return;
+	}
+	// drop all views of the buffer before letting go of it,
+	// even if it isn't pinned, since the caller may free it next
+	*img_ = cv::Mat{};
+	resetROI();
+	pinned_.reset();
+	viewing_ = false;
+}
+
+void Processor::resetROI() const {
+	*roi_ = *img_;
+	warp_.reset();
+}
 
 void Processor::setROI(const Rectangle& roi) const {
-	*roi_ = *img_;	// reset ROI
+	resetROI();
 
 	const auto& r{roi.cRef()};
 	cv::Rect crop{r.left, r.top, r.right - r.left, r.bottom - r.top};
@@ -155,41 +390,32 @@ void Processor::setROI(const Rectangle& roi) const {
 }
 
 void Processor::setRotatedROI(const Rectangle& roi, double angle) const {
-	*roi_ = *img_;	// reset ROI
-
-	const auto& r{roi.cRef()};
-	const cv::Point2f ctr{0.5F * static_cast<float>(r.left + r.right),
-						  0.5F * static_cast<float>(r.top + r.bottom)};
-	// adjust transformation matrix by adding a translation from the
-	// center of rotation to the (new) image center,
-	// i.e. center the text box on the image
-	cv::Mat rot{cv::getRotationMatrix2D(ctr, angle, 1.0)};
-	const cv::Point2f center{
-		0.5F * static_cast<float>(img_->size().width - 1),
-		0.5F * static_cast<float>(img_->size().height - 1)};
-	const cv::Point2f shift{center - ctr};
-	rot.at<double>(0, 2) += static_cast<double>(shift.x);
-	rot.at<double>(1, 2) += static_cast<double>(shift.y);
-
-	cv::Mat tmp{};
-	cv::warpAffine(*img_, tmp, rot, img_->size(), cv::INTER_LINEAR,
-				   cv::BORDER_REPLICATE);
-
-	cv::Rect crop{
-		cv::RotatedRect{center, cv::Size{r.right - r.left, r.bottom - r.top}, 0}
-			.boundingRect()};
-	// snap to bounds
-	crop.x = crop.x > 0 ? crop.x : 0;
-	crop.x = crop.x < tmp.cols ? crop.x : tmp.cols - 1;
-	crop.width =
-		crop.x + crop.width <= tmp.cols ? crop.width : tmp.cols - crop.x;
+	resetROI();
+	// resampled once the pixels are needed, see materialize()
+	warp_ = rotatedWarp(*img_, roi, angle);
+}
 
-	crop.y = crop.y > 0 ? crop.y : 0;
-	crop.y = crop.y < tmp.rows ? crop.y : tmp.rows - 1;
-	crop.height =
-		crop.y + crop.height <= tmp.rows ? crop.height : tmp.rows - crop.y;
+bool Processor::viewRawImage(const Image& raw, std::shared_ptr<const void> pin,
+							 RawOutput output) {
+	const auto& ref{raw.cRef()};
+	auto info{getConversionInfo(enums::from<PxType>(ref.pixelType))};
+	const bool viewable{
+		info && info->packing == Packing::None && info->colorConvCode == -1 &&
+		(output == RawOutput::Native ||
+		 (output == RawOutput::Grayscale && CV_MAT_CN(info->inputType) == 1) ||
+		 (output == RawOutput::Color && CV_MAT_CN(info->inputType) == 3))};
+	if (!viewable) {
+		return receiveRawImage(raw, output);
+	}
+	releaseRawImage();
 
-	*roi_ = tmp(crop);
+	id_ = ref.id;
+	*img_ = cv::Mat{ref.rows, ref.cols, info->inputType, ref.buffer,
+					ref.step > 0UL ? ref.step : enums::to(cv::Mat::AUTO_STEP)};
+	pinned_ = std::move(pin);
+	viewing_ = true;
+	resetROI();
+	return true;
 }
 
 void Processor::toColor() const {
@@ -208,6 +434,7 @@ void Processor::toGrayscale() const {
 
 bool Processor::writeImage(const std::string& fname) const {
 	// FIXME: flags should be adjustable
+	materialize();
 	const std::vector<int> flags{
 		cv::IMWRITE_PNG_COMPRESSION, 0,			   // lowest compression level
 		cv::IMWRITE_JPEG2000_COMPRESSION_X1000, 0  // lowest compression level
@@ -223,6 +450,14 @@ std::unique_ptr<cv::Mat> rawToMatPtr(const Image& raw) {
 				  << "unknown pixel type: " << ref.pixelType << std::endl;
 		return nullptr;
 	}
+	if (info->packing != Packing::None) {
+		auto img{std::make_unique<cv::Mat>()};
+		if (!internal::unpack(info->packing, ref.buffer, ref.rows, ref.cols,
+							  ref.step, *img)) {
+			return nullptr;
+		}
+		return img;
+	}
 	return std::make_unique<cv::Mat>(
 		ref.rows, ref.cols, info->inputType, ref.buffer,
 		ref.step > 0UL ? ref.step : enums::to(cv::Mat::AUTO_STEP));
@@ -10,6 +10,7 @@
 #include <array>
 #include <cstddef>
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -25,6 +26,10 @@ class Mat;
 
 namespace beholder {
 
+namespace internal {
+class BufferPool;
+}
+
 // Image read modes.
 // Can be combined using bitwise OR (|), although all combinations are not
 // necessarily valid.
@@ -36,18 +41,41 @@ enum class ReadMode {
 	NoOrient = 0x80	   // ignore EXIF orientation
 };
 
+// The output requested when receiving a raw image,
+// see Processor::receiveRawImage(...).
+enum class RawOutput {
+	Native = 0x00,	   // as defined by the pixel type, see ConversionInfo
+	Grayscale = 0x01,  // single-channel grayscale
+	Color = 0x02,	   // BGR
+	HalfColor = 0x03   // BGR at half the resolution
+};
+
 // TODO: Processor 'owns' the image entirely at this point, it should instead
 // just handle image processing and release the image to us afterwards.
 // TODO: We should also remove and/or hide the distinction between
 // a 'raw' image and a cv::Mat, which we treat as the 'true' image currently.
 class Processor {
 private:
+	// NOTE: declared first so that it outlives the images allocated from it
+	std::unique_ptr<internal::BufferPool> pool_;  // scratch buffer pool
+
 	std::unique_ptr<cv::Mat> img_;		   // underlying image
 	std::unique_ptr<cv::Mat> roi_;		   // active image ROI
 	std::vector<unsigned char> encoding_;  // local encoding buffer
+	std::vector<cv::Mat> extracted_;	   // extracted rotated ROIs
+	std::vector<Image> extractedRaw_;	   // extracted ROIs as Images
+	// pending geometric transformation of the ROI
+	mutable std::optional<ProcessingOp::Warp> warp_;
 	// FIXME: only images received from a camera will have an ID.
 	// It's probably better that we handle ID tagging entirely.
 	std::size_t id_{0};	 // camera assigned ID of the current image.
+	// keeps the buffer of a viewed raw image alive
+	std::shared_ptr<const void> pinned_;
+	// the image views a raw image buffer, see viewRawImage(...)
+	bool viewing_{false};
+
+	// Apply the pending geometric transformation, if any, to the ROI.
+	void materialize() const;
 
 public:
 	using OpList = std::vector<ProcessingOp::OpPtr>;
@@ -72,6 +100,15 @@ public:
 	Processor& operator=(const Processor&) = delete;
 	Processor& operator=(Processor&&) = delete;
 
+	// Compile the preprocessing pipeline, i.e. replace runs of adjacent
+	// pointwise 8-bit operations (see ProcessingOp::composeLUT), optionally
+	// preceded by a grayscale conversion, with a single fused operation.
+	//
+	// Should be called once the pipeline is set up. The fused operations
+	// take ownership of the originals, so the pipeline should not be
+	// modified afterwards.
+	void compile();
+
 	// Decode an image from a buffer.
 	// The buffer is left unchanged and the data is copied into the
 	// Processor. New memory is not allocated if the Processor
@@ -83,6 +120,16 @@ public:
 	const std::vector<unsigned char>&
 	encodeImage(const std::string& ext = ".png");
 
+	// Extract rotated regions of interest, in the same way as
+	// setRotatedROI(...) does, into separate images and return them.
+	//
+	// 'rois' and 'angles' should be of equal length.
+	// The images are backed by buffers owned by the Processor, and are
+	// valid until the next call.
+	const std::vector<Image>&
+	extractRotatedROIs(const std::vector<Rectangle>& rois,
+					   const std::vector<double>& angles);
+
 	// Get the stored image
 	[[nodiscard]] const cv::Mat& getImage() const;
 
@@ -95,7 +142,24 @@ public:
 	// Get the stored image as an Image
 	[[nodiscard]] Image getRawImage() const;
 
+	// Get the number of buffer allocations made by the Processor's
+	// scratch buffer pool. Should stay constant once the pool has
+	// seen the largest image passing through the pipeline.
+	// Mostly for debugging and internal use.
+	[[nodiscard]] std::size_t getNoAllocations() const;
+
 	// Run pre-OCR image processing
+	//
+	// Each operation is prepared (see ProcessingOp::prepare) for its
+	// input before execution, so per-frame setup costs are incurred only
+	// when the image geometry or type changes.
+	// Consecutive geometric operations (see ProcessingOp::composeWarp) are
+	// not executed right away, but composed into a single warp which is
+	// applied once the pixels are needed, i.e. by the next non-geometric
+	// operation or by whatever reads the image.
+	// Operations write into buffers recycled from the Processor's pool,
+	// alternating between input and output, so the stored image
+	// is left untouched and the ROI ends up holding the result.
 	// FIXME: this should take an Image
 	// FIXME: should be merged with postprocess
 	bool preprocess();
@@ -107,13 +171,25 @@ public:
 
 	// Recieve a raw image, usually a camera acquisition result, and
 	// copy it locally while converting to a standard color space.
+	// Packed pixel formats (eg. Mono12p) are unpacked on the way,
+	// see ConversionInfo.
+	//
+	// Bayer mosaics are converted straight into the requested 'output',
+	// i.e. demosaiced to grayscale, or binned 2x2 to half-resolution BGR,
+	// without producing a full-size BGR image first. Other pixel types
+	// are converted as usual and adjusted afterwards.
 	//
 	// Returns false if image conversion fails, and true otherwise.
-	bool receiveRawImage(const Image& raw);
+	bool receiveRawImage(const Image& raw,
+						 RawOutput output = RawOutput::Native);
 
 	// Read an image from disc
 	bool readImage(const std::string& path, ReadMode mode);
 
+	// Release the raw image buffer viewed by the Processor, if any,
+	// see viewRawImage(...). The stored image is cleared.
+	void releaseRawImage();
+
 	// Reset the region of interest, i.e. set the ROI to the whole image
 	void resetROI() const;
 
@@ -122,7 +198,12 @@ public:
 	// not the current ROI
 	void setROI(const Rectangle& roi) const;
 
-	// Set the region of interest
+	// Set the region of interest to a rectangle rotated by 'angle'
+	// degrees about its center, i.e. extract the text box so that
+	// it is axis-aligned.
+	// Only the pixels within the box are resampled, into a buffer drawn
+	// from the Processor's pool, and only once the pixels are needed,
+	// so that subsequent geometric preprocessing gets composed with it.
 	// FIXME: bad implementation, always operates on the original image,
 	// not the current ROI
 	void setRotatedROI(const Rectangle& roi, double angle) const;
@@ -133,12 +214,28 @@ public:
 	// Convert image to grayscale and reset the ROI
 	void toGrayscale() const;
 
+	// View a raw image, usually a camera acquisition result, in place,
+	// i.e. store it without copying the buffer, if it needs no conversion
+	// to end up in the requested 'output' (eg. Mono8 or BGR8packed).
+	// Otherwise the image is received as usual, see receiveRawImage(...).
+	//
+	// 'pin' should keep the buffer alive (eg. Frame::pin()), and is held
+	// until the image is released, see releaseRawImage(), or replaced.
+	// If 'pin' is empty, the caller must keep the buffer alive instead.
+	//
+	// The viewed buffer is only ever read, postprocessing draws on a copy,
+	// so it may be shared, eg. with a Recorder copying it in the background.
+	bool viewRawImage(const Image& raw, std::shared_ptr<const void> pin = {},
+					  RawOutput output = RawOutput::Native);
+
 	// Write an image (current ROI) to disc
 	// FIXME: hard-coded to use the lowest compression levels for PNG/JPEG.
 	[[nodiscard]] bool writeImage(const std::string& fname = "img.png") const;
 };
 
 // Convert a raw image to a cv::Mat pointer.
+// The matrix refers to the raw image buffer, except for packed pixel
+// formats, which are unpacked into a buffer owned by the matrix.
 std::unique_ptr<cv::Mat> rawToMatPtr(const Image& raw);
 
 }  // namespace beholder
@@ -0,0 +1,362 @@
+// beholder - Copyright © 2024 Philipp Milovic
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "beholder/image/Recording.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include "beholder/capi/Image.h"
+#include "beholder/image/internal/Segment.h"
+#include "beholder/util/Constants.h"
+#include "beholder/util/SPSCQueue.h"
+
+namespace beholder {
+
+namespace seg = internal::segment;
+
+namespace {
+// Get the number of bytes a frame takes up, i.e. up to the end of
+// its last row, and the number of bytes between its rows.
+std::size_t frameSize(const capi::Image& img, std::size_t& step) {
+	const auto bits{static_cast<std::size_t>(img.cols) * img.bitsPerPixel};
+	const auto rowBytes{(bits + cst::bits - 1) / cst::bits};
+	step = img.step > 0 ? img.step : rowBytes;
+	if (img.rows <= 0 || rowBytes == 0) {
+		return 0;
+	}
+	return static_cast<std::size_t>(img.rows - 1) * step + rowBytes;
+}
+
+// Report a failed system call on 'path'.
+void report(const std::string& what, const std::string& path, int err) {
+	std::cerr << what << ": " << path << ": " << std::strerror(err)
+			  << std::endl;
+}
+}  // namespace
+
+struct Recorder::Job {
+	seg::Entry entry{};				  // index entry of the frame
+	std::size_t slot{0};			  // index of the entry
+	const void* src{nullptr};		  // buffer to copy, if not yet copied
+	std::shared_ptr<const void> pin;  // keeps 'src' alive
+};
+
+Recorder::Recorder() = default;
+
+Recorder::~Recorder() { close(); }
+
+void Recorder::close() {
+	if (!isOpen()) {
+		return;
+	}
+	{
+		const std::lock_guard<std::mutex> lock{mtx_};
+		stop_ = true;
+	}
+	cv_.notify_one();
+	if (writer_.joinable()) {
+		writer_.join();
+	}
+	queue_.reset();
+
+	::msync(map_, mapSize_, MS_SYNC);
+	::munmap(map_, mapSize_);
+	// trim the unused part of the data region
+	if (::ftruncate(fd_, static_cast<off_t>(dataOffset_ + used_)) != 0) {
+		std::cerr << "could not trim segment: " << std::strerror(errno)
+				  << std::endl;
+	}
+	::close(fd_);
+	fd_ = -1;
+	map_ = nullptr;
+	mapSize_ = 0;
+}
+
+std::size_t Recorder::getNoDropped() const noexcept {
+	return dropped_.load(std::memory_order_relaxed);
+}
+
+bool Recorder::isOpen() const noexcept { return map_ != nullptr; }
+
+bool Recorder::open(const std::string& path, std::size_t capacity,
+					std::size_t maxFrames, std::size_t queueSize) {
+	close();
+	if (capacity == 0 || maxFrames == 0 || queueSize == 0) {
+		std::cerr << "could not open segment: " << path
+				  << ": empty segment or queue" << std::endl;
+		return false;
+	}
+	const auto dataOffset{
+		seg::pageSize +
+		seg::roundUp(maxFrames * sizeof(seg::Entry), seg::pageSize)};
+	const auto dataSize{seg::roundUp(capacity, seg::pageSize)};
+	const auto total{dataOffset + dataSize};
+
+	fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC,
+				 0644);	 // NOLINT(*-magic-numbers)
+	if (fd_ < 0) {
+		report("could not create segment", path, errno);
+		return false;
+	}
+	// allocate the whole segment up front, so that recording doesn't
+	// stall on, or run out of, disc space midway
+	if (const auto err{::posix_fallocate(fd_, 0, static_cast<off_t>(total))};
+		err != 0) {
+		report("could not allocate segment", path, err);
+		::close(fd_);
+		fd_ = -1;
+		return false;
+	}
+	void* m{
+		::mmap(nullptr, total, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0)};
+	if (m == MAP_FAILED) {	// NOLINT(*-cstyle-cast): system macro
+		report("could not map segment", path, errno);
+		::close(fd_);
+		fd_ = -1;
+		return false;
+	}
+
+	seg::Header hdr{};
+	hdr.magic = seg::magic;
+	hdr.version = seg::version;
+	hdr.entrySize = sizeof(seg::Entry);
+	hdr.maxFrames = maxFrames;
+	hdr.indexOffset = seg::pageSize;
+	hdr.dataOffset = dataOffset;
+	hdr.dataSize = dataSize;
+	std::memcpy(m, &hdr, sizeof(hdr));
+
+	map_ = m;
+	mapSize_ = total;
+	dataOffset_ = dataOffset;
+	capacity_ = dataSize;
+	maxFrames_ = maxFrames;
+	used_ = 0;
+	reserved_ = 0;
+	dropped_.store(0, std::memory_order_relaxed);
+
+	queue_ = std::make_unique<SPSCQueue<Job>>(queueSize);
+	stop_ = false;
+	writer_ = std::thread{&Recorder::run, this};
+	return true;
+}
+
+bool Recorder::record(const Image& img, const std::string& sn,
+					  std::shared_ptr<const void> pin) {
+	if (!isOpen()) {
+		return false;
+	}
+	const auto& ref{img.cRef()};
+	std::size_t step{0};
+	const auto size{frameSize(ref, step)};
+	const auto offset{seg::roundUp(used_, seg::frameAlign)};
+	if (!ref.buffer || size == 0 || reserved_ == maxFrames_ ||
+		offset + size > capacity_) {
+		dropped_.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+
+	Job job;
+	job.slot = reserved_;
+	job.entry.id = ref.id;
+	const auto now{std::chrono::system_clock::now().time_since_epoch()};
+	job.entry.timestamp =
+		std::chrono::duration_cast<std::chrono::nanoseconds>(now).count();
+	job.entry.pixelType = ref.pixelType;
+	job.entry.offset = offset;
+	job.entry.size = size;
+	job.entry.step = step;
+	job.entry.rows = ref.rows;
+	job.entry.cols = ref.cols;
+	job.entry.bitsPerPixel = ref.bitsPerPixel;
+	std::copy_n(sn.begin(), std::min(sn.size(), seg::snSize - 1),
+				job.entry.sn.begin());
+	if (pin) {
+		job.src = ref.buffer;
+		job.pin = std::move(pin);
+	} else {
+		// the space is only reserved once the job is queued, but nothing
+		// else writes there in the meantime
+		std::memcpy(static_cast<unsigned char*>(map_) + dataOffset_ + offset,
+					ref.buffer, size);
+	}
+	if (!queue_->push(std::move(job))) {
+		dropped_.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+	used_ = offset + size;
+	++reserved_;
+
+	// lock, so the writer can't miss the wake-up between checking
+	// the queue and going to sleep
+	{ const std::lock_guard<std::mutex> lock{mtx_}; }
+	cv_.notify_one();
+	return true;
+}
+
+void Recorder::run() {
+	for (;;) {
+		if (const auto job{queue_->pop()}) {
+			write(*job);
+			continue;
+		}
+		std::unique_lock<std::mutex> lock{mtx_};
+		if (stop_ && queue_->empty()) {
+			return;
+		}
+		cv_.wait(lock, [this]() -> bool { return stop_ || !queue_->empty(); });
+	}
+}
+
+void Recorder::write(const Job& job) {
+	auto* base{static_cast<unsigned char*>(map_)};
+	if (job.src) {
+		std::memcpy(base + dataOffset_ + job.entry.offset, job.src,
+					job.entry.size);
+	}
+	std::memcpy(base + seg::pageSize + job.slot * sizeof(seg::Entry),
+				&job.entry, sizeof(seg::Entry));
+	// commit the frame only once it's entirely written
+	std::atomic_thread_fence(std::memory_order_release);
+	const std::uint64_t n{job.slot + 1};
+	std::memcpy(base + offsetof(seg::Header, noFrames), &n, sizeof(n));
+}
+
+Recording::~Recording() { close(); }
+
+void Recording::close() noexcept {
+	if (map_) {
+		::munmap(map_, mapSize_);
+	}
+	map_ = nullptr;
+	mapSize_ = 0;
+	noFrames_ = 0;
+}
+
+bool Recording::entry(std::size_t i, seg::Entry& e) const {
+	if (i >= noFrames_) {
+		return false;
+	}
+	const auto* base{static_cast<const unsigned char*>(map_)};
+	std::memcpy(&e, base + indexOffset_ + i * sizeof(seg::Entry),
+				sizeof(seg::Entry));
+	// the data region might have been trimmed, or never written
+	return e.offset + e.size <= mapSize_ - dataOffset_;
+}
+
+std::optional<Image> Recording::getFrame(std::size_t i) const {
+	seg::Entry e{};
+	if (!entry(i, e)) {
+		return std::nullopt;
+	}
+	return Image{e.id,
+				 e.rows,
+				 e.cols,
+				 e.pixelType,
+				 static_cast<void*>(static_cast<unsigned char*>(map_) +
+									dataOffset_ + e.offset),
+				 e.step,
+				 e.bitsPerPixel,
+				 0UL,
+				 0,
+				 0UL,
+				 0UL,
+				 0.0};
+}
+
+std::size_t Recording::getNoFrames() const noexcept { return noFrames_; }
+
+std::string Recording::getSerialNumber(std::size_t i) const {
+	seg::Entry e{};
+	if (!entry(i, e)) {
+		return {};
+	}
+	return std::string{e.sn.data(), ::strnlen(e.sn.data(), e.sn.size())};
+}
+
+std::optional<std::chrono::system_clock::time_point>
+Recording::getTimestamp(std::size_t i) const {
+	seg::Entry e{};
+	if (!entry(i, e)) {
+		return std::nullopt;
+	}
+	return std::chrono::system_clock::time_point{
+		std::chrono::duration_cast<std::chrono::system_clock::duration>(
+			std::chrono::nanoseconds{e.timestamp})};
+}
+
+bool Recording::isRecording(const std::string& path) {
+	std::ifstream file{path, std::ios::binary};
+	decltype(seg::magic) m{};
+	return file.read(m.data(), m.size()) && m == seg::magic;
+}
+
+bool Recording::open(const std::string& path) {
+	close();
+	const int fd{::open(path.c_str(), O_RDONLY | O_CLOEXEC)};
+	if (fd < 0) {
+		report("could not open recording", path, errno);
+		return false;
+	}
+	struct stat st {};
+	if (::fstat(fd, &st) != 0 ||
+		static_cast<std::size_t>(st.st_size) < sizeof(seg::Header)) {
+		std::cerr << "could not open recording: " << path
+				  << ": not a segment file" << std::endl;
+		::close(fd);
+		return false;
+	}
+	const auto size{static_cast<std::size_t>(st.st_size)};
+	// private, so that images can be written to without touching the file
+	void* m{::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0)};
+	::close(fd);  // the mapping holds on to the file
+	if (m == MAP_FAILED) {	// NOLINT(*-cstyle-cast): system macro
+		report("could not map recording", path, errno);
+		return false;
+	}
+
+	seg::Header hdr{};
+	std::memcpy(&hdr, m, sizeof(hdr));
+	if (hdr.magic != seg::magic || hdr.version != seg::version ||
+		hdr.entrySize != sizeof(seg::Entry) || hdr.noFrames > hdr.maxFrames ||
+		hdr.dataOffset > size ||
+		hdr.indexOffset + hdr.maxFrames * sizeof(seg::Entry) >
+			hdr.dataOffset) {
+		std::cerr << "could not open recording: " << path
+				  << ": bad or incompatible segment header" << std::endl;
+		::munmap(m, size);
+		return false;
+	}
+	// frames are usually replayed in order
+	::madvise(m, size, MADV_SEQUENTIAL);
+
+	map_ = m;
+	mapSize_ = size;
+	indexOffset_ = hdr.indexOffset;
+	dataOffset_ = hdr.dataOffset;
+	noFrames_ = hdr.noFrames;
+	return true;
+}
+
+}  // namespace beholder
@@ -0,0 +1,176 @@
+// beholder - Copyright © 2024 Philipp Milovic
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// Recording of raw frames to, and replaying them from, memory-mapped
+// segment files.
+
+#ifndef BEHOLDER_IMAGE_RECORDING_H
+#define BEHOLDER_IMAGE_RECORDING_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+
+#include "beholder/capi/Image.h"
+#include "beholder/util/SPSCQueue.h"
+
+namespace beholder {
+
+namespace internal {
+namespace segment {
+struct Entry;
+}  // namespace segment
+}  // namespace internal
+
+// Recorder appends raw frames, as acquired, along with their metadata to
+// a preallocated, memory-mapped segment file, see internal/Segment.h.
+//
+// Frames are written from a background thread, so recording costs the
+// acquiring thread a queue push. Frames whose buffer is pinned are copied
+// by the background thread, others are copied into the mapping right away,
+// since their buffer might not outlive the call.
+// Frames are dropped, rather than blocking the caller, if the queue is
+// full or the segment has no room left.
+//
+// WARNING: record(...) must only be called from a single thread.
+class Recorder {
+private:
+	// A frame waiting to be written.
+	struct Job;
+
+	int fd_{-1};					// segment file descriptor
+	void* map_{nullptr};			// segment mapping
+	std::size_t mapSize_{0};		// size of the mapping
+	std::size_t dataOffset_{0};		// offset of the data region
+	std::size_t capacity_{0};		// size of the data region
+	std::size_t maxFrames_{0};		// number of index entries
+	std::size_t used_{0};			// reserved bytes of the data region
+	std::size_t reserved_{0};		// reserved index entries
+	std::atomic<std::size_t> dropped_{0};  // number of dropped frames
+
+	std::unique_ptr<SPSCQueue<Job>> queue_;	 // frames waiting to be written
+	std::mutex mtx_;				// guards stop_, pairs with cv_
+	std::condition_variable cv_;	// wakes the writer
+	bool stop_{false};				// stop once the queue is drained
+	std::thread writer_;			// background writer
+
+	// Write frames as they're queued, until stopped.
+	void run();
+
+	// Write a frame and its index entry, and commit it.
+	void write(const Job& job);
+
+public:
+	// Default number of frames which can wait to be written.
+	static constexpr std::size_t DfltQueueSize{64};
+
+	// Default constructor.
+	// Defined in the source because unique_ptr complains about
+	// incomplete types.
+	Recorder();
+
+	Recorder(const Recorder&) = delete;
+	Recorder(Recorder&&) = delete;
+
+	// Destructor, closes the segment.
+	~Recorder();
+
+	Recorder& operator=(const Recorder&) = delete;
+	Recorder& operator=(Recorder&&) = delete;
+
+	// Close the segment, once all queued frames are written.
+	// The unused part of the data region is trimmed from the file.
+	void close();
+
+	// Get the number of frames dropped, because the queue was full
+	// or the segment had no room left.
+	[[nodiscard]] std::size_t getNoDropped() const noexcept;
+
+	// Check if a segment is open.
+	[[nodiscard]] bool isOpen() const noexcept;
+
+	// Create a segment file at 'path', overwriting any existing one, with
+	// room for 'maxFrames' frames of 'capacity' bytes in total, and map it.
+	// Anything previously opened is closed.
+	// Returns false if the file could not be created, allocated or mapped.
+	bool open(const std::string& path, std::size_t capacity,
+			  std::size_t maxFrames, std::size_t queueSize = DfltQueueSize);
+
+	// Record a frame acquired by the camera with serial number 'sn'.
+	//
+	// If 'pin' is set, it should keep the frame's buffer alive, and is held
+	// until the frame is written, eg. a grab result. Otherwise the buffer
+	// is copied before returning.
+	// Returns false if the frame was dropped.
+	bool record(const Image& img, const std::string& sn = {},
+				std::shared_ptr<const void> pin = {});
+};
+
+// Recording is a read-only view of a segment file written by a Recorder.
+//
+// The segment is memory-mapped, so frames are replayed zero-copy, i.e.
+// images point straight into the mapping. The mapping is private, so
+// writing into an image's buffer does not modify the file.
+class Recording {
+private:
+	void* map_{nullptr};		  // segment mapping
+	std::size_t mapSize_{0};	  // size of the mapping
+	std::size_t indexOffset_{0};  // offset of the index
+	std::size_t dataOffset_{0};	  // offset of the data region
+	std::size_t noFrames_{0};	  // number of readable frames
+
+	// Get the index entry of the i-th frame into 'e'.
+	// Returns false if there's no such frame, or it lies outside
+	// the mapping.
+	bool entry(std::size_t i, internal::segment::Entry& e) const;
+
+public:
+	// Default constructor.
+	Recording() = default;
+
+	Recording(const Recording&) = delete;
+	Recording(Recording&&) = delete;
+
+	// Destructor, closes the segment.
+	~Recording();
+
+	Recording& operator=(const Recording&) = delete;
+	Recording& operator=(Recording&&) = delete;
+
+	// Check if the file at 'path' is a segment file.
+	[[nodiscard]] static bool isRecording(const std::string& path);
+
+	// Unmap the segment, invalidating all images of the recording.
+	void close() noexcept;
+
+	// Get the i-th frame, or nothing if there's no such frame.
+	// The image is valid until the recording is closed.
+	[[nodiscard]] std::optional<Image> getFrame(std::size_t i) const;
+
+	// Get the number of frames in the recording.
+	[[nodiscard]] std::size_t getNoFrames() const noexcept;
+
+	// Get the serial number of the camera which acquired the i-th frame,
+	// or an empty string if there's no such frame.
+	[[nodiscard]] std::string getSerialNumber(std::size_t i) const;
+
+	// Get the time at which the i-th frame was recorded,
+	// or nothing if there's no such frame.
+	[[nodiscard]] std::optional<std::chrono::system_clock::time_point>
+	getTimestamp(std::size_t i) const;
+
+	// Map the segment file at 'path'. Anything previously opened is closed.
+	// Returns false if the file could not be mapped, or is not a segment.
+	bool open(const std::string& path);
+};
+
+}  // namespace beholder
+
+#endif	// BEHOLDER_IMAGE_RECORDING_H
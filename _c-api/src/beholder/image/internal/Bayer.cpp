@@ -0,0 +1,125 @@
+// beholder - Copyright © 2024 Philipp Milovic
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "beholder/image/internal/Bayer.h"
+
+#include <opencv2/core.hpp>
+#include <opencv2/core/mat.hpp>
+#include <opencv2/core/types.hpp>
+#include <opencv2/imgproc.hpp>
+#include <optional>
+
+namespace beholder {
+namespace internal {
+
+namespace {
+// Get the position of the red pixel within a 2x2 quad of a Bayer mosaic,
+// given the code converting the mosaic to BGR.
+std::optional<cv::Point> redOffset(int bgrCode) {
+	switch (bgrCode) {
+		case cv::COLOR_BayerRGGB2BGR:
+			return cv::Point{0, 0};
+		case cv::COLOR_BayerGRBG2BGR:
+			return cv::Point{1, 0};
+		case cv::COLOR_BayerGBRG2BGR:
+			return cv::Point{0, 1};
+		case cv::COLOR_BayerBGGR2BGR:
+			return cv::Point{1, 1};
+		default:
+			return std::nullopt;
+	}
+}
+
+// Bin each 2x2 quad of a Bayer mosaic into a BGR pixel.
+template<typename T>
+void bin(const cv::Mat& raw, const cv::Point& red, cv::Mat& out) {
+	// blue is diagonal to red, the greens are on the other diagonal
+	const cv::Point blue{1 - red.x, 1 - red.y};
+	for (int i{0}; i < out.rows; ++i) {
+		const T* quad[2]{raw.ptr<T>(2 * i), raw.ptr<T>(2 * i + 1)};
+		auto* o{out.ptr<T>(i)};
+		for (int j{0}; j < out.cols; ++j) {
+			const int x{2 * j};
+			const unsigned g{static_cast<unsigned>(quad[red.y][x + blue.x]) +
+							 static_cast<unsigned>(quad[blue.y][x + red.x])};
+			o[3 * j] = quad[blue.y][x + blue.x];
+			o[3 * j + 1] = static_cast<T>((g + 1U) / 2U);
+			o[3 * j + 2] = quad[red.y][x + red.x];
+		}
+	}
+}
+
+// Sample each BGR pixel's channel called for by the mosaic.
+template<typename T>
+void sample(const cv::Mat& bgr, const cv::Point& red, cv::Mat& out) {
+	const cv::Point blue{1 - red.x, 1 - red.y};
+	for (int i{0}; i < out.rows; ++i) {
+		const auto* b{bgr.ptr<T>(i)};
+		auto* o{out.ptr<T>(i)};
+		for (int j{0}; j < out.cols; ++j) {
+			const cv::Point q{j % 2, i % 2};
+			const int ch{q == red ? 2 : (q == blue ? 0 : 1)};
+			o[j] = b[3 * j + ch];
+		}
+	}
+}
+}  // namespace
+
+int bayerToGray(int bgrCode) {
+	switch (bgrCode) {
+		case cv::COLOR_BayerRGGB2BGR:
+			return cv::COLOR_BayerRGGB2GRAY;
+		case cv::COLOR_BayerGRBG2BGR:
+			return cv::COLOR_BayerGRBG2GRAY;
+		case cv::COLOR_BayerGBRG2BGR:
+			return cv::COLOR_BayerGBRG2GRAY;
+		case cv::COLOR_BayerBGGR2BGR:
+			return cv::COLOR_BayerBGGR2GRAY;
+		default:
+			return -1;
+	}
+}
+
+bool binBayer(const cv::Mat& raw, int bgrCode, cv::Mat& out) {
+	const auto red{redOffset(bgrCode)};
+	if (!red || raw.channels() != 1) {
+		return false;
+	}
+	// keep the input alive in case 'out' refers to it
+	const cv::Mat src{raw};
+	out.create(src.rows / 2, src.cols / 2, CV_MAKETYPE(src.depth(), 3));
+	switch (src.depth()) {
+		case CV_8U:
+			bin<uchar>(src, *red, out);
+			return true;
+		case CV_16U:
+			bin<ushort>(src, *red, out);
+			return true;
+		default:
+			return false;
+	}
+}
+
+bool mosaicBayer(const cv::Mat& bgr, int bgrCode, cv::Mat& out) {
+	const auto red{redOffset(bgrCode)};
+	if (!red || bgr.channels() != 3) {
+		return false;
+	}
+	// keep the input alive in case 'out' refers to it
+	const cv::Mat src{bgr};
+	out.create(src.rows, src.cols, CV_MAKETYPE(src.depth(), 1));
+	switch (src.depth()) {
+		case CV_8U:
+			sample<uchar>(src, *red, out);
+			return true;
+		case CV_16U:
+			sample<ushort>(src, *red, out);
+			return true;
+		default:
+			return false;
+	}
+}
+
+}  // namespace internal
+}  // namespace beholder
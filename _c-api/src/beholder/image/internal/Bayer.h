@@ -0,0 +1,47 @@
+// beholder - Copyright © 2024 Philipp Milovic
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// Helpers for converting Bayer mosaics.
+
+#ifndef BEHOLDER_IMAGE_INTERNAL_BAYER_H
+#define BEHOLDER_IMAGE_INTERNAL_BAYER_H
+
+namespace cv {
+class Mat;
+}  // namespace cv
+
+namespace beholder {
+namespace internal {
+
+// Get the code converting a Bayer mosaic to grayscale, given the code
+// (cv::ColorConversionCodes) converting it to BGR, or -1 if 'bgrCode'
+// does not convert a Bayer mosaic.
+[[nodiscard]] int bayerToGray(int bgrCode);
+
+// Convert a Bayer mosaic to a BGR image of half its size, by binning
+// each 2x2 quad into a single pixel, where 'bgrCode' is the code
+// (cv::ColorConversionCodes) converting the mosaic to BGR.
+//
+// The red and blue values of a quad are taken as is, while green is the
+// average of the quad's two green values, so no interpolation across
+// quads is needed and each raw pixel is read exactly once.
+// Both 8- and 16-bit mosaics are supported, the output depth matches
+// the input one. Odd trailing rows and columns are dropped.
+// Returns false if 'bgrCode' does not convert a Bayer mosaic.
+bool binBayer(const cv::Mat& raw, int bgrCode, cv::Mat& out);
+
+// Sample a BGR image into a Bayer mosaic of the same size, i.e. the inverse
+// of demosaicing, where 'bgrCode' is the code (cv::ColorConversionCodes)
+// converting the mosaic back to BGR.
+//
+// Each raw pixel takes the channel its position in the 2x2 quad calls for.
+// Both 8- and 16-bit images are supported, the output depth matches
+// the input one.
+// Returns false if 'bgrCode' does not convert a Bayer mosaic.
+bool mosaicBayer(const cv::Mat& bgr, int bgrCode, cv::Mat& out);
+
+}  // namespace internal
+}  // namespace beholder
+
+#endif	// BEHOLDER_IMAGE_INTERNAL_BAYER_H
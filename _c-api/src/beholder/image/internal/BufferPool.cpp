@@ -0,0 +1,145 @@
+// beholder - Copyright © 2024 Philipp Milovic
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "beholder/image/internal/BufferPool.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <opencv2/core.hpp>
+#include <opencv2/core/mat.hpp>
+
+namespace beholder {
+namespace internal {
+
+unsigned char* BufferPool::acquire(std::size_t size) const {
+	maxSize_ = std::max(maxSize_, size);
+
+	// best fit, so large blocks are kept for large requests
+	auto best{free_.end()};
+	for (auto it{free_.begin()}; it != free_.end(); ++it) {
+		if (it->size >= size && (best == free_.end() || it->size < best->size)) {
+			best = it;
+		}
+	}
+	if (best != free_.end()) {
+		used_.emplace_back(*best);
+		free_.erase(best);
+		return used_.back().data;
+	}
+
+	// miss; blocks smaller than the largest request are stale by now
+	const auto stale{std::remove_if(
+		free_.begin(), free_.end(), [this](const Block& b) {
+			if (b.size < maxSize_) {
+				cv::fastFree(b.data);
+				return true;
+			}
+			return false;
+		})};
+	free_.erase(stale, free_.end());
+
+	auto* data{static_cast<unsigned char*>(cv::fastMalloc(maxSize_))};
+	++nAllocs_;
+	used_.emplace_back(Block{data, maxSize_});
+	return data;
+}
+
+cv::UMatData* BufferPool::header() const {
+	if (!headers_.empty()) {
+		auto* u{headers_.back()};
+		headers_.pop_back();
+		return u;
+	}
+	++nAllocs_;
+	return new cv::UMatData{this};
+}
+
+BufferPool::~BufferPool() {
+	for (const auto& b : free_) {
+		cv::fastFree(b.data);
+	}
+	for (const auto& b : used_) {
+		cv::fastFree(b.data);
+	}
+	for (auto* u : headers_) {
+		delete u;  // NOLINT(*-owning-memory)
+	}
+}
+
+cv::UMatData*
+BufferPool::allocate(int dims, const int* sizes, int type, void* data,
+					 std::size_t* step, [[maybe_unused]] cv::AccessFlag flags,
+					 [[maybe_unused]] cv::UMatUsageFlags usageFlags) const {
+	// compute steps the same way cv::StdMatAllocator does
+	std::size_t total{CV_ELEM_SIZE(type)};	// NOLINT
+	for (int i{dims - 1}; i >= 0; --i) {
+		if (step != nullptr) {
+			if (data != nullptr && step[i] != CV_AUTOSTEP) {
+				CV_Assert(total <= step[i]);
+				total = step[i];
+			} else {
+				step[i] = total;
+			}
+		}
+		total *= static_cast<std::size_t>(sizes[i]);
+	}
+
+	const std::lock_guard lock{mutex_};
+	auto* u{header()};
+	if (data != nullptr) {
+		u->data = u->origdata = static_cast<unsigned char*>(data);
+		u->flags |= cv::UMatData::USER_ALLOCATED;
+	} else {
+		u->data = u->origdata = acquire(total);
+	}
+	u->size = total;
+	return u;
+}
+
+bool BufferPool::allocate(cv::UMatData* data,
+						  [[maybe_unused]] cv::AccessFlag accessFlags,
+						  [[maybe_unused]] cv::UMatUsageFlags usageFlags) const {
+	return data != nullptr;
+}
+
+void BufferPool::deallocate(cv::UMatData* data) const {
+	if (data == nullptr) {
+		return;
+	}
+	CV_Assert(data->urefcount == 0);
+	CV_Assert(data->refcount == 0);
+
+	const std::lock_guard lock{mutex_};
+	if (!(data->flags & cv::UMatData::USER_ALLOCATED)) {
+		auto it{std::find_if(
+			used_.begin(), used_.end(),
+			[data](const Block& b) { return b.data == data->origdata; })};
+		if (it != used_.end()) {
+			free_.emplace_back(*it);
+			used_.erase(it);
+		} else {
+			cv::fastFree(data->origdata);  // not ours, shouldn't happen
+		}
+	}
+	// recycle the header by resetting it to a pristine state
+	data->~UMatData();
+	new (data) cv::UMatData{this};
+	headers_.emplace_back(data);
+}
+
+cv::Mat BufferPool::mat() {
+	cv::Mat m{};
+	m.allocator = this;
+	return m;
+}
+
+std::size_t BufferPool::nAllocations() const {
+	const std::lock_guard lock{mutex_};
+	return nAllocs_;
+}
+
+}  // namespace internal
+}  // namespace beholder
@@ -0,0 +1,92 @@
+// beholder - Copyright © 2024 Philipp Milovic
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// A recycling allocator for image buffers.
+
+#ifndef BEHOLDER_IMAGE_INTERNAL_BUFFER_POOL_H
+#define BEHOLDER_IMAGE_INTERNAL_BUFFER_POOL_H
+
+#include <cstddef>
+#include <mutex>
+#include <opencv2/core/mat.hpp>
+#include <vector>
+
+namespace beholder {
+namespace internal {
+
+// BufferPool is a cv::MatAllocator which hands out recycled memory blocks
+// instead of going to the system for each new cv::Mat.
+//
+// Every block the pool allocates is sized to the largest request seen so far,
+// hence any free block can serve any request once the pool has warmed up,
+// regardless of ROI size or image type. Blocks which became too small,
+// because a larger request came along, are released on the next miss.
+// UMatData headers are recycled as well, so a warmed-up pool performs no
+// heap allocations at all.
+//
+// A cv::Mat is attached to the pool by setting its 'allocator' field, see
+// mat(). OpenCV functions which (re)create an output array use the output's
+// allocator, so ops draw their outputs and temporaries from the pool simply
+// by inheriting the allocator of the output they were given.
+//
+// WARNING: matrices allocated from the pool must not outlive it.
+class BufferPool : public cv::MatAllocator {
+private:
+	// A memory block
+	struct Block {
+		unsigned char* data{nullptr};  // block start
+		std::size_t size{0};		   // block capacity in bytes
+	};
+
+	mutable std::mutex mutex_;					  // guards everything below
+	mutable std::vector<Block> free_;			  // blocks ready for reuse
+	mutable std::vector<Block> used_;			  // blocks held by matrices
+	mutable std::vector<cv::UMatData*> headers_;  // recycled headers
+	mutable std::size_t maxSize_{0};			  // largest request seen
+	mutable std::size_t nAllocs_{0};			  // system allocations made
+
+	// Get a block of at least 'size' bytes, the mutex must be held.
+	unsigned char* acquire(std::size_t size) const;
+
+	// Get a fresh UMatData header, the mutex must be held.
+	cv::UMatData* header() const;
+
+public:
+	// Default constructor.
+	BufferPool() = default;
+
+	BufferPool(const BufferPool&) = delete;
+	BufferPool(BufferPool&&) = delete;
+
+	// Release all blocks and headers.
+	~BufferPool() override;
+
+	BufferPool& operator=(const BufferPool&) = delete;
+	BufferPool& operator=(BufferPool&&) = delete;
+
+	// Allocate a matrix buffer.
+	cv::UMatData* allocate(int dims, const int* sizes, int type, void* data,
+						   std::size_t* step, cv::AccessFlag flags,
+						   cv::UMatUsageFlags usageFlags) const override;
+
+	// Allocate a buffer for existing UMatData, which is a no-op for
+	// host memory.
+	bool allocate(cv::UMatData* data, cv::AccessFlag accessFlags,
+				  cv::UMatUsageFlags usageFlags) const override;
+
+	// Return a matrix buffer to the pool.
+	void deallocate(cv::UMatData* data) const override;
+
+	// Get an empty matrix which allocates from the pool.
+	[[nodiscard]] cv::Mat mat();
+
+	// Get the number of system allocations made by the pool,
+	// blocks and headers alike.
+	[[nodiscard]] std::size_t nAllocations() const;
+};
+
+}  // namespace internal
+}  // namespace beholder
+
+#endif	// BEHOLDER_IMAGE_INTERNAL_BUFFER_POOL_H
@@ -0,0 +1,192 @@
+// beholder - Copyright © 2024 Philipp Milovic
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "beholder/image/internal/FusedOp.h"
+
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <numeric>
+#include <opencv2/core.hpp>
+#include <opencv2/core/mat.hpp>
+#include <opencv2/core/types.hpp>
+#include <opencv2/imgproc.hpp>
+#include <utility>
+#include <vector>
+
+#include "beholder/capi/Result.h"
+#include "beholder/image/ProcessingOp.h"
+#include "beholder/image/ops/Grayscale.h"
+
+namespace beholder {
+namespace internal {
+
+namespace {
+// Approximate size of a strip of converted pixels, small enough to stay
+// in cache until the look-up table is applied.
+constexpr int stripBytes{1 << 15};	// NOLINT(*-magic-numbers)
+
+// Check if an operation is a grayscale conversion.
+bool isGrayscale(const ProcessingOp& op) {
+	return dynamic_cast<const Grayscale*>(&op) != nullptr;
+}
+
+// Accumulate the histogram of a single-channel 8-bit image.
+void accumulate(const cv::Mat& img, ProcessingOp::Histogram& hist) {
+	for (int i{0}; i < img.rows; ++i) {
+		const auto* row{img.ptr<uchar>(i)};
+		for (int j{0}; j < img.cols; ++j) {
+			++hist[row[j]];
+		}
+	}
+}
+}  // namespace
+
+FusedOp::FusedOp(std::vector<OpPtr> ops) : ops_{std::move(ops)} {
+	gray_ = !ops_.empty() && isGrayscale(*ops_.front());
+	hist_ = std::any_of(ops_.begin(), ops_.end(), [](const OpPtr& o) {
+		return o->needsHistogram();
+	});
+}
+
+bool FusedOp::composeImpl(LUT& lut, const Histogram& hist) const {
+	std::iota(lut.begin(), lut.end(), static_cast<unsigned char>(0));
+	Histogram h{};	// histogram of the current operation's input
+	for (auto it{ops_.begin() + (gray_ ? 1 : 0)}; it != ops_.end(); ++it) {
+		if ((*it)->needsHistogram()) {
+			// push the input histogram through the table composed so far
+			h.fill(0);
+			for (auto i{0UL}; i < hist.size(); ++i) {
+				h[lut[i]] += hist[i];
+			}
+		}
+		if (!(*it)->composeLUT(lut, h)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool FusedOp::executeSequential(const cv::Mat& in, cv::Mat& out) const {
+	cv::Mat cur{in};
+	for (const auto& o : ops_) {
+		cv::Mat next{};
+		next.allocator = out.allocator;
+		if (!o->operator()(cur, next)) {
+			return false;
+		}
+		cur = next;
+	}
+	out = cur;
+	return true;
+}
+
+bool FusedOp::prepareImpl(const cv::Size& size, int type) {
+	int t{type};
+	for (const auto& o : ops_) {
+		if (!o->prepare(size, t)) {
+			return false;
+		}
+		if (gray_ && o == ops_.front()) {
+			t = CV_MAKETYPE(CV_MAT_DEPTH(type), 1);
+		}
+	}
+	ready_ = !hist_ && composeImpl(lut_, Histogram{});
+	return true;
+}
+
+bool FusedOp::isStaleImpl() const {
+	return std::any_of(ops_.begin(), ops_.end(),
+					   [](const auto& o) { return o->isStale(); });
+}
+
+bool FusedOp::execute(const cv::Mat& in, cv::Mat& out) const {
+	const bool fusible{in.depth() == CV_8U &&
+					   (gray_ ? in.channels() == 3
+							  : !hist_ || in.channels() == 1)};
+	if (!fusible) {
+		return executeSequential(in, out);
+	}
+	// keep the input alive in case 'out' refers to it
+	const cv::Mat src{in};
+	LUT lut{lut_};
+	const cv::Mat table{1, static_cast<int>(lut.size()), CV_8U, lut.data()};
+	Histogram hist{};
+
+	// not prepared, so compose the table on the spot if we can
+	bool ready{ready_ && !isStaleImpl()};
+	if (!ready && !hist_) {
+		if (!composeImpl(lut, hist)) {
+			return executeSequential(src, out);
+		}
+		ready = true;
+	}
+
+	if (!gray_) {
+		if (!ready) {
+			accumulate(src, hist);
+			if (!composeImpl(lut, hist)) {
+				return executeSequential(src, out);
+			}
+		}
+		cv::LUT(src, table, out);
+		return true;
+	}
+
+	// convert strip by strip and apply the table while the strip is hot,
+	// or just gather the histogram if the table depends on it
+	out.create(src.size(), CV_8UC1);
+	const int nRows{std::max(1, stripBytes / std::max(1, src.cols))};
+	for (int i{0}; i < src.rows; i += nRows) {
+		const cv::Range rows{i, std::min(i + nRows, src.rows)};
+		cv::Mat strip{out.rowRange(rows)};
+		cv::cvtColor(src.rowRange(rows), strip, cv::COLOR_BGR2GRAY, 1);
+		if (ready) {
+			cv::LUT(strip, table, strip);
+		} else {
+			accumulate(strip, hist);
+		}
+	}
+	if (!ready) {
+		if (!composeImpl(lut, hist)) {
+			return executeSequential(src, out);
+		}
+		cv::LUT(out, table, out);
+	}
+	return true;
+}
+
+bool FusedOp::execute(const cv::Mat& in, cv::Mat& out,
+					  [[maybe_unused]] const std::vector<Result>& res) const {
+	return execute(in, out);
+}
+
+void FusedOp::fuse(std::vector<OpPtr>& ops) {
+	std::vector<OpPtr> fused;
+	fused.reserve(ops.size());
+	auto it{ops.begin()};
+	while (it != ops.end()) {
+		// a run may start with a grayscale conversion
+		auto last{it};
+		if (isGrayscale(**last)) {
+			++last;
+		}
+		while (last != ops.end() && (*last)->isPointwise()) {
+			++last;
+		}
+		if (std::distance(it, last) > 1) {
+			std::vector<OpPtr> run(std::make_move_iterator(it),
+								   std::make_move_iterator(last));
+			fused.emplace_back(std::make_unique<FusedOp>(std::move(run)));
+			it = last;
+		} else {
+			fused.emplace_back(std::move(*it));
+			++it;
+		}
+	}
+	ops = std::move(fused);
+}
+
+}  // namespace internal
+}  // namespace beholder
@@ -0,0 +1,86 @@
+// beholder - Copyright © 2024 Philipp Milovic
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// A processing operation which fuses a chain of pointwise operations.
+
+#ifndef BEHOLDER_IMAGE_INTERNAL_FUSED_OP_H
+#define BEHOLDER_IMAGE_INTERNAL_FUSED_OP_H
+
+#include <vector>
+
+#include "beholder/capi/Result.h"
+#include "beholder/image/ProcessingOp.h"
+
+namespace cv {
+class Mat;
+template<typename T>
+class Size_;  // for Size == Size2i == Size_<int>
+}  // namespace cv
+
+namespace beholder {
+namespace internal {
+
+// FusedOp executes a chain of adjacent pointwise 8-bit operations
+// (see ProcessingOp::composeLUT) as a single look-up table, i.e. as a single
+// pass over the image instead of one pass per operation.
+//
+// The chain may start with a grayscale conversion, in which case
+// the conversion and the table are applied strip by strip, so that
+// the converted pixels are still in cache when the table is applied.
+// Chains containing operations which depend on the image histogram take one
+// additional pass to compute it.
+//
+// Inputs which can't be fused, e.g. non 8-bit images, are processed
+// by executing the original operations one by one.
+class FusedOp : public ProcessingOp {
+private:
+	std::vector<OpPtr> ops_;  // the fused operations, in order
+	bool gray_{false};		  // chain starts with a grayscale conversion
+	bool hist_{false};		  // chain needs the input histogram
+	bool ready_{false};		  // 'lut_' is precomputed
+	LUT lut_{};				  // precomputed table, if histogram independent
+
+	// Compose the look-up table of the chain, where 'hist' is the histogram
+	// of the (grayscale converted) input.
+	bool composeImpl(LUT& lut, const Histogram& hist) const;
+
+	// Execute the operations one by one.
+	bool executeSequential(const cv::Mat& in, cv::Mat& out) const;
+
+protected:
+	// Prepare the fused operations and precompute the table if possible.
+	bool prepareImpl(const cv::Size_<int>& size, int type) override;
+
+	// Check if any of the fused operations is stale.
+	[[nodiscard]] bool isStaleImpl() const override;
+
+	// Execute the processing operation.
+	bool execute(const cv::Mat& in, cv::Mat& out) const override;
+
+	// Execute the processing operation.
+	bool execute(const cv::Mat& in, cv::Mat& out,
+				 const std::vector<Result>& res) const override;
+
+public:
+	// Construct from a chain of operations, which should be pointwise,
+	// except for the first one which may be a grayscale conversion.
+	explicit FusedOp(std::vector<OpPtr> ops);
+
+	FusedOp(const FusedOp&) = delete;
+	FusedOp(FusedOp&&) = default;
+
+	~FusedOp() override = default;
+
+	FusedOp& operator=(const FusedOp&) = delete;
+	FusedOp& operator=(FusedOp&&) = default;
+
+	// Replace runs of adjacent fusible operations in a list with FusedOps.
+	// Runs consisting of a single operation are left as is.
+	static void fuse(std::vector<OpPtr>& ops);
+};
+
+}  // namespace internal
+}  // namespace beholder
+
+#endif	// BEHOLDER_IMAGE_INTERNAL_FUSED_OP_H
@@ -0,0 +1,87 @@
+// beholder - Copyright © 2024 Philipp Milovic
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// The on-disc layout of raw frame recordings, see Recorder.
+
+#ifndef BEHOLDER_IMAGE_INTERNAL_SEGMENT_H
+#define BEHOLDER_IMAGE_INTERNAL_SEGMENT_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace beholder {
+namespace internal {
+namespace segment {
+
+// A segment file starts with a page holding the Header, followed by
+// the index, i.e. an array of Entry, padded to whole pages, followed by
+// the data region holding the raw frames back to back.
+// All offsets and sizes are in bytes, and all values are stored in
+// the host byte order.
+
+// NOLINTBEGIN(*-magic-numbers)
+
+// Magic bytes identifying a segment file.
+inline constexpr std::array<char, 8> magic{'B', 'H', 'R', 'A',
+										   'W', 'S', 'E', 'G'};
+
+// Version of the layout, bumped on incompatible changes.
+inline constexpr std::uint32_t version{1};
+
+// Size of a page, the header, index and data region are aligned to it.
+inline constexpr std::size_t pageSize{4096};
+
+// Alignment of frames within the data region.
+inline constexpr std::size_t frameAlign{64};
+
+// Maximum length of a serial number, including the terminating NUL.
+inline constexpr std::size_t snSize{32};
+
+// NOLINTEND(*-magic-numbers)
+
+// Header is the first thing in a segment file.
+struct Header {
+	std::array<char, 8> magic;	// see segment::magic
+	std::uint32_t version;		// see segment::version
+	std::uint32_t entrySize;	// sizeof(Entry), as a sanity check
+	std::uint64_t maxFrames;	// capacity of the index
+	std::uint64_t indexOffset;	// offset of the index
+	std::uint64_t dataOffset;	// offset of the data region
+	std::uint64_t dataSize;		// capacity of the data region
+	// Number of frames written so far. Updated only once a frame and its
+	// entry are written, so a segment is readable up to the last
+	// committed frame, even if the recorder never closed it.
+	std::uint64_t noFrames;
+};
+
+// Entry is an index entry describing a single frame.
+struct Entry {
+	std::uint64_t id;			 // camera assigned image ID
+	std::int64_t timestamp;		 // recording time, ns since the Unix epoch
+	std::int64_t pixelType;		 // see PxType
+	std::uint64_t offset;		 // offset within the data region
+	std::uint64_t size;			 // number of bytes stored
+	std::uint64_t step;			 // bytes between two rows
+	std::int32_t rows;			 // image height in pixels
+	std::int32_t cols;			 // image width in pixels
+	std::uint64_t bitsPerPixel;	 // number of bits per pixel
+	std::array<char, snSize> sn;  // source serial number, NUL padded
+};
+
+static_assert(std::is_trivially_copyable_v<Header>);
+static_assert(std::is_trivially_copyable_v<Entry>);
+static_assert(sizeof(Header) <= pageSize);
+
+// Round 'n' up to a multiple of 'align'.
+[[nodiscard]] constexpr std::size_t roundUp(std::size_t n, std::size_t align) {
+	return (n + align - 1) / align * align;
+}
+
+}  // namespace segment
+}  // namespace internal
+}  // namespace beholder
+
+#endif	// BEHOLDER_IMAGE_INTERNAL_SEGMENT_H
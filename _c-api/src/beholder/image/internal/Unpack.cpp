@@ -0,0 +1,377 @@
+// beholder - Copyright © 2024 Philipp Milovic
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "beholder/image/internal/Unpack.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <opencv2/core.hpp>
+#include <opencv2/core/hal/intrin.hpp>
+#include <opencv2/core/mat.hpp>
+
+#include "beholder/image/ConversionInfo.h"
+#include "beholder/util/Constants.h"
+
+namespace beholder {
+namespace internal {
+
+// NOLINTBEGIN(*-magic-numbers): bit twiddling ahead
+
+namespace {
+// Get the number of bits per pixel of a packing.
+int bitsPerPixel(Packing p) {
+	switch (p) {
+		case Packing::Mono1:
+			return 1;
+		case Packing::Mono2:
+			return 2;
+		case Packing::Mono4:
+			return 4;
+		case Packing::P10:
+			return 10;
+		case Packing::P12:
+		case Packing::Packed10:	 // 12 bits per pixel, 2 of which are unused
+		case Packing::Packed12:
+			return 12;
+		default:
+			return 0;
+	}
+}
+
+// Unpack 'n' pixels of 1, 2 or 4 bits, first pixel in the least significant
+// bits, scaling them to the full 8-bit range.
+template<int Bits>
+void unpackSubByte(const uchar* src, uchar* dst, int n) {
+	constexpr int perByte{static_cast<int>(cst::bits) / Bits};
+	constexpr unsigned mask{(1U << Bits) - 1U};
+	constexpr unsigned scale{cst::max8bit / mask};
+
+	int i{0};
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+	if constexpr (Bits == 4) {
+		const int lanes{cv::VTraits<cv::v_uint8>::vlanes()};
+		const cv::v_uint16 nibble{cv::vx_setall_u16(0xF)};
+		for (; i + 2 * lanes <= n; i += 2 * lanes) {
+			cv::v_uint16 x0;
+			cv::v_uint16 x1;
+			cv::v_expand(cv::vx_load(src + i / 2), x0, x1);
+			cv::v_uint16 lo0{cv::v_and(x0, nibble)};
+			cv::v_uint16 lo1{cv::v_and(x1, nibble)};
+			cv::v_uint16 hi0{cv::v_shr<4>(x0)};
+			cv::v_uint16 hi1{cv::v_shr<4>(x1)};
+			// scale by 17, i.e. repeat the nibble
+			lo0 = cv::v_or(lo0, cv::v_shl<4>(lo0));
+			lo1 = cv::v_or(lo1, cv::v_shl<4>(lo1));
+			hi0 = cv::v_or(hi0, cv::v_shl<4>(hi0));
+			hi1 = cv::v_or(hi1, cv::v_shl<4>(hi1));
+			cv::v_store_interleave(dst + i, cv::v_pack(lo0, lo1),
+								   cv::v_pack(hi0, hi1));
+		}
+		cv::vx_cleanup();
+	}
+#endif
+	for (; i < n; ++i) {
+		const unsigned v{static_cast<unsigned>(src[i / perByte]) >>
+						 (Bits * (i % perByte))};
+		dst[i] = static_cast<uchar>((v & mask) * scale);
+	}
+}
+
+// Compose the two pixels of a 3-byte group 'a', 'b', 'c'.
+template<Packing P>
+void pair(unsigned a, unsigned b, unsigned c, ushort& p, ushort& q) {
+	if constexpr (P == Packing::P12) {
+		p = static_cast<ushort>(a | ((b & 0xFU) << 8U));
+		q = static_cast<ushort>((b >> 4U) | (c << 4U));
+	} else if constexpr (P == Packing::Packed12) {
+		p = static_cast<ushort>((a << 4U) | (b & 0xFU));
+		q = static_cast<ushort>((c << 4U) | (b >> 4U));
+	} else {  // Packed10
+		p = static_cast<ushort>((a << 2U) | (b & 0x3U));
+		q = static_cast<ushort>((c << 2U) | ((b >> 4U) & 0x3U));
+	}
+}
+
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+// Compose the two pixels of a 3-byte group, lane by lane.
+template<Packing P>
+void pair(const cv::v_uint16& a, const cv::v_uint16& b, const cv::v_uint16& c,
+		  cv::v_uint16& p, cv::v_uint16& q) {
+	if constexpr (P == Packing::P12) {
+		p = cv::v_or(a, cv::v_shl<8>(cv::v_and(b, cv::vx_setall_u16(0xF))));
+		q = cv::v_or(cv::v_shr<4>(b), cv::v_shl<4>(c));
+	} else if constexpr (P == Packing::Packed12) {
+		p = cv::v_or(cv::v_shl<4>(a), cv::v_and(b, cv::vx_setall_u16(0xF)));
+		q = cv::v_or(cv::v_shl<4>(c), cv::v_shr<4>(b));
+	} else {  // Packed10
+		const cv::v_uint16 low2{cv::vx_setall_u16(0x3)};
+		p = cv::v_or(cv::v_shl<2>(a), cv::v_and(b, low2));
+		q = cv::v_or(cv::v_shl<2>(c), cv::v_and(cv::v_shr<4>(b), low2));
+	}
+}
+#endif
+
+// Unpack 'n' pixels stored as 2 pixels per 3 bytes.
+//
+// The groups are split into their first, second and third bytes with
+// a deinterleaving load, so a whole vector of groups is composed at once.
+template<Packing P>
+void unpackTriplets(const uchar* src, ushort* dst, int n) {
+	int i{0};
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+	const int lanes{cv::VTraits<cv::v_uint8>::vlanes()};
+	for (; i + 2 * lanes <= n; i += 2 * lanes) {
+		cv::v_uint8 a;
+		cv::v_uint8 b;
+		cv::v_uint8 c;
+		cv::v_load_deinterleave(src + i / 2 * 3, a, b, c);
+
+		cv::v_uint16 a0;
+		cv::v_uint16 a1;
+		cv::v_uint16 b0;
+		cv::v_uint16 b1;
+		cv::v_uint16 c0;
+		cv::v_uint16 c1;
+		cv::v_expand(a, a0, a1);
+		cv::v_expand(b, b0, b1);
+		cv::v_expand(c, c0, c1);
+
+		cv::v_uint16 p;
+		cv::v_uint16 q;
+		pair<P>(a0, b0, c0, p, q);
+		cv::v_store_interleave(dst + i, p, q);
+		pair<P>(a1, b1, c1, p, q);
+		cv::v_store_interleave(dst + i + lanes, p, q);
+	}
+	cv::vx_cleanup();
+#endif
+	for (; i < n; i += 2) {
+		const uchar* g{src + i / 2 * 3};
+		// the last group is incomplete for odd widths
+		const bool full{i + 1 < n};
+		ushort p{0};
+		ushort q{0};
+		pair<P>(g[0], g[1], full ? g[2] : 0U, p, q);
+		dst[i] = p;
+		if (full) {
+			dst[i + 1] = q;
+		}
+	}
+}
+
+// Unpack 'n' pixels from a 10-bit little-endian bit stream,
+// i.e. 4 pixels per 5 bytes.
+//
+// There is no 5-way deinterleaving load, so each group is read
+// into a 64-bit word and split with shifts instead.
+void unpackP10(const uchar* src, ushort* dst, int n) {
+	constexpr std::uint64_t mask{0x3FF};
+	int i{0};
+	for (; i + 4 <= n; i += 4) {
+		const uchar* g{src + i / 4 * 5};
+		const std::uint64_t v{static_cast<std::uint64_t>(g[0]) |
+							  static_cast<std::uint64_t>(g[1]) << 8U |
+							  static_cast<std::uint64_t>(g[2]) << 16U |
+							  static_cast<std::uint64_t>(g[3]) << 24U |
+							  static_cast<std::uint64_t>(g[4]) << 32U};
+		dst[i] = static_cast<ushort>(v & mask);
+		dst[i + 1] = static_cast<ushort>((v >> 10U) & mask);
+		dst[i + 2] = static_cast<ushort>((v >> 20U) & mask);
+		dst[i + 3] = static_cast<ushort>((v >> 30U) & mask);
+	}
+	// a 10-bit pixel always spans exactly 2 bytes
+	for (; i < n; ++i) {
+		const auto bit{static_cast<std::size_t>(i) * 10U};
+		const uchar* g{src + bit / cst::bits};
+		const unsigned v{static_cast<unsigned>(g[0]) |
+						 static_cast<unsigned>(g[1]) << 8U};
+		dst[i] = static_cast<ushort>((v >> (bit % cst::bits)) & mask);
+	}
+}
+
+// Unpack a row of 'n' pixels.
+bool unpackRow(Packing p, const uchar* src, cv::Mat& dst, int row, int n) {
+	switch (p) {
+		case Packing::Mono1:
+			unpackSubByte<1>(src, dst.ptr<uchar>(row), n);
+			return true;
+		case Packing::Mono2:
+			unpackSubByte<2>(src, dst.ptr<uchar>(row), n);
+			return true;
+		case Packing::Mono4:
+			unpackSubByte<4>(src, dst.ptr<uchar>(row), n);
+			return true;
+		case Packing::P10:
+			unpackP10(src, dst.ptr<ushort>(row), n);
+			return true;
+		case Packing::P12:
+			unpackTriplets<Packing::P12>(src, dst.ptr<ushort>(row), n);
+			return true;
+		case Packing::Packed10:
+			unpackTriplets<Packing::Packed10>(src, dst.ptr<ushort>(row), n);
+			return true;
+		case Packing::Packed12:
+			unpackTriplets<Packing::Packed12>(src, dst.ptr<ushort>(row), n);
+			return true;
+		default:
+			return false;
+	}
+}
+
+// Pack 'n' pixels into 1, 2 or 4 bits each, first pixel in the least
+// significant bits, keeping the most significant bits of each value.
+template<int Bits>
+void packSubByte(const uchar* src, uchar* dst, int n) {
+	constexpr int perByte{static_cast<int>(cst::bits) / Bits};
+	constexpr int shift{static_cast<int>(cst::bits) - Bits};
+	for (int i{0}; i < n; i += perByte) {
+		unsigned v{0};
+		for (int k{0}; k < perByte && i + k < n; ++k) {
+			v |= (static_cast<unsigned>(src[i + k]) >> shift) << (Bits * k);
+		}
+		dst[i / perByte] = static_cast<uchar>(v);
+	}
+}
+
+// Split two pixels into a 3-byte group, i.e. the inverse of pair(...).
+template<Packing P>
+void split(unsigned p, unsigned q, uchar* g) {
+	if constexpr (P == Packing::P12) {
+		g[0] = static_cast<uchar>(p & 0xFFU);
+		g[1] = static_cast<uchar>(((p >> 8U) & 0xFU) | ((q & 0xFU) << 4U));
+		g[2] = static_cast<uchar>((q >> 4U) & 0xFFU);
+	} else if constexpr (P == Packing::Packed12) {
+		g[0] = static_cast<uchar>((p >> 4U) & 0xFFU);
+		g[1] = static_cast<uchar>((p & 0xFU) | ((q & 0xFU) << 4U));
+		g[2] = static_cast<uchar>((q >> 4U) & 0xFFU);
+	} else {  // Packed10
+		g[0] = static_cast<uchar>((p >> 2U) & 0xFFU);
+		g[1] = static_cast<uchar>((p & 0x3U) | ((q & 0x3U) << 4U));
+		g[2] = static_cast<uchar>((q >> 2U) & 0xFFU);
+	}
+}
+
+// Pack 'n' pixels as 2 pixels per 3 bytes.
+template<Packing P>
+void packTriplets(const ushort* src, uchar* dst, int n) {
+	for (int i{0}; i < n; i += 2) {
+		uchar g[3];	 // NOLINT(*-avoid-c-arrays)
+		// the last group is incomplete for odd widths
+		const bool full{i + 1 < n};
+		split<P>(src[i], full ? src[i + 1] : 0U, g);
+		uchar* o{dst + i / 2 * 3};
+		o[0] = g[0];
+		o[1] = g[1];
+		if (full) {
+			o[2] = g[2];
+		}
+	}
+}
+
+// Pack 'n' pixels into a 10-bit little-endian bit stream,
+// i.e. 4 pixels per 5 bytes.
+void packP10(const ushort* src, uchar* dst, int n) {
+	constexpr std::uint64_t mask{0x3FF};
+	int i{0};
+	for (; i + 4 <= n; i += 4) {
+		const std::uint64_t v{(src[i] & mask) | (src[i + 1] & mask) << 10U |
+							  (src[i + 2] & mask) << 20U |
+							  (src[i + 3] & mask) << 30U};
+		uchar* g{dst + i / 4 * 5};
+		for (int k{0}; k < 5; ++k) {
+			g[k] = static_cast<uchar>((v >> (cst::bits * k)) & 0xFFU);
+		}
+	}
+	// the tail starts on a byte boundary, clear it before or-ing into it
+	uchar* tail{dst + i / 4 * 5};
+	std::fill(tail, dst + packedStep(Packing::P10, n), uchar{0});
+	for (; i < n; ++i) {
+		const auto bit{static_cast<std::size_t>(i) * 10U};
+		uchar* g{dst + bit / cst::bits};
+		const auto v{static_cast<unsigned>(src[i] & mask) << (bit % cst::bits)};
+		g[0] = static_cast<uchar>(g[0] | (v & 0xFFU));
+		g[1] = static_cast<uchar>(g[1] | (v >> 8U));
+	}
+}
+
+// Pack a row of 'n' pixels.
+bool packRow(Packing p, const cv::Mat& src, int row, uchar* dst, int n) {
+	switch (p) {
+		case Packing::Mono1:
+			packSubByte<1>(src.ptr<uchar>(row), dst, n);
+			return true;
+		case Packing::Mono2:
+			packSubByte<2>(src.ptr<uchar>(row), dst, n);
+			return true;
+		case Packing::Mono4:
+			packSubByte<4>(src.ptr<uchar>(row), dst, n);
+			return true;
+		case Packing::P10:
+			packP10(src.ptr<ushort>(row), dst, n);
+			return true;
+		case Packing::P12:
+			packTriplets<Packing::P12>(src.ptr<ushort>(row), dst, n);
+			return true;
+		case Packing::Packed10:
+			packTriplets<Packing::Packed10>(src.ptr<ushort>(row), dst, n);
+			return true;
+		case Packing::Packed12:
+			packTriplets<Packing::Packed12>(src.ptr<ushort>(row), dst, n);
+			return true;
+		default:
+			return false;
+	}
+}
+}  // namespace
+
+// NOLINTEND(*-magic-numbers)
+
+std::size_t packedStep(Packing p, int cols) {
+	const auto bits{static_cast<std::size_t>(bitsPerPixel(p))};
+	return (static_cast<std::size_t>(cols) * bits + cst::bits - 1) / cst::bits;
+}
+
+bool unpack(Packing p, const void* src, int rows, int cols, std::size_t step,
+			cv::Mat& dst) {
+	const auto bits{static_cast<std::size_t>(bitsPerPixel(p))};
+	if (bits == 0) {
+		return false;
+	}
+	dst.create(rows, cols, bits < cst::bits ? CV_8UC1 : CV_16UC1);
+
+	const auto* in{static_cast<const uchar*>(src)};
+	const std::size_t srcStep{step > 0 ? step : packedStep(p, cols)};
+	// unpack in one go if there's no padding at either end
+	if (dst.isContinuous() &&
+		srcStep * cst::bits == static_cast<std::size_t>(cols) * bits) {
+		return unpackRow(p, in, dst, 0, rows * cols);
+	}
+	for (int i{0}; i < rows; ++i) {
+		if (!unpackRow(p, in + static_cast<std::size_t>(i) * srcStep, dst, i,
+					   cols)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool pack(Packing p, const cv::Mat& src, void* dst, std::size_t step) {
+	const auto bits{static_cast<std::size_t>(bitsPerPixel(p))};
+	if (bits == 0 || src.type() != (bits < cst::bits ? CV_8UC1 : CV_16UC1)) {
+		return false;
+	}
+	auto* out{static_cast<uchar*>(dst)};
+	const std::size_t dstStep{step > 0 ? step : packedStep(p, src.cols)};
+	for (int i{0}; i < src.rows; ++i) {
+		if (!packRow(p, src, i, out + static_cast<std::size_t>(i) * dstStep,
+					 src.cols)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+}  // namespace internal
+}  // namespace beholder
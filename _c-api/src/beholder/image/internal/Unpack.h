@@ -0,0 +1,54 @@
+// beholder - Copyright © 2024 Philipp Milovic
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// Unpacking and packing of packed pixel formats.
+
+#ifndef BEHOLDER_IMAGE_INTERNAL_UNPACK_H
+#define BEHOLDER_IMAGE_INTERNAL_UNPACK_H
+
+#include <cstddef>
+
+#include "beholder/image/ConversionInfo.h"
+
+namespace cv {
+class Mat;
+}  // namespace cv
+
+namespace beholder {
+namespace internal {
+
+// Get the number of bytes a row of 'cols' pixels takes up in a packed buffer,
+// assuming rows are padded to whole bytes.
+[[nodiscard]] std::size_t packedStep(Packing p, int cols);
+
+// Unpack a 'rows' x 'cols' image from a packed buffer, whose rows are 'step'
+// bytes apart, into 'dst'. If 'step' is 0, rows are assumed to be
+// packedStep(...) bytes apart.
+//
+// Sub-byte formats are unpacked into CV_8UC1, with values scaled to the full
+// 8-bit range. Formats wider than 8 bits are unpacked into CV_16UC1,
+// with values left as is, i.e. as their unpacked counterparts (eg. Mono12)
+// would store them.
+// 'dst' is (re)allocated if necessary. The 16-bit layouts are vectorized
+// for whatever SIMD extensions OpenCV was built with.
+// Returns false if 'p' is not a packed layout.
+bool unpack(Packing p, const void* src, int rows, int cols, std::size_t step,
+			cv::Mat& dst);
+
+// Pack 'src' into a buffer, whose rows are 'step' bytes apart, i.e. the
+// inverse of unpack(...). If 'step' is 0, rows are assumed to be
+// packedStep(...) bytes apart.
+//
+// Sub-byte formats are packed from CV_8UC1, keeping the most significant
+// bits of each value. Formats wider than 8 bits are packed from CV_16UC1,
+// keeping the least significant bits.
+// Mostly for producing test and replay data, hence not vectorized.
+// Returns false if 'p' is not a packed layout, or if 'src' is not of
+// the type unpack(...) would produce.
+bool pack(Packing p, const cv::Mat& src, void* dst, std::size_t step);
+
+}  // namespace internal
+}  // namespace beholder
+
+#endif	// BEHOLDER_IMAGE_INTERNAL_UNPACK_H
@@ -14,11 +14,9 @@
 namespace beholder {
 
 bool AddPadding::execute(const cv::Mat& in, cv::Mat& out) const {
-	cv::Mat tmp{in.rows + 2 * padding, in.cols + 2 * padding, in.depth()};
 	// assume white background
-	cv::copyMakeBorder(in, tmp, padding, padding, padding, padding,
+	cv::copyMakeBorder(in, out, padding, padding, padding, padding,
 					   cv::BORDER_ISOLATED, cv::Scalar::all(padValue));
-	out = tmp;
 	return true;
 }
 
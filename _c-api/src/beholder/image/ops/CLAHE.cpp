@@ -4,6 +4,7 @@
 
 #include "beholder/image/ops/CLAHE.h"
 
+#include <memory>
 #include <opencv2/core/mat.hpp>
 #include <opencv2/core/types.hpp>
 #include <opencv2/imgproc.hpp>
@@ -13,7 +14,49 @@
 
 namespace beholder {
 
+CLAHE::CLAHE(const CLAHE& other)
+	: ProcessingOp{other},
+	  claheClipLimit_{other.claheClipLimit_},
+	  claheTileRows_{other.claheTileRows_},
+	  claheTileColumns_{other.claheTileColumns_},
+	  clipLimit{other.clipLimit},
+	  tileRows{other.tileRows},
+	  tileColumns{other.tileColumns} {
+	if (other.clahe_) {
+		clahe_ = cv::createCLAHE(claheClipLimit_,
+								 cv::Size{claheTileRows_, claheTileColumns_});
+	}
+}
+
+CLAHE& CLAHE::operator=(const CLAHE& other) {
+	if (this != &other) {
+		CLAHE tmp{other};
+		*this = std::move(tmp);
+	}
+	return *this;
+}
+
+bool CLAHE::prepareImpl([[maybe_unused]] const cv::Size& size,
+						[[maybe_unused]] int type) {
+	clahe_ = cv::createCLAHE(clipLimit, cv::Size{tileRows, tileColumns});
+	claheClipLimit_ = clipLimit;
+	claheTileRows_ = tileRows;
+	claheTileColumns_ = tileColumns;
+	return static_cast<bool>(clahe_);
+}
+
+bool CLAHE::isStaleImpl() const {
+	return clahe_ &&
+		   (claheClipLimit_ != clipLimit || claheTileRows_ != tileRows ||
+			claheTileColumns_ != tileColumns);
+}
+
 bool CLAHE::execute(const cv::Mat& in, cv::Mat& out) const {
+	if (clahe_ && !isStaleImpl()) {
+		clahe_->apply(in, out);
+		return true;
+	}
+	// not prepared, so create the algorithm on the spot
 	const cv::Ptr<cv::CLAHE> clahe{
 		cv::createCLAHE(clipLimit, cv::Size{tileRows, tileColumns})};
 	clahe->apply(in, out);
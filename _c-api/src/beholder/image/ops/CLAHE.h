@@ -5,19 +5,39 @@
 #ifndef BEHOLDER_IMAGE_OPS_CLAHE_H
 #define BEHOLDER_IMAGE_OPS_CLAHE_H
 
+#include <memory>
 #include <vector>
 
 #include "beholder/image/ProcessingOp.h"
 
 namespace cv {
 class Mat;
-}
+class CLAHE;
+template<typename T>
+class Size_;  // for Size == Size2i == Size_<int>
+}  // namespace cv
 
 namespace beholder {
 
 // A contrast limited adaptive histogram equalization operation.
 class CLAHE : public ProcessingOp {
+private:
+	// The underlying equalization algorithm, along with its internal buffers,
+	// and the parameters it was created with.
+	// Copies get an instance of their own, so they can be used on other
+	// threads.
+	std::shared_ptr<cv::CLAHE> clahe_;
+	float claheClipLimit_{0.0};
+	int claheTileRows_{0};
+	int claheTileColumns_{0};
+
 protected:
+	// Create the equalization algorithm.
+	bool prepareImpl(const cv::Size_<int>& size, int type) override;
+
+	// Check if the parameters changed since the algorithm was created.
+	[[nodiscard]] bool isStaleImpl() const override;
+
 	// Execute the processing operation.
 	bool execute(const cv::Mat& in, cv::Mat& out) const override;
 
@@ -42,12 +62,14 @@ public:
 	CLAHE(float cLim, int tR, int tC)
 		: clipLimit{cLim}, tileRows{tR}, tileColumns{tC} {}
 
-	CLAHE(const CLAHE&) = default;
+	// Copy constructor, creates a separate equalization algorithm.
+	CLAHE(const CLAHE& other);
 	CLAHE(CLAHE&&) = default;
 
 	~CLAHE() override = default;
 
-	CLAHE& operator=(const CLAHE&) = default;
+	// Copy assignment, creates a separate equalization algorithm.
+	CLAHE& operator=(const CLAHE& other);
 	CLAHE& operator=(CLAHE&&) = default;
 };
 
@@ -5,10 +5,12 @@
 #include "beholder/image/ops/CorrectGamma.h"
 
 #include <cmath>
+#include <memory>
 #include <opencv2/core.hpp>
 #include <opencv2/core/mat.hpp>
 #include <opencv2/core/types.hpp>
 #include <opencv2/imgproc.hpp>
+#include <utility>
 #include <vector>
 
 #include "beholder/image/ProcessingOp.h"
@@ -16,13 +18,69 @@
 
 namespace beholder {
 
-bool CorrectGamma::execute(const cv::Mat& in, cv::Mat& out) const {
-	cv::Mat lut{cv::Size{1, cst::max8bit + 1}, CV_8U};
+namespace {
+// Fill a gamma correction look-up table.
+void makeGammaLUT(cv::Mat& lut, double gamma) {
+	lut.create(cv::Size{1, cst::max8bit + 1}, CV_8U);
 	for (auto i{0UL}; i < cst::max8bit + 1; ++i) {
 		lut.at<uchar>(static_cast<int>(i)) = cv::saturate_cast<uchar>(
 			std::pow(static_cast<double>(i) / cst::max8bit, gamma) *
 			cst::max8bit);
 	}
+}
+}  // namespace
+
+CorrectGamma::CorrectGamma(const CorrectGamma& other)
+	: ProcessingOp{other},
+	  lut_{other.lut_ ? std::make_shared<cv::Mat>(other.lut_->clone())
+					  : nullptr},
+	  lutGamma_{other.lutGamma_},
+	  gamma{other.gamma} {}
+
+CorrectGamma& CorrectGamma::operator=(const CorrectGamma& other) {
+	if (this != &other) {
+		CorrectGamma tmp{other};
+		*this = std::move(tmp);
+	}
+	return *this;
+}
+
+bool CorrectGamma::prepareImpl([[maybe_unused]] const cv::Size& size,
+							   [[maybe_unused]] int type) {
+	auto lut{std::make_shared<cv::Mat>()};
+	makeGammaLUT(*lut, gamma);
+	lut_ = std::move(lut);
+	lutGamma_ = gamma;
+	return true;
+}
+
+bool CorrectGamma::isStaleImpl() const {
+	return lut_ && lutGamma_ != gamma;
+}
+
+bool CorrectGamma::isPointwiseImpl() const { return true; }
+
+bool CorrectGamma::composeLUTImpl(
+	LUT& lut, [[maybe_unused]] const Histogram& hist) const {
+	cv::Mat tmp{};
+	if (!lut_ || lut_->empty() || isStaleImpl()) {
+		makeGammaLUT(tmp, gamma);
+	}
+	const cv::Mat& gLUT{tmp.empty() ? *lut_ : tmp};
+	for (auto& v : lut) {
+		v = gLUT.at<uchar>(v);
+	}
+	return true;
+}
+
+bool CorrectGamma::execute(const cv::Mat& in, cv::Mat& out) const {
+	if (lut_ && !lut_->empty() && !isStaleImpl()) {
+		cv::LUT(in, *lut_, out);
+		return true;
+	}
+	// not prepared, so compute the table on the spot
+	cv::Mat lut{};
+	makeGammaLUT(lut, gamma);
 	cv::LUT(in, lut, out);
 	return true;
 }
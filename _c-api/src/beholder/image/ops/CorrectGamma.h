@@ -5,18 +5,39 @@
 #ifndef BEHOLDER_IMAGE_OPS_CORRECT_GAMMA_H
 #define BEHOLDER_IMAGE_OPS_CORRECT_GAMMA_H
 
+#include <memory>
 #include <vector>
 
 #include "beholder/image/ProcessingOp.h"
 
 namespace cv {
 class Mat;
-}
+template<typename T>
+class Size_;  // for Size == Size2i == Size_<int>
+}  // namespace cv
 
 namespace beholder {
 
 class CorrectGamma : public ProcessingOp {
+private:
+	// Precomputed look-up table, and the gamma it was computed for.
+	// Copies get a copy of their own, so they can be used on other threads.
+	std::shared_ptr<cv::Mat> lut_;
+	double lutGamma_{0.0};
+
 protected:
+	// Build the look-up table.
+	bool prepareImpl(const cv::Size_<int>& size, int type) override;
+
+	// Check if the gamma changed since the table was built.
+	[[nodiscard]] bool isStaleImpl() const override;
+
+	// Check if the operation is a pointwise 8-bit mapping.
+	[[nodiscard]] bool isPointwiseImpl() const override;
+
+	// Compose the operation onto a look-up table.
+	bool composeLUTImpl(LUT& lut, const Histogram& hist) const override;
+
 	// Execute the processing operation.
 	bool execute(const cv::Mat& in, cv::Mat& out) const override;
 
@@ -33,12 +54,14 @@ public:
 	// Default constructor.
 	explicit CorrectGamma(double g) : gamma{g} {}
 
-	CorrectGamma(const CorrectGamma&) = default;
+	// Copy constructor, copies the look-up table.
+	CorrectGamma(const CorrectGamma& other);
 	CorrectGamma(CorrectGamma&&) = default;
 
 	~CorrectGamma() override = default;
 
-	CorrectGamma& operator=(const CorrectGamma&) = default;
+	// Copy assignment, copies the look-up table.
+	CorrectGamma& operator=(const CorrectGamma& other);
 	CorrectGamma& operator=(CorrectGamma&&) = default;
 };
 
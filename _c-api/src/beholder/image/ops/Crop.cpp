@@ -13,19 +13,34 @@
 
 namespace beholder {
 
-bool Crop::execute(const cv::Mat& in, cv::Mat& out) const {
-	cv::Rect crop{left, top, width, height};
+namespace {
+// Get the crop rectangle snapped to the bounds of an image of size 'in'.
+cv::Rect snap(const Crop& c, const cv::Size& in) {
+	cv::Rect crop{c.left, c.top, c.width, c.height};
 	// snap to bounds
 	crop.x = crop.x > 0 ? crop.x : 0;
-	crop.x = crop.x < in.cols ? crop.x : in.cols - 1;
-	crop.width = crop.x + crop.width <= in.cols ? crop.width : in.cols - crop.x;
+	crop.x = crop.x < in.width ? crop.x : in.width - 1;
+	crop.width =
+		crop.x + crop.width <= in.width ? crop.width : in.width - crop.x;
 
 	crop.y = crop.y > 0 ? crop.y : 0;
-	crop.y = crop.y < in.rows ? crop.y : in.rows - 1;
+	crop.y = crop.y < in.height ? crop.y : in.height - 1;
 	crop.height =
-		crop.y + crop.height <= in.rows ? crop.height : in.rows - crop.y;
+		crop.y + crop.height <= in.height ? crop.height : in.height - crop.y;
+	return crop;
+}
+}  // namespace
+
+bool Crop::composeWarpImpl(Warp& w) const {
+	const cv::Rect crop{snap(*this, cv::Size{w.cols, w.rows})};
+	return composeAffine(w,
+						 {1.0, 0.0, static_cast<double>(-crop.x), 0.0, 1.0,
+						  static_cast<double>(-crop.y)},
+						 crop.height, crop.width, -1);
+}
 
-	out = out(crop);
+bool Crop::execute(const cv::Mat& in, cv::Mat& out) const {
+	out = in(snap(*this, in.size()));
 	return true;
 }
 
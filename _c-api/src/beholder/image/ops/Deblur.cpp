@@ -5,10 +5,12 @@
 #include "beholder/image/ops/Deblur.h"
 
 #include <array>
+#include <memory>
 #include <opencv2/core.hpp>
 #include <opencv2/core/base.hpp>
 #include <opencv2/core/mat.hpp>
 #include <opencv2/imgproc.hpp>
+#include <utility>
 #include <vector>
 
 #include "beholder/capi/Result.h"
@@ -17,19 +19,63 @@
 
 namespace beholder {
 
-bool Deblur::execute(const cv::Mat& in, cv::Mat& out) const {
-	// NOTE: the tutorial uses grayscale images only?
+Deblur::Deblur(const Deblur& other)
+	: ProcessingOp{other},
+	  filter_{other.filter_ ? std::make_shared<cv::Mat>(other.filter_->clone())
+						  : nullptr},
+	  filterRadius_{other.filterRadius_},
+	  filterSNR_{other.filterSNR_},
+	  radius{other.radius},
+	  snr{other.snr} {}
+
+Deblur& Deblur::operator=(const Deblur& other) {
+	if (this != &other) {
+		Deblur tmp{other};
+		*this = std::move(tmp);
+	}
+	return *this;
+}
+
+bool Deblur::prepareImpl(const cv::Size& size, [[maybe_unused]] int type) {
 	// even images only
-	const cv::Rect roi{0, 0, in.cols & -2, in.rows & -2};
+	const cv::Size sz{size.width & -2, size.height & -2};
 
-	// compute Hw
 	cv::Mat Hw{};
 	cv::Mat h{};
-	computePSF(h, roi.size(), radius);
+	computePSF(h, sz, radius);
 	computeWeinerFilter(h, Hw, 1.0 / static_cast<double>(snr));
 
+	// merge once, so we don't have to do it for each frame
+	const std::array<cv::Mat, 2> planes{cv::Mat_<float>{Hw},
+										cv::Mat::zeros(Hw.size(), CV_32F)};
+	auto filter{std::make_shared<cv::Mat>()};
+	cv::merge(planes, *filter);
+	filter_ = std::move(filter);
+	filterRadius_ = radius;
+	filterSNR_ = snr;
+	return true;
+}
+
+bool Deblur::isStaleImpl() const {
+	return filter_ && (filterRadius_ != radius || filterSNR_ != snr);
+}
+
+bool Deblur::execute(const cv::Mat& in, cv::Mat& out) const {
+	// NOTE: the tutorial uses grayscale images only?
+	// even images only
+	const cv::Rect roi{0, 0, in.cols & -2, in.rows & -2};
+
 	// filter
-	filter2Dfreq(in(roi), out, Hw);
+	if (filter_ && filter_->size() == roi.size() && !isStaleImpl()) {
+		filter2Dfreq(in(roi), out, *filter_);
+	} else {
+		// not prepared, so compute Hw on the spot
+		cv::Mat Hw{};
+		cv::Mat h{};
+		computePSF(h, roi.size(), radius);
+		computeWeinerFilter(h, Hw, 1.0 / static_cast<double>(snr));
+		filter2Dfreq(in(roi), out, Hw);
+	}
 
 	out.convertTo(out, CV_8U);
 	cv::normalize(out, out, 0, cst::max8bit, cv::NORM_MINMAX);
@@ -76,10 +122,14 @@ void filter2Dfreq(const cv::Mat& in, cv::Mat& out, const cv::Mat& H) {
 	cv::merge(planes, complexI);
 	cv::dft(complexI, complexI, cv::DFT_SCALE);
 
-	const std::array<cv::Mat, 2> planesH{cv::Mat_<float>{H.clone()},
-										 cv::Mat::zeros(H.size(), CV_32F)};
 	cv::Mat complexH{};
-	cv::merge(planesH, complexH);
+	if (H.channels() == 2) {
+		complexH = H;
+	} else {
+		const std::array<cv::Mat, 2> planesH{cv::Mat_<float>{H.clone()},
+											 cv::Mat::zeros(H.size(), CV_32F)};
+		cv::merge(planesH, complexH);
+	}
 	cv::Mat complexIH;
 	cv::mulSpectrums(complexI, complexH, complexIH, 0);
 
@@ -5,6 +5,7 @@
 #ifndef BEHOLDER_IMAGE_OPS_DEBLUR_H
 #define BEHOLDER_IMAGE_OPS_DEBLUR_H
 
+#include <memory>
 #include <vector>
 
 #include "beholder/image/ProcessingOp.h"
@@ -22,7 +23,21 @@ namespace beholder {
 // For more info, see:
 // https://docs.opencv.org/4.10.0/de/d3c/tutorial_out_of_focus_deblur_filter.html
 class Deblur : public ProcessingOp {
+private:
+	// Precomputed (complex) Wiener filter spectrum, for the prepared size,
+	// and the parameters it was computed with.
+	// Copies get a copy of their own, so they can be used on other threads.
+	std::shared_ptr<cv::Mat> filter_;
+	int filterRadius_{0};
+	int filterSNR_{0};
+
 protected:
+	// Compute the PSF and the Wiener filter spectrum.
+	bool prepareImpl(const cv::Size_<int>& size, int type) override;
+
+	// Check if the parameters changed since the filter was computed.
+	[[nodiscard]] bool isStaleImpl() const override;
+
 	// Execute the processing operation.
 	bool execute(const cv::Mat& in, cv::Mat& out) const override;
 
@@ -45,12 +60,14 @@ public:
 	// Default constructor.
 	Deblur() = default;
 
-	Deblur(const Deblur&) = default;
+	// Copy constructor, copies the filter spectrum.
+	Deblur(const Deblur& other);
 	Deblur(Deblur&&) = default;
 
 	~Deblur() override = default;
 
-	Deblur& operator=(const Deblur&) = default;
+	// Copy assignment, copies the filter spectrum.
+	Deblur& operator=(const Deblur& other);
 	Deblur& operator=(Deblur&&) = default;
 };
 
@@ -58,6 +75,9 @@ void computePSF(cv::Mat& out, const cv::Size_<int>& filterSize, int R);
 
 void fftShift(const cv::Mat& in, cv::Mat& out);
 
+// Filter in the frequency domain.
+// H can either be a real-valued filter, or an already merged complex
+// (2-channel) filter spectrum.
 void filter2Dfreq(const cv::Mat& in, cv::Mat& out, const cv::Mat& H);
 
 void computeWeinerFilter(const cv::Mat& in, cv::Mat& out, double nsr);
@@ -15,7 +15,9 @@
 namespace beholder {
 
 bool DivGaussianBlur::execute(const cv::Mat& in, cv::Mat& out) const {
-	cv::Mat tmp{in.clone()};
+	// draw the scratch buffer from wherever the output comes from
+	cv::Mat tmp{};
+	tmp.allocator = out.allocator;
 	GaussianBlur::execute(in, tmp);
 	cv::divide(in, tmp, out, scaleFactor);
 	return true;
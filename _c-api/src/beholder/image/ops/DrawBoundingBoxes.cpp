@@ -16,15 +16,17 @@
 
 namespace beholder {
 
-bool DrawBoundingBoxes::execute([[maybe_unused]] const cv::Mat& in,
-								[[maybe_unused]] cv::Mat& out) const {
+bool DrawBoundingBoxes::execute(const cv::Mat& in, cv::Mat& out) const {
 	// can't really do anything without the results
+	out = in;
 	return true;
 }
 
-bool DrawBoundingBoxes::execute([[maybe_unused]] const cv::Mat& in,
-								cv::Mat& out,
+bool DrawBoundingBoxes::execute(const cv::Mat& in, cv::Mat& out,
 								const std::vector<Result>& res) const {
+	if (out.data != in.data) {
+		in.copyTo(out);
+	}
 	const cv::Scalar c{color[0], color[1], color[2], color[3]};
 	cv::RotatedRect rect{};
 	//cv::Point2f verts[4]{};
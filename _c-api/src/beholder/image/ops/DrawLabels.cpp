@@ -18,14 +18,17 @@
 
 namespace beholder {
 
-bool DrawLabels::execute([[maybe_unused]] const cv::Mat& in,
-						 [[maybe_unused]] cv::Mat& out) const {
+bool DrawLabels::execute(const cv::Mat& in, cv::Mat& out) const {
 	// can't really do anything without the BEHOLDER results
+	out = in;
 	return true;
 }
 
-bool DrawLabels::execute([[maybe_unused]] const cv::Mat& in, cv::Mat& out,
+bool DrawLabels::execute(const cv::Mat& in, cv::Mat& out,
 						 const std::vector<Result>& res) const {
+	if (out.data != in.data) {
+		in.copyTo(out);
+	}
 	const cv::Scalar c{color[0], color[1], color[2], color[3]};
 	std::string label;
 	for (const auto& r : res) {
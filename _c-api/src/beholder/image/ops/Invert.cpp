@@ -10,9 +10,20 @@
 
 #include "beholder/capi/Result.h"
 #include "beholder/image/ProcessingOp.h"
+#include "beholder/util/Constants.h"
 
 namespace beholder {
 
+bool Invert::isPointwiseImpl() const { return true; }
+
+bool Invert::composeLUTImpl(LUT& lut,
+							[[maybe_unused]] const Histogram& hist) const {
+	for (auto& v : lut) {
+		v = static_cast<unsigned char>(cst::max8bit - v);
+	}
+	return true;
+}
+
 bool Invert::execute(const cv::Mat& in, cv::Mat& out) const {
 	cv::bitwise_not(in, out);
 	return true;
@@ -17,6 +17,12 @@ namespace beholder {
 
 class Invert : public ProcessingOp {
 protected:
+	// Check if the operation is a pointwise 8-bit mapping.
+	[[nodiscard]] bool isPointwiseImpl() const override;
+
+	// Compose the operation onto a look-up table.
+	bool composeLUTImpl(LUT& lut, const Histogram& hist) const override;
+
 	// Execute the processing operation.
 	bool execute(const cv::Mat& in, cv::Mat& out) const override;
 
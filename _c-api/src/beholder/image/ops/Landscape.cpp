@@ -13,9 +13,21 @@
 
 namespace beholder {
 
+bool Landscape::composeWarpImpl(Warp& w) const {
+	if (w.cols >= w.rows) {
+		return true;  // nothing to do
+	}
+	// same as cv::rotate(..., cv::ROTATE_90_CLOCKWISE)
+	return composeAffine(
+		w, {0.0, -1.0, static_cast<double>(w.rows - 1), 1.0, 0.0, 0.0}, w.cols,
+		w.rows, -1);
+}
+
 bool Landscape::execute(const cv::Mat& in, cv::Mat& out) const {
 	if (in.cols < in.rows) {
 		cv::rotate(in, out, cv::ROTATE_90_CLOCKWISE);
+	} else {
+		out = in;
 	}
 	return true;
 }
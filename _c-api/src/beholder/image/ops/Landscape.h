@@ -21,6 +21,9 @@ namespace beholder {
 // nothing.
 class Landscape : public ProcessingOp {
 protected:
+	// Compose the operation onto a pending warp.
+	bool composeWarpImpl(Warp& w) const override;
+
 	// Execute the processing operation.
 	bool execute(const cv::Mat& in, cv::Mat& out) const override;
 
@@ -4,6 +4,7 @@
 
 #include "beholder/image/ops/Morphology.h"
 
+#include <memory>
 #include <opencv2/core/mat.hpp>
 #include <opencv2/core/types.hpp>
 #include <opencv2/imgproc.hpp>
@@ -36,7 +37,49 @@ static_assert(Shp::Cross == cv::MORPH_CROSS);
 static_assert(Shp::Ellipse == cv::MORPH_ELLIPSE);
 }  // namespace
 
+Morphology::Morphology(const Morphology& other)
+	: ProcessingOp{other},
+	  kernel_{other.kernel_ ? std::make_shared<cv::Mat>(other.kernel_->clone())
+						  : nullptr},
+	  kernelShape_{other.kernelShape_},
+	  kernelWidth_{other.kernelWidth_},
+	  kernelHeight_{other.kernelHeight_},
+	  type{other.type},
+	  shape{other.shape},
+	  width{other.width},
+	  height{other.height},
+	  iterations{other.iterations} {}
+
+Morphology& Morphology::operator=(const Morphology& other) {
+	if (this != &other) {
+		Morphology tmp{other};
+		*this = std::move(tmp);
+	}
+	return *this;
+}
+
+bool Morphology::prepareImpl([[maybe_unused]] const cv::Size& size,
+							 [[maybe_unused]] int type) {
+	kernel_ = std::make_shared<cv::Mat>(
+		cv::getStructuringElement(enums::to(shape), cv::Size(width, height)));
+	kernelShape_ = enums::to(shape);
+	kernelWidth_ = width;
+	kernelHeight_ = height;
+	return true;
+}
+
+bool Morphology::isStaleImpl() const {
+	return kernel_ && (kernelShape_ != enums::to(shape) ||
+					   kernelWidth_ != width || kernelHeight_ != height);
+}
+
 bool Morphology::execute(const cv::Mat& in, cv::Mat& out) const {
+	if (kernel_ && !isStaleImpl()) {
+		cv::morphologyEx(in, out, enums::to(type), *kernel_, cv::Point(-1, -1),
+						 iterations);
+		return true;
+	}
+	// not prepared, so build the structuring element on the spot
 	const cv::Mat el =
 		cv::getStructuringElement(enums::to(shape), cv::Size(width, height));
 	cv::morphologyEx(in, out, enums::to(type), el, cv::Point(-1, -1),
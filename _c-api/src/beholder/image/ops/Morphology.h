@@ -5,18 +5,35 @@
 #ifndef BEHOLDER_IMAGE_OPS_MORPHOLOGY_H
 #define BEHOLDER_IMAGE_OPS_MORPHOLOGY_H
 
+#include <memory>
 #include <vector>
 
 #include "beholder/image/ProcessingOp.h"
 
 namespace cv {
 class Mat;
-}
+template<typename T>
+class Size_;  // for Size == Size2i == Size_<int>
+}  // namespace cv
 
 namespace beholder {
 
 class Morphology : public ProcessingOp {
+private:
+	// Precomputed structuring element, and the parameters it was built with.
+	// Copies get a copy of their own, so they can be used on other threads.
+	std::shared_ptr<cv::Mat> kernel_;
+	int kernelShape_{-1};
+	int kernelWidth_{0};
+	int kernelHeight_{0};
+
 protected:
+	// Build the structuring element.
+	bool prepareImpl(const cv::Size_<int>& size, int type) override;
+
+	// Check if the kernel parameters changed since it was built.
+	[[nodiscard]] bool isStaleImpl() const override;
+
 	// Execute the processing operation.
 	bool execute(const cv::Mat& in, cv::Mat& out) const override;
 
@@ -57,12 +74,14 @@ public:
 	Morphology(Shape s, int w, int h, Type typ, int iter)
 		: type{typ}, shape{s}, width{w}, height{h}, iterations{iter} {}
 
-	Morphology(const Morphology&) = default;
+	// Copy constructor, copies the structuring element.
+	Morphology(const Morphology& other);
 	Morphology(Morphology&&) = default;
 
 	~Morphology() override = default;
 
-	Morphology& operator=(const Morphology&) = default;
+	// Copy assignment, copies the structuring element.
+	Morphology& operator=(const Morphology& other);
 	Morphology& operator=(Morphology&&) = default;
 };
 
@@ -4,6 +4,8 @@
 
 #include "beholder/image/ops/NormalizeBrightnessContrast.h"
 
+#include <array>
+#include <cmath>
 #include <opencv2/core.hpp>
 #include <opencv2/core/mat.hpp>
 #include <opencv2/imgproc.hpp>
@@ -14,22 +16,19 @@
 
 namespace beholder {
 
-bool NormalizeBrightnessContrast::execute(const cv::Mat& in,
-										  cv::Mat& out) const {
-	// compute histogram
-	const std::vector<cv::Mat> input{in};  // FIXME: this is wasteful
-	const std::vector<int> channels{0};	   // FIXME: read from image
-	std::vector<int> histSize{cst::max8bit};
-	cv::Mat hist;
+namespace {
+// Histogram with the binning used for computing the clip points.
+using Bins = std::array<float, cst::max8bit>;
 
-	cv::calcHist(input, channels, cv::Mat{}, hist, histSize,
-				 std::vector<float>{});
+// Compute the scale and offset which stretch the clipped histogram
+// over the full 8-bit range.
+void computeStretch(const Bins& hist, float clipLowPct, float clipHighPct,
+					float& alpha, float& beta) {
 	// compute cumulative distribution
-	std::vector<float> acc;
-	acc.reserve(hist.total());
-	acc.emplace_back(hist.at<float>(0));
-	for (auto i{1UL}; i < hist.total(); ++i) {
-		acc.emplace_back(acc[i - 1] + hist.at<float>(static_cast<int>(i)));
+	Bins acc{};
+	acc[0] = hist[0];
+	for (auto i{1UL}; i < hist.size(); ++i) {
+		acc[i] = acc[i - 1] + hist[i];
 	}
 	// locate clip points
 	const float max{acc.back()};
@@ -42,13 +41,58 @@ bool NormalizeBrightnessContrast::execute(const cv::Mat& in,
 		++min_gray;
 	}
 	// locate right cut
-	int max_gray{histSize[0] - 1};
+	int max_gray{static_cast<int>(acc.size()) - 1};
 	while (acc[max_gray] >= (max - hi)) {
 		--max_gray;
 	}
-	const float alpha{static_cast<float>(cst::max8bit) /
-					  static_cast<float>((max_gray - min_gray))};
-	const float beta{static_cast<float>(-min_gray) * alpha};
+	alpha = static_cast<float>(cst::max8bit) /
+			static_cast<float>((max_gray - min_gray));
+	beta = static_cast<float>(-min_gray) * alpha;
+}
+}  // namespace
+
+bool NormalizeBrightnessContrast::isPointwiseImpl() const { return true; }
+
+bool NormalizeBrightnessContrast::needsHistogramImpl() const { return true; }
+
+bool NormalizeBrightnessContrast::composeLUTImpl(LUT& lut,
+												 const Histogram& hist) const {
+	// rebin the same way cv::calcHist does with 255 uniform bins
+	// over [0, 256), i.e. values 0 and 1 share the first bin
+	Bins bins{};
+	bins[0] = static_cast<float>(hist[0] + hist[1]);
+	for (auto i{1UL}; i < bins.size(); ++i) {
+		bins[i] = static_cast<float>(hist[i + 1]);
+	}
+	float alpha{};
+	float beta{};
+	computeStretch(bins, clipLowPct, clipHighPct, alpha, beta);
+
+	// same as cv::convertScaleAbs
+	for (auto& v : lut) {
+		v = cv::saturate_cast<uchar>(
+			std::abs(static_cast<float>(v) * alpha + beta));
+	}
+	return true;
+}
+
+bool NormalizeBrightnessContrast::execute(const cv::Mat& in,
+										  cv::Mat& out) const {
+	// compute histogram
+	const std::vector<cv::Mat> input{in};  // FIXME: this is wasteful
+	const std::vector<int> channels{0};	   // FIXME: read from image
+	std::vector<int> histSize{cst::max8bit};
+	cv::Mat hist;
+
+	cv::calcHist(input, channels, cv::Mat{}, hist, histSize,
+				 std::vector<float>{});
+	Bins bins{};
+	for (auto i{0UL}; i < bins.size(); ++i) {
+		bins[i] = hist.at<float>(static_cast<int>(i));
+	}
+	float alpha{};
+	float beta{};
+	computeStretch(bins, clipLowPct, clipHighPct, alpha, beta);
 
 	cv::convertScaleAbs(in, out, alpha, beta);
 
@@ -14,6 +14,17 @@
 
 namespace beholder {
 
+bool Rescale::composeWarpImpl(Warp& w) const {
+	// same interpolation choice as below
+	const int interp{scale > 1.0 ? cv::INTER_CUBIC : cv::INTER_AREA};
+	// same output size and scaling about pixel centers as cv::resize
+	const int rows{cv::saturate_cast<int>(w.rows * scale)};
+	const int cols{cv::saturate_cast<int>(w.cols * scale)};
+	return composeAffine(
+		w, {scale, 0.0, 0.5 * scale - 0.5, 0.0, scale, 0.5 * scale - 0.5},
+		rows, cols, interp);
+}
+
 bool Rescale::execute(const cv::Mat& in, cv::Mat& out) const {
 	// we usually shrink images
 	int interp{cv::INTER_AREA};
@@ -17,6 +17,9 @@ namespace beholder {
 
 class Rescale : public ProcessingOp {
 protected:
+	// Compose the operation onto a pending warp.
+	bool composeWarpImpl(Warp& w) const override;
+
 	// Execute the processing operation.
 	bool execute(const cv::Mat& in, cv::Mat& out) const override;
 
@@ -15,6 +15,23 @@
 
 namespace beholder {
 
+bool ResizeToHeight::composeWarpImpl(Warp& w) const {
+	const double ratio{static_cast<double>(w.cols) /
+					   static_cast<double>(w.rows)};
+	const int width{cvRound(height * ratio)};
+
+	// same interpolation choice as below
+	int interp{cv::INTER_AREA};
+	if (width * height > w.rows * w.cols) {
+		interp = cv::INTER_CUBIC;
+	}
+	// scaling about pixel centers, as cv::resize does
+	const double sx{static_cast<double>(width) / w.cols};
+	const double sy{static_cast<double>(height) / w.rows};
+	return composeAffine(w, {sx, 0.0, 0.5 * sx - 0.5, 0.0, sy, 0.5 * sy - 0.5},
+						 height, width, interp);
+}
+
 bool ResizeToHeight::execute(const cv::Mat& in, cv::Mat& out) const {
 	const double ratio{static_cast<double>(in.cols) /
 					   static_cast<double>(in.rows)};
@@ -5,6 +5,7 @@
 #include "beholder/image/ops/Rotate.h"
 
 #include <opencv2/core/mat.hpp>
+#include <opencv2/core/matx.hpp>
 #include <opencv2/core/types.hpp>
 #include <opencv2/imgproc.hpp>
 #include <vector>
@@ -15,24 +16,49 @@
 
 namespace beholder {
 
-bool Rotate::execute(const cv::Mat& in, cv::Mat& out) const {
+namespace {
+// Get the matrix which rotates an image of size 'in' by 'angle' degrees
+// about its center, and the size of the image which fits the result.
+cv::Matx23d rotation(const cv::Size& in, double angle, cv::Size& out) {
 	// get rotation matrix for rotating the image
 	// around it's center in pixel coordinates
-	const cv::Point2f center{static_cast<float>(in.cols - 1) / 2,
-							 static_cast<float>(in.rows - 1) / 2};
-	cv::Mat rot{cv::getRotationMatrix2D(center, angle, 1.0)};
+	const cv::Point2f center{static_cast<float>(in.width - 1) / 2,
+							 static_cast<float>(in.height - 1) / 2};
+	cv::Matx23d rot{cv::getRotationMatrix2D_(center, angle, 1.0)};
 
 	// determine bounding rectangle, center not relevant
 	const cv::Rect2f bbox{
-		cv::RotatedRect{center, in.size(), angle}.boundingRect2f()};
+		cv::RotatedRect{center, in, static_cast<float>(angle)}
+			.boundingRect2f()};
 
 	// adjust transformation matrix
-	rot.at<double>(0, 2) += (static_cast<double>(bbox.width) - in.cols) / 2;
-	rot.at<double>(1, 2) += (static_cast<double>(bbox.height) - in.rows) / 2;
+	rot(0, 2) += (static_cast<double>(bbox.width) - in.width) / 2;
+	rot(1, 2) += (static_cast<double>(bbox.height) - in.height) / 2;
+
+	out = bbox.size();
+	return rot;
+}
+}  // namespace
+
+bool Rotate::composeWarpImpl(Warp& w) const {
+	cv::Size size{};
+	const cv::Matx23d rot{rotation(cv::Size{w.cols, w.rows}, angle, size)};
+
+	// assume a white background
+	w.border = cv::BORDER_CONSTANT;
+	w.borderValue = {cst::max8bit, cst::max8bit, cst::max8bit, 0.0};
+	return composeAffine(w,
+						 {rot(0, 0), rot(0, 1), rot(0, 2), rot(1, 0),
+						  rot(1, 1), rot(1, 2)},
+						 size.height, size.width, cv::INTER_NEAREST);
+}
+
+bool Rotate::execute(const cv::Mat& in, cv::Mat& out) const {
+	cv::Size size{};
+	const cv::Matx23d rot{rotation(in.size(), angle, size)};
 
 	// assume a white background
-	cv::warpAffine(in, out, rot, bbox.size(), cv::INTER_NEAREST,
-				   cv::BORDER_CONSTANT,
+	cv::warpAffine(in, out, rot, size, cv::INTER_NEAREST, cv::BORDER_CONSTANT,
 				   cv::Scalar{cst::max8bit, cst::max8bit, cst::max8bit});
 	return true;
 }
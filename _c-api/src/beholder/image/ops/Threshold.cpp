@@ -4,6 +4,10 @@
 
 #include "beholder/image/ops/Threshold.h"
 
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <opencv2/core.hpp>
 #include <opencv2/core/mat.hpp>
 #include <opencv2/imgproc.hpp>
 #include <vector>
@@ -26,8 +30,97 @@ static_assert(Typ::ToZeroInv == cv::THRESH_TOZERO_INV);
 static_assert(Typ::Mask == cv::THRESH_MASK);
 static_assert(Typ::Otsu == cv::THRESH_OTSU);
 static_assert(Typ::Triangle == cv::THRESH_TRIANGLE);
+
+// Compute Otsu's threshold from a histogram.
+// Mirrors the computation cv::threshold does for 8-bit images, so that
+// the results are identical.
+double otsuThreshold(const ProcessingOp::Histogram& hist) {
+	std::size_t total{0};
+	double mu{0.0};
+	for (auto i{0UL}; i < hist.size(); ++i) {
+		total += hist[i];
+		mu += static_cast<double>(i) * static_cast<double>(hist[i]);
+	}
+	if (total == 0) {
+		return 0.0;
+	}
+	const double scale{1.0 / static_cast<double>(total)};
+	mu *= scale;
+
+	constexpr auto eps{std::numeric_limits<float>::epsilon()};
+	double mu1{0.0};
+	double q1{0.0};
+	double maxSigma{0.0};
+	double maxVal{0.0};
+	for (auto i{0UL}; i < hist.size(); ++i) {
+		const auto x{static_cast<double>(i)};
+		const double p{static_cast<double>(hist[i]) * scale};
+		mu1 *= q1;
+		q1 += p;
+		const double q2{1.0 - q1};
+		if (std::min(q1, q2) < eps || std::max(q1, q2) > 1.0 - eps) {
+			continue;
+		}
+		mu1 = (mu1 + x * p) / q1;
+		const double mu2{(mu - q1 * mu1) / q2};
+		const double sigma{q1 * q2 * (mu1 - mu2) * (mu1 - mu2)};
+		if (sigma > maxSigma) {
+			maxSigma = sigma;
+			maxVal = x;
+		}
+	}
+	return maxVal;
+}
 }  // namespace
 
+bool Threshold::isPointwiseImpl() const {
+	// triangle thresholding and unknown types are left to OpenCV
+	const int t{enums::to(type)};
+	return (t & cv::THRESH_TRIANGLE) == 0 &&
+		   (t & cv::THRESH_MASK) <= cv::THRESH_TOZERO_INV;
+}
+
+bool Threshold::needsHistogramImpl() const {
+	return (enums::to(type) & cv::THRESH_OTSU) != 0;
+}
+
+bool Threshold::composeLUTImpl(LUT& lut, const Histogram& hist) const {
+	if (!isPointwiseImpl()) {
+		return false;
+	}
+	const double thresh{needsHistogramImpl() ? otsuThreshold(hist)
+											 : static_cast<double>(threshold)};
+	// same rounding as cv::threshold for 8-bit images
+	const int t{cvFloor(thresh)};
+	const int maxv{cv::saturate_cast<uchar>(cvRound(maxValue))};
+	const int mode{enums::to(type) & cv::THRESH_MASK};
+	for (auto& v : lut) {
+		const int x{v};
+		int y{x};
+		switch (mode) {
+			case cv::THRESH_BINARY:
+				y = x > t ? maxv : 0;
+				break;
+			case cv::THRESH_BINARY_INV:
+				y = x > t ? 0 : maxv;
+				break;
+			case cv::THRESH_TRUNC:
+				y = x > t ? t : x;
+				break;
+			case cv::THRESH_TOZERO:
+				y = x > t ? x : 0;
+				break;
+			case cv::THRESH_TOZERO_INV:
+				y = x > t ? 0 : x;
+				break;
+			default:
+				return false;
+		}
+		v = cv::saturate_cast<uchar>(y);
+	}
+	return true;
+}
+
 bool Threshold::execute(const cv::Mat& in, cv::Mat& out) const {
 	cv::threshold(in, out, threshold, maxValue, enums::to(type));
 	return true;
@@ -19,6 +19,15 @@ namespace beholder {
 
 class Threshold : public ProcessingOp {
 protected:
+	// Check if the operation is a pointwise 8-bit mapping.
+	[[nodiscard]] bool isPointwiseImpl() const override;
+
+	// Check if the look-up table depends on the input histogram.
+	[[nodiscard]] bool needsHistogramImpl() const override;
+
+	// Compose the operation onto a look-up table.
+	bool composeLUTImpl(LUT& lut, const Histogram& hist) const override;
+
 	// Execute the processing operation.
 	bool execute(const cv::Mat& in, cv::Mat& out) const override;
 
@@ -14,12 +14,21 @@
 namespace beholder {
 
 bool UnsharpMask::execute(const cv::Mat& in, cv::Mat& out) const {
+	// draw scratch buffers from wherever the output comes from
 	cv::Mat blurred{};
+	cv::Mat mask{};
+	blurred.allocator = out.allocator;
+	mask.allocator = out.allocator;
+
 	cv::GaussianBlur(in, blurred, cv::Size{}, sigma, sigma);
-	const cv::Mat lowContrastMask{cv::abs(in - blurred) < threshold};
-	cv::Mat sharp{in * (1.0 + amount) + blurred * (-amount)};
-	in.copyTo(sharp, lowContrastMask);
-	out = sharp;
+	// same as abs(in - blurred) < threshold,
+	// but without the matrix expression temporaries
+	cv::absdiff(in, blurred, mask);
+	cv::compare(mask, threshold, mask, cv::CMP_LT);
+	// the sharpened image overwrites the blurred one
+	cv::addWeighted(in, 1.0 + amount, blurred, -amount, 0.0, blurred);
+	in.copyTo(blurred, mask);
+	out = blurred;
 	return true;
 }
 
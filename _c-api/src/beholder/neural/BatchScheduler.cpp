@@ -0,0 +1,126 @@
+// beholder - Copyright © 2024 Philipp Milovic
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "beholder/neural/BatchScheduler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <future>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "beholder/capi/Image.h"
+#include "beholder/neural/ObjDetector.h"
+
+namespace beholder {
+
+void BatchScheduler::run() {
+	std::vector<Request> batch;
+	std::vector<Image> imgs;
+	batch.reserve(maxBatch_);
+	imgs.reserve(maxBatch_);
+
+	std::unique_lock lock{mtx_};
+	while (true) {
+		cv_.wait(lock, [this]() { return stop_ || !queue_.empty(); });
+		if (stop_) {
+			break;
+		}
+		// wait for the batch to fill up, at most until the oldest request
+		// has waited for a whole window
+		const auto deadline{queue_.front().submitted + window_};
+		cv_.wait_until(lock, deadline, [this]() {
+			return stop_ || queue_.size() >= maxBatch_;
+		});
+		if (stop_) {
+			break;
+		}
+		const auto n{std::min(queue_.size(), maxBatch_)};
+		for (auto i{0UL}; i < n; ++i) {
+			batch.emplace_back(std::move(queue_.front()));
+			queue_.pop_front();
+		}
+		lock.unlock();
+
+		for (const auto& r : batch) {
+			imgs.emplace_back(r.img);
+		}
+		const auto start{Clock::now()};
+		bool ok{false};
+		try {
+			ok = det_->detectBatch(imgs);
+		} catch (const std::exception& e) {
+			std::cerr << "could not infer batch: " << e.what() << std::endl;
+		} catch (...) {
+			std::cerr << "could not infer batch" << std::endl;
+		}
+		const auto end{Clock::now()};
+
+		for (auto i{0UL}; i < batch.size(); ++i) {
+			BatchReply rep{};
+			rep.ok = ok;
+			if (ok) {
+				rep.results = det_->getBatchResults()[i];
+			}
+			rep.timing = BatchTiming{start - batch[i].submitted, end - start,
+									 batch.size()};
+			batch[i].reply.set_value(std::move(rep));
+		}
+		batch.clear();
+		imgs.clear();
+
+		lock.lock();
+	}
+	// fail the requests which were not inferred
+	for (auto& r : queue_) {
+		r.reply.set_value(BatchReply{});
+	}
+	queue_.clear();
+}
+
+BatchScheduler::BatchScheduler(ObjDetector& det, std::size_t maxBatch,
+							   std::chrono::microseconds window)
+	: det_{&det},
+	  maxBatch_{std::max(maxBatch, std::size_t{1})},
+	  window_{window},
+	  worker_{&BatchScheduler::run, this} {}
+
+BatchScheduler::~BatchScheduler() { stop(); }
+
+BatchReply BatchScheduler::detect(const Image& img) {
+	return submit(img).get();
+}
+
+void BatchScheduler::stop() noexcept {
+	{
+		const std::lock_guard lock{mtx_};
+		stop_ = true;
+	}
+	cv_.notify_all();
+	if (worker_.joinable()) {
+		worker_.join();
+	}
+}
+
+std::future<BatchReply> BatchScheduler::submit(const Image& img) {
+	Request r{img, Clock::now(), std::promise<BatchReply>{}};
+	auto fut{r.reply.get_future()};
+	{
+		const std::lock_guard lock{mtx_};
+		if (stop_) {
+			r.reply.set_value(BatchReply{});
+			return fut;
+		}
+		queue_.emplace_back(std::move(r));
+	}
+	cv_.notify_all();
+	return fut;
+}
+
+}  // namespace beholder
@@ -0,0 +1,123 @@
+// beholder - Copyright © 2024 Philipp Milovic
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// A dynamic batching front-end for object detectors.
+
+#ifndef BEHOLDER_NEURAL_BATCH_SCHEDULER_H
+#define BEHOLDER_NEURAL_BATCH_SCHEDULER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "beholder/capi/Image.h"
+#include "beholder/capi/Result.h"
+#include "beholder/neural/ObjDetector.h"
+
+namespace beholder {
+
+// The default max. number of images inferred at once.
+inline static constexpr std::size_t DfltMaxBatch{8};
+
+// The default time a request waits for others to share its batch with.
+inline static constexpr std::chrono::microseconds DfltBatchWindow{5000};
+
+// BatchTiming is the latency accounting of a single detection request.
+struct BatchTiming {
+	// Time from submission until the request's batch was inferred.
+	std::chrono::nanoseconds queued{0};
+	// Time spent inferring the request's batch.
+	std::chrono::nanoseconds inference{0};
+	// Number of images in the request's batch.
+	std::size_t batchSize{0};
+};
+
+// BatchReply holds the results of a single detection request.
+struct BatchReply {
+	// Whether inferencing succeeded.
+	bool ok{false};
+	// Detection results of the request's image.
+	std::vector<Result> results;
+	// Latency accounting of the request.
+	BatchTiming timing;
+};
+
+// BatchScheduler collects images submitted by several sources, eg. one
+// per camera, and infers them in batches on a worker thread of its own,
+// see ObjDetector::detectBatch.
+//
+// A batch is inferred once it holds 'maxBatch' images, or once its oldest
+// image has waited for 'window', whichever comes first, so each request
+// trades a bounded amount of latency for the throughput of batched
+// inference.
+//
+// NOTE: the detector must outlive the scheduler, and must not be used
+// elsewhere while the scheduler is running, since the worker thread
+// uses it without locking.
+class BatchScheduler {
+public:
+	using Clock = std::chrono::steady_clock;
+
+private:
+	// Request is a submitted image awaiting inference.
+	struct Request {
+		Image img;
+		Clock::time_point submitted;
+		std::promise<BatchReply> reply;
+	};
+
+	ObjDetector* det_;					   // the detector, not owned
+	std::size_t maxBatch_;				   // max. images per batch
+	std::chrono::microseconds window_;	   // max. wait for a full batch
+	std::mutex mtx_;					   // guards the queue
+	std::condition_variable cv_;		   // signals new requests
+	std::deque<Request> queue_;			   // submitted requests
+	bool stop_{false};					   // the worker should stop
+	std::thread worker_;				   // infers batches
+
+	// Infer batches until stopped, called on the worker thread.
+	void run();
+
+public:
+	// Construct a scheduler, and start its worker thread, which infers
+	// batches of up to 'maxBatch' images through 'det', waiting up to
+	// 'window' for a batch to fill up.
+	explicit BatchScheduler(ObjDetector& det,
+							std::size_t maxBatch = DfltMaxBatch,
+							std::chrono::microseconds window = DfltBatchWindow);
+
+	BatchScheduler(const BatchScheduler&) = delete;
+	BatchScheduler(BatchScheduler&&) = delete;
+
+	// Destructor, stops the worker thread.
+	~BatchScheduler();
+
+	BatchScheduler& operator=(const BatchScheduler&) = delete;
+	BatchScheduler& operator=(BatchScheduler&&) = delete;
+
+	// Submit an image and wait for its results.
+	// Thread-safe.
+	BatchReply detect(const Image& img);
+
+	// Stop the worker thread, waiting for it to exit.
+	// Requests which were not inferred yet fail.
+	void stop() noexcept;
+
+	// Submit an image for inference, and return a future of its results.
+	// Requests submitted after the scheduler was stopped fail.
+	// Thread-safe.
+	//
+	// WARNING: the image buffer must stay valid until the results are
+	// available.
+	std::future<BatchReply> submit(const Image& img);
+};
+
+}  // namespace beholder
+
+#endif	// BEHOLDER_NEURAL_BATCH_SCHEDULER_H
@@ -7,7 +7,10 @@
 #ifndef BEHOLDER_NEURAL_H
 #define BEHOLDER_NEURAL_H
 
+#include "beholder/neural/BatchScheduler.h"
 #include "beholder/neural/CRAFTDetector.h"
+#include "beholder/neural/DetectorPipeline.h"
+#include "beholder/neural/DetectorPool.h"
 #include "beholder/neural/EASTDetector.h"
 #include "beholder/neural/ObjDetector.h"
 #include "beholder/neural/PARSeqDetector.h"
@@ -5,6 +5,7 @@
 #include "beholder/neural/CRAFTDetector.h"
 
 #include <cmath>
+#include <memory>
 #include <opencv2/core.hpp>
 #include <opencv2/core/fast_math.hpp>
 #include <opencv2/core/mat.hpp>
@@ -21,16 +22,24 @@
 namespace beholder {
 
 // NOLINTBEGIN(*-magic-numbers)
-void CRAFTDetector::extract() {
+void CRAFTDetector::extract(int n) {
 	if (buf_->outs.size() != 2) {
 		return;
 	}
-	cv::Mat out{};
-	transposeND(buf_->outs[0], std::vector<int>{0, 3, 1, 2}, out);
-	const cv::Mat textmap{out.size[2], out.size[3], CV_32F,
-						  out.ptr<float>(0, 0)};
-	const cv::Mat linkmap{out.size[2], out.size[3], CV_32F,
-						  out.ptr<float>(0, 1)};
+	cv::Mat& outs{buf_->outs[0]};
+	if (outs.dims != 4 || outs.size[0] <= n || outs.size[3] != 2 ||
+		outs.type() != CV_32FC1 || !outs.isContinuous()) {
+		return;
+	}
+	// only the n-th image's output, [N, H, W, 2] -> [H, W, 2], is viewed
+	// as a 2-channel map and split into the text and the link map,
+	// instead of transposing the whole batch
+	const cv::Mat out{outs.size[1], outs.size[2], CV_32FC2,
+					  outs.ptr<float>(n)};
+	std::vector<cv::Mat> maps;
+	cv::split(out, maps);
+	const cv::Mat& textmap{maps[0]};
+	const cv::Mat& linkmap{maps[1]};
 
 	/* TODO: do some assertions here
 	if
@@ -156,6 +165,15 @@ void CRAFTDetector::store() {
 	}
 }
 
+std::unique_ptr<ObjDetector> CRAFTDetector::clone() const {
+	auto d{std::make_unique<CRAFTDetector>()};
+	copyConfig(*d);
+	d->textThreshold = textThreshold;
+	d->linkThreshold = linkThreshold;
+	d->lowText = lowText;
+	return d;
+}
+
 CRAFTDetector::CRAFTDetector() {
 	// For more info, see:
 	// https://github.com/clovaai/CRAFT-pytorch/blob/e332dd8b718e291f51b66ff8f9ef2c98ee4474c8/imgproc.py#L20
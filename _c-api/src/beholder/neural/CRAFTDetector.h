@@ -9,6 +9,7 @@
 #define BEHOLDER_NEURAL_CRAFT_DETECTOR_H
 
 #include <array>
+#include <memory>
 
 #include "beholder/neural/ObjDetector.h"
 
@@ -26,7 +27,7 @@ protected:
 	// Extract inference results
 	// TODO: extract confidences from NN output
 	// TODO: clean up and optimize if possible
-	void extract() override;
+	void extract(int n) override;
 
 	// Store results
 	// NOTE: has to happen after re-mapping from blob back to the image
@@ -51,6 +52,9 @@ public:
 
 	CRAFTDetector& operator=(const CRAFTDetector&) = delete;
 	CRAFTDetector& operator=(CRAFTDetector&&) = default;
+
+	// Construct an uninitialized detector with the same configuration.
+	[[nodiscard]] std::unique_ptr<ObjDetector> clone() const override;
 };
 
 }  // namespace beholder
@@ -0,0 +1,147 @@
+// beholder - Copyright © 2024 Philipp Milovic
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "beholder/neural/DetectorPipeline.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include "beholder/capi/Image.h"
+#include "beholder/image/Processor.h"
+#include "beholder/neural/ObjDetector.h"
+#include "beholder/neural/internal/ObjDetectorImpl.h"
+
+namespace beholder {
+
+void DetectorPipeline::complete(Request& r) {
+	r.rep.timing.latency = Clock::now() - r.submitted;
+	jobs_.emplace_back(std::move(r.job));
+	r.reply.set_value(std::move(r.rep));
+}
+
+bool DetectorPipeline::forward(Request& r) {
+	const auto start{Clock::now()};
+	const auto ok{det_->forward(*r.job)};
+	r.rep.timing.forward = Clock::now() - start;
+	return ok;
+}
+
+bool DetectorPipeline::postprocess(Request& r) {
+	const auto start{Clock::now()};
+	const auto ok{det_->postprocess(*r.job, r.rep.results)};
+	r.rep.timing.postprocess = Clock::now() - start;
+	return ok;
+}
+
+bool DetectorPipeline::preprocess(Request& r) {
+	const auto start{Clock::now()};
+	auto ok{conv_.viewRawImage(r.img, {}, RawOutput::Color)};
+	ok = ok && det_->preprocess(conv_.getRawImage(), *r.job);
+	conv_.releaseRawImage();
+	r.rep.timing.preprocess = Clock::now() - start;
+	return ok;
+}
+
+void DetectorPipeline::run(std::deque<Request>& in, std::deque<Request>* out,
+						   Stage stage) {
+	std::unique_lock lock{mtx_};
+	while (true) {
+		cv_.wait(lock, [this, &in]() { return stop_ || !in.empty(); });
+		if (stop_) {
+			break;
+		}
+		Request r{std::move(in.front())};
+		in.pop_front();
+		lock.unlock();
+
+		bool ok{false};
+		try {
+			ok = (this->*stage)(r);
+		} catch (const std::exception& e) {
+			std::cerr << "could not run pipeline stage: " << e.what()
+					  << std::endl;
+		} catch (...) {
+			std::cerr << "could not run pipeline stage" << std::endl;
+		}
+
+		lock.lock();
+		if (ok && out) {
+			out->emplace_back(std::move(r));
+		} else {
+			r.rep.ok = ok;
+			complete(r);
+		}
+		cv_.notify_all();
+	}
+}
+
+DetectorPipeline::DetectorPipeline(ObjDetector& det, std::size_t depth)
+	: det_{&det}, depth_{std::max(depth, std::size_t{1})} {
+	jobs_.reserve(depth_);
+	for (auto i{0UL}; i < depth_; ++i) {
+		jobs_.emplace_back(std::make_unique<internal::ObjDetectorJob>());
+	}
+	prep_ = std::thread{&DetectorPipeline::run, this, std::ref(prepQ_),
+						&fwdQ_, &DetectorPipeline::preprocess};
+	fwd_ = std::thread{&DetectorPipeline::run, this, std::ref(fwdQ_),
+					   &postQ_, &DetectorPipeline::forward};
+	post_ = std::thread{&DetectorPipeline::run, this, std::ref(postQ_),
+						nullptr, &DetectorPipeline::postprocess};
+}
+
+DetectorPipeline::~DetectorPipeline() { stop(); }
+
+void DetectorPipeline::stop() noexcept {
+	{
+		const std::lock_guard lock{mtx_};
+		stop_ = true;
+	}
+	cv_.notify_all();
+	for (auto* t : {&prep_, &fwd_, &post_}) {
+		if (t->joinable()) {
+			t->join();
+		}
+	}
+	// fail the requests which were not completed
+	const std::lock_guard lock{mtx_};
+	for (auto* q : {&prepQ_, &fwdQ_, &postQ_}) {
+		for (auto& r : *q) {
+			r.rep.ok = false;
+			r.rep.results.clear();
+			complete(r);
+		}
+		q->clear();
+	}
+}
+
+std::future<PipelineReply> DetectorPipeline::submit(const Image& img) {
+	Request r{img, Clock::now(), nullptr, std::promise<PipelineReply>{},
+			  PipelineReply{}};
+	auto fut{r.reply.get_future()};
+	{
+		std::unique_lock lock{mtx_};
+		// each request in the pipeline holds a job, so wait for one
+		cv_.wait(lock, [this]() { return stop_ || !jobs_.empty(); });
+		if (stop_) {
+			r.reply.set_value(PipelineReply{});
+			return fut;
+		}
+		r.job = std::move(jobs_.back());
+		jobs_.pop_back();
+		prepQ_.emplace_back(std::move(r));
+	}
+	cv_.notify_all();
+	return fut;
+}
+
+}  // namespace beholder
@@ -0,0 +1,145 @@
+// beholder - Copyright © 2024 Philipp Milovic
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// An asynchronous, pipelined front-end for object detectors.
+
+#ifndef BEHOLDER_NEURAL_DETECTOR_PIPELINE_H
+#define BEHOLDER_NEURAL_DETECTOR_PIPELINE_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "beholder/capi/Image.h"
+#include "beholder/capi/Result.h"
+#include "beholder/image/Processor.h"
+#include "beholder/neural/ObjDetector.h"
+
+namespace beholder {
+
+// The default max. number of images in the pipeline at once.
+inline static constexpr std::size_t DfltPipelineDepth{3};
+
+// PipelineTiming is the latency accounting of a single detection request.
+struct PipelineTiming {
+	// Time spent converting the image into a blob.
+	std::chrono::nanoseconds preprocess{0};
+	// Time spent passing the blob through the network.
+	std::chrono::nanoseconds forward{0};
+	// Time spent extracting and filtering the results.
+	std::chrono::nanoseconds postprocess{0};
+	// Time from submission until the results were available.
+	std::chrono::nanoseconds latency{0};
+};
+
+// PipelineReply holds the results of a single detection request.
+struct PipelineReply {
+	// Whether inferencing succeeded.
+	bool ok{false};
+	// Detection results of the request's image.
+	std::vector<Result> results;
+	// Latency accounting of the request.
+	PipelineTiming timing;
+};
+
+// DetectorPipeline runs the stages of a detection, i.e. preprocessing,
+// the forward pass and postprocessing, each on a worker thread of its own,
+// so that, eg. image N+1 is letterboxed and image N-1 is filtered (NMS)
+// while image N is passed through the network, see ObjDetector::preprocess.
+//
+// Images are converted to color (BGR) while they are preprocessed, so raw
+// camera images, eg. Mono8 or Bayer, can be submitted as they are, and
+// images which are already BGR are used in place.
+//
+// Images pass through the pipeline in the order in which they were
+// submitted. At most 'depth' images are in the pipeline at once, further
+// submissions wait until an image leaves the pipeline, so a slow network
+// throttles its source instead of accumulating images.
+//
+// NOTE: the detector must outlive the pipeline, and must not be used
+// elsewhere while the pipeline is running, since the worker threads
+// use it without locking.
+class DetectorPipeline {
+public:
+	using Clock = std::chrono::steady_clock;
+
+private:
+	// Request is a submitted image passing through the pipeline.
+	struct Request {
+		Image img;
+		Clock::time_point submitted;
+		std::unique_ptr<internal::ObjDetectorJob> job;
+		std::promise<PipelineReply> reply;
+		PipelineReply rep;	// the reply being assembled
+	};
+
+	// A stage processes a request, and returns false if it failed.
+	using Stage = bool (DetectorPipeline::*)(Request&);
+
+	ObjDetector* det_;	   // the detector, not owned
+	Processor conv_;	   // converts images to BGR, used by prep_ only
+	std::size_t depth_;	   // max. images in the pipeline
+	std::mutex mtx_;	   // guards everything below
+	std::condition_variable cv_;  // signals queue and capacity changes
+	std::vector<std::unique_ptr<internal::ObjDetectorJob>> jobs_;  // idle
+	std::deque<Request> prepQ_;	  // requests awaiting preprocessing
+	std::deque<Request> fwdQ_;	  // requests awaiting the forward pass
+	std::deque<Request> postQ_;	  // requests awaiting postprocessing
+	bool stop_{false};			  // the workers should stop
+	std::thread prep_;			  // preprocesses requests
+	std::thread fwd_;			  // passes requests through the network
+	std::thread post_;			  // postprocesses requests
+
+	// Complete a request, i.e. return its job and fulfill its promise.
+	// The lock must be held.
+	void complete(Request& r);
+
+	// Stages, called on the worker threads.
+	bool forward(Request& r);
+	bool postprocess(Request& r);
+	bool preprocess(Request& r);
+
+	// Run 'stage' on requests taken from 'in' until stopped, and pass them
+	// on to 'out', or complete them if 'out' is a nullptr or if the stage
+	// failed. Called on the worker threads.
+	void run(std::deque<Request>& in, std::deque<Request>* out, Stage stage);
+
+public:
+	// Construct a pipeline, and start its worker threads, which pass
+	// up to 'depth' images through 'det' at once.
+	explicit DetectorPipeline(ObjDetector& det,
+							  std::size_t depth = DfltPipelineDepth);
+
+	DetectorPipeline(const DetectorPipeline&) = delete;
+	DetectorPipeline(DetectorPipeline&&) = delete;
+
+	// Destructor, stops the worker threads.
+	~DetectorPipeline();
+
+	DetectorPipeline& operator=(const DetectorPipeline&) = delete;
+	DetectorPipeline& operator=(DetectorPipeline&&) = delete;
+
+	// Stop the worker threads, waiting for them to exit.
+	// Requests which were not completed yet fail.
+	void stop() noexcept;
+
+	// Submit an image for inference, and return a future of its results.
+	// Waits if the pipeline is full. Requests submitted after
+	// the pipeline was stopped fail.
+	// Thread-safe.
+	//
+	// WARNING: the image buffer must stay valid until the results are
+	// available.
+	std::future<PipelineReply> submit(const Image& img);
+};
+
+}  // namespace beholder
+
+#endif	// BEHOLDER_NEURAL_DETECTOR_PIPELINE_H
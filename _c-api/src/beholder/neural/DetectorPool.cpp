@@ -0,0 +1,99 @@
+// beholder - Copyright © 2024 Philipp Milovic
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "beholder/neural/DetectorPool.h"
+
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "beholder/neural/ObjDetector.h"
+
+namespace beholder {
+
+ObjDetector* DetectorPool::acquire() {
+	std::unique_lock lock{mtx_};
+	if (dets_.empty()) {
+		return nullptr;
+	}
+	cv_.wait(lock, [this]() { return !idle_.empty(); });
+	ObjDetector* det{idle_.back()};
+	idle_.pop_back();
+	return det;
+}
+
+std::size_t DetectorPool::idle() const {
+	const std::lock_guard lock{mtx_};
+	return idle_.size();
+}
+
+bool DetectorPool::init(const ObjDetector& proto, std::size_t n) {
+	dets_.clear();
+	{
+		const std::lock_guard lock{mtx_};
+		idle_.clear();
+	}
+	// read the model once, and initialize all instances from memory
+	const auto path{std::filesystem::path{proto.modelPath} / proto.model};
+	std::ifstream f{path, std::ios::binary};
+	if (!f) {
+		std::cerr << "could not open model file: " << path << std::endl;
+		return false;
+	}
+	const std::vector<unsigned char> weights{
+		std::istreambuf_iterator<char>{f}, std::istreambuf_iterator<char>{}};
+	if (weights.empty()) {
+		std::cerr << "could not read model file: " << path << std::endl;
+		return false;
+	}
+
+	std::vector<std::unique_ptr<ObjDetector>> dets;
+	dets.reserve(n);
+	for (auto i{0UL}; i < n; ++i) {
+		auto det{proto.clone()};
+		if (!det || !det->init(weights)) {
+			std::cerr << "could not initialize detector " << i << std::endl;
+			return false;
+		}
+		dets.emplace_back(std::move(det));
+	}
+	dets_ = std::move(dets);
+
+	const std::lock_guard lock{mtx_};
+	for (const auto& det : dets_) {
+		idle_.emplace_back(det.get());
+	}
+	return true;
+}
+
+void DetectorPool::release(ObjDetector* det) {
+	if (!det) {
+		return;
+	}
+	{
+		const std::lock_guard lock{mtx_};
+		idle_.emplace_back(det);
+	}
+	cv_.notify_one();
+}
+
+std::size_t DetectorPool::size() const noexcept { return dets_.size(); }
+
+ObjDetector* DetectorPool::tryAcquire() {
+	const std::lock_guard lock{mtx_};
+	if (idle_.empty()) {
+		return nullptr;
+	}
+	ObjDetector* det{idle_.back()};
+	idle_.pop_back();
+	return det;
+}
+
+}  // namespace beholder
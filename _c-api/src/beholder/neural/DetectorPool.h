@@ -0,0 +1,88 @@
+// beholder - Copyright © 2024 Philipp Milovic
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// A pool of object detectors for multi-threaded inference.
+
+#ifndef BEHOLDER_NEURAL_DETECTOR_POOL_H
+#define BEHOLDER_NEURAL_DETECTOR_POOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "beholder/neural/ObjDetector.h"
+
+namespace beholder {
+
+// DetectorPool holds several instances of the same detector, so that
+// several threads can run inference at once, each on an instance checked
+// out of the pool, eg. one inference stream per physical core.
+//
+// The model file is read only once, and each instance is initialized
+// from the in-memory copy, so the model is read from disk, or extracted,
+// only once, regardless of the number of instances.
+//
+// NOTE: each instance is a separate network, and OpenCV's DNN module
+// doesn't share weights between networks, so each instance still holds
+// a copy of the parsed weights.
+// NOTE: OpenCV parallelizes each forward pass over all cores by default,
+// so with one instance per core, OpenCV's thread count should usually be
+// reduced, see cv::setNumThreads.
+class DetectorPool {
+private:
+	std::vector<std::unique_ptr<ObjDetector>> dets_;  // all instances
+	mutable std::mutex mtx_;						  // guards idle_
+	std::condition_variable cv_;					  // signals returns
+	std::vector<ObjDetector*> idle_;  // instances which are not checked out
+
+public:
+	// Default constructor.
+	DetectorPool() = default;
+
+	DetectorPool(const DetectorPool&) = delete;
+	DetectorPool(DetectorPool&&) = delete;
+
+	// Default destructor.
+	// NOTE: all instances must be returned before the pool is destroyed.
+	~DetectorPool() = default;
+
+	DetectorPool& operator=(const DetectorPool&) = delete;
+	DetectorPool& operator=(DetectorPool&&) = delete;
+
+	// Check out an instance, waiting until one is returned if all of them
+	// are checked out. Returns a nullptr if the pool is empty.
+	// Thread-safe.
+	[[nodiscard]] ObjDetector* acquire();
+
+	// Get the number of instances which are not checked out.
+	// Thread-safe.
+	[[nodiscard]] std::size_t idle() const;
+
+	// Initialize the pool with 'n' instances of 'proto', i.e. detectors
+	// of the same type and configuration, see ObjDetector::clone.
+	// 'proto' itself is not used and need not be initialized.
+	// Returns false if the model could not be read, or if an instance
+	// could not be initialized, in which case the pool is empty.
+	//
+	// NOTE: the pool must not be initialized while instances are
+	// checked out.
+	bool init(const ObjDetector& proto, std::size_t n);
+
+	// Return an instance checked out by acquire().
+	// Thread-safe.
+	void release(ObjDetector* det);
+
+	// Get the number of instances.
+	[[nodiscard]] std::size_t size() const noexcept;
+
+	// Check out an instance, if one is idle, otherwise return a nullptr.
+	// Thread-safe.
+	[[nodiscard]] ObjDetector* tryAcquire();
+};
+
+}  // namespace beholder
+
+#endif	// BEHOLDER_NEURAL_DETECTOR_POOL_H
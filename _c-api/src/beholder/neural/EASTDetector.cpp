@@ -6,6 +6,7 @@
 
 #include <array>
 #include <cmath>
+#include <memory>
 #include <opencv2/core.hpp>
 #include <opencv2/core/fast_math.hpp>
 #include <opencv2/core/mat.hpp>
@@ -17,7 +18,7 @@
 namespace beholder {
 
 // NOLINTBEGIN(*-magic-numbers, cppcoreguidelines-pro-bounds-pointer-arithmetic)
-void EASTDetector::extract() {
+void EASTDetector::extract(int n) {
 	if (buf_->outs.size() != 2) {
 		return;
 	}
@@ -25,8 +26,8 @@ void EASTDetector::extract() {
 	cv::Mat geometry{buf_->outs[0]};
 	cv::Mat confsMap{buf_->outs[1]};
 
-	if (confsMap.dims != 4 || geometry.dims != 4 || confsMap.size[0] != 1 ||
-		geometry.size[0] != 1 || confsMap.size[1] != 1 ||
+	if (confsMap.dims != 4 || geometry.dims != 4 || confsMap.size[0] <= n ||
+		geometry.size[0] <= n || confsMap.size[1] != 1 ||
 		geometry.size[1] != 5 || confsMap.size[2] != geometry.size[2] ||
 		confsMap.size[3] != geometry.size[3] || confsMap.type() != CV_32FC1 ||
 		geometry.type() != CV_32FC1) {
@@ -36,12 +37,12 @@ void EASTDetector::extract() {
 	const int height{confsMap.size[2]};
 	const int width{confsMap.size[3]};
 	for (auto y{0}; y < height; ++y) {
-		const float* confs = confsMap.ptr<float>(0, 0, y);
-		const float* x0s = geometry.ptr<float>(0, 0, y);
-		const float* x1s = geometry.ptr<float>(0, 1, y);
-		const float* x2s = geometry.ptr<float>(0, 2, y);
-		const float* x3s = geometry.ptr<float>(0, 3, y);
-		const float* angles = geometry.ptr<float>(0, 4, y);
+		const float* confs = confsMap.ptr<float>(n, 0, y);
+		const float* x0s = geometry.ptr<float>(n, 0, y);
+		const float* x1s = geometry.ptr<float>(n, 1, y);
+		const float* x2s = geometry.ptr<float>(n, 2, y);
+		const float* x3s = geometry.ptr<float>(n, 3, y);
+		const float* angles = geometry.ptr<float>(n, 4, y);
 		for (auto x{0}; x < width; ++x) {
 			const float conf{confs[x]};
 			if (conf < confidenceThreshold) {
@@ -91,6 +92,12 @@ void EASTDetector::store() {
 	}
 }
 
+std::unique_ptr<ObjDetector> EASTDetector::clone() const {
+	auto d{std::make_unique<EASTDetector>()};
+	copyConfig(*d);
+	return d;
+}
+
 EASTDetector::EASTDetector() {
 	// For more info, see:
 	// https://docs.opencv.org/4.10.0/d4/d43/tutorial_dnn_text_spotting.html
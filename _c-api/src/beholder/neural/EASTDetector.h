@@ -9,6 +9,7 @@
 #define BEHOLDER_NEURAL_EAST_DETECTOR_H
 
 #include <array>
+#include <memory>
 
 #include "beholder/neural/ObjDetector.h"
 
@@ -24,7 +25,7 @@ public:
 
 protected:
 	// Extract inference results.
-	void extract() override;
+	void extract(int n) override;
 
 	// Filter (NMS) and store results.
 	void store() override;
@@ -40,6 +41,9 @@ public:
 
 	EASTDetector& operator=(const EASTDetector&) = delete;
 	EASTDetector& operator=(EASTDetector&&) = default;
+
+	// Construct an uninitialized detector with the same configuration.
+	[[nodiscard]] std::unique_ptr<ObjDetector> clone() const override;
 };
 
 }  // namespace beholder
@@ -6,7 +6,9 @@
 
 #include <filesystem>
 #include <memory>
+#include <opencv2/core/mat.hpp>
 #include <opencv2/dnn/dnn.hpp>
+#include <utility>
 #include <vector>
 
 #include "beholder/capi/Image.h"
@@ -61,6 +63,23 @@ void ObjDetector::clear() {
 		buf_->clear();
 	}
 	res_.clear();
+	batch_.clear();
+}
+
+void ObjDetector::copyConfig(ObjDetector& to) const {
+	to.resizeMode_ = resizeMode_;
+	to.modelPath = modelPath;
+	to.model = model;
+	to.backend = backend;
+	to.target = target;
+	to.classes = classes;
+	to.size = size;
+	to.scale = scale;
+	to.confidenceThreshold = confidenceThreshold;
+	to.nmsThreshold = nmsThreshold;
+	to.mean = mean;
+	to.swapRB = swapRB;
+	to.padValue = padValue;
 }
 
 bool ObjDetector::detect(const Image& raw) {
@@ -81,7 +100,7 @@ bool ObjDetector::detect(const Image& raw) {
 	// XXX: what were we talking about here?
 	impl_->infer(buf_->outs);
 
-	extract();
+	extract(0);
 	impl_->transferBoxes(buf_->tBoxes, img->size());
 
 	// store results
@@ -90,9 +109,71 @@ bool ObjDetector::detect(const Image& raw) {
 	return !res_.empty();
 }
 
+bool ObjDetector::detectBatch(const std::vector<Image>& raws) {
+	clear();
+
+	if (!impl_ || impl_->empty() || raws.empty()) {
+		return false;
+	}
+	// the matrices only refer to the raw image buffers, so they're cheap
+	std::vector<cv::Mat> imgs;
+	imgs.reserve(raws.size());
+	for (const auto& raw : raws) {
+		auto img{rawToMatPtr(raw)};
+		if (!img) {
+			return false;
+		}
+		imgs.emplace_back(std::move(*img));
+	}
+	impl_->setInputs(imgs);
+	impl_->infer(buf_->outs);
+
+	// extract and store the results of each image separately, reusing
+	// the temporaries, since the boxes are mapped back per image
+	batch_.resize(imgs.size());
+	for (auto n{0UL}; n < imgs.size(); ++n) {
+		buf_->clearExtracted();
+		res_.clear();
+		extract(static_cast<int>(n));
+		impl_->transferBoxes(buf_->tBoxes, imgs[n].size());
+		store();
+		batch_[n].swap(res_);
+	}
+	res_.clear();
+
+	return true;
+}
+
+bool ObjDetector::forward(internal::ObjDetectorJob& job) {
+	if (!impl_ || impl_->empty() || job.blob.empty()) {
+		return false;
+	}
+	impl_->infer(job.blob, job.outs);
+	return true;
+}
+
+const std::vector<std::vector<Result>>& ObjDetector::getBatchResults() const {
+	return batch_;
+}
+
 const std::vector<Result>& ObjDetector::getResults() const { return res_; }
 
 bool ObjDetector::init() {
+	makeImpl();
+	return impl_->makeNet(std::filesystem::path{modelPath} / model,
+						  enums::from<cv::dnn::Backend>(backend),
+						  enums::from<cv::dnn::Target>(target));
+}
+
+bool ObjDetector::init(const std::vector<unsigned char>& weights) {
+	makeImpl();
+	return impl_->makeNet(weights,
+						  std::filesystem::path{model}.extension().string(),
+						  enums::from<cv::dnn::Backend>(backend),
+						  enums::from<cv::dnn::Target>(target));
+}
+
+void ObjDetector::makeImpl() {
 	buf_ = std::make_unique<internal::ObjDetectorBuffers>();
 	impl_ = std::make_unique<internal::ObjDetectorImpl>();
 	impl_->makeParams(cv::Scalar{scale[0], scale[1], scale[2]},
@@ -100,9 +181,41 @@ bool ObjDetector::init() {
 					  cv::Scalar{mean[0], mean[1], mean[2]}, swapRB,
 					  enums::from<cv::dnn::ImagePaddingMode>(resizeMode_),
 					  cv::Scalar{padValue[0], padValue[1], padValue[2]});
-	return impl_->makeNet(std::filesystem::path{modelPath} / model,
-						  enums::from<cv::dnn::Backend>(backend),
-						  enums::from<cv::dnn::Target>(target));
+}
+
+bool ObjDetector::postprocess(internal::ObjDetectorJob& job,
+							  std::vector<Result>& res) {
+	res.clear();
+	if (!impl_ || !buf_) {
+		return false;
+	}
+	buf_->clear();
+	res_.clear();
+	// borrow the forward results, and hand them back afterwards, so that
+	// the job keeps the allocated memory
+	buf_->outs.swap(job.outs);
+	extract(0);
+	impl_->transferBoxes(buf_->tBoxes, job.size);
+	store();
+	buf_->outs.swap(job.outs);
+	res.swap(res_);
+
+	return true;
+}
+
+bool ObjDetector::preprocess(const Image& raw,
+							 internal::ObjDetectorJob& job) const {
+	// NOTE: the network isn't checked, since it may be in use by forward
+	if (!impl_) {
+		return false;
+	}
+	auto img{rawToMatPtr(raw)};
+	if (!img) {
+		return false;
+	}
+	job.size = img->size();
+	impl_->makeBlob(*img, job.blob);
+	return true;
 }
 
 }  // namespace beholder
@@ -20,6 +20,7 @@ namespace beholder {
 namespace internal {
 class ObjDetectorBuffers;  // forward declaration
 class ObjDetectorImpl;	   // forward declaration
+class ObjDetectorJob;	   // forward declaration
 }  // namespace internal
 
 // WARNING: these are OpenCV supported backends, so they will get changed in the
@@ -90,20 +91,33 @@ protected:
 	// detection results
 	std::vector<Result> res_;
 
+	// detection results of each image of the last batch, see detectBatch
+	std::vector<std::vector<Result>> batch_;
+
 	// Image padding/resize mode when converting to blob.
 	// Should usually be set by the model, not at runtime.
 	// TODO: should letterboxing be the default?
 	ResizeMode resizeMode_{ResizeMode::ResizeLetterbox};
 
-	// Extract and store inference results
+	// Extract and store inference results of the n-th image of the batch,
+	// i.e. of the image at index 'n' of the output blobs' first dimension.
 	// TODO: we would like to time this externally, somehow
 	// TODO: should return an error of some kind
-	virtual void extract() = 0;
+	virtual void extract(int n) = 0;
 
 	// Store extracted results from the buffer after mapping bounding
 	// boxes from the blob back to the image.
 	virtual void store() = 0;
 
+	// Copy the configuration, i.e. the public parameters and the resize
+	// mode, to 'to', but not the network, buffers or results.
+	// Used by derived classes to implement clone().
+	void copyConfig(ObjDetector& to) const;
+
+	// Make the network implementation and the buffers, but not
+	// the network itself.
+	void makeImpl();
+
 public:
 	// Directory path of the model (weights) file.
 	std::string modelPath;
@@ -168,15 +182,69 @@ public:
 	// Clear detection results.
 	virtual void clear();
 
+	// Construct an uninitialized detector of the same type with the same
+	// configuration, eg. to run several instances of the same model
+	// concurrently, see DetectorPool.
+	[[nodiscard]] virtual std::unique_ptr<ObjDetector> clone() const = 0;
+
 	// Run inferencing and store the results.
 	// NOTE: the results are cleared as soon as detect is called.
 	virtual bool detect(const Image& raw);
 
+	// Run inferencing on several images at once and store the results
+	// of each image, see getBatchResults.
+	// Returns false if there are no images, or if inferencing failed,
+	// but not if nothing was detected, unlike detect.
+	//
+	// The images are packed into a single blob and passed through
+	// the network in a single forward pass, which amortizes the per-call
+	// overhead when there are many small inputs, eg. text crops.
+	// NOTE: the results are cleared as soon as detectBatch is called.
+	// NOTE: the model has to have a dynamic batch dimension.
+	virtual bool detectBatch(const std::vector<Image>& raws);
+
+	// Pass an image preprocessed by preprocess through the network,
+	// the second stage of an asynchronous detection.
+	// Returns false if the detector is not initialized, or if the image
+	// was not preprocessed.
+	bool forward(internal::ObjDetectorJob& job);
+
+	// Get a const reference to the detection results of each image
+	// of the last batch, in the order in which the images were supplied.
+	[[nodiscard]] const std::vector<std::vector<Result>>&
+	getBatchResults() const;
+
 	// Get a const reference to the detection results.
 	[[nodiscard]] const std::vector<Result>& getResults() const;
 
 	// Initialize the object detector.
 	virtual bool init();
+
+	// Initialize the object detector from the contents of the model file,
+	// already read into memory, instead of reading the model file.
+	// The model's format is deduced from the extension of 'model',
+	// only ONNX and TensorFlow models are supported.
+	virtual bool init(const std::vector<unsigned char>& weights);
+
+	// Extract the results of an image passed through the network
+	// by forward, and store them into 'res', the last stage of
+	// an asynchronous detection.
+	// Returns false if the detector is not initialized, but not if
+	// nothing was detected, unlike detect.
+	// NOTE: overwrites the results of the last detect.
+	bool postprocess(internal::ObjDetectorJob& job, std::vector<Result>& res);
+
+	// Convert an image into a blob, the first stage of an asynchronous
+	// detection, see DetectorPipeline.
+	// Returns false if the detector is not initialized, or if the image
+	// is invalid.
+	//
+	// The stages of different images may run concurrently, each on
+	// a thread of its own, i.e. an image can be preprocessed while
+	// another is passed through the network and a third is postprocessed.
+	// The stages of each image must be called in order, and detect must
+	// not be called while stages are running.
+	bool preprocess(const Image& raw, internal::ObjDetectorJob& job) const;
 };
 
 }  // namespace beholder
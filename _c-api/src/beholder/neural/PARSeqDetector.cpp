@@ -5,6 +5,7 @@
 #include "beholder/neural/PARSeqDetector.h"
 
 #include <cmath>
+#include <memory>
 #include <opencv2/core.hpp>
 #include <opencv2/core/fast_math.hpp>
 #include <opencv2/core/mat.hpp>
@@ -17,16 +18,16 @@
 
 namespace beholder {
 
-void PARSeqDetector::extract() {
+void PARSeqDetector::extract(int n) {
 	if (buf_->outs.size() != 1) {
 		return;
 	}
-	// for the pretrained model, the output should be [1, 26, 95],
+	// for the pretrained model, the output should be [N, 26, 95],
 	// 25+1 positions (results) for 1+94 chars (the first char is a blank)
 	const int chsetLen{static_cast<int>(charset.size())};
 	cv::Mat out{buf_->outs[0]};
-	if (out.size[1] != nPos || out.size[2] != chsetLen + 1 ||
-		out.type() != CV_32FC1) {
+	if (out.dims != 3 || out.size[0] <= n || out.size[1] != nPos ||
+		out.size[2] != chsetLen + 1 || out.type() != CV_32FC1) {
 		return;
 	}
 
@@ -35,7 +36,7 @@ void PARSeqDetector::extract() {
 
 	// TODO: pull this out, we should be able to use different decoders
 	for (auto pos{0}; pos < nPos; ++pos) {
-		const float* pred{out.ptr<float>(0, pos)};
+		const float* pred{out.ptr<float>(n, pos)};
 
 		int maxLoc{0};	// index of the max score
 		// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
@@ -64,6 +65,13 @@ void PARSeqDetector::extract() {
 	}
 }
 
+std::unique_ptr<ObjDetector> PARSeqDetector::clone() const {
+	auto d{std::make_unique<PARSeqDetector>()};
+	copyConfig(*d);
+	d->charset = charset;
+	return d;
+}
+
 PARSeqDetector::PARSeqDetector() {
 	// no padding or cropping, the input image should be just the
 	// word/character sequence which is to be evaluated/recognized
@@ -9,6 +9,7 @@
 #define BEHOLDER_NEURAL_PARSEQ_DETECTOR_H
 
 #include <cstddef>
+#include <memory>
 
 #include "beholder/neural/ObjDetector.h"
 
@@ -20,7 +21,7 @@ public:
 
 protected:
 	// Extract inference results.
-	void extract() override;
+	void extract(int n) override;
 
 	// Store results.
 	// NOTE: no-op, everything stored during extraction.
@@ -48,6 +49,9 @@ public:
 
 	PARSeqDetector& operator=(const PARSeqDetector&) = delete;
 	PARSeqDetector& operator=(PARSeqDetector&&) = default;
+
+	// Construct an uninitialized detector with the same configuration.
+	[[nodiscard]] std::unique_ptr<ObjDetector> clone() const override;
 };
 
 }  // namespace beholder
@@ -4,12 +4,20 @@
 
 #include "beholder/neural/YOLOv8Detector.h"
 
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <numeric>
 #include <opencv2/core.hpp>
 #include <opencv2/core/fast_math.hpp>
+#include <opencv2/core/hal/intrin.hpp>
 #include <opencv2/core/mat.hpp>
 #include <opencv2/core/types.hpp>
 #include <opencv2/dnn/dnn.hpp>
 #include <utility>
+#include <vector>
 
 #include "beholder/neural/internal/ObjDetectorImpl.h"
 #include "beholder/util/Constants.h"
@@ -17,38 +25,100 @@
 namespace beholder {
 
 // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
-void YOLOv8Detector::extract() {
+void YOLOv8Detector::extract(int n) {
 	if (buf_->outs.size() != 1) {
 		return;
 	}
 
-	cv::Mat out{buf_->outs[0]};
-	if (out.dims != 3 ||
-		out.size[2] < 5)  // NOLINT: should have 4 coords and at least 1 class
-	{
+	const cv::Mat& outs{buf_->outs[0]};
+	// NOLINTNEXTLINE(*-magic-numbers): 4 coords and at least 1 class
+	if (outs.dims != 3 || outs.size[0] <= n || outs.size[1] < 5 ||
+		outs.type() != CV_32FC1 || !outs.isContinuous()) {
 		return;
 	}
-	cv::transposeND(out, {0, 2, 1}, out);
-	out = out.reshape(1, out.size[1]);	// [1, 8400, 85] -> [8400, 85]
-	cv::Mat scores{};
-	for (auto i{0}; i < out.rows; ++i) {
-		double conf{};
-		cv::Point maxLoc{};
-		scores = out.row(i).colRange(
-			4, out.cols);  // just a 'view', so should be efficient
-		cv::minMaxLoc(scores, nullptr, &conf, nullptr, &maxLoc);
-
-		if (conf < confidenceThreshold) {
+	// the n-th image's output is decoded in its native, channel-major,
+	// layout, [N, 84, 8400] -> [84, 8400], i.e. each row holds a single
+	// value of all anchors: the box coordinates [xCenter, yCenter, width,
+	// height], followed by the class scores, so the scores of consecutive
+	// anchors can be compared several at a time
+	const int nAnchors{outs.size[2]};
+	const int nClasses{outs.size[1] - 4};
+	const float* out{outs.ptr<float>(n)};
+
+	// the classes which are scanned, and their score rows
+	std::vector<int> ids;
+	if (classFilter.empty()) {
+		ids.resize(static_cast<std::size_t>(nClasses));
+		std::iota(ids.begin(), ids.end(), 0);
+	} else {
+		std::copy_if(classFilter.begin(), classFilter.end(),
+					 std::back_inserter(ids),
+					 [nClasses](int id) { return id >= 0 && id < nClasses; });
+	}
+	if (ids.empty()) {
+		return;
+	}
+	std::vector<const float*> rows;
+	rows.reserve(ids.size());
+	for (const auto id : ids) {
+		rows.emplace_back(out + static_cast<std::ptrdiff_t>(4 + id) * nAnchors);
+	}
+
+	// store the box of an anchor which passed the confidence threshold,
+	// the box coordinates are read only for such anchors
+	const auto keep = [&](int a, float conf, int id) {
+		const float w{out[2 * nAnchors + a]};
+		const float h{out[3 * nAnchors + a]};
+		buf_->tBoxes.emplace_back(cvFloor(out[a] - w / 2),
+								  cvFloor(out[nAnchors + a] - h / 2),
+								  cvFloor(w), cvFloor(h));
+		buf_->tClassIDs.emplace_back(id);
+		buf_->tConfidences.emplace_back(conf);
+	};
+
+	int a{0};
+#if (CV_SIMD || CV_SIMD_SCALABLE)
+	// find the best class of a vector of anchors at once
+	const int lanes{cv::VTraits<cv::v_float32>::vlanes()};
+	const cv::v_float32 thresh{cv::vx_setall_f32(confidenceThreshold)};
+	std::array<float, cv::VTraits<cv::v_float32>::max_nlanes> confs{};
+	std::array<float, cv::VTraits<cv::v_float32>::max_nlanes> best{};
+	for (; a + lanes <= nAnchors; a += lanes) {
+		cv::v_float32 conf{cv::vx_load(rows[0] + a)};
+		cv::v_float32 id{cv::vx_setall_f32(static_cast<float>(ids[0]))};
+		for (auto c{1UL}; c < rows.size(); ++c) {
+			const cv::v_float32 score{cv::vx_load(rows[c] + a)};
+			const cv::v_float32 gt{cv::v_gt(score, conf)};
+			conf = cv::v_select(gt, score, conf);
+			id = cv::v_select(gt, cv::vx_setall_f32(static_cast<float>(ids[c])),
+							  id);
+		}
+		// most anchors are background, so skip them as a whole
+		if (!cv::v_check_any(cv::v_ge(conf, thresh))) {
 			continue;
 		}
-
-		// get bbox coords; [xCenter, yCenter, width, height]
-		float* det{out.ptr<float>(i)};
-		buf_->tBoxes.emplace_back(cvFloor(det[0] - det[2] / 2),
-								  cvFloor(det[1] - det[3] / 2), cvFloor(det[2]),
-								  cvFloor(det[3]));
-		buf_->tClassIDs.emplace_back(maxLoc.x);
-		buf_->tConfidences.emplace_back(static_cast<float>(conf));
+		cv::v_store(confs.data(), conf);
+		cv::v_store(best.data(), id);
+		for (auto l{0}; l < lanes; ++l) {
+			if (confs[l] >= confidenceThreshold) {
+				keep(a + l, confs[l], static_cast<int>(best[l]));
+			}
+		}
+	}
+	cv::vx_cleanup();
+#endif
+	for (; a < nAnchors; ++a) {
+		float conf{rows[0][a]};
+		int id{ids[0]};
+		for (auto c{1UL}; c < rows.size(); ++c) {
+			if (rows[c][a] > conf) {
+				conf = rows[c][a];
+				id = ids[c];
+			}
+		}
+		if (conf >= confidenceThreshold) {
+			keep(a, conf, id);
+		}
 	}
 }
 // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
@@ -75,6 +145,13 @@ void YOLOv8Detector::store() {
 	}
 }
 
+std::unique_ptr<ObjDetector> YOLOv8Detector::clone() const {
+	auto d{std::make_unique<YOLOv8Detector>()};
+	copyConfig(*d);
+	d->classFilter = classFilter;
+	return d;
+}
+
 YOLOv8Detector::YOLOv8Detector() {
 	scale = Base::Vec3<>{1.0 / cst::max8bit, 1.0 / cst::max8bit,
 						 1.0 / cst::max8bit};
@@ -9,6 +9,9 @@
 #ifndef BEHOLDER_NEURAL_YOLOV8_DETECTOR_H
 #define BEHOLDER_NEURAL_YOLOV8_DETECTOR_H
 
+#include <memory>
+#include <vector>
+
 #include "beholder/neural/ObjDetector.h"
 
 namespace beholder {
@@ -19,12 +22,18 @@ public:
 
 protected:
 	// Extract inference results.
-	void extract() override;
+	void extract(int n) override;
 
 	// Filter (NMS) and store results.
 	void store() override;
 
 public:
+	// IDs of the classes which are detected, all classes are detected
+	// if empty. Invalid IDs are ignored.
+	// Restricting the classes also speeds up decoding, since only
+	// the scores of these classes are compared.
+	std::vector<int> classFilter;
+
 	// Default constructor.
 	YOLOv8Detector();
 
@@ -35,6 +44,9 @@ public:
 
 	YOLOv8Detector& operator=(const YOLOv8Detector&) = delete;
 	YOLOv8Detector& operator=(YOLOv8Detector&&) = default;
+
+	// Construct an uninitialized detector with the same configuration.
+	[[nodiscard]] std::unique_ptr<ObjDetector> clone() const override;
 };
 
 }  // namespace beholder
@@ -16,6 +16,8 @@
 #include <opencv2/core/mat.hpp>
 #include <opencv2/core/types.hpp>
 #include <opencv2/dnn/dnn.hpp>
+#include <string>
+#include <utility>
 #include <vector>
 
 namespace beholder {
@@ -44,20 +46,38 @@ private:
 	std::unique_ptr<Net> net_;		  // the underlying neural network
 	std::unique_ptr<Params> params_;  // conversion params
 
+	bool setNet(Net&& net, cv::dnn::Backend b, cv::dnn::Target t) {
+		net_ = std::make_unique<Net>(std::move(net));
+		if (!net_ || net_->empty()) {
+			return false;
+		}
+		net_->setPreferableBackend(b);
+		net_->setPreferableTarget(t);
+		return true;
+	}
+
 public:
 	bool makeNet(const std::filesystem::path& model, cv::dnn::Backend b,
 				 cv::dnn::Target t) {
 		// XXX: no checks, we assume that it's been checked and is correct; yolo
-		// TODO: we could supply a buffer and read from memory
 		// TODO: we should also probably restrict support to ONNX files only,
 		// because they seem to cause issues least frequently.
-		net_ = std::make_unique<Net>(cv::dnn::readNet(model));
-		if (!net_ || net_->empty()) {
-			return false;
+		return setNet(cv::dnn::readNet(model), b, t);
+	}
+
+	// Make the network from a model file read into memory, the format
+	// of which is deduced from the file's extension 'ext'.
+	bool makeNet(const std::vector<uchar>& buf, const std::string& ext,
+				 cv::dnn::Backend b, cv::dnn::Target t) {
+		if (ext == ".onnx") {
+			return setNet(cv::dnn::readNetFromONNX(buf), b, t);
 		}
-		net_->setPreferableBackend(b);
-		net_->setPreferableTarget(t);
-		return true;
+		if (ext == ".pb") {
+			return setNet(cv::dnn::readNetFromTensorflow(buf), b, t);
+		}
+		std::cerr << "unsupported in-memory model format: " << ext
+				  << std::endl;
+		return false;
 	}
 
 	void makeParams(const cv::Scalar& scale, const cv::Size& size,
@@ -78,6 +98,25 @@ public:
 		net_->forward(outs, net_->getUnconnectedOutLayersNames());
 	}
 
+	// Pass 'blob' through the network.
+	// NOTE: only touches the network, so it may run concurrently with
+	// makeBlob and transferBoxes.
+	void infer(const cv::Mat& blob, std::vector<cv::Mat>& outs) {
+		assert(static_cast<bool>(net_));
+
+		net_->setInput(blob);
+		net_->forward(outs, net_->getUnconnectedOutLayersNames());
+	}
+
+	// Convert 'img' into 'blob', without setting it as the network input.
+	// NOTE: only reads the conversion params, so it may run concurrently
+	// with infer and transferBoxes.
+	void makeBlob(const cv::Mat& img, cv::Mat& blob) const {
+		assert(static_cast<bool>(params_));
+
+		cv::dnn::blobFromImageWithParams(img, blob, *params_);
+	}
+
 	void setInput(const cv::Mat& img) {
 		assert(static_cast<bool>(net_));
 		assert(static_cast<bool>(params_));
@@ -86,6 +125,16 @@ public:
 		net_->setInput(blob_);
 	}
 
+	// Pack several images into a single blob, one image per entry
+	// of the blob's first (batch) dimension.
+	void setInputs(const std::vector<cv::Mat>& imgs) {
+		assert(static_cast<bool>(net_));
+		assert(static_cast<bool>(params_));
+
+		cv::dnn::blobFromImagesWithParams(imgs, blob_, *params_);
+		net_->setInput(blob_);
+	}
+
 	// TODO: will probably have to re-implement at some point because we
 	// would like this to work for RotatedRects as well.
 	// See TextDetectionModel_EAST_impl::detectTextRectangles for an example
@@ -100,6 +149,16 @@ public:
 	}
 };
 
+// The state of a single image passing through the stages of
+// an asynchronous detection, see ObjDetector::preprocess.
+// Reused between images to keep the allocated memory.
+class ObjDetectorJob {
+public:
+	cv::Size size;				// size of the original image
+	cv::Mat blob;				// blob passed to the network
+	std::vector<cv::Mat> outs;	// forward results
+};
+
 // Temporaries used during ObjDetector::detect and ObjDetector::extract.
 class ObjDetectorBuffers {
 public:
@@ -114,6 +173,12 @@ public:
 	// Clear buffers, but keep allocated memory.
 	void clear() {
 		outs.clear();
+		clearExtracted();
+	}
+
+	// Clear values extracted from the forward results, but keep
+	// the forward results and allocated memory.
+	void clearExtracted() {
 		tBoxes.clear();
 		tAngles.clear();
 		tClassIDs.clear();
@@ -0,0 +1,111 @@
+// beholder - Copyright © 2024 Philipp Milovic
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// A bounded lock-free single-producer/single-consumer queue.
+
+#ifndef BEHOLDER_UTIL_SPSC_QUEUE_H
+#define BEHOLDER_UTIL_SPSC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace beholder {
+
+// SPSCQueue is a bounded FIFO queue which can be pushed to from one thread
+// and popped from another without locking.
+//
+// Elements are stored in a ring buffer with one spare slot, so that a full
+// queue can be told apart from an empty one, and the producer and consumer
+// only ever write to their own index.
+// Popped slots are reset to a default constructed T, so resources held
+// by elements are released as soon as they are popped.
+//
+// WARNING: push(...) must only be called from a single (producer) thread,
+// and front() and pop() from a single (consumer) thread.
+template<typename T>
+class SPSCQueue {
+	static_assert(std::is_default_constructible_v<T>);
+	static_assert(std::is_move_assignable_v<T>);
+
+private:
+	// Assumed cache line size, keeps the indices from false sharing.
+	static constexpr std::size_t lineSize{64};
+
+	std::vector<T> buf_;  // ring buffer, one slot larger than the capacity
+	alignas(lineSize) std::atomic<std::size_t> head_{0};  // next to pop
+	alignas(lineSize) std::atomic<std::size_t> tail_{0};  // next to push
+
+	// Get the slot following 'i'.
+	[[nodiscard]] std::size_t next(std::size_t i) const noexcept {
+		return i + 1 == buf_.size() ? 0 : i + 1;
+	}
+
+public:
+	// Construct a queue which holds up to 'capacity' elements.
+	explicit SPSCQueue(std::size_t capacity) : buf_(capacity + 1) {}
+
+	SPSCQueue(const SPSCQueue&) = delete;
+	SPSCQueue(SPSCQueue&&) = delete;
+
+	~SPSCQueue() = default;
+
+	SPSCQueue& operator=(const SPSCQueue&) = delete;
+	SPSCQueue& operator=(SPSCQueue&&) = delete;
+
+	// Get the maximum number of elements the queue can hold.
+	[[nodiscard]] std::size_t capacity() const noexcept {
+		return buf_.size() - 1;
+	}
+
+	// Check if the queue is empty.
+	// The result is exact only when called from the consumer thread.
+	[[nodiscard]] bool empty() const noexcept {
+		return head_.load(std::memory_order_acquire) ==
+			   tail_.load(std::memory_order_acquire);
+	}
+
+	// Get the element at the front of the queue without popping it,
+	// or nullptr if the queue is empty.
+	// The element stays valid until it is popped.
+	[[nodiscard]] const T* front() const noexcept {
+		const auto head{head_.load(std::memory_order_relaxed)};
+		if (head == tail_.load(std::memory_order_acquire)) {
+			return nullptr;
+		}
+		return &buf_[head];
+	}
+
+	// Pop the element at the front of the queue, if any.
+	std::optional<T> pop() {
+		const auto head{head_.load(std::memory_order_relaxed)};
+		if (head == tail_.load(std::memory_order_acquire)) {
+			return std::nullopt;
+		}
+		std::optional<T> v{std::move(buf_[head])};
+		buf_[head] = T{};
+		head_.store(next(head), std::memory_order_release);
+		return v;
+	}
+
+	// Push an element to the back of the queue.
+	// Returns false, and leaves 'v' as is, if the queue is full.
+	bool push(T&& v) {
+		const auto tail{tail_.load(std::memory_order_relaxed)};
+		const auto n{next(tail)};
+		if (n == head_.load(std::memory_order_acquire)) {
+			return false;
+		}
+		buf_[tail] = std::move(v);
+		tail_.store(n, std::memory_order_release);
+		return true;
+	}
+};
+
+}  // namespace beholder
+
+#endif	// BEHOLDER_UTIL_SPSC_QUEUE_H
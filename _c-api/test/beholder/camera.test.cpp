@@ -5,19 +5,29 @@
 // Camera API tests.
 
 #include <beholder/camera/Camera.h>
+#include <beholder/camera/CameraArray.h>
+#include <beholder/camera/Exception.h>
 #include <beholder/camera/ParamEntry.h>
 #include <beholder/camera/PylonAPI.h>
+#include <beholder/camera/SensorROI.h>
+#include <beholder/camera/Stream.h>
 #include <beholder/camera/TransportLayer.h>
+#include <beholder/camera/Trigger.h>
 #include <beholder/capi/Image.h>
 #include <beholder/image/Processor.h>
 #include <gtest/gtest.h>
 
 #include <array>
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <filesystem>
 #include <limits>
+#include <optional>
 #include <ostream>
 #include <string>
+#include <string_view>
+#include <vector>
 
 #include "Testing.h"
 
@@ -27,46 +37,61 @@ namespace test {
 // Test fixtures and helpers
 // -------------------------
 
-// Tests
-// -----
+// CameraEmulated sets up the transport layer of emulated camera devices.
 //
 // NOTE: camera emulation is enabled for all tests by default through CMake
 // defined environment variables, and 3 emulated devices are available.
+class CameraEmulated : public ::testing::Test {
+protected:
+	// Serial numbers of the emulated camera devices.
+	static constexpr std::array<std::string_view, 3> sns{
+		"0815-0000", "0815-0001", "0815-0002"};
 
-// Connect to an emulated camera device and acquire an image.
-TEST(CameraEmulated, AcquireImage) {  // NOLINT(*-function-cognitive-complexity)
-	const auto testimage{assetsDir / "images/red_100x100.png"};
-	const ParamList camParams{
-		ParamEntry{"AcquisitionMode", "Continuous"},
+	// before using any pylon methods, the pylon runtime must be initialized.
+	const PylonAPI api_{};
+	TransportLayer tl_{};
 
-		ParamEntry{"TriggerSelector", "FrameStart"},
-		ParamEntry{"TriggerMode", "On"},
-		ParamEntry{"TriggerSource", "Software"},
+	void SetUp() override { ASSERT_TRUE(tl_.init(DeviceClass::Emulated)); }
 
-		ParamEntry{"TestImageSelector", "Off"},
-		ParamEntry{"ImageFileMode", "On"},
-		ParamEntry{"ImageFilename", testimage},
-	};
-	constexpr std::string_view sn{"0815-0000"};	 // emulated camera SN
-	constexpr std::size_t nImages{3};			 // No. images to acquire
+	// Get the parameters for continuous, software triggered acquisition,
+	// of 'image', if set, instead of the test pattern.
+	static ParamList triggerParams(const std::filesystem::path& image = {}) {
+		ParamList params{
+			ParamEntry{"AcquisitionMode", "Continuous"},
 
-	// before using any pylon methods, the pylon runtime must be initialized.
-	const PylonAPI api{};
+			ParamEntry{"TriggerSelector", "FrameStart"},
+			ParamEntry{"TriggerMode", "On"},
+			ParamEntry{"TriggerSource", "Software"},
+		};
+		if (!image.empty()) {
+			params.emplace_back("TestImageSelector", "Off");
+			params.emplace_back("ImageFileMode", "On");
+			params.emplace_back("ImageFilename", image.string());
+		}
+		return params;
+	}
 
-	try {
-		// create transport layer
-		TransportLayer tl{};
-		ASSERT_TRUE(tl.init(DeviceClass::Emulated));
+	// Attach 'cam' to the emulated device with serial number 'sn',
+	// and apply 'params'. Returns false if any of the steps failed.
+	bool attach(Camera& cam, std::string_view sn, const ParamList& params) {
+		auto* dev{tl_.createDevice(std::string{sn}, DeviceDesignator::SN)};
+		return dev && cam.init(dev) && cam.setParams(params);
+	}
+};
 
-		// create device
-		auto* dev{tl.createDevice(sn.data(), DeviceDesignator::SN)};
-		ASSERT_NE(dev, nullptr);
+// Tests
+// -----
+
+// Connect to an emulated camera device and acquire an image.
+TEST_F(CameraEmulated, AcquireImage) {	// NOLINT(*-cognitive-complexity)
+	const auto testimage{assetsDir / "images/red_100x100.png"};
+	constexpr std::size_t nImages{3};  // No. images to acquire
 
+	try {
 		// create camera and apply configuration
 		Camera cam{};
-		ASSERT_TRUE(cam.init(dev));
+		ASSERT_TRUE(attach(cam, sns[0], triggerParams(testimage)));
 		ASSERT_TRUE(cam.isInitialized());
-		EXPECT_TRUE(cam.setParams(camParams));
 		//dumpParams(cam.getParams(ParamAccessMode::Read));
 
 		// acquire image(s)
@@ -86,5 +111,405 @@ TEST(CameraEmulated, AcquireImage) {  // NOLINT(*-function-cognitive-complexity)
 	}
 }
 
+// Setting parameters which are already set should write nothing.
+TEST_F(CameraEmulated, SetParamsUnchanged) {
+	auto camParams{triggerParams()};
+	camParams.emplace_back("Width", "64");
+	camParams.emplace_back("Height", "48");
+
+	try {
+		Camera cam{};
+		ASSERT_TRUE(attach(cam, sns[0], camParams));
+		const auto n{cam.getNoParamWrites()};
+
+		EXPECT_TRUE(cam.setParams(camParams));
+		EXPECT_EQ(cam.getNoParamWrites(), n);
+	} catch (...) {
+		FAIL();
+	}
+}
+
+// Acquire images on pylon's grab loop thread and take them from the queue.
+TEST_F(CameraEmulated, GrabFrames) {  // NOLINT(*-cognitive-complexity)
+	const auto testimage{assetsDir / "images/red_100x100.png"};
+	constexpr std::size_t nImages{3};  // No. images to acquire
+
+	try {
+		Camera cam{};
+		ASSERT_TRUE(attach(cam, sns[0], triggerParams(testimage)));
+
+		// nothing to take before grabbing starts
+		EXPECT_FALSE(cam.nextFrame(std::chrono::milliseconds{1}).has_value());
+
+		ASSERT_TRUE(cam.startGrabbing());
+		for (auto i{0UL}; i < nImages; ++i) {
+			EXPECT_TRUE(cam.waitAndTrigger(std::chrono::seconds{1}));
+			auto f{cam.nextFrame()};
+			ASSERT_TRUE(f.has_value());
+			EXPECT_TRUE(f->isValid());	// NOLINT(*-optional-access)
+			EXPECT_EQ(f->getImage().cRef().rows, 100);	// NOLINT
+			EXPECT_EQ(f->getImage().cRef().cols, 100);	// NOLINT
+		}
+		EXPECT_EQ(cam.getNoDroppedFrames(), 0);
+
+		// stopping wakes up the consumer
+		cam.stopAcquisition();
+		EXPECT_FALSE(cam.nextFrame().has_value());
+
+		// polling afterwards is not intercepted by the grab thread
+		ASSERT_TRUE(cam.startAcquisition());
+		EXPECT_TRUE(cam.waitAndTrigger(std::chrono::seconds{1}));
+		EXPECT_TRUE(cam.acquire());
+		EXPECT_TRUE(cam.getImage().has_value());
+		cam.stopAcquisition();
+	} catch (...) {
+		FAIL();
+	}
+}
+
+// Hold frames in the frame ring, release them out of order, and make sure
+// stale handles are ignored.
+TEST_F(CameraEmulated, FrameRing) {	 // NOLINT(*-cognitive-complexity)
+	const auto testimage{assetsDir / "images/red_100x100.png"};
+	constexpr std::size_t nSlots{3};  // frame ring size
+
+	try {
+		Camera cam{};
+		ASSERT_TRUE(attach(cam, sns[0], triggerParams(testimage)));
+		EXPECT_FALSE(cam.setRingSize(0));
+		ASSERT_TRUE(cam.setRingSize(nSlots));
+
+		auto acquire = [&cam]() -> std::optional<FrameSlot> {
+			EXPECT_TRUE(cam.waitAndTrigger(std::chrono::seconds{1}));
+			return cam.acquireFrame();
+		};
+
+		// fill the ring
+		ASSERT_TRUE(cam.startAcquisition());
+		std::vector<FrameSlot> slots;
+		for (auto i{0UL}; i < nSlots; ++i) {
+			auto s{acquire()};
+			ASSERT_TRUE(s.has_value());
+			slots.emplace_back(*s);	 // NOLINT(*-optional-access)
+		}
+		EXPECT_FALSE(cam.acquireFrame().has_value());
+
+		// release out of order, and twice
+		cam.releaseFrame(slots[1]);
+		cam.releaseFrame(slots[0]);
+		cam.releaseFrame(slots[1]);
+		EXPECT_THROW(static_cast<void>(cam.getFrame(slots[1])), Exception);
+		EXPECT_TRUE(cam.getFrame(slots[2]).isValid());
+
+		// a refilled slot is not released through a stale handle
+		auto s{acquire()};
+		ASSERT_TRUE(s.has_value());
+		EXPECT_EQ(s->index, slots[0].index);  // NOLINT(*-optional-access)
+		cam.releaseFrame(slots[0]);
+		EXPECT_TRUE(cam.getFrame(*s).isValid());  // NOLINT(*-optional-access)
+
+		cam.releaseFrame(*s);  // NOLINT(*-optional-access)
+		cam.releaseFrame(slots[2]);
+		cam.stopAcquisition();
+	} catch (...) {
+		FAIL();
+	}
+}
+
+// Acquire images from several cameras at once, in arrival order.
+TEST_F(CameraEmulated, GrabArray) {	 // NOLINT(*-cognitive-complexity)
+	try {
+		std::array<Camera, 2> cams{};
+		for (auto i{0UL}; i < cams.size(); ++i) {
+			ASSERT_TRUE(attach(cams[i], sns[i], triggerParams()));
+		}
+		// null cameras would shift the indices of the others
+		const std::vector<Camera*> withNull{&cams[0], nullptr, &cams[1]};
+		EXPECT_THROW(static_cast<void>(CameraArray{withNull}), Exception);
+		CameraArray arr{{&cams[0], &cams[1]}};
+		ASSERT_EQ(arr.size(), cams.size());
+		ASSERT_TRUE(arr.startGrabbing());
+
+		// only the second camera is triggered, the first one must not
+		// hold it up
+		EXPECT_TRUE(cams[1].waitAndTrigger(std::chrono::seconds{1}));
+		auto f{arr.nextFrame()};
+		ASSERT_TRUE(f.has_value());
+		EXPECT_EQ(f->index, 1);			  // NOLINT(*-optional-access)
+		EXPECT_EQ(f->sn, sns[1]);		  // NOLINT(*-optional-access)
+		EXPECT_TRUE(f->frame.isValid());  // NOLINT(*-optional-access)
+
+		// the first camera's frame follows once it is triggered
+		EXPECT_TRUE(cams[0].waitAndTrigger(std::chrono::seconds{1}));
+		EXPECT_TRUE(arr.nextFrame().has_value());
+
+		arr.stopAcquisition();
+		EXPECT_FALSE(arr.nextFrame().has_value());
+	} catch (...) {
+		FAIL();
+	}
+}
+
+// Initialize an array of cameras, where devices which could not be created
+// are skipped, without holding up the others.
+TEST_F(CameraEmulated, InitArray) {
+	const std::vector<std::string> devSNs{std::string{sns[0]}, "0815-0999"};
+
+	try {
+		const auto devs{tl_.createDevices(devSNs, DeviceDesignator::SN, false)};
+		ASSERT_EQ(devs.size(), devSNs.size());
+		EXPECT_NE(devs[0], nullptr);
+		EXPECT_EQ(devs[1], nullptr);
+
+		std::array<Camera, 2> cams{};
+		CameraArray arr{{&cams[0], &cams[1]}};
+		EXPECT_FALSE(arr.init(devs));
+		EXPECT_TRUE(cams[0].isInitialized());
+		EXPECT_FALSE(cams[1].isInitialized());
+	} catch (...) {
+		FAIL();
+	}
+}
+
+// Reconnect a camera of an array, which should rejoin the acquisition.
+TEST_F(CameraEmulated, ReconnectArray) {  // NOLINT(*-cognitive-complexity)
+	try {
+		std::array<Camera, 2> cams{};
+		for (auto i{0UL}; i < cams.size(); ++i) {
+			ASSERT_TRUE(attach(cams[i], sns[i], triggerParams()));
+		}
+		CameraArray arr{{&cams[0], &cams[1]}};
+		ASSERT_TRUE(arr.startGrabbing());
+
+		EXPECT_FALSE(arr.reconnect(cams.size(), tl_));
+		ASSERT_TRUE(arr.reconnect(1, tl_));
+		EXPECT_TRUE(cams[1].isInitialized());
+		EXPECT_TRUE(cams[1].isAcquiring());
+		EXPECT_EQ(cams[1].getSerialNumber(), sns[1]);
+
+		// the reconnected camera wakes up the array's consumer
+		EXPECT_TRUE(cams[1].waitAndTrigger(std::chrono::seconds{1}));
+		auto f{arr.nextFrame()};
+		ASSERT_TRUE(f.has_value());
+		EXPECT_EQ(f->index, 1);	 // NOLINT(*-optional-access)
+
+		arr.stopAcquisition();
+	} catch (...) {
+		FAIL();
+	}
+}
+
+// Trigger on a fixed period from the scheduler thread.
+TEST_F(CameraEmulated, ScheduledTrigger) {	// NOLINT(*-cognitive-complexity)
+	constexpr std::size_t nImages{5};  // No. images to acquire
+	constexpr std::chrono::milliseconds period{50};
+
+	try {
+		Camera cam{};
+		ASSERT_TRUE(attach(cam, sns[0], triggerParams()));
+
+		// requests are only taken without a period
+		EXPECT_FALSE(cam.requestTrigger());
+
+		ASSERT_TRUE(cam.startGrabbing());
+		ASSERT_TRUE(cam.startTriggering(TriggerSchedule{period}));
+		EXPECT_FALSE(cam.requestTrigger());
+		for (auto i{0UL}; i < nImages; ++i) {
+			EXPECT_TRUE(cam.nextFrame().has_value());
+		}
+		cam.stopTriggering();
+		cam.stopAcquisition();
+
+		const auto s{cam.getTriggerStats()};
+		EXPECT_GE(s.triggers, nImages);
+		EXPECT_GE(s.frames, nImages);
+		EXPECT_GT(s.intervalMean, 0.0);
+		EXPECT_GT(s.latencyMean, 0.0);
+		EXPECT_GE(s.latencyMax, s.latencyMean);
+	} catch (...) {
+		FAIL();
+	}
+}
+
+// Frames should carry the host time of their exposure once the clock
+// is synced, i.e. a time between triggering and taking the frame.
+TEST_F(CameraEmulated, ClockSync) {	 // NOLINT(*-cognitive-complexity)
+	constexpr std::size_t nImages{3};  // No. images to acquire
+	// leeway for the sync uncertainty and the emulator's timestamping
+	constexpr std::int64_t slack{
+		std::chrono::nanoseconds{std::chrono::milliseconds{50}}.count()};
+
+	const auto now = []() -> std::int64_t {
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(
+				   std::chrono::system_clock::now().time_since_epoch())
+			.count();
+	};
+
+	try {
+		Camera cam{};
+		ASSERT_TRUE(attach(cam, sns[0], triggerParams()));
+		ASSERT_TRUE(cam.syncClock());
+
+		ASSERT_TRUE(cam.startGrabbing());
+		for (auto i{0UL}; i < nImages; ++i) {
+			const auto t0{now()};
+			EXPECT_TRUE(cam.waitAndTrigger(std::chrono::seconds{1}));
+			auto f{cam.nextFrame()};
+			const auto t1{now()};
+			ASSERT_TRUE(f.has_value());
+			const auto& img{f->getImage().cRef()};	// NOLINT
+			EXPECT_GE(img.hostTime, t0 - slack);
+			EXPECT_LE(img.hostTime, t1 + slack);
+		}
+		cam.stopAcquisition();
+	} catch (...) {
+		FAIL();
+	}
+}
+
+// Grabbed frames should carry the device's timestamp, frame counter and,
+// with chunks enabled, the exposure time.
+TEST_F(CameraEmulated, GrabMetadata) {	// NOLINT(*-cognitive-complexity)
+	constexpr std::size_t nImages{3};  // No. images to acquire
+	constexpr double exposure{5000.0};	// µs
+
+	auto camParams{triggerParams()};
+	camParams.emplace_back("ExposureTime", std::to_string(exposure));
+	camParams.emplace_back("ChunkModeActive", "true");
+	camParams.emplace_back("ChunkSelector", "ExposureTime");
+	camParams.emplace_back("ChunkEnable", "true");
+
+	try {
+		Camera cam{};
+		ASSERT_TRUE(attach(cam, sns[0], camParams));
+
+		ASSERT_TRUE(cam.startGrabbing());
+		std::uint64_t lastTimestamp{0};
+		std::uint64_t lastCounter{0};
+		for (auto i{0UL}; i < nImages; ++i) {
+			EXPECT_TRUE(cam.waitAndTrigger(std::chrono::seconds{1}));
+			auto f{cam.nextFrame()};
+			ASSERT_TRUE(f.has_value());
+			const auto& img{f->getImage().cRef()};	// NOLINT
+			EXPECT_GT(img.timestamp, lastTimestamp);
+			if (i > 0) {
+				EXPECT_EQ(img.frameCounter, lastCounter + 1);
+			}
+			EXPECT_DOUBLE_EQ(img.exposureTime, exposure);
+			lastTimestamp = img.timestamp;
+			lastCounter = img.frameCounter;
+		}
+		cam.stopAcquisition();
+	} catch (...) {
+		FAIL();
+	}
+}
+
+// Stream statistics should account for every frame grabbed, and be reset
+// when acquisition starts; only the stream parameters set are applied.
+TEST_F(CameraEmulated, StreamStats) {  // NOLINT(*-cognitive-complexity)
+	constexpr std::size_t nImages{5};		// No. images to acquire
+	constexpr std::int64_t nBuffers{16};	// more than the ring needs
+
+	try {
+		Camera cam{};
+		ASSERT_TRUE(attach(cam, sns[0], triggerParams()));
+
+		// the GigE only parameters are left alone, so nothing is written
+		const auto n{cam.getNoParamWrites()};
+		StreamConfig cfg{};
+		cfg.maxNumBuffer = 0;
+		EXPECT_FALSE(cam.setStreamConfig(cfg));
+		cfg.maxNumBuffer = nBuffers;
+		EXPECT_TRUE(cam.setStreamConfig(cfg));
+		EXPECT_EQ(cam.getNoParamWrites(), n);
+
+		ASSERT_TRUE(cam.startGrabbing());
+		EXPECT_EQ(
+			getParameter("MaxNumBuffer", cam.getParams(ParamAccessMode::Read))
+				.value,
+			std::to_string(nBuffers));
+		for (auto i{0UL}; i < nImages; ++i) {
+			EXPECT_TRUE(cam.waitAndTrigger(std::chrono::seconds{1}));
+			EXPECT_TRUE(cam.nextFrame().has_value());
+		}
+		cam.stopAcquisition();
+
+		auto s{cam.getStreamStats()};
+		ASSERT_TRUE(s.has_value());
+		EXPECT_EQ(s->totalBuffers, nImages);	// NOLINT(*-optional-access)
+		EXPECT_EQ(s->failedBuffers, 0);			// NOLINT(*-optional-access)
+		EXPECT_EQ(s->droppedFrames, 0);			// NOLINT(*-optional-access)
+		EXPECT_EQ(s->skippedFrames, 0);			// NOLINT(*-optional-access)
+		EXPECT_EQ(s->timeouts, 0);				// NOLINT(*-optional-access)
+
+		// an untriggered acquisition times out, on a fresh count
+		ASSERT_TRUE(cam.startAcquisition());
+		EXPECT_FALSE(cam.acquire(std::chrono::milliseconds{10}));
+		cam.stopAcquisition();
+
+		s = cam.getStreamStats();
+		ASSERT_TRUE(s.has_value());
+		EXPECT_EQ(s->timeouts, 1);	// NOLINT(*-optional-access)
+	} catch (...) {
+		FAIL();
+	}
+}
+
+// Set the sensor region while grabbing, which should be grown to cover it,
+// clamped to the sensor, and leave grabbing running.
+TEST_F(CameraEmulated, SensorROI) {	 // NOLINT(*-cognitive-complexity)
+	// NOLINTBEGIN(*-magic-numbers, *-optional-access)
+	try {
+		Camera cam{};
+		ASSERT_TRUE(attach(cam, sns[0], triggerParams()));
+		const auto full{cam.getFullROI()};
+		ASSERT_TRUE(full.has_value());
+
+		// odd values don't fit the increments, so the region is grown
+		const SensorROI roi{33, 17, 101, 51, 1};
+		ASSERT_TRUE(cam.startGrabbing());
+		ASSERT_TRUE(cam.setROI(roi));
+		EXPECT_TRUE(cam.isAcquiring());
+		auto got{cam.getROI()};
+		ASSERT_TRUE(got.has_value());
+		EXPECT_LE(got->offsetX, roi.offsetX);
+		EXPECT_LE(got->offsetY, roi.offsetY);
+		EXPECT_GE(got->offsetX + got->width, roi.offsetX + roi.width);
+		EXPECT_GE(got->offsetY + got->height, roi.offsetY + roi.height);
+
+		// grabbing was restarted with the new image size
+		EXPECT_TRUE(cam.waitAndTrigger(std::chrono::seconds{1}));
+		auto f{cam.nextFrame()};
+		ASSERT_TRUE(f.has_value());
+		EXPECT_EQ(f->getImage().cRef().cols, got->width);
+		EXPECT_EQ(f->getImage().cRef().rows, got->height);
+		f.reset();
+
+		// a region already set is left as is
+		const auto n{cam.getNoParamWrites()};
+		EXPECT_TRUE(cam.setROI(roi));
+		EXPECT_EQ(cam.getNoParamWrites(), n);
+
+		// a region reaching past the sensor is clamped to it
+		const SensorROI past{full->width - 10, full->height - 10, 100, 100, 1};
+		EXPECT_TRUE(cam.setROI(past));
+		got = cam.getROI();
+		ASSERT_TRUE(got.has_value());
+		EXPECT_LE(got->offsetX, past.offsetX);
+		EXPECT_LE(got->offsetY, past.offsetY);
+		EXPECT_LE(got->offsetX + got->width, full->width);
+		EXPECT_LE(got->offsetY + got->height, full->height);
+		EXPECT_TRUE(cam.isAcquiring());
+
+		EXPECT_FALSE(cam.setROI(SensorROI{0, 0, 0, 10, 1}));
+		EXPECT_FALSE(cam.setROI(SensorROI{0, 0, 10, 10, 0}));
+		cam.stopAcquisition();
+	} catch (...) {
+		FAIL();
+	}
+	// NOLINTEND(*-magic-numbers, *-optional-access)
+}
+
 }  // namespace test
 }  // namespace beholder
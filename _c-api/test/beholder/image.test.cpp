@@ -4,9 +4,32 @@
 
 // Image processing tests.
 
+#include <beholder/image/ConversionInfo.h>
+#include <beholder/image/FrameSource.h>
 #include <beholder/image/Processor.h>
+#include <beholder/image/Recording.h>
+#include <beholder/image/ops/AddPadding.h>
+#include <beholder/image/ops/CorrectGamma.h>
+#include <beholder/image/ops/DrawBoundingBoxes.h>
+#include <beholder/image/ops/Grayscale.h>
+#include <beholder/image/ops/Invert.h>
+#include <beholder/image/ops/Resize.h>
+#include <beholder/image/ops/Rotate.h>
+#include <beholder/image/ops/Threshold.h>
+#include <beholder/image/ops/UnsharpMask.h>
+#include <beholder/util/Constants.h>
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <utility>
+#include <vector>
+
 #include "Testing.h"
 
 namespace beholder {
@@ -15,6 +38,60 @@ namespace test {
 // Test fixtures and helpers
 // -------------------------
 
+// Set up a chain of pointwise operations, preceded by a grayscale conversion.
+void addPointwiseChain(Processor::OpList& ops) {
+	ops.emplace_back(std::make_unique<Grayscale>());
+	ops.emplace_back(std::make_unique<CorrectGamma>(0.8));	// NOLINT
+	ops.emplace_back(std::make_unique<Invert>());
+	ops.emplace_back(std::make_unique<Threshold>());  // Otsu
+}
+
+// Check if two images are pixel-for-pixel identical.
+bool equal(const Image& a, const Image& b) {
+	const auto& ra{a.cRef()};
+	const auto& rb{b.cRef()};
+	if (ra.rows != rb.rows || ra.cols != rb.cols ||
+		ra.pixelType != rb.pixelType) {
+		return false;
+	}
+	const auto rowBytes{static_cast<std::size_t>(ra.cols) * ra.bitsPerPixel /
+						cst::bits};
+	for (auto i{0}; i < ra.rows; ++i) {
+		const auto* pa{static_cast<const unsigned char*>(ra.buffer) +
+					   static_cast<std::size_t>(i) * ra.step};
+		const auto* pb{static_cast<const unsigned char*>(rb.buffer) +
+					   static_cast<std::size_t>(i) * rb.step};
+		if (std::memcmp(pa, pb, rowBytes) != 0) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// Get the mean absolute difference between the bytes of two images,
+// or a negative value if their geometry or pixel types differ.
+double meanAbsDiff(const Image& a, const Image& b) {
+	const auto& ra{a.cRef()};
+	const auto& rb{b.cRef()};
+	if (ra.rows != rb.rows || ra.cols != rb.cols ||
+		ra.pixelType != rb.pixelType) {
+		return -1.0;
+	}
+	const auto rowBytes{static_cast<std::size_t>(ra.cols) * ra.bitsPerPixel /
+						cst::bits};
+	double sum{0.0};
+	for (auto i{0}; i < ra.rows; ++i) {
+		const auto* pa{static_cast<const unsigned char*>(ra.buffer) +
+					   static_cast<std::size_t>(i) * ra.step};
+		const auto* pb{static_cast<const unsigned char*>(rb.buffer) +
+					   static_cast<std::size_t>(i) * rb.step};
+		for (auto j{0UL}; j < rowBytes; ++j) {
+			sum += std::abs(static_cast<int>(pa[j]) - static_cast<int>(pb[j]));
+		}
+	}
+	return sum / (static_cast<double>(rowBytes) * std::max(ra.rows, 1));
+}
+
 // Tests
 // -----
 
@@ -26,5 +103,437 @@ TEST(Processor, Construct) {
 	EXPECT_TRUE(true);
 }
 
+// Preprocessing should not allocate new buffers once the
+// Processor has seen an image.
+TEST(Processor, PreprocessNoAllocations) {
+	const auto testimage{assetsDir / "images/test_30px_320x320.png"};
+	const auto nWarmup{3};
+	const auto nRuns{5};
+
+	Processor proc{};
+	proc.preprocessing.emplace_back(std::make_unique<Grayscale>());
+	proc.preprocessing.emplace_back(std::make_unique<UnsharpMask>());
+	proc.preprocessing.emplace_back(std::make_unique<Rotate>(10.0F));  // NOLINT
+	proc.preprocessing.emplace_back(
+		std::make_unique<AddPadding>(10, 255.0));  // NOLINT
+
+	ASSERT_TRUE(proc.readImage(testimage, ReadMode::Color));
+	for (auto i{0}; i < nWarmup; ++i) {
+		proc.resetROI();
+		ASSERT_TRUE(proc.preprocess());
+	}
+	const std::size_t n{proc.getNoAllocations()};
+	EXPECT_GT(n, 0U);
+
+	for (auto i{0}; i < nRuns; ++i) {
+		proc.resetROI();
+		ASSERT_TRUE(proc.preprocess());
+	}
+	EXPECT_EQ(proc.getNoAllocations(), n);
+}
+
+// Fused pointwise operations should give the same result as
+// executing them one by one.
+TEST(Processor, CompileFusesPointwiseOps) {
+	const auto testimage{assetsDir / "images/test_30px_320x320.png"};
+
+	Processor ref{};
+	addPointwiseChain(ref.preprocessing);
+	ASSERT_TRUE(ref.readImage(testimage, ReadMode::Color));
+	ASSERT_TRUE(ref.preprocess());
+
+	Processor proc{};
+	addPointwiseChain(proc.preprocessing);
+	proc.compile();
+	EXPECT_EQ(proc.preprocessing.size(), 1U);
+	ASSERT_TRUE(proc.readImage(testimage, ReadMode::Color));
+	ASSERT_TRUE(proc.preprocess());
+
+	EXPECT_TRUE(equal(proc.getRawImage(), ref.getRawImage()));
+}
+
+// Changing an operation's parameters after it was prepared should take
+// effect on the next preprocessing.
+TEST(Processor, PreprocessAfterParameterChange) {
+	const auto testimage{assetsDir / "images/test_30px_320x320.png"};
+	const auto gamma{2.0};
+
+	Processor ref{};
+	ref.preprocessing.emplace_back(std::make_unique<Grayscale>());
+	ref.preprocessing.emplace_back(std::make_unique<CorrectGamma>(gamma));
+	ASSERT_TRUE(ref.readImage(testimage, ReadMode::Color));
+	ASSERT_TRUE(ref.preprocess());
+
+	Processor proc{};
+	auto op{std::make_unique<CorrectGamma>(0.8)};  // NOLINT
+	auto* gammaOp{op.get()};
+	proc.preprocessing.emplace_back(std::make_unique<Grayscale>());
+	proc.preprocessing.emplace_back(std::move(op));
+	ASSERT_TRUE(proc.readImage(testimage, ReadMode::Color));
+	ASSERT_TRUE(proc.preprocess());
+
+	gammaOp->gamma = gamma;
+	EXPECT_TRUE(gammaOp->isStale());
+	ASSERT_TRUE(proc.readImage(testimage, ReadMode::Color));
+	ASSERT_TRUE(proc.preprocess());
+	EXPECT_FALSE(gammaOp->isStale());
+
+	EXPECT_TRUE(equal(proc.getRawImage(), ref.getRawImage()));
+}
+
+// Batch extraction of rotated ROIs should give the same result as
+// setting them one by one.
+TEST(Processor, ExtractRotatedROIs) {
+	const auto testimage{assetsDir / "images/test_30px_320x320.png"};
+	// NOLINTBEGIN(*-magic-numbers)
+	const std::vector<Rectangle> rois{Rectangle{100, 140, 220, 180},
+									  Rectangle{0, 0, 50, 30}};
+	const std::vector<double> angles{15.0, -5.0};
+	// NOLINTEND(*-magic-numbers)
+
+	Processor proc{};
+	ASSERT_TRUE(proc.readImage(testimage, ReadMode::Color));
+	const auto& imgs{proc.extractRotatedROIs(rois, angles)};
+	ASSERT_EQ(imgs.size(), rois.size());
+	for (auto i{0UL}; i < rois.size(); ++i) {
+		proc.setRotatedROI(rois[i], angles[i]);
+		EXPECT_TRUE(equal(imgs[i], proc.getRawImage()));
+	}
+}
+
+// Composed geometric operations should give (nearly) the same result as
+// executing them one by one.
+TEST(Processor, PreprocessComposesWarps) {
+	const auto testimage{assetsDir / "images/test_30px_320x320.png"};
+	// NOLINTBEGIN(*-magic-numbers)
+	const int rows{480};
+	const int cols{640};
+	const double tolerance{2.0};  // mean abs. difference per byte
+
+	// rotate, then enlarge, so that both are linear and get composed
+	Processor proc{};
+	ASSERT_TRUE(proc.readImage(testimage, ReadMode::Color));
+	proc.preprocessing.emplace_back(std::make_unique<Rotate>(90.0F));
+	proc.preprocessing.emplace_back(std::make_unique<Resize>(cols, rows));
+	ASSERT_TRUE(proc.preprocess());
+	const auto raw{proc.getRawImage()};
+	EXPECT_EQ(raw.cRef().rows, rows);
+	EXPECT_EQ(raw.cRef().cols, cols);
+
+	// the same operations, each with a processor of its own
+	Processor rotated{};
+	ASSERT_TRUE(rotated.readImage(testimage, ReadMode::Color));
+	rotated.preprocessing.emplace_back(std::make_unique<Rotate>(90.0F));
+	ASSERT_TRUE(rotated.preprocess());
+	Processor resized{};
+	ASSERT_TRUE(resized.receiveRawImage(rotated.getRawImage()));
+	resized.preprocessing.emplace_back(std::make_unique<Resize>(cols, rows));
+	ASSERT_TRUE(resized.preprocess());
+	// NOLINTEND(*-magic-numbers)
+
+	const auto diff{meanAbsDiff(raw, resized.getRawImage())};
+	EXPECT_GE(diff, 0.0);
+	EXPECT_LT(diff, tolerance);
+}
+
+// Packed pixel formats should be unpacked into their plain counterparts.
+TEST(Processor, ReceivePackedImage) {
+	// NOLINTBEGIN(*-magic-numbers)
+	const int cols{70};	 // exercises both the vectorized and scalar paths
+	Processor proc{};
+
+	// Mono4packed, 2 pixels per byte, first one in the low nibble
+	std::vector<std::uint8_t> mono4(2 * cols / 2);
+	for (auto i{0UL}; i < mono4.size(); ++i) {
+		mono4[i] = static_cast<std::uint8_t>(i * 7);
+	}
+	ASSERT_TRUE(proc.receiveRawImage(
+		Image{0UL, 2, cols, static_cast<std::int64_t>(PxType::Mono4packed),
+			  mono4.data(), 0UL, 4UL, 0UL, 0, 0UL, 0UL, 0.0}));
+	auto raw{proc.getRawImage()};
+	ASSERT_EQ(raw.cRef().rows, 2);
+	ASSERT_EQ(raw.cRef().cols, cols);
+	for (auto i{0}; i < 2 * cols; ++i) {
+		const auto* row{static_cast<const std::uint8_t*>(raw.cRef().buffer) +
+						static_cast<std::size_t>(i / cols) * raw.cRef().step};
+		const unsigned nibble{(mono4[i / 2] >> (4 * (i % 2))) & 0xFU};
+		EXPECT_EQ(row[i % cols], nibble * 17);
+	}
+
+	// Mono12p, 2 pixels per 3 bytes, little-endian bit stream
+	std::vector<std::uint16_t> px(cols);
+	std::vector<std::uint8_t> mono12(cols / 2 * 3);
+	for (auto i{0}; i < cols; i += 2) {
+		px[i] = static_cast<std::uint16_t>((i * 59) % 4096);
+		px[i + 1] = static_cast<std::uint16_t>((i * 113 + 7) % 4096);
+		auto* g{&mono12[static_cast<std::size_t>(i / 2 * 3)]};
+		g[0] = static_cast<std::uint8_t>(px[i] & 0xFFU);
+		g[1] = static_cast<std::uint8_t>((px[i] >> 8U) | (px[i + 1] << 4U));
+		g[2] = static_cast<std::uint8_t>(px[i + 1] >> 4U);
+	}
+	ASSERT_TRUE(proc.receiveRawImage(
+		Image{0UL, 1, cols, static_cast<std::int64_t>(PxType::Mono12p),
+			  mono12.data(), 0UL, 12UL, 0UL, 0, 0UL, 0UL, 0.0}));
+	raw = proc.getRawImage();
+	ASSERT_EQ(raw.cRef().cols, cols);
+	EXPECT_EQ(std::memcmp(raw.cRef().buffer, px.data(),
+						  px.size() * sizeof(std::uint16_t)),
+			  0);
+	// NOLINTEND(*-magic-numbers)
+}
+
+// Bayer mosaics should be converted straight into the requested output.
+TEST(Processor, ReceiveBayerImage) {
+	// NOLINTBEGIN(*-magic-numbers)
+	const int rows{4};
+	const int cols{6};
+	// RGGB quads with R = 200, G = 100 and 51, B = 10
+	std::vector<std::uint8_t> bayer(static_cast<std::size_t>(rows * cols));
+	for (auto i{0}; i < rows; ++i) {
+		for (auto j{0}; j < cols; ++j) {
+			const bool evenRow{i % 2 == 0};
+			const bool evenCol{j % 2 == 0};
+			bayer[static_cast<std::size_t>(i * cols + j)] =
+				evenRow ? (evenCol ? 200 : 100) : (evenCol ? 51 : 10);
+		}
+	}
+	const Image raw{0UL,
+					rows,
+					cols,
+					static_cast<std::int64_t>(PxType::BayerRG8),
+					bayer.data(),
+					0UL,
+					8UL,
+					0UL,
+					0,
+					0UL,
+					0UL,
+					0.0};
+	Processor proc{};
+
+	ASSERT_TRUE(proc.receiveRawImage(raw, RawOutput::HalfColor));
+	auto img{proc.getRawImage()};
+	ASSERT_EQ(img.cRef().rows, rows / 2);
+	ASSERT_EQ(img.cRef().cols, cols / 2);
+	ASSERT_EQ(img.cRef().bitsPerPixel, 24UL);
+	for (auto i{0}; i < rows / 2; ++i) {
+		const auto* row{static_cast<const std::uint8_t*>(img.cRef().buffer) +
+						static_cast<std::size_t>(i) * img.cRef().step};
+		for (auto j{0}; j < cols / 2; ++j) {
+			EXPECT_EQ(row[3 * j], 10);		 // B
+			EXPECT_EQ(row[3 * j + 1], 76);	 // (100 + 51 + 1) / 2
+			EXPECT_EQ(row[3 * j + 2], 200);	 // R
+		}
+	}
+
+	ASSERT_TRUE(proc.receiveRawImage(raw, RawOutput::Grayscale));
+	img = proc.getRawImage();
+	EXPECT_EQ(img.cRef().rows, rows);
+	EXPECT_EQ(img.cRef().cols, cols);
+	EXPECT_EQ(img.cRef().bitsPerPixel, 8UL);
+	// NOLINTEND(*-magic-numbers)
+}
+
+// Raw images which need no conversion should be viewed in place, and
+// the pin should be held until the image is released.
+TEST(Processor, ViewRawImage) {
+	// NOLINTBEGIN(*-magic-numbers)
+	std::vector<std::uint8_t> buf(16 * 8, 42);
+	const Image raw{0UL,
+					8,
+					16,
+					static_cast<std::int64_t>(PxType::Mono8),
+					buf.data(),
+					0UL,
+					8UL,
+					0UL,
+					0,
+					0UL,
+					0UL,
+					0.0};
+	// NOLINTEND(*-magic-numbers)
+	auto pin{std::make_shared<int>(0)};
+	const std::weak_ptr<int> pinned{pin};
+
+	Processor proc{};
+	ASSERT_TRUE(proc.viewRawImage(raw, std::move(pin)));
+	EXPECT_EQ(proc.getRawImage().cRef().buffer, buf.data());
+	EXPECT_FALSE(pinned.expired());
+
+	proc.releaseRawImage();
+	EXPECT_TRUE(pinned.expired());
+	EXPECT_EQ(proc.getRawImage().cRef().buffer, nullptr);
+}
+
+// Raw images viewed without a pin should also be let go of when released,
+// since the caller is about to free the buffer.
+TEST(Processor, ViewRawImageUnpinned) {
+	// NOLINTBEGIN(*-magic-numbers)
+	std::vector<std::uint8_t> buf(16 * 8, 42);
+	const Image raw{0UL,
+					8,
+					16,
+					static_cast<std::int64_t>(PxType::Mono8),
+					buf.data(),
+					0UL,
+					8UL,
+					0UL,
+					0,
+					0UL,
+					0UL,
+					0.0};
+	// NOLINTEND(*-magic-numbers)
+
+	Processor proc{};
+	ASSERT_TRUE(proc.viewRawImage(raw));
+	EXPECT_EQ(proc.getRawImage().cRef().buffer, buf.data());
+
+	proc.releaseRawImage();
+	EXPECT_NE(proc.getRawImage().cRef().buffer, buf.data());
+	EXPECT_EQ(proc.getRawImage().cRef().buffer, nullptr);
+}
+
+// Postprocessing should draw on a copy of a viewed raw image, so that
+// whoever else reads the buffer, eg. a Recorder, never sees it change.
+TEST(Processor, ViewRawImagePostprocess) {
+	// NOLINTBEGIN(*-magic-numbers)
+	std::vector<std::uint8_t> buf(16 * 8, 42);
+	const Image raw{0UL,
+					8,
+					16,
+					static_cast<std::int64_t>(PxType::Mono8),
+					buf.data(),
+					0UL,
+					8UL,
+					0UL,
+					0,
+					0UL,
+					0UL,
+					0.0};
+	const std::vector<Result> res{
+		Result{"", Rectangle{2, 2, 12, 6}, 0.0, 1.0}};
+
+	Processor proc{};
+	proc.postprocessing.emplace_back(
+		new DrawBoundingBoxes{DrawBoundingBoxes::Color{255, 0, 0, 0}, 1});
+	ASSERT_TRUE(proc.viewRawImage(raw));
+	ASSERT_TRUE(proc.postprocess(res));
+	EXPECT_TRUE(std::all_of(buf.begin(), buf.end(),
+							[](std::uint8_t v) -> bool { return v == 42; }));
+	const auto img{proc.getRawImage()};
+	const auto& r{img.cRef()};
+	ASSERT_NE(r.buffer, buf.data());
+	EXPECT_EQ(static_cast<const std::uint8_t*>(r.buffer)[2 * r.step + 2], 255);
+	// NOLINTEND(*-magic-numbers)
+}
+
+// Replayed images should be converted into the requested pixel type,
+// and survive the round trip through the raw image conversion.
+TEST(FileSource, ReplayPackedBayer) {
+	// NOLINTBEGIN(*-magic-numbers)
+	const auto testimage{assetsDir / "images/red_100x100.png"};
+	FileSource src{};
+	src.setPixelType(PxType::BayerRG12p);
+	ASSERT_TRUE(src.open(testimage.string()));
+	ASSERT_EQ(src.getNoImages(), 1UL);
+
+	const auto raw{src.next()};
+	ASSERT_TRUE(raw);
+	EXPECT_EQ(raw->cRef().pixelType,
+			  static_cast<std::int64_t>(PxType::BayerRG12p));
+	EXPECT_EQ(raw->cRef().cols, 100);
+	EXPECT_EQ(raw->cRef().bitsPerPixel, 12UL);
+	EXPECT_EQ(raw->cRef().step, 150UL);
+
+	Processor proc{};
+	ASSERT_TRUE(proc.receiveRawImage(*raw, RawOutput::HalfColor));
+	const auto img{proc.getRawImage()};
+	ASSERT_EQ(img.cRef().rows, 50);
+	const auto* px{static_cast<const std::uint16_t*>(img.cRef().buffer)};
+	EXPECT_EQ(px[0], 0);		   // B
+	EXPECT_EQ(px[1], 0);		   // G
+	EXPECT_EQ(px[2], 255U << 4U);  // R, scaled to 12 bits
+
+	// exhausted unless looping
+	EXPECT_FALSE(src.next());
+	src.setLoop(true);
+	const auto again{src.next()};
+	ASSERT_TRUE(again);
+	EXPECT_EQ(again->cRef().id, 1UL);
+	// NOLINTEND(*-magic-numbers)
+}
+
+// Recorded frames should be replayed as recorded, in place.
+TEST(Recorder, RecordAndReplay) {
+	// NOLINTBEGIN(*-magic-numbers)
+	const auto path{std::filesystem::temp_directory_path() /
+					"beholder_recorder_test.seg"};
+	// a Mono12p image with padded rows, and a plain one
+	auto packed{std::make_shared<std::vector<std::uint8_t>>(4 * 64, 7)};
+	const Image a{1UL,
+				  4,
+				  40,
+				  static_cast<std::int64_t>(PxType::Mono12p),
+				  packed->data(),
+				  64UL,
+				  12UL,
+				  0UL,
+				  0,
+				  0UL,
+				  0UL,
+				  0.0};
+	std::vector<std::uint8_t> plain(8 * 16, 42);
+	const Image b{2UL,
+				  8,
+				  16,
+				  static_cast<std::int64_t>(PxType::Mono8),
+				  plain.data(),
+				  0UL,
+				  8UL,
+				  0UL,
+				  0,
+				  0UL,
+				  0UL,
+				  0.0};
+
+	Recorder rec{};
+	ASSERT_TRUE(rec.open(path.string(), 1 << 16, 4));
+	ASSERT_TRUE(rec.record(a, "A", packed));
+	packed.reset();	 // the recorder holds on to the buffer
+	ASSERT_TRUE(rec.record(b, "B"));
+	rec.close();
+	EXPECT_EQ(rec.getNoDropped(), 0UL);
+
+	ASSERT_TRUE(Recording::isRecording(path.string()));
+	Recording r{};
+	ASSERT_TRUE(r.open(path.string()));
+	ASSERT_EQ(r.getNoFrames(), 2UL);
+	EXPECT_EQ(r.getSerialNumber(0), "A");
+	EXPECT_EQ(r.getSerialNumber(1), "B");
+	EXPECT_TRUE(r.getTimestamp(1));
+	EXPECT_FALSE(r.getFrame(2));
+
+	const auto ra{r.getFrame(0)};
+	ASSERT_TRUE(ra);
+	EXPECT_EQ(ra->cRef().id, 1UL);
+	EXPECT_EQ(ra->cRef().step, 64UL);
+	EXPECT_EQ(static_cast<const std::uint8_t*>(ra->cRef().buffer)[0], 7);
+	const auto rb{r.getFrame(1)};
+	ASSERT_TRUE(rb);
+	EXPECT_TRUE(equal(*rb, b));
+
+	// and through a frame source
+	FileSource src{};
+	ASSERT_TRUE(src.open(path.string()));
+	EXPECT_EQ(src.getNoImages(), 2UL);
+	const auto first{src.next()};
+	ASSERT_TRUE(first);
+	EXPECT_EQ(first->cRef().pixelType,
+			  static_cast<std::int64_t>(PxType::Mono12p));
+
+	std::filesystem::remove(path);
+	// NOLINTEND(*-magic-numbers)
+}
+
 }  // namespace test
 }  // namespace beholder
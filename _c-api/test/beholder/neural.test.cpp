@@ -7,12 +7,19 @@
 // TODO: drive tests through a JSON config file
 
 #include <beholder/image/Processor.h>
+#include <beholder/neural/BatchScheduler.h>
 #include <beholder/neural/CRAFTDetector.h>
+#include <beholder/neural/DetectorPipeline.h>
+#include <beholder/neural/DetectorPool.h>
 #include <beholder/neural/EASTDetector.h>
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <cstddef>
 #include <exception>
 #include <filesystem>
+#include <future>
+#include <vector>
 
 #include "Testing.h"
 
@@ -22,6 +29,33 @@ namespace test {
 // Test fixtures and helpers
 // -------------------------
 
+// Get a blank (black) image shaped like 'img', backed by 'buf'.
+Image blankLike(const Image& img, std::vector<unsigned char>& buf) {
+	const auto& r{img.cRef()};
+	buf.assign(static_cast<std::size_t>(r.rows) * r.step, 0);
+	Image blank{img};
+	blank.ref().buffer = buf.data();
+	return blank;
+}
+
+// Configure an EAST detector for the test image, without initializing it.
+void configureEAST(EASTDetector& det) {
+	det.modelPath = assetsDir / "models";
+	det.model = "east.pb";
+	det.size = EASTDetector::Vec2<>{320, 320};	// NOLINT
+}
+
+// Check if a detected text box is the one in the test image.
+// NOTE: this is acceptance testing mostly
+// TODO: use a comparison function with some tolerance
+void expectTestTextBox(const Result& res) {
+	const auto& b{res.box.cRef()};
+	EXPECT_GE(b.left, 270);	   // FIXME: tie to test image
+	EXPECT_GE(b.top, 300);	   // FIXME: tie to test image
+	EXPECT_LE(b.right, 375);   // FIXME: tie to test image
+	EXPECT_LE(b.bottom, 340);  // FIXME: tie to test image
+}
+
 // Tests
 // -----
 
@@ -30,9 +64,7 @@ TEST(Neural, EAST) {  // NOLINT(*-function-cognitive-complexity)
 	try {
 		// set up detector
 		beholder::EASTDetector det{};
-		det.modelPath = assetsDir / "models";
-		det.model = "east.pb";
-		det.size = beholder::EASTDetector::Vec2<>{320, 320};  // NOLINT
+		configureEAST(det);
 		ASSERT_TRUE(det.init());
 
 		// read the image
@@ -45,14 +77,202 @@ TEST(Neural, EAST) {  // NOLINT(*-function-cognitive-complexity)
 		const auto& res{det.getResults()};
 		ASSERT_EQ(res.size(), 1);  // FIXME: tie to test image
 
-		// check if the bounding box is within some acceptable region
-		// NOTE: this part is acceptance testing mostly
-		// TODO: use a comparison function with some tolerance
-		const auto& b{res.front().box.cRef()};
-		EXPECT_GE(b.left, 270);	   // FIXME: tie to test image
-		EXPECT_GE(b.top, 300);	   // FIXME: tie to test image
-		EXPECT_LE(b.right, 375);   // FIXME: tie to test image
-		EXPECT_LE(b.bottom, 340);  // FIXME: tie to test image
+		expectTestTextBox(res.front());
+	} catch (const std::exception& e) {
+		FAIL() << e.what();
+	} catch (...) {
+		FAIL() << "caught unknown exception";
+	}
+}
+
+// Detect text in several images with a single forward pass.
+TEST(Neural, EASTBatch) {  // NOLINT(*-function-cognitive-complexity)
+	const auto testimage{assetsDir / "images/test_30px_640x640.png"};
+	try {
+		// set up detector
+		beholder::EASTDetector det{};
+		configureEAST(det);
+		ASSERT_TRUE(det.init());
+
+		// read the image
+		Processor proc{};
+		ASSERT_TRUE(proc.readImage(testimage, ReadMode::Color));
+
+		// detect text in the image and in a blank one, so that each
+		// image's results can be told apart
+		std::vector<unsigned char> buf;
+		const std::vector<Image> imgs{
+			proc.getRawImage(), blankLike(proc.getRawImage(), buf)};
+		EXPECT_TRUE(det.detectBatch(imgs));
+
+		const auto& batch{det.getBatchResults()};
+		ASSERT_EQ(batch.size(), imgs.size());
+		ASSERT_EQ(batch[0].size(), 1);	// FIXME: tie to test image
+		EXPECT_TRUE(batch[1].empty());
+		expectTestTextBox(batch[0].front());
+	} catch (const std::exception& e) {
+		FAIL() << e.what();
+	} catch (...) {
+		FAIL() << "caught unknown exception";
+	}
+}
+
+// Detect text in images submitted concurrently, in batches.
+TEST(Neural, BatchScheduler) {	// NOLINT(*-function-cognitive-complexity)
+	const auto testimage{assetsDir / "images/test_30px_640x640.png"};
+	constexpr std::size_t nReq{4};	// No. concurrent requests
+	try {
+		// set up detector
+		beholder::EASTDetector det{};
+		configureEAST(det);
+		ASSERT_TRUE(det.init());
+
+		// read the image, every other request submits a blank one,
+		// so that each reply can be matched to its request
+		Processor proc{};
+		ASSERT_TRUE(proc.readImage(testimage, ReadMode::Color));
+		std::vector<unsigned char> buf;
+		const std::vector<Image> imgs{
+			proc.getRawImage(), blankLike(proc.getRawImage(), buf)};
+
+		// the window is long enough for all requests to share a batch
+		BatchScheduler sched{det, nReq, std::chrono::seconds{1}};
+		std::vector<std::future<BatchReply>> futs;
+		for (auto i{0UL}; i < nReq; ++i) {
+			futs.emplace_back(std::async(std::launch::async, [&, i]() {
+				return sched.detect(imgs[i % imgs.size()]);
+			}));
+		}
+		for (auto i{0UL}; i < nReq; ++i) {
+			const auto rep{futs[i].get()};
+			ASSERT_TRUE(rep.ok);
+			EXPECT_EQ(rep.timing.batchSize, nReq);
+			EXPECT_GT(rep.timing.inference.count(), 0);
+			if (i % imgs.size() != 0) {
+				EXPECT_TRUE(rep.results.empty());
+				continue;
+			}
+			ASSERT_EQ(rep.results.size(), 1);  // FIXME: tie to test image
+			expectTestTextBox(rep.results.front());
+		}
+	} catch (const std::exception& e) {
+		FAIL() << e.what();
+	} catch (...) {
+		FAIL() << "caught unknown exception";
+	}
+}
+
+// Detect text in consecutive images with overlapping detection stages.
+TEST(Neural, DetectorPipeline) {  // NOLINT(*-function-cognitive-complexity)
+	const auto testimage{assetsDir / "images/test_30px_640x640.png"};
+	constexpr std::size_t nReq{4};	// No. submitted images
+	try {
+		// set up detector
+		beholder::EASTDetector det{};
+		configureEAST(det);
+		ASSERT_TRUE(det.init());
+
+		// read the image, every other submission is a blank one,
+		// so that each reply can be matched to its submission
+		Processor proc{};
+		ASSERT_TRUE(proc.readImage(testimage, ReadMode::Color));
+		std::vector<unsigned char> buf;
+		const std::vector<Image> imgs{
+			proc.getRawImage(), blankLike(proc.getRawImage(), buf)};
+
+		DetectorPipeline pipe{det};
+		std::vector<std::future<PipelineReply>> futs;
+		for (auto i{0UL}; i < nReq; ++i) {
+			futs.emplace_back(pipe.submit(imgs[i % imgs.size()]));
+		}
+		for (auto i{0UL}; i < nReq; ++i) {
+			const auto rep{futs[i].get()};
+			ASSERT_TRUE(rep.ok);
+			EXPECT_GT(rep.timing.forward.count(), 0);
+			EXPECT_GE(rep.timing.latency, rep.timing.forward);
+			if (i % imgs.size() != 0) {
+				EXPECT_TRUE(rep.results.empty());
+				continue;
+			}
+			ASSERT_EQ(rep.results.size(), 1);  // FIXME: tie to test image
+			expectTestTextBox(rep.results.front());
+		}
+	} catch (const std::exception& e) {
+		FAIL() << e.what();
+	} catch (...) {
+		FAIL() << "caught unknown exception";
+	}
+}
+
+// Detect text in a raw grayscale image, converted to color by the pipeline.
+TEST(Neural, DetectorPipelineGrayscale) {  // NOLINT(*-cognitive-complexity)
+	const auto testimage{assetsDir / "images/test_30px_640x640.png"};
+	try {
+		// set up detector
+		beholder::EASTDetector det{};
+		configureEAST(det);
+		ASSERT_TRUE(det.init());
+
+		// read the image
+		Processor proc{};
+		ASSERT_TRUE(proc.readImage(testimage, ReadMode::Grayscale));
+
+		DetectorPipeline pipe{det};
+		const auto rep{pipe.submit(proc.getRawImage()).get()};
+		ASSERT_TRUE(rep.ok);
+		ASSERT_EQ(rep.results.size(), 1);  // FIXME: tie to test image
+		expectTestTextBox(rep.results.front());
+	} catch (const std::exception& e) {
+		FAIL() << e.what();
+	} catch (...) {
+		FAIL() << "caught unknown exception";
+	}
+}
+
+// Detect text concurrently with detectors checked out of a pool.
+TEST(Neural, DetectorPool) {  // NOLINT(*-function-cognitive-complexity)
+	const auto testimage{assetsDir / "images/test_30px_640x640.png"};
+	constexpr std::size_t nDet{2};	// No. pooled detectors
+	constexpr std::size_t nReq{4};	// No. concurrent requests
+	try {
+		// set up the pool
+		beholder::EASTDetector proto{};
+		configureEAST(proto);
+		DetectorPool pool{};
+		ASSERT_TRUE(pool.init(proto, nDet));
+		ASSERT_EQ(pool.size(), nDet);
+		ASSERT_EQ(pool.idle(), nDet);
+
+		// read the image, every other request submits a blank one,
+		// so that each result can be matched to its request
+		Processor proc{};
+		ASSERT_TRUE(proc.readImage(testimage, ReadMode::Color));
+		std::vector<unsigned char> buf;
+		const std::vector<Image> imgs{
+			proc.getRawImage(), blankLike(proc.getRawImage(), buf)};
+
+		std::vector<std::future<std::vector<Result>>> futs;
+		for (auto i{0UL}; i < nReq; ++i) {
+			futs.emplace_back(std::async(std::launch::async, [&, i]() {
+				ObjDetector* det{pool.acquire()};
+				std::vector<Result> res;
+				if (det && det->detect(imgs[i % imgs.size()])) {
+					res = det->getResults();
+				}
+				pool.release(det);
+				return res;
+			}));
+		}
+		for (auto i{0UL}; i < nReq; ++i) {
+			const auto res{futs[i].get()};
+			if (i % imgs.size() != 0) {
+				EXPECT_TRUE(res.empty());
+				continue;
+			}
+			ASSERT_EQ(res.size(), 1);  // FIXME: tie to test image
+			expectTestTextBox(res.front());
+		}
+		EXPECT_EQ(pool.idle(), nDet);
 	} catch (const std::exception& e) {
 		FAIL() << e.what();
 	} catch (...) {
@@ -119,29 +119,27 @@ func cam(cmd *cobra.Command, args []string) error {
 			return err // FIXME: should probably handle timeouts gracefully
 		}
 		log.Println("acquiring...")
-		if err := app.Cs.Acquire(); err != nil {
+		f, err := app.Cs.Acquire()
+		if err != nil {
 			return err
 		}
-		// FIXME: output/processing should not block acquisition
-		for _, cam := range app.Cs {
-			if cam.Result.Buffer == nil {
-				continue
-			}
-			acquired++
+		acquired++
 
-			// FIXME: the image processor shouldn't own the image
-			if err := app.IP.ReceiveRawImage(cam.Result); err != nil {
-				return err
-			}
-			log.Println("writing image with ID: ", cam.Result.ID)
-			var fname string
-			if fname, err = app.F.Get(&cam.Result); err != nil {
-				log.Println("could not generate image filename: ", err.Error())
-				continue
-			}
-			if err := app.IP.WriteImage(fname); err != nil {
-				log.Println("failed to write image: ", err.Error())
-			}
+		// FIXME: output/processing should not block acquisition
+		// FIXME: the image processor shouldn't own the image
+		err = app.IP.ReceiveRawImageAs(f.Image, app.IP.RawOutput)
+		app.Cs.ReleaseFrame(&f) // the processor holds a copy
+		if err != nil {
+			return err
+		}
+		log.Println("writing image with ID: ", f.Image.ID)
+		var fname string
+		if fname, err = app.F.Get(&f.Image); err != nil {
+			log.Println("could not generate image filename: ", err.Error())
+			continue
+		}
+		if err := app.IP.WriteImage(fname); err != nil {
+			log.Println("failed to write image: ", err.Error())
 		}
 	}
 	return nil
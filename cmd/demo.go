@@ -9,6 +9,7 @@ import (
 	"encoding/json"
 	"errors"
 	"fmt"
+	"io"
 	"log"
 	"math"
 	"net"
@@ -18,6 +19,7 @@ import (
 	"path"
 	"runtime"
 	"strings"
+	"sync/atomic"
 	"syscall"
 	"time"
 
@@ -40,6 +42,10 @@ func init() {
 	uuid.EnableRandPool()
 }
 
+// clockSyncPeriod is the period at which camera clocks are resynced
+// with the host's, see [camera.Camera.SyncClock].
+const clockSyncPeriod = 5 * time.Minute
+
 var (
 	demoCmd = &cobra.Command{
 		Use:   "demo [CONFIG]",
@@ -64,6 +70,19 @@ type DemoApp struct {
 	P  *imgproc.Processor     `json:"image_processing"`
 	O  *output.Output         `json:"output"`
 	F  Filename[models.Image] `json:"filename"`
+	// Src replays images from disc instead of acquiring them from
+	// the cameras, if its path is set.
+	Src *imgproc.FileSource `json:"source"`
+	// Rec records the acquired images, before they are processed,
+	// if its path is set.
+	Rec *imgproc.Recorder `json:"record"`
+	// PipelineDepth is the number of camera frames in which objects are
+	// detected ahead of the frame being recognized, if positive, see
+	// [neural.Pipeline]. Frames stay pinned until they're processed,
+	// so it should be kept well below the camera's buffer count.
+	// It has no effect when replaying, since replayed images are only
+	// valid until the next one is read.
+	PipelineDepth int `json:"pipeline_depth"`
 
 	TstImg string `json:"tst_camera_test_image"`
 
@@ -75,16 +94,33 @@ type DemoApp struct {
 	errs chan error
 	// stats is a collection of app statistics and processing results.
 	stats *Stats
+	// replaying is set while images are replayed from Src.
+	replaying atomic.Bool
+	// pipe detects objects (Y) in frames submitted ahead,
+	// if PipelineDepth is positive.
+	pipe *neural.Pipeline
+	// detections are the objects detected in the last processed image,
+	// before they're grown for recognition, see processImage.
+	detections []models.Rectangle
+}
+
+// pipelined is a frame whose objects are being detected ahead,
+// see [DemoApp.PipelineDepth].
+type pipelined struct {
+	f    camera.Frame
+	pend *neural.Pending
 }
 
 // NewDemoApp creates a new demo app.
 func NewDemoApp() *DemoApp {
 	return &DemoApp{
-		Y:  neural.NewYOLOv8(),
-		CR: neural.NewCRAFT(),
-		PS: neural.NewPARSeq(),
-		P:  imgproc.NewProcessor(),
-		O:  output.NewOutput(),
+		Y:   neural.NewYOLOv8(),
+		CR:  neural.NewCRAFT(),
+		PS:  neural.NewPARSeq(),
+		P:   imgproc.NewProcessor(),
+		O:   output.NewOutput(),
+		Src: imgproc.NewFileSource(),
+		Rec: imgproc.NewRecorder(),
 		F: Filename[models.Image]{
 			FString: "img_%v_%v.png",
 			Fields: []string{
@@ -100,18 +136,40 @@ func NewDemoApp() *DemoApp {
 // closes all files and/or connections.
 func (app *DemoApp) Finalize() error {
 	app.Cs.Delete()
+	if app.pipe != nil {
+		app.pipe.Delete()
+	}
 	app.Y.Delete()
 	app.CR.Delete()
 	app.PS.Delete()
 	app.P.Delete()
+	app.Src.Delete()
+	if app.record() {
+		app.Rec.Close()
+		if n := app.Rec.Dropped(); n != 0 {
+			log.Printf("images not recorded: %d", n)
+		}
+	}
+	app.Rec.Delete()
 	return app.O.Close()
 }
 
 // Init initializes app by applying the configuration.
 func (app *DemoApp) Init() error {
-	if err := app.Cs.Init(); err != nil {
+	if app.replay() {
+		if err := app.Src.Init(); err != nil {
+			return err
+		}
+		log.Println("replaying images from: ", app.Src.Path)
+	} else if err := app.Cs.Init(); err != nil {
 		return err
 	}
+	if app.record() {
+		if err := app.Rec.Init(); err != nil {
+			return err
+		}
+		log.Println("recording images to: ", app.Rec.Path)
+	}
 	if len(app.TstImg) != 0 {
 		if err := app.Cs.Apply(func(c *camera.Camera) error {
 			return c.TstSetImage(app.TstImg)
@@ -123,6 +181,17 @@ func (app *DemoApp) Init() error {
 	if err := app.Y.Init(); err != nil {
 		return err
 	}
+	if app.PipelineDepth > 0 && !app.replay() {
+		// objects are detected in the frame, so the processed image
+		// must keep its resolution for the detections to fit
+		if app.P.RawOutput == imgproc.ROHalfColor {
+			return errors.New("pipeline depth set with a half resolution raw output")
+		}
+		var err error
+		if app.pipe, err = neural.NewPipeline(app.Y, app.PipelineDepth); err != nil {
+			return err
+		}
+	}
 	if err := app.CR.Init(); err != nil {
 		return err
 	}
@@ -142,18 +211,26 @@ func (app *DemoApp) Init() error {
 }
 
 // processImage runs the processing pipeline for a single result (image).
-func (app *DemoApp) processImage(res *models.Result) error {
+// Objects are detected first, unless they already were,
+// see [DemoApp.PipelineDepth].
+func (app *DemoApp) processImage(res *models.Result, detected bool) error {
 	sw := stopwatch.New()
 
 	// force 3-channel image
 	app.P.ToColor()
 
 	// detect
-	if err := app.Y.Inference(app.P.GetRawImage(), res); err != nil {
-		log.Printf("object detection error: %v", err)
-		return nil
+	app.detections = app.detections[:0] // none, should detection fail
+	if !detected {
+		if err := app.Y.Inference(app.P.GetRawImage(), res); err != nil {
+			log.Printf("object detection error: %v", err)
+			return nil
+		}
+		res.Timings.Set("yolo", sw.Lap())
 	}
-	res.Timings.Set("yolo", sw.Lap())
+
+	// the boxes are grown below, so the detections are kept as they are
+	app.detections = append(app.detections[:0], res.Boxes...)
 
 	// loop for each yolo ROI
 	for i := range res.Boxes {
@@ -170,19 +247,30 @@ func (app *DemoApp) processImage(res *models.Result) error {
 			continue
 		}
 
-		// loop for each craft ROI
-		tRes := models.NewResult()
-		var ts []string
-		for ei, eb := range eRes.Boxes {
+		// extract all craft ROIs at once
+		for ei := range eRes.Boxes {
+			eb := &eRes.Boxes[ei]
 			eb.Move(res.Boxes[i].Left, res.Boxes[i].Top)
 			eb.Resize(int64(math.Floor(0.05 * float64(min(eb.Height(), eb.Width())))))
-			app.P.SetRotatedROI(eb, eRes.Angles[ei])
+		}
+		rois, err := app.P.ExtractRotatedROIs(eRes.Boxes, eRes.Angles)
+		if err != nil {
+			log.Printf("text extraction error: %v", err)
+			continue
+		}
 
-			if err := app.PS.Inference(app.P.GetRawImage(), tRes); err != nil {
-				log.Printf("text recognition error: %v", err)
-			}
-			ts = append(ts, tRes.Text...)
-			for _, tc := range tRes.Confidences {
+		// recognize all craft ROIs in a single pass
+		tRes := make([]*models.Result, len(rois))
+		for ri := range tRes {
+			tRes[ri] = models.NewResult()
+		}
+		if err := app.PS.BatchInference(rois, tRes); err != nil {
+			log.Printf("text recognition error: %v", err)
+		}
+		var ts []string
+		for _, tr := range tRes {
+			ts = append(ts, tr.Text...)
+			for _, tc := range tr.Confidences {
 				res.Confidences[i] *= tc
 			}
 		}
@@ -213,6 +301,104 @@ func (app *DemoApp) processImage(res *models.Result) error {
 	return nil
 }
 
+// frameDetections returns the objects detected in the last processed image,
+// see processImage, mapped onto the raw image of f, e.g. for the sensor ROI.
+// The two differ in size if the raw output is halved, see
+// [imgproc.ROHalfColor].
+func (app *DemoApp) frameDetections(f camera.Frame) []models.Rectangle {
+	img := app.P.GetRawImage()
+	if img.Cols <= 0 || img.Rows <= 0 {
+		return nil
+	}
+	sx := float64(f.Image.Cols) / float64(img.Cols)
+	sy := float64(f.Image.Rows) / float64(img.Rows)
+	boxes := make([]models.Rectangle, len(app.detections))
+	for i, b := range app.detections {
+		// grown to whole pixels, so that the objects stay covered
+		boxes[i] = models.Rectangle{
+			Left:   int64(math.Floor(float64(b.Left) * sx)),
+			Top:    int64(math.Floor(float64(b.Top) * sy)),
+			Right:  int64(math.Ceil(float64(b.Right) * sx)),
+			Bottom: int64(math.Ceil(float64(b.Bottom) * sy)),
+		}
+	}
+	return boxes
+}
+
+// reconnectStalled reconnects the cameras which stalled because their device
+// was removed, eg. because of a connection glitch, so that they rejoin
+// the acquisition. It reports whether all cameras are acquiring afterwards.
+func (app *DemoApp) reconnectStalled() bool {
+	for _, cam := range app.Cs.Stalled() {
+		if cam.IsAttached() {
+			continue // just slow or not triggered, nothing to reconnect
+		}
+		log.Printf("reconnecting camera %q", cam.SN)
+		if err := app.Cs.Reconnect(cam); err != nil {
+			log.Printf("could not reconnect camera %q: %v", cam.SN, err)
+		}
+	}
+	return app.Cs.IsAcquiring()
+}
+
+// record reports whether acquired images are recorded,
+// see [DemoApp.Rec].
+func (app *DemoApp) record() bool {
+	return len(app.Rec.Path) != 0
+}
+
+// replay reports whether images are replayed from disc, instead of
+// being acquired from the cameras, see [DemoApp.Src].
+func (app *DemoApp) replay() bool {
+	return len(app.Src.Path) != 0
+}
+
+// startSource starts acquiring images from the cameras,
+// or replaying them from disc.
+func (app *DemoApp) startSource() error {
+	if app.replay() {
+		app.replaying.Store(true)
+		return nil
+	}
+	return app.Cs.StartAcquisition()
+}
+
+// stopSource stops acquiring, or replaying, images.
+func (app *DemoApp) stopSource() {
+	if app.replay() {
+		app.replaying.Store(false)
+		return
+	}
+	app.Cs.StopAcquisition()
+}
+
+// sourceActive reports whether images are still being acquired,
+// or replayed.
+func (app *DemoApp) sourceActive() bool {
+	if app.replay() {
+		return app.replaying.Load()
+	}
+	// a removed camera stops acquiring, so it's reconnected before giving up
+	return app.Cs.IsAcquiring() || app.reconnectStalled()
+}
+
+// acquire returns the next image, either acquired from the cameras
+// or replayed from disc, as a frame which must be released once
+// it is no longer needed.
+// io.EOF is returned once the replayed images are exhausted.
+func (app *DemoApp) acquire() (camera.Frame, error) {
+	if !app.replay() {
+		return app.Cs.Acquire()
+	}
+	img, err := app.Src.Next()
+	if err != nil {
+		return camera.Frame{}, err
+	}
+	// replayed images stay valid until the next one is read,
+	// so there's no need for a release
+	return camera.Frame{Image: img, SN: app.Src.Path}, nil
+}
+
 // acquireImages ...
 // TODO: write docs
 func (app *DemoApp) acquireImages() {
@@ -226,114 +412,168 @@ func (app *DemoApp) acquireImages() {
 	sw := stopwatch.New()
 
 	log.Println("starting acquisition")
-	if err := app.Cs.StartAcquisition(); err != nil {
+	if err := app.startSource(); err != nil {
 		app.errs <- err
 		return
 	}
 	// TODO: would be nice to communicate that acquisition has stopped
 	// to other parts of the software.
-	defer app.Cs.StopAcquisition()
+	defer app.stopSource()
+	// collected before acquisition stops, which closes the stream grabbers
+	defer func() {
+		app.stats.Streams = app.Cs.StreamStats()
+		app.stats.Triggers = app.Cs.TriggerStats()
+	}()
 
-	// BUG: stopping acquisiting with [DemoApp.StopAcquisition] gives:
-	//
-	// 	2024/09/26 18:05:57 triggering error or timed out
-	// 	2024/09/26 18:05:57 acquiring image
-	// 	could not acquire image: acquisition not started
-	// 	2024/09/26 18:05:57 error: camera.Camera.Acquire: image acquisition error
-	//
-	// Acquisition should stop cleanly if it's stopped manually.
-	for app.Cs.IsAcquiring() {
+	// frames submitted to the pipeline, oldest first, whose detections
+	// have to be collected before the frames are released
+	var inflight []pipelined
+	defer func() {
+		for _, pl := range inflight {
+			_ = pl.pend.Wait(models.NewResult())
+			app.Cs.ReleaseFrame(&pl.f)
+		}
+	}()
+
+	lastSync := time.Now()
+	for app.sourceActive() {
+		if !app.replay() && time.Since(lastSync) > clockSyncPeriod {
+			// cameras which can't sync keep using host receive times
+			if err := app.Cs.Apply(func(c *camera.Camera) error { return c.SyncClock() }); err != nil {
+				log.Printf("clock sync error: %v", err)
+			}
+			lastSync = time.Now()
+		}
 		app.stats.Result.Reset()
 		app.stats.Result.Timestamp = time.Now()
 		sw.Lap() // reset the lap for the new acquisition loop
 
-		// use the trigger if it's defined
+		// use the trigger if it's defined, scheduled triggers are
+		// executed by the cameras' scheduler threads instead
 		// TODO: the trigger should enable single/multiple image acquisition
 		// mode, it currently only supports continuous (infinite) acquisition.
 		if err := app.Cs.TryTrigger(); err != nil {
-			// TODO: would be nice to know which camera failed to trigger.
-			log.Println("triggering error or timed out")
-			// FIXME: IsAcquiring should pick up more serious errors, so
-			// we should be able to ignore trigger errors entirely,
-			// however if we fail to trigger there is no sense in trying
-			// to acquire.
-			// The issue is that we currently expect all cameras to trigger
-			// once TryTrigger is called, so if one camera fails to trigger
-			// we won't acquire any images.
-			// What we should probably do is trigger the first available
-			// camera, and then acquire the first available image, that is
-			// we have to change how [camera.Array] functions which implies
-			// modifying the C-API.
-			// When this is done, the loop below won't be necessary.
-			continue
+			// a camera which fails to trigger won't hold up the others,
+			// so we acquire regardless
+			log.Printf("triggering error or timed out: %v", err)
 		}
 		log.Println("acquiring image")
-		if err := app.Cs.Acquire(); err != nil {
-			// TODO: would be nice to know which camera failed to acquire.
-			app.errs <- err
-			return
+		f, err := app.acquire()
+		if errors.Is(err, io.EOF) {
+			log.Println("replayed images exhausted")
+			break
+		}
+		if err != nil {
+			// the stalled cameras are named by the error
+			log.Printf("acquisition error: %v", err)
+			app.reconnectStalled()
+			continue
 		}
 		app.stats.Result.Timings.Set("acquisition", sw.Lap())
 
-		// FIXME: output/processing should not block acquisition
-		for _, cam := range app.Cs {
-			if cam.Result.Buffer == nil {
-				continue
-			}
-			sw.Lap() // reset the lap to time processing
-
-			// FIXME: the image processor shouldn't own the image
-			if err := app.P.ReceiveRawImage(cam.Result); err != nil {
-				// TODO: would be nice to know which camera failed to
-				// yield an image.
-				app.errs <- err
-				return
+		// the pin keeps the camera buffer alive until it's written,
+		// so it isn't copied here, replayed images are copied instead
+		if app.record() {
+			if err := app.Rec.Record(f.Image, f.SN, f.Pin()); err != nil {
+				log.Printf("recording error, camera %q: %v", f.SN, err)
 			}
-			log.Printf("processing image: %d", cam.Result.ID)
-			if err := app.processImage(app.stats.Result); err != nil {
-				// TODO: would be nice to know from which camera the failed
-				// image came from.
-				log.Printf("processing error: %v", err)
+		}
+		app.stats.Result.Timings.Set("record", sw.Lap())
+
+		// the camera keeps the buffer until the frame is released, so
+		// objects are detected straight from it, while earlier frames
+		// are recognized, and the frame is processed once it's the oldest
+		detected := app.pipe != nil
+		if detected {
+			pend, err := app.pipe.Submit(f.Image)
+			if err != nil {
+				log.Printf("object detection error, camera %q: %v", f.SN, err)
+				app.Cs.ReleaseFrame(&f)
 				continue
 			}
-			app.stats.Result.Timings.Set("process", sw.Lap())
-
-			// FIXME: encoding/writing should not block acquisition/processing.
-			var err error
-			var fname string
-			if fname, err = app.F.Get(&cam.Result); err != nil {
-				log.Printf("could not generate image filename: %v", err)
+			inflight = append(inflight, pipelined{f: f, pend: pend})
+			if len(inflight) < app.PipelineDepth {
+				continue
 			}
-			app.stats.Result.Timings.Set("gen-fname", sw.Lap())
-
-			var encoding []byte
-			if encoding, err = app.P.EncodeImage(path.Ext(fname)); err != nil {
-				log.Printf("failed to encode image: %v", err)
-				app.stats.RollingAverage(app.stats.Result.Timings)
+			pl := inflight[0]
+			inflight = inflight[1:]
+			f = pl.f
+			if err := pl.pend.Wait(app.stats.Result); err != nil {
+				log.Printf("object detection error, camera %q: %v", f.SN, err)
+				app.Cs.ReleaseFrame(&f)
 				continue
 			}
-			app.stats.Result.Timings.Set("encode", sw.Lap())
+			app.stats.Result.Timings.Set("yolo", sw.Lap())
+		}
 
-			if err := os.WriteFile(fname, encoding, 0644); err != nil {
-				log.Printf("failed to write image: %v", err)
-			}
-			app.stats.Result.Timings.Set("write", sw.Lap())
+		// FIXME: output/processing should not block acquisition
+		// the camera keeps the buffer until the frame is released,
+		// so the processor can work on it in place
+		if err := app.P.ViewRawImage(f.Image, app.P.RawOutput); err != nil {
+			app.Cs.ReleaseFrame(&f)
+			app.errs <- fmt.Errorf("camera %q: %w", f.SN, err)
+			return
+		}
+		log.Printf("processing image: %d from camera %q", f.Image.ID, f.SN)
+		if err := app.processImage(app.stats.Result, detected); err != nil {
+			log.Printf("processing error, camera %q: %v", f.SN, err)
+			app.P.ReleaseRawImage()
+			app.Cs.ReleaseFrame(&f)
+			continue
+		}
+		app.stats.Result.Timings.Set("process", sw.Lap())
 
-			blob := &server.Blob{
-				UUID:   uuid.Must(uuid.NewV7()), // FIXME: should take img.UUID
-				Source: cam.SN,
-				Bytes:  encoding,
+		// fit the sensor region to the detections, if configured
+		if !app.replay() {
+			if err := app.Cs.UpdateROI(f, app.frameDetections(f)); err != nil {
+				log.Printf("sensor ROI error, camera %q: %v", f.SN, err)
 			}
-			app.blobs <- blob
-			app.stats.Result.Timings.Set("ch-send", sw.Lap())
+		}
+		app.stats.Result.Timings.Set("roi", sw.Lap())
 
+		// FIXME: encoding/writing should not block acquisition/processing.
+		var fname string
+		if fname, err = app.F.Get(&f.Image); err != nil {
+			log.Printf("could not generate image filename: %v", err)
+		}
+		app.stats.Result.Timings.Set("gen-fname", sw.Lap())
+
+		var encoding []byte
+		encoding, err = app.P.EncodeImage(path.Ext(fname))
+		app.P.ReleaseRawImage() // the encoding is a copy
+		app.Cs.ReleaseFrame(&f)
+		if err != nil {
+			log.Printf("failed to encode image: %v", err)
 			app.stats.RollingAverage(app.stats.Result.Timings)
+			continue
+		}
+		app.stats.Result.Timings.Set("encode", sw.Lap())
+
+		if err := os.WriteFile(fname, encoding, 0644); err != nil {
+			log.Printf("failed to write image: %v", err)
+		}
+		app.stats.Result.Timings.Set("write", sw.Lap())
+
+		blob := &server.Blob{
+			UUID:   uuid.Must(uuid.NewV7()), // FIXME: should take img.UUID
+			Source: f.SN,
+			Bytes:  encoding,
 		}
+		app.blobs <- blob
+		app.stats.Result.Timings.Set("ch-send", sw.Lap())
+		// the image is timestamped at exposure, if the camera's clock
+		// is synced, so this is the latency from exposure to result
+		app.stats.Result.Timings.Set("latency", time.Since(f.Image.Timestamp))
+
+		app.stats.RollingAverage(app.stats.Result.Timings)
 	}
 }
 
 // IsAcquiring reports whether image acquisition is currently running.
 func (app *DemoApp) IsAcquiring() bool {
+	if app.replay() {
+		return app.replaying.Load()
+	}
 	runtime.LockOSThread()
 	defer runtime.UnlockOSThread()
 	return app.Cs.IsAcquiring()
@@ -358,7 +598,7 @@ func (app *DemoApp) StartAcquisition(blobsSize int) (<-chan *server.Blob, <-chan
 // stoppage and close any channels currently in use, which might not be
 // the best idea.
 func (app *DemoApp) StopAcquisition() {
-	app.Cs.StopAcquisition()
+	app.stopSource()
 }
 
 // demoMain reads the runtime configuration and sets up and runs the program.
@@ -10,6 +10,7 @@ import (
 	"strings"
 	"time"
 
+	"github.com/Milover/beholder/internal/camera"
 	"github.com/Milover/beholder/internal/chrono"
 	"github.com/Milover/beholder/internal/models"
 )
@@ -23,6 +24,12 @@ type Stats struct {
 	InitDuration time.Duration
 	// ExecDuration is the total time elapsed while running the program.
 	ExecDuration time.Duration
+	// Streams are the image data stream statistics of each camera,
+	// keyed by serial number, as of when acquisition was last stopped.
+	Streams map[string]camera.StreamStats
+	// Triggers are the statistics of each camera's trigger scheduler,
+	// keyed by serial number, for cameras with a scheduled trigger.
+	Triggers map[string]camera.TriggerStats
 
 	avgCount int64 // rolling average count
 }
@@ -60,5 +67,11 @@ func (s *Stats) String() string {
 		s.InitDuration,
 		s.ExecDuration,
 	)
+	for sn, st := range s.Streams {
+		fmt.Fprintf(&b, "stream %v: %+v\n", sn, st)
+	}
+	for sn, tr := range s.Triggers {
+		fmt.Fprintf(&b, "trigger %v: %+v\n", sn, tr)
+	}
 	return b.String()
 }
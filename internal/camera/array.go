@@ -4,13 +4,29 @@
 
 package camera
 
-import "errors"
+/*
+#include <stdlib.h>
+#include "camera.h"
+*/
+import "C"
+import (
+	"errors"
+	"fmt"
+	"slices"
+	"strings"
+	"sync"
+	"time"
+
+	"github.com/Milover/beholder/internal/mem"
+	"github.com/Milover/beholder/internal/models"
+)
 
 // Array represents an array of camera devices.
 //
-// Array supports most [Camera] functions, and calls them for each camera
-// in the array sequentially, hence it can be used as if though it were
-// a single [Camera].
+// Array supports most [Camera] functions, hence it can be used as if though
+// it were a single [Camera]. Images are acquired from all cameras
+// concurrently and handed out in the order in which they arrive,
+// see [Array.Acquire].
 type Array []*Camera
 
 // Apply is a function which sequentially applies fn
@@ -24,17 +40,56 @@ func (a Array) Apply(fn func(*Camera) error) error {
 	return err
 }
 
-// Acquire attempts to acquire images from each camera in the array.
-// See [Camera.Acquire] for more details.
+// cams returns the C-handles of the cameras in the array.
+func (a Array) cams() []C.Cam {
+	cs := make([]C.Cam, len(a))
+	for i, cam := range a {
+		cs[i] = cam.p
+	}
+	return cs
+}
+
+// Acquire returns the first image acquired by any camera in the array,
+// waiting up to the longest [Camera.AcquisitionTimeout] for one to arrive.
+// Images are returned in the order in which they arrived, tagged with
+// the serial number of the camera which acquired them.
 //
-// FIXME: this is a provisional implementation. We should not assume that
-// all cameras will yield an image at the same time, instead, we should
-// just acquire the first available image from any camera in the array and
-// leave concurrency, thread locking and other details up to the caller.
-func (a Array) Acquire() error {
-	return a.Apply(func(c *Camera) error {
-		return c.Acquire()
-	})
+// A camera which fails to acquire an image does not hold up the others.
+// If no image arrives in time, the returned error names the cameras
+// which have not delivered an image within their own
+// [Camera.AcquisitionTimeout], see [Array.Stalled].
+//
+// The image is kept until it is explicitly released,
+// see [Array.ReleaseFrame].
+func (a Array) Acquire() (Frame, error) {
+	if len(a) == 0 {
+		return Frame{}, errors.New("camera.Array.Acquire: empty camera array")
+	}
+	var timeout time.Duration
+	for _, cam := range a {
+		timeout = max(timeout, cam.AcquisitionTimeout.Duration)
+	}
+	cs := a.cams()
+	var idx C.size_t
+	var r C.Img
+	h := C.CamArr_NextFrame(&cs[0], C.size_t(len(cs)), C.size_t(timeout.Milliseconds()), &idx, &r)
+	if h == (C.Frm)(nil) {
+		var sns []string
+		for _, cam := range a.Stalled() {
+			sns = append(sns, cam.SN)
+		}
+		if len(sns) == 0 {
+			return Frame{}, fmt.Errorf("camera.Array.Acquire: %w", ErrAcquisition)
+		}
+		return Frame{}, fmt.Errorf("camera.Array.Acquire: %w: stalled cameras: %s",
+			ErrAcquisition, strings.Join(sns, ", "))
+	}
+	return Frame{
+		Image: toImage(r),
+		SN:    a[idx].SN,
+		ROI:   a[idx].roi,
+		h:     h,
+	}, nil
 }
 
 // Delete releases the C-allocated memory of each camera in the array,
@@ -48,10 +103,50 @@ func (a Array) Delete() {
 
 // Init initializes (C call) all camera device with configuration data,
 // see [Camera.Init] for more details.
+//
+// Unlike calling [Camera.Init] for each camera, the cameras are brought up
+// concurrently: devices of the same [Type] are found with a single
+// enumeration, rebooted together, and then opened and configured
+// in parallel.
 func (a Array) Init() error {
-	return a.Apply(func(c *Camera) error {
-		return c.Init()
-	})
+	ar := &mem.Arena{}
+	defer ar.Free()
+
+	// group cameras by transport layer
+	type group struct {
+		tl   *transportLayer
+		cams Array
+		ins  []C.CamInit
+	}
+	var groups []*group
+	for _, cam := range a {
+		tl, in, err := cam.prepare(ar)
+		if err != nil {
+			return err
+		}
+		i := slices.IndexFunc(groups, func(g *group) bool { return g.tl.p == tl.p })
+		if i < 0 {
+			i = len(groups)
+			groups = append(groups, &group{tl: tl})
+		}
+		groups[i].cams = append(groups[i].cams, cam)
+		groups[i].ins = append(groups[i].ins, in)
+	}
+	var err error
+	for _, g := range groups {
+		cs := g.cams.cams()
+		if ok := C.CamArr_Init(&cs[0], C.size_t(len(cs)), g.tl.p, &g.ins[0]); !ok {
+			err = errors.Join(err, fmt.Errorf("camera.Array.Init: could not initialize cameras of type: %q", g.tl.typ))
+			continue
+		}
+		err = errors.Join(err, g.cams.Apply(func(c *Camera) error {
+			if err := c.initRing(); err != nil {
+				return err
+			}
+			return c.initStream()
+		}))
+	}
+	return err
 }
 
 // IsAcquiring reports the image acquisition status of the camera array.
@@ -65,18 +160,89 @@ func (a Array) IsAcquiring() bool {
 	return acq
 }
 
+// Reconnect reattaches the device of cam, which must be a camera of
+// the array, eg. after it was removed because of a connection glitch,
+// see [Camera.Reconnect].
+// If the array is acquiring, cam rejoins the acquisition, i.e. its frames
+// are returned by [Array.Acquire] again.
+//
+// All frames acquired by cam must be released before calling Reconnect.
+func (a Array) Reconnect(cam *Camera) error {
+	i := slices.Index(a, cam)
+	if i < 0 {
+		return errors.New("camera.Array.Reconnect: camera not in array")
+	}
+	tl, err := getTransportLayer(cam.Type)
+	if err != nil {
+		return fmt.Errorf("camera.Array.Reconnect: %w", err)
+	}
+	cs := a.cams()
+	if ok := C.CamArr_Reconnect(&cs[0], C.size_t(len(cs)), C.size_t(i), tl.p); !ok {
+		return fmt.Errorf("camera.Array.Reconnect: could not reconnect camera %q", cam.SN)
+	}
+	cam.roi, _ = cam.ROI()
+	return nil
+}
+
+// ReleaseFrame releases f, handing its buffer back to the camera
+// which acquired it. The handle and image buffer of f are cleared,
+// so releasing f again does nothing, but the image metadata can still
+// be read.
+func (a Array) ReleaseFrame(f *Frame) {
+	if f == nil {
+		return
+	}
+	C.Frm_Delete(&f.h)
+	f.Image.Buffer = nil
+}
+
+// Stalled returns the cameras in the array which have not delivered
+// an image within their [Camera.AcquisitionTimeout], or which are
+// not acquiring at all.
+func (a Array) Stalled() []*Camera {
+	var stalled []*Camera
+	for _, cam := range a {
+		if idle, ok := cam.IdleTime(); !ok || idle > cam.AcquisitionTimeout.Duration {
+			stalled = append(stalled, cam)
+		}
+	}
+	return stalled
+}
+
 // StartAcquisition starts image acquisition for each camera in the array,
-// see [Camera.StartAcquisition] for more details.
+// each on its own grab thread, see [Camera.StartGrabbing].
+//
+// Cameras with a scheduled [Trigger] start triggering once grabbing
+// has started, see [Camera.StartTriggering].
+//
+// If acquisition cannot be started on any of the cameras, it is stopped
+// on all of them.
 func (a Array) StartAcquisition() error {
-	return a.Apply(func(c *Camera) error {
-		return c.StartAcquisition()
+	if len(a) == 0 {
+		return errors.New("camera.Array.StartAcquisition: empty camera array")
+	}
+	cs := a.cams()
+	if ok := C.CamArr_StartGrabbing(&cs[0], C.size_t(len(cs))); !ok {
+		return errors.New("camera.Array.StartAcquisition: could not start image acquisition")
+	}
+	err := a.Apply(func(c *Camera) error {
+		if c.Trigger == nil || !c.Trigger.Scheduled {
+			return nil
+		}
+		return c.StartTriggering()
 	})
+	if err != nil {
+		a.StopAcquisition()
+		return fmt.Errorf("camera.Array.StartAcquisition: %w", err)
+	}
+	return nil
 }
 
-// StopAcquisition stops image acquisition for each camera in the array,
-// see [Camera.StopAcquisition] for more details.
+// StopAcquisition stops image acquisition, and the trigger scheduler,
+// for each camera in the array, see [Camera.StopAcquisition] for more details.
 func (a Array) StopAcquisition() {
 	_ = a.Apply(func(c *Camera) error {
+		c.StopTriggering()
 		c.StopAcquisition()
 		return nil
 	})
@@ -85,10 +251,20 @@ func (a Array) StopAcquisition() {
 // TryTrigger is a function that will try to execute a software trigger
 // for each camera in the array, see [Camera.TryTrigger] for more details.
 //
-// TODO: rethink whether we should try to trigger all cameras in the array,
-// or just the first triggerable one.
+// The cameras are triggered concurrently, so waiting for one camera to
+// become ready does not delay the others.
 func (a Array) TryTrigger() error {
-	return a.Apply(func(c *Camera) error {
-		return c.TryTrigger()
-	})
+	errs := make([]error, len(a))
+	var wg sync.WaitGroup
+	for i, cam := range a {
+		wg.Add(1)
+		go func() {
+			defer wg.Done()
+			if err := cam.TryTrigger(); err != nil {
+				errs[i] = fmt.Errorf("camera %q: %w", cam.SN, err)
+			}
+		}()
+	}
+	wg.Wait()
+	return errors.Join(errs...)
 }
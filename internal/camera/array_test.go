@@ -136,13 +136,136 @@ func TestArray(t *testing.T) {
 				t.Log("trigger fired")
 
 				t.Log("acquiring...")
-				err = errors.Join(err, p.Cs.Acquire())
-				for _, cam := range p.Cs {
-					if cam.Result.Buffer != nil { //nolint:staticcheck // wat do?
-					}
+				f, e := p.Cs.Acquire()
+				err = errors.Join(err, e)
+				if e == nil {
+					assert.NotNil(f.Image.Buffer, "acquired image has no buffer")
+					assert.NotEmpty(f.SN, "acquired frame has no source")
+					p.Cs.ReleaseFrame(&f)
 				}
 				assert.ErrorIs(err, tt.Error, "unexpected error")
 			}
 		})
 	}
 }
+
+type arrayInitTest struct {
+	Name        string
+	Fail        bool   // should initialization fail?
+	Initialized []bool // which cameras should end up initialized
+	Config      string
+}
+
+var arrayInitTests = []arrayInitTest{
+	{
+		Name:        "emulated",
+		Fail:        false,
+		Initialized: []bool{true, true},
+		Config: `
+{
+	"cameras": [
+		{"type": "emulated", "serial_number": "0815-0000"},
+		{"type": "emulated", "serial_number": "0815-0001"}
+	]
+}
+`,
+	},
+	{
+		Name:        "emulated-missing-device",
+		Fail:        true,
+		Initialized: []bool{true, false},
+		Config: `
+{
+	"cameras": [
+		{"type": "emulated", "serial_number": "0815-0000"},
+		{"type": "emulated", "serial_number": "0815-0999"}
+	]
+}
+`,
+	},
+}
+
+// TestArrayInit tests initialization of an array of cameras, where
+// devices which can't be created must not hold up the others.
+func TestArrayInit(t *testing.T) {
+	for _, tt := range arrayInitTests {
+		t.Run(tt.Name, func(t *testing.T) {
+			assert := assert.New(t)
+			require := require.New(t)
+
+			p := struct {
+				Cs Array `json:"cameras"`
+			}{}
+			defer p.Cs.Delete()
+			err := json.Unmarshal([]byte(tt.Config), &p)
+			require.NoError(err)
+			require.Len(p.Cs, len(tt.Initialized))
+
+			err = p.Cs.Init()
+			if tt.Fail {
+				assert.Error(err)
+			} else {
+				assert.NoError(err)
+			}
+			for i, cam := range p.Cs {
+				assert.Equal(tt.Initialized[i], cam.IsInitialized(), "camera %d", i)
+			}
+		})
+	}
+}
+
+// TestArrayReconnect tests reconnecting a camera of an array, which should
+// rejoin the acquisition afterwards.
+func TestArrayReconnect(t *testing.T) {
+	assert := assert.New(t)
+	require := require.New(t)
+
+	const config = `
+{
+	"cameras": [
+		{
+			"type": "emulated",
+			"serial_number": "0815-0000",
+			"acquisition_timeout": "1s",
+			"parameters": [
+				{"name": "AcquisitionMode",    "value": "Continuous"},
+				{"name": "TriggerSelector",    "value": "FrameStart"},
+				{"name": "TriggerMode",        "value": "On"},
+				{"name": "TriggerSource",      "value": "Software"}
+			]
+		},
+		{
+			"type": "emulated",
+			"serial_number": "0815-0001",
+			"acquisition_timeout": "1s",
+			"parameters": [
+				{"name": "AcquisitionMode",    "value": "Continuous"},
+				{"name": "TriggerSelector",    "value": "FrameStart"},
+				{"name": "TriggerMode",        "value": "On"},
+				{"name": "TriggerSource",      "value": "Software"}
+			]
+		}
+	]
+}
+`
+	p := struct {
+		Cs Array `json:"cameras"`
+	}{}
+	defer p.Cs.Delete()
+	require.NoError(json.Unmarshal([]byte(config), &p))
+	require.NoError(p.Cs.Init())
+	require.NoError(p.Cs.StartAcquisition())
+	defer p.Cs.StopAcquisition()
+
+	assert.Error(p.Cs.Reconnect(NewCamera()), "camera outside the array")
+	cam := p.Cs[1]
+	require.NoError(p.Cs.Reconnect(cam))
+	assert.True(cam.IsAcquiring())
+
+	// the reconnected camera's frames are acquired by the array again
+	require.NoError(cam.CmdExecute("TriggerSoftware"))
+	f, err := p.Cs.Acquire()
+	require.NoError(err)
+	assert.Equal(cam.SN, f.SN)
+	p.Cs.ReleaseFrame(&f)
+}
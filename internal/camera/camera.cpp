@@ -7,11 +7,14 @@
 #include <pylon/Device.h>
 #include <pylon/TypeMappings.h>
 
+#include <algorithm>
 #include <chrono>
+#include <cstdint>
 #include <cstdlib>
 #include <cstring>
 #include <iostream>
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -32,6 +35,30 @@ bool Cam_Acquire(Cam c, size_t timeoutMs) {
 	return false;
 }
 
+bool Cam_AcquireFrame(Cam c, size_t timeoutMs, size_t *slot, uint64_t *gen,
+					  Img *img) {
+	if (!c || !slot || !gen || !img) {
+		return false;
+	}
+	try {
+		auto s{c->acquireFrame(std::chrono::milliseconds{timeoutMs})};
+		if (!s) {
+			return false;
+		}
+		*slot = s->index;
+		*gen = s->generation;
+		*img = c->getFrame(*s).getImage().toC();
+		return true;
+	} catch (const Pylon::GenericException &e) {
+		std::cerr << "could not acquire image: " << e.what() << std::endl;
+	} catch (const beholder::Exception &e) {
+		std::cerr << "could not acquire image: " << e.what() << std::endl;
+	} catch (...) {
+		std::cerr << "could not acquire image" << std::endl;
+	}
+	return false;
+}
+
 bool Cam_CmdExecute(Cam c, const char *cmd) {
 	if (!c) {
 		return false;
@@ -53,6 +80,38 @@ void Cam_Delete(Cam *c) {
 	}
 }
 
+bool Cam_GetFullROI(Cam c, SROI *r) {
+	if (!c || !r) {
+		return false;
+	}
+	const auto roi{c->getFullROI()};
+	if (!roi) {
+		return false;
+	}
+	*r = SROI{roi->offsetX, roi->offsetY, roi->width, roi->height,
+			  roi->binning};
+	return true;
+}
+
+bool Cam_GetIdleTime(Cam c, size_t *ms) {
+	if (!c || !ms) {
+		return false;
+	}
+	auto t{c->getIdleTime()};
+	if (!t) {
+		return false;
+	}
+	*ms = static_cast<size_t>(t->count());
+	return true;
+}
+
+size_t Cam_GetNoDroppedFrames(Cam c) {
+	if (c) {
+		return c->getNoDroppedFrames();
+	}
+	return 0;
+}
+
 Img Cam_GetRawImage(Cam c) {
 	if (!c) {
 		return Img{};
@@ -64,6 +123,61 @@ Img Cam_GetRawImage(Cam c) {
 	return std::move(res).value().moveToC();
 }
 
+bool Cam_GetROI(Cam c, SROI *r) {
+	if (!c || !r) {
+		return false;
+	}
+	const auto roi{c->getROI()};
+	if (!roi) {
+		return false;
+	}
+	*r = SROI{roi->offsetX, roi->offsetY, roi->width, roi->height,
+			  roi->binning};
+	return true;
+}
+
+bool Cam_GetStreamStats(Cam c, StrStats *s) {
+	if (!c || !s) {
+		return false;
+	}
+	const auto st{c->getStreamStats()};
+	if (!st) {
+		return false;
+	}
+	s->totalBuffers = st->totalBuffers;
+	s->failedBuffers = st->failedBuffers;
+	s->bufferUnderruns = st->bufferUnderruns;
+	s->totalPackets = st->totalPackets;
+	s->failedPackets = st->failedPackets;
+	s->resendRequests = st->resendRequests;
+	s->resendPackets = st->resendPackets;
+	s->missedFrames = st->missedFrames;
+	s->skippedFrames = st->skippedFrames;
+	s->droppedFrames = st->droppedFrames;
+	s->timeouts = st->timeouts;
+	return true;
+}
+
+bool Cam_GetTriggerStats(Cam c, TrigStats *s) {
+	if (!c || !s) {
+		return false;
+	}
+	const auto st{c->getTriggerStats()};
+	s->triggers = st.triggers;
+	s->missed = st.missed;
+	s->frames = st.frames;
+	s->unanswered = st.unanswered;
+	s->intervalMean = st.intervalMean;
+	s->intervalStd = st.intervalStd;
+	s->jitterMean = st.jitterMean;
+	s->jitterStd = st.jitterStd;
+	s->jitterMax = st.jitterMax;
+	s->latencyMean = st.latencyMean;
+	s->latencyStd = st.latencyStd;
+	s->latencyMax = st.latencyMax;
+	return true;
+}
+
 bool Cam_IsAcquiring(Cam c) {
 	if (c) {
 		return c->isAcquiring();
@@ -107,6 +221,47 @@ bool Cam_Init(Cam c, Trans t, const CamInit *in) {
 
 Cam Cam_New() { return new beholder::Camera{}; }
 
+Frm Cam_NextFrame(Cam c, size_t timeoutMs, Img *img) {
+	if (!c || !img) {
+		return nullptr;
+	}
+	try {
+		auto f{c->nextFrame(std::chrono::milliseconds{timeoutMs})};
+		if (!f || !f->isValid()) {
+			return nullptr;
+		}
+		*img = f->getImage().toC();
+		return new beholder::Frame{std::move(f).value()};
+	} catch (const Pylon::GenericException &e) {
+		std::cerr << "could not get next frame: " << e.what() << std::endl;
+	} catch (const beholder::Exception &e) {
+		std::cerr << "could not get next frame: " << e.what() << std::endl;
+	} catch (...) {
+		std::cerr << "could not get next frame" << std::endl;
+	}
+	return nullptr;
+}
+
+bool Cam_Reconnect(Cam c, Trans t) {
+	if (!c || !t) {
+		return false;
+	}
+	return c->reconnect(*t);
+}
+
+void Cam_ReleaseFrame(Cam c, size_t slot, uint64_t gen) {
+	if (c) {
+		c->releaseFrame(beholder::FrameSlot{slot, gen});
+	}
+}
+
+bool Cam_RequestTrigger(Cam c) {
+	if (!c) {
+		return false;
+	}
+	return c->requestTrigger();
+}
+
 bool Cam_SetParameters(Cam c, Par *pars, size_t nPars) {
 	if (!c) {
 		return false;
@@ -121,6 +276,36 @@ bool Cam_SetParameters(Cam c, Par *pars, size_t nPars) {
 	return c->setParams(list);
 }
 
+bool Cam_SetROI(Cam c, const SROI *r) {
+	if (!c || !r) {
+		return false;
+	}
+	return c->setROI(beholder::SensorROI{r->offsetX, r->offsetY, r->width,
+										 r->height, r->binning});
+}
+
+bool Cam_SetRingSize(Cam c, size_t n) {
+	if (c) {
+		return c->setRingSize(n);
+	}
+	return false;
+}
+
+bool Cam_SetStreamConfig(Cam c, const StrCfg *cfg) {
+	if (!c || !cfg) {
+		return false;
+	}
+	auto opt = [](int64_t v) -> std::optional<std::int64_t> {
+		if (v < 0) {
+			return std::nullopt;
+		}
+		return v;
+	};
+	return c->setStreamConfig(beholder::StreamConfig{
+		opt(cfg->maxNumBuffer), opt(cfg->packetSize),
+		opt(cfg->interPacketDelay), opt(cfg->frameTransmissionDelay)});
+}
+
 bool Cam_StartAcquisition(Cam c) {
 	if (c) {
 		return c->startAcquisition();
@@ -128,12 +313,42 @@ bool Cam_StartAcquisition(Cam c) {
 	return false;
 }
 
+bool Cam_StartGrabbing(Cam c) {
+	if (c) {
+		return c->startGrabbing();
+	}
+	return false;
+}
+
+bool Cam_StartTriggering(Cam c, const TrigSched *s) {
+	if (!c || !s) {
+		return false;
+	}
+	return c->startTriggering(
+		beholder::TriggerSchedule{std::chrono::microseconds{s->periodUs},
+								  std::chrono::microseconds{s->spinUs},
+								  std::chrono::milliseconds{s->maxLatencyMs}});
+}
+
 void Cam_StopAcquisition(Cam c) {
 	if (c) {
 		c->stopAcquisition();
 	}
 }
 
+void Cam_StopTriggering(Cam c) {
+	if (c) {
+		c->stopTriggering();
+	}
+}
+
+bool Cam_SyncClock(Cam c) {
+	if (!c) {
+		return false;
+	}
+	return c->syncClock();
+}
+
 bool Cam_Trigger(Cam c) {
 	if (!c) {
 		return false;
@@ -148,6 +363,129 @@ bool Cam_WaitAndTrigger(Cam c, size_t timeoutMs) {
 	return c->waitAndTrigger(std::chrono::milliseconds{timeoutMs});
 }
 
+bool CamArr_Init(Cam *cs, size_t n, Trans t, const CamInit *ins) {
+	if (!cs || !t || !ins || std::find(cs, cs + n, nullptr) != cs + n) {
+		return false;
+	}
+	try {
+		// create devices, one batch per reboot setting
+		std::vector<Pylon::IPylonDevice *> devs(n, nullptr);
+		for (const bool reboot : {true, false}) {
+			std::vector<std::string> sns;
+			std::vector<size_t> idx;
+			for (auto i{0ul}; i < n; ++i) {
+				if (ins[i].reboot == reboot) {
+					sns.emplace_back(ins[i].sn);
+					idx.push_back(i);
+				}
+			}
+			if (sns.empty()) {
+				continue;
+			}
+			auto ds{
+				t->createDevices(sns, beholder::DeviceDesignator::SN, reboot)};
+			for (auto i{0ul}; i < idx.size(); ++i) {
+				devs[idx[i]] = ds[i];
+			}
+		}
+		// params
+		std::vector<beholder::ParamList> lists(n);
+		for (auto i{0ul}; i < n; ++i) {
+			lists[i].reserve(ins[i].nPars);
+			for (auto j{0ul}; j < ins[i].nPars; ++j) {
+				lists[i].emplace_back(ins[i].pars[j].name,
+									  ins[i].pars[j].value);
+			}
+		}
+		// NOTE: we don't technically have to fail if params can't be set
+		bool ok{std::find(devs.begin(), devs.end(), nullptr) == devs.end()};
+		beholder::CameraArray arr{std::vector<Cam>(cs, cs + n)};
+		return arr.init(devs, lists) && ok;
+	} catch (const Pylon::GenericException &e) {
+		std::cerr << "could not initialize cameras: " << e.what() << std::endl;
+	} catch (const beholder::Exception &e) {
+		std::cerr << "could not initialize cameras: " << e.what() << std::endl;
+	} catch (...) {
+		std::cerr << "could not initialize cameras" << std::endl;
+	}
+	return false;
+}
+
+Frm CamArr_NextFrame(Cam *cs, size_t n, size_t timeoutMs, size_t *idx,
+					 Img *img) {
+	if (!cs || !idx || !img) {
+		return nullptr;
+	}
+	try {
+		beholder::CameraArray arr{std::vector<Cam>(cs, cs + n)};
+		auto f{arr.nextFrame(std::chrono::milliseconds{timeoutMs})};
+		if (!f || !f->frame.isValid()) {
+			return nullptr;
+		}
+		*idx = f->index;
+		*img = f->frame.getImage().toC();
+		return new beholder::Frame{std::move(f->frame)};
+	} catch (const Pylon::GenericException &e) {
+		std::cerr << "could not get next frame: " << e.what() << std::endl;
+	} catch (const beholder::Exception &e) {
+		std::cerr << "could not get next frame: " << e.what() << std::endl;
+	} catch (...) {
+		std::cerr << "could not get next frame" << std::endl;
+	}
+	return nullptr;
+}
+
+bool CamArr_Reconnect(Cam *cs, size_t n, size_t i, Trans t) {
+	if (!cs || !t || std::find(cs, cs + n, nullptr) != cs + n) {
+		return false;
+	}
+	try {
+		return beholder::CameraArray{std::vector<Cam>(cs, cs + n)}.reconnect(
+			i, *t);
+	} catch (...) {
+		std::cerr << "could not reconnect camera" << std::endl;
+	}
+	return false;
+}
+
+bool CamArr_StartGrabbing(Cam *cs, size_t n) {
+	if (!cs) {
+		return false;
+	}
+	try {
+		return beholder::CameraArray{std::vector<Cam>(cs, cs + n)}
+			.startGrabbing();
+	} catch (...) {
+		std::cerr << "could not start grabbing" << std::endl;
+	}
+	return false;
+}
+
+void CamArr_StopAcquisition(Cam *cs, size_t n) {
+	if (!cs) {
+		return;
+	}
+	try {
+		beholder::CameraArray{std::vector<Cam>(cs, cs + n)}.stopAcquisition();
+	} catch (...) {
+		std::cerr << "could not stop acquisition" << std::endl;
+	}
+}
+
+void Frm_Delete(Frm *f) {
+	if (f && *f) {
+		delete *f;
+		*f = nullptr;
+	}
+}
+
+void *Frm_Pin(Frm f) {
+	if (!f || !f->isValid()) {
+		return nullptr;
+	}
+	return new std::shared_ptr<const void>{f->pin()};
+}
+
 Pyl Pyl_New() { return new beholder::PylonAPI{}; }
 
 void Pyl_Delete(Pyl *p) {
@@ -117,6 +117,19 @@ type Camera struct {
 	// [models.Image.Buffer] only after successful acquisitions.
 	Result models.Image `json:"-"`
 
+	// ROIControl is an optional field which fits the sensor region
+	// to recent detections, see [Camera.UpdateROI].
+	ROIControl *ROIControl `json:"roi_control"`
+
+	// Stream is an optional field which tunes the camera device's
+	// image data stream, see [Camera.StreamStats].
+	Stream *Stream `json:"stream"`
+
+	// RingSize is the number of acquisition results which can be held
+	// at once, see [Camera.AcquireFrame].
+	// If 0, the default size is used.
+	RingSize int `json:"ring_size"`
+
 	// NoReboot toggles whether to reboot the camera device when attached.
 	// This should always be set to false, since the reboot clears
 	// any previous errors or inconsistent states on the device.
@@ -124,7 +137,8 @@ type Camera struct {
 	// However, impatient developers might find it handy in some cases.
 	NoReboot bool `json:"no_reboot"`
 
-	p C.Cam
+	roi SensorROI // the sensor region images are acquired with
+	p   C.Cam
 }
 
 // NewCamera constructs a new Camera with sensible defaults.
@@ -155,19 +169,87 @@ func (c *Camera) Acquire() error {
 	if r.buffer == nil {
 		return fmt.Errorf("camera.Camera.Acquire: could not get raw image data")
 	}
-	c.Result = models.Image{
-		Buffer:       r.buffer,
-		ID:           uint64(r.id),
-		Timestamp:    time.Now(),
-		Rows:         int(r.rows),
-		Cols:         int(r.cols),
-		PixelType:    int64(r.pixelType),
-		Step:         uint64(r.step),
-		BitsPerPixel: uint64(r.bitsPerPixel),
-	}
+	c.Result = toImage(r)
 	return nil
 }
 
+// Frame is an acquisition result held in a slot of the camera's frame ring,
+// or handed over by the grab thread, see [Camera.NextFrame].
+// The image buffer is valid until the frame is released,
+// see [Camera.ReleaseFrame].
+type Frame struct {
+	// Image is the acquired image.
+	Image models.Image
+	// SN is the serial number of the camera which acquired the image.
+	SN string
+	// ROI is the sensor region the image was acquired with, which maps
+	// image coordinates onto the sensor, see [SensorROI.ToSensor].
+	ROI SensorROI
+
+	slot C.size_t
+	gen  C.uint64_t
+	h    C.Frm
+}
+
+// Pin returns (C call) a new pin of the frame's image buffer, which keeps
+// the buffer alive after the frame is released, or nil if the frame is
+// not a grab thread frame, see [Camera.NextFrame].
+//
+// WARNING: the pin is C-allocated and must be handed over to a consumer
+// which takes ownership of it, eg. imgproc.Recorder.Record.
+func (f Frame) Pin() unsafe.Pointer {
+	return C.Frm_Pin(f.h)
+}
+
+// toImage converts a raw image into an image.
+// The timestamp is the host time of exposure, if the device timestamp could
+// be mapped onto the host's clock, see [Camera.SyncClock], otherwise it is
+// the current time.
+func toImage(r C.Img) models.Image {
+	ts := time.Now()
+	if r.hostTime != 0 {
+		ts = time.Unix(0, int64(r.hostTime))
+	}
+	return models.Image{
+		Buffer:          r.buffer,
+		ID:              uint64(r.id),
+		Timestamp:       ts,
+		Rows:            int(r.rows),
+		Cols:            int(r.cols),
+		PixelType:       int64(r.pixelType),
+		Step:            uint64(r.step),
+		BitsPerPixel:    uint64(r.bitsPerPixel),
+		DeviceTimestamp: uint64(r.timestamp),
+		FrameCounter:    uint64(r.frameCounter),
+		TriggerCounter:  uint64(r.triggerCounter),
+		ExposureTime:    time.Duration(float64(r.exposureTime) * float64(time.Microsecond)),
+	}
+}
+
+// AcquireFrame attempts to acquire an image into a free slot of
+// the camera's frame ring.
+//
+// Unlike [Camera.Acquire], the image is kept until it is explicitly
+// released, so acquisition can run ahead of processing by up to
+// [Camera.RingSize] frames.
+// An error is returned if acquisition failed or no slot is free.
+func (c *Camera) AcquireFrame() (Frame, error) {
+	var slot C.size_t
+	var gen C.uint64_t
+	var r C.Img
+	ok := C.Cam_AcquireFrame(c.p, (C.size_t)(c.AcquisitionTimeout.Milliseconds()), &slot, &gen, &r)
+	if !ok {
+		return Frame{}, fmt.Errorf("camera.Camera.AcquireFrame: %w", ErrAcquisition)
+	}
+	return Frame{
+		Image: toImage(r),
+		SN:    c.SN,
+		ROI:   c.roi,
+		slot:  slot,
+		gen:   gen,
+	}, nil
+}
+
 // CmdExecute tries to execute a (GenICam) command.
 //
 // A non-nil error does not guarantee that a command was executed or that
@@ -196,6 +278,25 @@ func (c *Camera) Delete() {
 	C.Cam_Delete(&c.p)
 }
 
+// DroppedFrames reports the number of frames dropped by the grab thread,
+// since grabbing was last started, because they were not taken with
+// [Camera.NextFrame] fast enough.
+func (c Camera) DroppedFrames() uint64 {
+	return uint64(C.Cam_GetNoDroppedFrames(c.p))
+}
+
+// IdleTime reports the time since the grab thread last delivered a frame,
+// or since grabbing was started if no frame has been delivered yet,
+// see [Camera.StartGrabbing].
+// It returns false if grabbing was never started.
+func (c Camera) IdleTime() (time.Duration, bool) {
+	var ms C.size_t
+	if ok := C.Cam_GetIdleTime(c.p, &ms); !ok {
+		return 0, false
+	}
+	return time.Duration(ms) * time.Millisecond, true
+}
+
 // IsAcquiring reports the image acquisition status of the camera.
 //
 // BUG: when 'AcquisitionMode' is set to 'SingleFrame' and an image is acquired
@@ -245,6 +346,24 @@ func (c Camera) IsValid() error {
 	if c.AcquisitionTimeout.Milliseconds() < 0 {
 		return errors.New("camera.Camera.IsValid: bad image acquisition timeout")
 	}
+	if c.RingSize < 0 {
+		return errors.New("camera.Camera.IsValid: bad frame ring size")
+	}
+	if c.Trigger != nil {
+		if err := c.Trigger.IsValid(); err != nil {
+			return fmt.Errorf("camera.Camera.IsValid: %w", err)
+		}
+	}
+	if c.Stream != nil {
+		if err := c.Stream.IsValid(); err != nil {
+			return fmt.Errorf("camera.Camera.IsValid: %w", err)
+		}
+	}
+	if c.ROIControl != nil {
+		if err := c.ROIControl.IsValid(); err != nil {
+			return fmt.Errorf("camera.Camera.IsValid: %w", err)
+		}
+	}
 	// TODO: check parameters
 	return nil
 }
@@ -256,27 +375,72 @@ func (c Camera) IsValid() error {
 //
 // WARNING: Delete must be called to release the memory when no longer needed.
 func (c *Camera) Init() error {
-	if err := c.IsValid(); err != nil {
+	ar := &mem.Arena{}
+	defer ar.Free()
+
+	tl, in, err := c.prepare(ar)
+	if err != nil {
+		return err
+	}
+	if ok := C.Cam_Init(c.p, tl.p, &in); !ok {
+		return errors.New("camera.Camera.Init: could not initialize camera")
+	}
+	if err := c.initRing(); err != nil {
 		return err
 	}
+	return c.initStream()
+}
+
+// initRing sizes the frame ring of an initialized camera,
+// see [Camera.RingSize].
+func (c *Camera) initRing() error {
+	if c.RingSize > 0 {
+		if ok := C.Cam_SetRingSize(c.p, C.size_t(c.RingSize)); !ok {
+			return errors.New("camera.Camera.Init: could not set frame ring size")
+		}
+	}
+	return nil
+}
+
+// initStream tunes the image data stream of an initialized camera,
+// see [Camera.Stream], and records the sensor region it acquires with.
+func (c *Camera) initStream() error {
+	if c.Stream != nil {
+		cfg := c.Stream.toC()
+		if ok := C.Cam_SetStreamConfig(c.p, &cfg); !ok {
+			return errors.New("camera.Camera.Init: could not configure stream")
+		}
+	}
+	// not all devices have a sensor region, in which case
+	// images are mapped onto the sensor as is
+	c.roi, _ = c.ROI()
+	return nil
+}
+
+// prepare validates c, allocates its C-memory and returns the transport
+// layer and the data with which c should be initialized.
+//
+// All C-memory referenced by the returned data is stored into ar.
+func (c *Camera) prepare(ar *mem.Arena) (*transportLayer, C.CamInit, error) {
+	if err := c.IsValid(); err != nil {
+		return nil, C.CamInit{}, err
+	}
 	// get the transport layer
 	tl, err := getTransportLayer(c.Type)
 	if err != nil {
-		return err
+		return nil, C.CamInit{}, err
 	}
 	// allocate C-memory for the camera
 	c.p = C.Cam_New()
 	if c.p == (C.Cam)(nil) {
-		return errors.New("camera.Camera.Init: could not allocate C-memory")
+		return nil, C.CamInit{}, errors.New("camera.Camera.Init: could not allocate C-memory")
 	}
-	ar := &mem.Arena{}
-	defer ar.Free()
 
 	// handle SN
 	if c.SN == SNPickFirst {
 		sn := ar.StoreCStrConv(unsafe.Pointer(C.Trans_GetFirstSN(tl.p)))
 		if len(sn) == 0 {
-			return errors.New("camera.Camera.Init: could not find a camera device")
+			return nil, C.CamInit{}, errors.New("camera.Camera.Init: could not find a camera device")
 		}
 		c.SN = sn
 	}
@@ -297,12 +461,65 @@ func (c *Camera) Init() error {
 	// handle parameters
 	in.pars, in.nPars = c.Parameters.makeCPars(ar)
 
-	if ok := C.Cam_Init(c.p, tl.p, &in); !ok {
-		return errors.New("camera.Camera.Init: could not initialize camera")
+	return tl, in, nil
+}
+
+// NextFrame returns the next frame acquired by the grab thread,
+// see [Camera.StartGrabbing], waiting up to [Camera.AcquisitionTimeout]
+// for one to arrive.
+//
+// The frame is kept until it is explicitly released,
+// see [Camera.ReleaseFrame].
+// An error is returned on timeout, or if grabbing was not started or
+// has been stopped.
+func (c *Camera) NextFrame() (Frame, error) {
+	var r C.Img
+	h := C.Cam_NextFrame(c.p, (C.size_t)(c.AcquisitionTimeout.Milliseconds()), &r)
+	if h == (C.Frm)(nil) {
+		return Frame{}, fmt.Errorf("camera.Camera.NextFrame: %w", ErrAcquisition)
 	}
+	return Frame{
+		Image: toImage(r),
+		SN:    c.SN,
+		ROI:   c.roi,
+		h:     h,
+	}, nil
+}
+
+// Reconnect reattaches the camera device, eg. after it was removed because
+// of a connection glitch, and reapplies all parameters set so far, without
+// resetting the device to its default configuration first.
+//
+// Acquisition is stopped and has to be restarted, and all frames acquired
+// from the removed device must be released before calling Reconnect.
+func (c *Camera) Reconnect() error {
+	tl, err := getTransportLayer(c.Type)
+	if err != nil {
+		return fmt.Errorf("camera.Camera.Reconnect: %w", err)
+	}
+	if ok := C.Cam_Reconnect(c.p, tl.p); !ok {
+		return errors.New("camera.Camera.Reconnect: could not reconnect camera")
+	}
+	c.roi, _ = c.ROI()
 	return nil
 }
 
+// ReleaseFrame releases f, handing its buffer back to the camera.
+// The handle and image buffer of f are cleared, so releasing f again
+// does nothing, but the image metadata can still be read.
+func (c Camera) ReleaseFrame(f *Frame) {
+	if f == nil {
+		return
+	}
+	if f.h != (C.Frm)(nil) {
+		C.Frm_Delete(&f.h)
+	} else if f.gen != 0 {
+		C.Cam_ReleaseFrame(c.p, f.slot, f.gen)
+	}
+	f.gen = 0
+	f.Image.Buffer = nil
+}
+
 // SetParams sets (GenICam) parameters on the camera device.
 func (c Camera) SetParameters(params Parameters) error {
 	ar := &mem.Arena{}
@@ -384,11 +601,38 @@ func (c Camera) StartAcquisition() error {
 	return nil
 }
 
+// StartGrabbing starts image acquisition on a dedicated grab thread,
+// which queues acquired frames until they are taken with [Camera.NextFrame].
+//
+// Up to [Camera.RingSize] frames are queued, frames arriving while the queue
+// is full are dropped, see [Camera.DroppedFrames].
+// [Camera.Acquire] and [Camera.AcquireFrame] must not be used while grabbing.
+func (c Camera) StartGrabbing() error {
+	if ok := C.Cam_StartGrabbing(c.p); !ok {
+		return errors.New("camera.Camera.StartGrabbing: could not start grabbing")
+	}
+	return nil
+}
+
 // StopAcquisition stops image acquisition on the camera device.
 func (c Camera) StopAcquisition() {
 	C.Cam_StopAcquisition(c.p)
 }
 
+// SyncClock estimates the offset, and drift, between the camera's clock
+// and the host's, so that acquired images are timestamped with the host
+// time of their exposure, see [models.Image.Timestamp].
+//
+// The clock is synced when the camera is initialized, but camera clocks
+// drift, so SyncClock should be called periodically, eg. every few minutes.
+// An error is returned if the camera cannot latch its timestamp counter.
+func (c Camera) SyncClock() error {
+	if ok := C.Cam_SyncClock(c.p); !ok {
+		return errors.New("camera.Camera.SyncClock: could not sync clock")
+	}
+	return nil
+}
+
 // TryTrigger is a function that will try to execute a software trigger.
 //
 // If no trigger is available (defined) it returns nil immediately, otherwise
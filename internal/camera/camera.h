@@ -18,11 +18,13 @@ extern "C" {
 
 #ifdef __cplusplus
 typedef beholder::Camera* Cam;
+typedef beholder::Frame* Frm;
 typedef beholder::PylonAPI* Pyl;
 typedef beholder::TransportLayer* Trans;
 typedef beholder::capi::Image Img;
 #else
 typedef void* Cam;
+typedef void* Frm;
 typedef void* Pyl;
 typedef void* Trans;
 typedef Image Img;
@@ -40,22 +42,103 @@ typedef struct {
 	bool reboot;
 } CamInit;
 
+typedef struct {
+	int64_t offsetX;
+	int64_t offsetY;
+	int64_t width;
+	int64_t height;
+	int64_t binning;
+} SROI;
+
+typedef struct {
+	uint64_t totalBuffers;
+	uint64_t failedBuffers;
+	uint64_t bufferUnderruns;
+	uint64_t totalPackets;
+	uint64_t failedPackets;
+	uint64_t resendRequests;
+	uint64_t resendPackets;
+	uint64_t missedFrames;
+	uint64_t skippedFrames;
+	uint64_t droppedFrames;
+	uint64_t timeouts;
+} StrStats;
+
+// Negative values are left as they are.
+typedef struct {
+	int64_t maxNumBuffer;
+	int64_t packetSize;
+	int64_t interPacketDelay;
+	int64_t frameTransmissionDelay;
+} StrCfg;
+
+typedef struct {
+	int64_t periodUs;
+	int64_t spinUs;
+	int64_t maxLatencyMs;
+} TrigSched;
+
+// Times are in microseconds.
+typedef struct {
+	uint64_t triggers;
+	uint64_t missed;
+	uint64_t frames;
+	uint64_t unanswered;
+	double intervalMean;
+	double intervalStd;
+	double jitterMean;
+	double jitterStd;
+	double jitterMax;
+	double latencyMean;
+	double latencyStd;
+	double latencyMax;
+} TrigStats;
+
 bool Cam_Acquire(Cam c, size_t timeoutMs);
+bool Cam_AcquireFrame(Cam c, size_t timeoutMs, size_t* slot, uint64_t* gen,
+					  Img* img);
 bool Cam_CmdExecute(Cam c, const char* cmd);
 bool Cam_CmdIsDone(Cam c, const char* cmd);
 void Cam_Delete(Cam* c);
+bool Cam_GetFullROI(Cam c, SROI* r);
+bool Cam_GetIdleTime(Cam c, size_t* ms);
+size_t Cam_GetNoDroppedFrames(Cam c);
 Img Cam_GetRawImage(Cam c);
+bool Cam_GetROI(Cam c, SROI* r);
+bool Cam_GetStreamStats(Cam c, StrStats* s);
+bool Cam_GetTriggerStats(Cam c, TrigStats* s);
 bool Cam_IsAcquiring(Cam c);
 bool Cam_IsAttached(Cam c);
 bool Cam_IsInitialized(Cam c);
 bool Cam_Init(Cam c, Trans t, const CamInit* in);
 Cam Cam_New();
+Frm Cam_NextFrame(Cam c, size_t timeoutMs, Img* img);
+bool Cam_Reconnect(Cam c, Trans t);
+void Cam_ReleaseFrame(Cam c, size_t slot, uint64_t gen);
+bool Cam_RequestTrigger(Cam c);
 bool Cam_SetParameters(Cam c, Par* pars, size_t nPars);
+bool Cam_SetROI(Cam c, const SROI* r);
+bool Cam_SetRingSize(Cam c, size_t n);
+bool Cam_SetStreamConfig(Cam c, const StrCfg* cfg);
 bool Cam_StartAcquisition(Cam c);
+bool Cam_StartGrabbing(Cam c);
+bool Cam_StartTriggering(Cam c, const TrigSched* s);
 void Cam_StopAcquisition(Cam c);
+void Cam_StopTriggering(Cam c);
+bool Cam_SyncClock(Cam c);
 bool Cam_Trigger(Cam c);
 bool Cam_WaitAndTrigger(Cam c, size_t timeoutMs);
 
+bool CamArr_Init(Cam* cs, size_t n, Trans t, const CamInit* ins);
+Frm CamArr_NextFrame(Cam* cs, size_t n, size_t timeoutMs, size_t* idx,
+					 Img* img);
+bool CamArr_Reconnect(Cam* cs, size_t n, size_t i, Trans t);
+bool CamArr_StartGrabbing(Cam* cs, size_t n);
+void CamArr_StopAcquisition(Cam* cs, size_t n);
+
+void Frm_Delete(Frm* f);
+void* Frm_Pin(Frm f);
+
 Pyl Pyl_New();
 void Pyl_Delete(Pyl* p);
 
@@ -0,0 +1,273 @@
+// beholder - Copyright © 2024 Philipp Milovic
+//
+// SPDX-License-Identifier: Apache-2.0
+
+package camera
+
+/*
+#include <stdlib.h>
+#include "camera.h"
+*/
+import "C"
+import (
+	"errors"
+	"fmt"
+
+	"github.com/Milover/beholder/internal/models"
+)
+
+// SensorROI is the region of a camera's sensor which is read out and
+// transmitted, along with the factor by which it is binned, or decimated.
+//
+// The region is in sensor pixels, i.e. before binning. A point (x, y) of
+// an image acquired with the region maps onto the sensor point
+// (X + x*Binning, Y + y*Binning).
+type SensorROI struct {
+	X, Y          int64 // top-left corner
+	Width, Height int64 // size
+	Binning       int64 // binning/decimation factor, both axes
+}
+
+// fromCROI converts a C region into a SensorROI.
+func fromCROI(r C.SROI) SensorROI {
+	return SensorROI{
+		X:       int64(r.offsetX),
+		Y:       int64(r.offsetY),
+		Width:   int64(r.width),
+		Height:  int64(r.height),
+		Binning: int64(r.binning),
+	}
+}
+
+// Rect returns the region as a rectangle, in sensor pixels.
+func (r SensorROI) Rect() models.Rectangle {
+	return models.Rectangle{
+		Left:   r.X,
+		Top:    r.Y,
+		Right:  r.X + r.Width,
+		Bottom: r.Y + r.Height,
+	}
+}
+
+// ToSensor maps a rectangle of an image acquired with r onto the sensor.
+func (r SensorROI) ToSensor(rect models.Rectangle) models.Rectangle {
+	b := max(r.Binning, 1)
+	return models.Rectangle{
+		Left:   r.X + rect.Left*b,
+		Top:    r.Y + rect.Top*b,
+		Right:  r.X + rect.Right*b,
+		Bottom: r.Y + rect.Bottom*b,
+	}
+}
+
+// toC converts r into its C representation.
+func (r SensorROI) toC() C.SROI {
+	return C.SROI{
+		offsetX: C.int64_t(r.X),
+		offsetY: C.int64_t(r.Y),
+		width:   C.int64_t(r.Width),
+		height:  C.int64_t(r.Height),
+		binning: C.int64_t(max(r.Binning, 1)),
+	}
+}
+
+// FullROI returns the whole sensor as a region, at the current binning factor.
+func (c Camera) FullROI() (SensorROI, error) {
+	var r C.SROI
+	if ok := C.Cam_GetFullROI(c.p, &r); !ok {
+		return SensorROI{}, errors.New("camera.Camera.FullROI: could not get sensor size")
+	}
+	return fromCROI(r), nil
+}
+
+// ROI returns the sensor region images are acquired with.
+func (c Camera) ROI() (SensorROI, error) {
+	var r C.SROI
+	if ok := C.Cam_GetROI(c.p, &r); !ok {
+		return SensorROI{}, errors.New("camera.Camera.ROI: could not get sensor ROI")
+	}
+	return fromCROI(r), nil
+}
+
+// SetROI sets the sensor region images are acquired with, so that only
+// the part of the sensor which is of interest is read out and transmitted.
+//
+// The region is grown to the device's increments, so it always covers r,
+// and clamped to the sensor. Acquisition, if running, is restarted,
+// since the image size can't change while acquiring, and frames queued
+// by the grab thread are released.
+func (c *Camera) SetROI(r SensorROI) error {
+	cr := r.toC()
+	ok := C.Cam_SetROI(c.p, &cr)
+	// the region actually set, even if only partially
+	roi, err := c.ROI()
+	if err == nil {
+		c.roi = roi
+	}
+	if !ok {
+		return errors.New("camera.Camera.SetROI: could not set sensor ROI")
+	}
+	return err
+}
+
+// UpdateROI feeds the objects detected in f, in image coordinates,
+// to the camera's [ROIControl], and sets the sensor region it decides on.
+// It is a no-op if the camera has no ROIControl.
+func (c *Camera) UpdateROI(f Frame, boxes []models.Rectangle) error {
+	if c.ROIControl == nil {
+		return nil
+	}
+	if c.ROIControl.full.Width == 0 {
+		full, err := c.FullROI()
+		if err != nil {
+			return fmt.Errorf("camera.Camera.UpdateROI: %w", err)
+		}
+		c.ROIControl.full = full
+	}
+	r, ok := c.ROIControl.next(f.ROI, boxes)
+	if !ok || r == c.roi {
+		return nil
+	}
+	if err := c.SetROI(r); err != nil {
+		return fmt.Errorf("camera.Camera.UpdateROI: %w", err)
+	}
+	return nil
+}
+
+// UpdateROI feeds the objects detected in f to the [ROIControl] of
+// the camera which acquired f, see [Camera.UpdateROI].
+func (a Array) UpdateROI(f Frame, boxes []models.Rectangle) error {
+	for _, cam := range a {
+		if cam.SN == f.SN {
+			return cam.UpdateROI(f, boxes)
+		}
+	}
+	return fmt.Errorf("camera.Array.UpdateROI: no camera: %q", f.SN)
+}
+
+// ROIControl is a feedback loop which fits a camera's sensor region to
+// the region in which objects were recently detected, see [Camera.SetROI].
+//
+// The region is the union of the objects detected in the last History
+// frames, grown by Margin. Every KeyframePeriod-th frame, and whenever
+// nothing was detected in the last History frames, the whole sensor is
+// acquired instead, so that objects outside the region are re-acquired.
+//
+// Each change of the region restarts acquisition, so changes which only
+// shrink the region by less than Hysteresis are skipped.
+type ROIControl struct {
+	// History is the number of recent frames whose detections are merged.
+	History int `json:"history"`
+	// Margin is the margin added around the detections, in sensor pixels.
+	Margin int64 `json:"margin"`
+	// KeyframePeriod is the number of frames between full-sensor frames.
+	// If 0, full-sensor frames are acquired only when nothing
+	// was detected recently.
+	KeyframePeriod int `json:"keyframe_period"`
+	// Hysteresis is the least amount, in sensor pixels, by which an edge
+	// of the region has to move inwards for the region to shrink.
+	Hysteresis int64 `json:"hysteresis"`
+	// Binning is the binning/decimation factor, 0 or 1 for none.
+	Binning int64 `json:"binning"`
+
+	full     SensorROI          // the whole sensor
+	recent   []models.Rectangle // detections of recent frames, on the sensor
+	pos      int                // next slot of recent
+	sinceKey int                // frames since the last full-sensor frame
+}
+
+// IsValid checks whether rc is valid.
+func (rc ROIControl) IsValid() error {
+	if rc.History <= 0 {
+		return errors.New("camera.ROIControl.IsValid: non-positive history")
+	}
+	if rc.Margin < 0 || rc.Hysteresis < 0 || rc.KeyframePeriod < 0 || rc.Binning < 0 {
+		return errors.New("camera.ROIControl.IsValid: negative value")
+	}
+	return nil
+}
+
+// next records the detections of a frame acquired with roi, and returns
+// the region the next frame should be acquired with, or false if
+// there's nothing to decide on.
+func (rc *ROIControl) next(roi SensorROI, boxes []models.Rectangle) (SensorROI, bool) {
+	if rc.full.Width == 0 || rc.History <= 0 {
+		return SensorROI{}, false
+	}
+	if len(rc.recent) != rc.History {
+		rc.recent = make([]models.Rectangle, rc.History)
+		rc.pos = 0
+	}
+	// an empty rectangle marks a frame without detections
+	var u models.Rectangle
+	for i, b := range boxes {
+		s := roi.ToSensor(b)
+		if i == 0 {
+			u = s
+			continue
+		}
+		u = models.Rectangle{
+			Left:   min(u.Left, s.Left),
+			Top:    min(u.Top, s.Top),
+			Right:  max(u.Right, s.Right),
+			Bottom: max(u.Bottom, s.Bottom),
+		}
+	}
+	rc.recent[rc.pos] = u
+	rc.pos = (rc.pos + 1) % len(rc.recent)
+
+	full := rc.full
+	full.Binning = max(rc.Binning, 1)
+	rc.sinceKey++
+	if rc.KeyframePeriod > 0 && rc.sinceKey >= rc.KeyframePeriod {
+		rc.sinceKey = 0
+		return full, true
+	}
+
+	var t models.Rectangle
+	found := false
+	for _, r := range rc.recent {
+		if r.Area() <= 0 {
+			continue
+		}
+		if !found {
+			t, found = r, true
+			continue
+		}
+		t = models.Rectangle{
+			Left:   min(t.Left, r.Left),
+			Top:    min(t.Top, r.Top),
+			Right:  max(t.Right, r.Right),
+			Bottom: max(t.Bottom, r.Bottom),
+		}
+	}
+	if !found {
+		return full, true
+	}
+	t.Resize(rc.Margin)
+	f := full.Rect()
+	t = models.Rectangle{
+		Left:   max(t.Left, f.Left),
+		Top:    max(t.Top, f.Top),
+		Right:  min(t.Right, f.Right),
+		Bottom: min(t.Bottom, f.Bottom),
+	}
+
+	// keep the current region if it covers the target, and is only
+	// slightly larger than it
+	cur := roi.Rect()
+	if roi.Binning == full.Binning &&
+		t.Left >= cur.Left && t.Left-cur.Left < rc.Hysteresis &&
+		t.Top >= cur.Top && t.Top-cur.Top < rc.Hysteresis &&
+		t.Right <= cur.Right && cur.Right-t.Right < rc.Hysteresis &&
+		t.Bottom <= cur.Bottom && cur.Bottom-t.Bottom < rc.Hysteresis {
+		return roi, true
+	}
+	return SensorROI{
+		X:       t.Left,
+		Y:       t.Top,
+		Width:   t.Width(),
+		Height:  t.Height(),
+		Binning: full.Binning,
+	}, true
+}
@@ -0,0 +1,108 @@
+// beholder - Copyright © 2024 Philipp Milovic
+//
+// SPDX-License-Identifier: Apache-2.0
+
+package camera
+
+import (
+	"testing"
+
+	"github.com/Milover/beholder/internal/models"
+	"github.com/stretchr/testify/assert"
+)
+
+// Test the sensor ROI feedback loop.
+type roiControlTest struct {
+	Name     string
+	Control  ROIControl
+	Frames   [][]models.Rectangle // detections of consecutive frames
+	Expected SensorROI            // region decided on after the last frame
+}
+
+var roiFull = SensorROI{X: 0, Y: 0, Width: 2000, Height: 1000, Binning: 1}
+
+var roiControlTests = []roiControlTest{
+	{
+		Name:     "no-detections",
+		Control:  ROIControl{History: 2},
+		Frames:   [][]models.Rectangle{nil},
+		Expected: roiFull,
+	},
+	{
+		Name:    "fit-with-margin",
+		Control: ROIControl{History: 2, Margin: 10},
+		Frames: [][]models.Rectangle{
+			{{Left: 100, Top: 100, Right: 200, Bottom: 150}},
+		},
+		Expected: SensorROI{X: 90, Y: 90, Width: 120, Height: 70, Binning: 1},
+	},
+	{
+		Name:    "merge-history",
+		Control: ROIControl{History: 2},
+		Frames: [][]models.Rectangle{
+			{{Left: 100, Top: 100, Right: 200, Bottom: 150}},
+			{{Left: 150, Top: 120, Right: 300, Bottom: 140}},
+		},
+		Expected: SensorROI{X: 100, Y: 100, Width: 200, Height: 50, Binning: 1},
+	},
+	{
+		Name:    "clamp-to-sensor",
+		Control: ROIControl{History: 1, Margin: 50},
+		Frames: [][]models.Rectangle{
+			{{Left: 10, Top: 900, Right: 200, Bottom: 990}},
+		},
+		Expected: SensorROI{X: 0, Y: 850, Width: 250, Height: 150, Binning: 1},
+	},
+	{
+		Name:    "drained-history",
+		Control: ROIControl{History: 2},
+		Frames: [][]models.Rectangle{
+			{{Left: 100, Top: 100, Right: 200, Bottom: 150}},
+			nil,
+			nil,
+		},
+		Expected: roiFull,
+	},
+	{
+		Name:    "keyframe",
+		Control: ROIControl{History: 4, KeyframePeriod: 2},
+		Frames: [][]models.Rectangle{
+			{{Left: 100, Top: 100, Right: 200, Bottom: 150}},
+			{{Left: 100, Top: 100, Right: 200, Bottom: 150}},
+		},
+		Expected: roiFull,
+	},
+	{
+		Name:    "binning",
+		Control: ROIControl{History: 1, Binning: 2},
+		Frames: [][]models.Rectangle{
+			{{Left: 100, Top: 100, Right: 200, Bottom: 150}},
+		},
+		Expected: SensorROI{X: 100, Y: 100, Width: 100, Height: 50, Binning: 2},
+	},
+}
+
+func TestROIControl(t *testing.T) {
+	for _, tt := range roiControlTests {
+		t.Run(tt.Name, func(t *testing.T) {
+			assert := assert.New(t)
+
+			rc := tt.Control
+			rc.full = roiFull
+			// the frames are acquired with whatever region was decided on
+			roi := roiFull
+			var ok bool
+			for _, boxes := range tt.Frames {
+				// detections are in image coordinates
+				var img []models.Rectangle
+				for _, b := range boxes {
+					b.Move(-roi.X, -roi.Y)
+					img = append(img, b)
+				}
+				roi, ok = rc.next(roi, img)
+				assert.True(ok)
+			}
+			assert.Equal(tt.Expected, roi)
+		})
+	}
+}
@@ -0,0 +1,131 @@
+// beholder - Copyright © 2024 Philipp Milovic
+//
+// SPDX-License-Identifier: Apache-2.0
+
+package camera
+
+/*
+#include <stdlib.h>
+#include "camera.h"
+*/
+import "C"
+import (
+	"errors"
+)
+
+// Stream tunes the image data stream of a camera device.
+// Unset (nil) values are left as they are.
+//
+// On a GigE link shared by several cameras, the packet size, the delay
+// between packets and the delay of the transmission of each frame are used
+// to spread the cameras' bandwidth, so that their bursts don't overflow
+// the switch's or the NIC's buffers. See [StreamStats] to check the result.
+type Stream struct {
+	// MaxNumBuffer is the minimum number of buffers grabbed into.
+	// It takes effect when acquisition starts.
+	MaxNumBuffer *int64 `json:"max_num_buffer"`
+	// PacketSize is the packet size in bytes, GigE only.
+	PacketSize *int64 `json:"packet_size"`
+	// InterPacketDelay is the delay between packets in timestamp ticks,
+	// GigE only.
+	InterPacketDelay *int64 `json:"inter_packet_delay"`
+	// FrameTransmissionDelay is the delay of each frame's transmission
+	// in timestamp ticks, GigE only.
+	FrameTransmissionDelay *int64 `json:"frame_transmission_delay"`
+}
+
+// toC converts s into its C representation.
+func (s Stream) toC() C.StrCfg {
+	val := func(v *int64) C.int64_t {
+		if v == nil {
+			return -1
+		}
+		return C.int64_t(*v)
+	}
+	return C.StrCfg{
+		maxNumBuffer:           val(s.MaxNumBuffer),
+		packetSize:             val(s.PacketSize),
+		interPacketDelay:       val(s.InterPacketDelay),
+		frameTransmissionDelay: val(s.FrameTransmissionDelay),
+	}
+}
+
+// IsValid checks whether s is valid.
+func (s Stream) IsValid() error {
+	for _, v := range []*int64{s.MaxNumBuffer, s.PacketSize, s.InterPacketDelay, s.FrameTransmissionDelay} {
+		if v != nil && *v < 0 {
+			return errors.New("camera.Stream.IsValid: negative value")
+		}
+	}
+	if s.MaxNumBuffer != nil && *s.MaxNumBuffer == 0 {
+		return errors.New("camera.Stream.IsValid: zero max. number of buffers")
+	}
+	return nil
+}
+
+// StreamStats are the statistics of a camera's image data stream.
+//
+// All counters are reset whenever acquisition starts. Counters which
+// the transport layer doesn't keep are 0, eg. packet counters are kept
+// only for GigE devices.
+type StreamStats struct {
+	// TotalBuffers is the number of buffers grabbed.
+	TotalBuffers uint64 `json:"total_buffers"`
+	// FailedBuffers is the number of buffers grabbed incompletely.
+	FailedBuffers uint64 `json:"failed_buffers"`
+	// BufferUnderruns is the number of times there was no free buffer
+	// to grab into.
+	BufferUnderruns uint64 `json:"buffer_underruns"`
+	// TotalPackets is the number of packets received, GigE only.
+	TotalPackets uint64 `json:"total_packets"`
+	// FailedPackets is the number of packets lost, GigE only.
+	FailedPackets uint64 `json:"failed_packets"`
+	// ResendRequests is the number of resend requests sent, GigE only.
+	ResendRequests uint64 `json:"resend_requests"`
+	// ResendPackets is the number of packets requested again, GigE only.
+	ResendPackets uint64 `json:"resend_packets"`
+	// MissedFrames is the number of frames missed by the device, USB only.
+	MissedFrames uint64 `json:"missed_frames"`
+	// SkippedFrames is the number of frames which never arrived,
+	// i.e. gaps in the block IDs of consecutive frames.
+	SkippedFrames uint64 `json:"skipped_frames"`
+	// DroppedFrames is the number of frames dropped by the grab thread,
+	// see [Camera.DroppedFrames].
+	DroppedFrames uint64 `json:"dropped_frames"`
+	// Timeouts is the number of acquisition timeouts.
+	Timeouts uint64 `json:"timeouts"`
+}
+
+// StreamStats returns the statistics of the camera's image data stream.
+func (c Camera) StreamStats() (StreamStats, error) {
+	var s C.StrStats
+	if ok := C.Cam_GetStreamStats(c.p, &s); !ok {
+		return StreamStats{}, errors.New("camera.Camera.StreamStats: could not get stream statistics")
+	}
+	return StreamStats{
+		TotalBuffers:    uint64(s.totalBuffers),
+		FailedBuffers:   uint64(s.failedBuffers),
+		BufferUnderruns: uint64(s.bufferUnderruns),
+		TotalPackets:    uint64(s.totalPackets),
+		FailedPackets:   uint64(s.failedPackets),
+		ResendRequests:  uint64(s.resendRequests),
+		ResendPackets:   uint64(s.resendPackets),
+		MissedFrames:    uint64(s.missedFrames),
+		SkippedFrames:   uint64(s.skippedFrames),
+		DroppedFrames:   uint64(s.droppedFrames),
+		Timeouts:        uint64(s.timeouts),
+	}, nil
+}
+
+// StreamStats returns the statistics of the image data stream of each
+// camera in the array, keyed by serial number.
+// Cameras whose statistics could not be read are left out.
+func (a Array) StreamStats() map[string]StreamStats {
+	ss := make(map[string]StreamStats, len(a))
+	for _, cam := range a {
+		if s, err := cam.StreamStats(); err == nil {
+			ss[cam.SN] = s
+		}
+	}
+	return ss
+}
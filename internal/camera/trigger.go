@@ -38,6 +38,25 @@ type Trigger struct {
 	// eg. to avoid 'incomplete buffer read' errors.
 	WaitAfter chrono.Duration `json:"wait_after"`
 
+	// Scheduled selects whether triggers are executed by a scheduler thread
+	// of the camera, rather than by Execute, so that the trigger cadence
+	// doesn't depend on goroutine scheduling, see [Camera.StartTriggering].
+	//
+	// Triggers are executed every Period, or, if Period is 0, whenever
+	// requested by an external timing source, see [Camera.RequestTrigger].
+	// Timeout and WaitAfter are not used.
+	Scheduled bool `json:"scheduled"`
+
+	// Spin is the time the scheduler thread spends spinning, rather than
+	// sleeping, before each scheduled trigger, since sleeps overshoot.
+	// It trades CPU time for a steadier trigger cadence.
+	// Defaults to 200µs if 0.
+	Spin chrono.Duration `json:"spin"`
+
+	// MaxLatency is the time a scheduled trigger waits for its frame,
+	// after which it is counted as unanswered. Defaults to 1s if 0.
+	MaxLatency chrono.Duration `json:"max_latency"`
+
 	// lastExecute is the time at which the trigger was last executed.
 	lastExecute time.Time
 }
@@ -53,10 +72,20 @@ func NewTrigger() *Trigger {
 }
 
 // Execute executes a trigger and then waits for t.TimeAfter time.
+//
+// If the trigger is scheduled, Execute only requests a trigger from
+// the camera's scheduler, if the scheduler has no period, and is a no-op
+// otherwise.
 // TODO: does waiting incur penalties when used in a OS-locked routines?
 // OS-locked routines shouldn't block because it reportedly causes a context
 // switch which is expensive, is this also true when sleeping?
 func (t *Trigger) Execute(c Camera) error {
+	if t.Scheduled {
+		if t.Period.Duration == 0 {
+			return c.RequestTrigger()
+		}
+		return nil
+	}
 	// wait for the period to expire
 	triggerAt := t.lastExecute.Add(t.Period.Duration)
 	time.Sleep(time.Until(triggerAt))
@@ -74,3 +103,135 @@ func (t *Trigger) Execute(c Camera) error {
 	time.Sleep(t.WaitAfter.Duration)
 	return nil
 }
+
+// IsValid checks whether t is valid.
+func (t Trigger) IsValid() error {
+	if t.Timeout.Duration < 0 || t.Period.Duration < 0 || t.WaitAfter.Duration < 0 ||
+		t.Spin.Duration < 0 || t.MaxLatency.Duration < 0 {
+		return errors.New("camera.Trigger.IsValid: negative duration")
+	}
+	return nil
+}
+
+// toC converts the schedule of t into its C representation.
+func (t Trigger) toC() C.TrigSched {
+	spin := t.Spin.Duration
+	if spin == 0 {
+		spin = 200 * time.Microsecond
+	}
+	maxLat := t.MaxLatency.Duration
+	if maxLat == 0 {
+		maxLat = time.Second
+	}
+	return C.TrigSched{
+		periodUs:     C.int64_t(t.Period.Microseconds()),
+		spinUs:       C.int64_t(spin.Microseconds()),
+		maxLatencyMs: C.int64_t(maxLat.Milliseconds()),
+	}
+}
+
+// TriggerStats are the statistics of the triggers executed by a camera's
+// trigger scheduler, see [Camera.StartTriggering].
+//
+// Jitter is the time by which a trigger was executed after it was due,
+// i.e. after its deadline or after it was requested. Latency is the time
+// from a trigger's execution until its frame arrived on the host,
+// measured only while grabbing. All statistics are reset whenever
+// the scheduler starts.
+type TriggerStats struct {
+	// Triggers is the number of triggers executed.
+	Triggers uint64 `json:"triggers"`
+	// Missed is the number of triggers not executed, because their
+	// deadline had passed, or the camera wasn't acquiring.
+	Missed uint64 `json:"missed"`
+	// Frames is the number of frames matched to a trigger.
+	Frames uint64 `json:"frames"`
+	// Unanswered is the number of triggers for which no frame arrived.
+	Unanswered uint64 `json:"unanswered"`
+
+	IntervalMean time.Duration `json:"interval_mean"` // mean time between triggers
+	IntervalStd  time.Duration `json:"interval_std"`  // std. deviation of the above
+	JitterMean   time.Duration `json:"jitter_mean"`   // mean jitter
+	JitterStd    time.Duration `json:"jitter_std"`    // std. deviation of the jitter
+	JitterMax    time.Duration `json:"jitter_max"`    // max. jitter
+	LatencyMean  time.Duration `json:"latency_mean"`  // mean latency
+	LatencyStd   time.Duration `json:"latency_std"`   // std. deviation of the latency
+	LatencyMax   time.Duration `json:"latency_max"`   // max. latency
+}
+
+// StartTriggering starts the camera's trigger scheduler, which executes
+// software triggers on a thread of its own, as scheduled by the camera's
+// [Trigger], so that the trigger cadence is deterministic.
+// A running scheduler is restarted, and its statistics are reset.
+//
+// Periodic triggers are executed on absolute deadlines, so the cadence
+// doesn't drift, and missed deadlines are skipped. While grabbing, each
+// trigger is matched with the next frame which arrives, to measure
+// the latency from trigger to frame, see [Camera.TriggerStats].
+func (c Camera) StartTriggering() error {
+	if c.Trigger == nil || !c.Trigger.Scheduled {
+		return errors.New("camera.Camera.StartTriggering: no scheduled trigger")
+	}
+	s := c.Trigger.toC()
+	if ok := C.Cam_StartTriggering(c.p, &s); !ok {
+		return errors.New("camera.Camera.StartTriggering: could not start trigger scheduler")
+	}
+	return nil
+}
+
+// StopTriggering stops the camera's trigger scheduler.
+func (c Camera) StopTriggering() {
+	C.Cam_StopTriggering(c.p)
+}
+
+// RequestTrigger requests a trigger from the camera's trigger scheduler,
+// eg. on a tick of an external timing source, which is executed
+// by the scheduler thread as soon as possible.
+// An error is returned if the scheduler isn't running without a period.
+func (c Camera) RequestTrigger() error {
+	if ok := C.Cam_RequestTrigger(c.p); !ok {
+		return errors.New("camera.Camera.RequestTrigger: could not request trigger")
+	}
+	return nil
+}
+
+// TriggerStats returns the statistics of the triggers executed by
+// the camera's trigger scheduler since it was last started.
+func (c Camera) TriggerStats() (TriggerStats, error) {
+	var s C.TrigStats
+	if ok := C.Cam_GetTriggerStats(c.p, &s); !ok {
+		return TriggerStats{}, errors.New("camera.Camera.TriggerStats: could not get trigger statistics")
+	}
+	us := func(v C.double) time.Duration {
+		return time.Duration(float64(v) * float64(time.Microsecond))
+	}
+	return TriggerStats{
+		Triggers:     uint64(s.triggers),
+		Missed:       uint64(s.missed),
+		Frames:       uint64(s.frames),
+		Unanswered:   uint64(s.unanswered),
+		IntervalMean: us(s.intervalMean),
+		IntervalStd:  us(s.intervalStd),
+		JitterMean:   us(s.jitterMean),
+		JitterStd:    us(s.jitterStd),
+		JitterMax:    us(s.jitterMax),
+		LatencyMean:  us(s.latencyMean),
+		LatencyStd:   us(s.latencyStd),
+		LatencyMax:   us(s.latencyMax),
+	}, nil
+}
+
+// TriggerStats returns the statistics of the trigger scheduler of each
+// camera in the array which has a scheduled trigger, keyed by serial number.
+func (a Array) TriggerStats() map[string]TriggerStats {
+	ts := make(map[string]TriggerStats, len(a))
+	for _, cam := range a {
+		if cam.Trigger == nil || !cam.Trigger.Scheduled {
+			continue
+		}
+		if s, err := cam.TriggerStats(); err == nil {
+			ts[cam.SN] = s
+		}
+	}
+	return ts
+}
@@ -5,7 +5,9 @@
 #include "imgproc.h"
 
 #include <cstring>
+#include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace bh = beholder;
@@ -31,6 +33,24 @@ const unsigned char* Proc_EncodeImage(Proc p, const char* ext, int* encSize) {
 	return enc.data();
 }
 
+size_t Proc_ExtractRotatedROIs(Proc p, const Rect* rois, const double* angs,
+							   size_t nROIs, Img* out) {
+	if (!p || !rois || !angs || !out) {
+		return 0;
+	}
+	std::vector<bh::Rectangle> r;
+	r.reserve(nROIs);
+	for (auto i{0ul}; i < nROIs; ++i) {
+		r.emplace_back(rois[i]);
+	}
+	const std::vector<double> a(angs, angs + nROIs);
+	const auto& imgs{p->extractRotatedROIs(r, a)};
+	for (auto i{0ul}; i < imgs.size(); ++i) {
+		out[i] = imgs[i].cRef();
+	}
+	return imgs.size();
+}
+
 Img Proc_GetRawImage(Proc p) {
 	if (!p) {
 		return Img{};
@@ -54,6 +74,7 @@ bool Proc_Init(Proc p, void** post, size_t nPost, void** pre, size_t nPre) {
 	};
 	helper(p->postprocessing, post, nPost);
 	helper(p->preprocessing, pre, nPre);
+	p->compile();
 	return true;
 }
 
@@ -86,11 +107,19 @@ bool Proc_ReadImage(Proc p, const char* filename, int flags) {
 	return p->readImage(s, bh::enums::from<bh::ReadMode>(flags));
 }
 
-bool Proc_ReceiveRawImage(Proc p, const Img* img) {
+bool Proc_ReceiveRawImage(Proc p, const Img* img, int output) {
 	if (!p || !img) {
 		return false;
 	}
-	return p->receiveRawImage(bh::Image{*img});
+	return p->receiveRawImage(bh::Image{*img},
+							  bh::enums::from<bh::RawOutput>(output));
+}
+
+void Proc_ReleaseRawImage(Proc p) {
+	if (!p) {
+		return;
+	}
+	p->releaseRawImage();
 }
 
 void Proc_ResetROI(Proc p) {
@@ -130,6 +159,15 @@ void Proc_ToGrayscale(Proc p) {
 	p->toGrayscale();
 }
 
+bool Proc_ViewRawImage(Proc p, const Img* img, int output) {
+	if (!p || !img) {
+		return false;
+	}
+	// the caller keeps the buffer alive, so there's nothing to pin
+	return p->viewRawImage(bh::Image{*img}, {},
+						   bh::enums::from<bh::RawOutput>(output));
+}
+
 bool Proc_WriteImage(Proc p, const char* filename) {
 	if (!p) {
 		return false;
@@ -137,3 +175,65 @@ bool Proc_WriteImage(Proc p, const char* filename) {
 	std::string s{filename};
 	return p->writeImage(s);
 }
+
+void Rec_Close(Rec r) {
+	if (r) {
+		r->close();
+	}
+}
+
+void Rec_Delete(Rec r) { delete r; }
+
+size_t Rec_GetNoDropped(Rec r) { return r ? r->getNoDropped() : 0; }
+
+Rec Rec_New() { return new bh::Recorder{}; }
+
+bool Rec_Open(Rec r, const char* path, size_t capacity, size_t maxFrames) {
+	if (!r || !path) {
+		return false;
+	}
+	return r->open(path, capacity, maxFrames);
+}
+
+bool Rec_Record(Rec r, const Img* img, const char* sn, void* pin) {
+	// the pin is taken over first, so it's released on every path
+	std::unique_ptr<std::shared_ptr<const void>> p{
+		static_cast<std::shared_ptr<const void>*>(pin)};
+	if (!r || !img) {
+		return false;
+	}
+	if (!p) {
+		// the buffer is owned by Go, so it's copied right away
+		return r->record(bh::Image{*img}, sn ? sn : "");
+	}
+	return r->record(bh::Image{*img}, sn ? sn : "", std::move(*p));
+}
+
+void Src_Delete(Src s) { delete s; }
+
+Src Src_New() { return new bh::FileSource{}; }
+
+bool Src_Next(Src s, Img* img) {
+	if (!s || !img) {
+		return false;
+	}
+	auto res{s->next()};
+	if (!res) {
+		return false;
+	}
+	*img = std::move(res).value().moveToC();
+	return true;
+}
+
+bool Src_Open(Src s, const char* path, int64_t pxType, double rate, bool loop) {
+	if (!s || !path) {
+		return false;
+	}
+	// 0 is not a pixel type, it requests the natural one
+	if (pxType != 0) {
+		s->setPixelType(bh::enums::from<bh::PxType>(pxType));
+	}
+	s->setLoop(loop);
+	s->setRate(rate);
+	return s->open(path);
+}
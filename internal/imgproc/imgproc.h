@@ -19,11 +19,15 @@ extern "C" {
 
 #ifdef __cplusplus
 typedef beholder::Processor* Proc;
+typedef beholder::Recorder* Rec;
+typedef beholder::FileSource* Src;
 typedef beholder::capi::Image Img;
 typedef beholder::capi::Rectangle Rect;
 typedef beholder::capi::Result Res;
 #else
 typedef void* Proc;
+typedef void* Rec;
+typedef void* Src;
 typedef Image Img;
 typedef Rectangle Rect;
 typedef Result Res;
@@ -32,20 +36,38 @@ typedef Result Res;
 bool Proc_DecodeImage(Proc p, void* buf, int bufSize, int flags);
 void Proc_Delete(Proc p);
 const unsigned char* Proc_EncodeImage(Proc p, const char* ext, int* encSize);
+size_t Proc_ExtractRotatedROIs(Proc p, const Rect* rois, const double* angs,
+							   size_t nROIs, Img* out);
 Img Proc_GetRawImage(Proc p);
 bool Proc_Init(Proc p, void** post, size_t nPost, void** pre, size_t nPre);
 Proc Proc_New();
 bool Proc_Postprocess(Proc p, Res* res, size_t nRes);
 bool Proc_Preprocess(Proc p);
-bool Proc_ReceiveRawImage(Proc p, const Img* img);
+bool Proc_ReceiveRawImage(Proc p, const Img* img, int output);
 bool Proc_ReadImage(Proc p, const char* filename, int flags);
+void Proc_ReleaseRawImage(Proc p);
 void Proc_ResetROI(Proc p);
 void Proc_SetROI(Proc p, const Rect* roi);
 void Proc_SetRotatedROI(Proc p, const Rect* roi, double ang);
 void Proc_ToColor(Proc p);
 void Proc_ToGrayscale(Proc p);
+bool Proc_ViewRawImage(Proc p, const Img* img, int output);
 bool Proc_WriteImage(Proc p, const char* filename);
 
+void Rec_Close(Rec r);
+void Rec_Delete(Rec r);
+size_t Rec_GetNoDropped(Rec r);
+Rec Rec_New();
+bool Rec_Open(Rec r, const char* path, size_t capacity, size_t maxFrames);
+// 'pin', if set, is a pin of the image buffer (a std::shared_ptr<const void>*,
+// see Frm_Pin), which is taken over, otherwise the buffer is copied.
+bool Rec_Record(Rec r, const Img* img, const char* sn, void* pin);
+
+void Src_Delete(Src s);
+Src Src_New();
+bool Src_Next(Src s, Img* img);
+bool Src_Open(Src s, const char* path, int64_t pxType, double rate, bool loop);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif
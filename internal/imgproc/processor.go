@@ -17,6 +17,7 @@ import (
 	"time"
 	"unsafe"
 
+	"github.com/Milover/beholder/internal/enumutils"
 	"github.com/Milover/beholder/internal/mem"
 	"github.com/Milover/beholder/internal/models"
 )
@@ -31,6 +32,34 @@ const (
 	RMAnyColor = 4
 )
 
+// RawOutput is the output requested when receiving a raw image.
+type RawOutput int
+
+const (
+	RONative    RawOutput = iota // as defined by the pixel type
+	ROGrayscale                  // single-channel grayscale
+	ROColor                      // BGR
+	ROHalfColor                  // BGR at half the resolution
+)
+
+var (
+	rawOutputMap = map[RawOutput]string{
+		RONative:    "native",
+		ROGrayscale: "grayscale",
+		ROColor:     "color",
+		ROHalfColor: "half_color",
+	}
+	invRawOutputMap = enumutils.Invert(rawOutputMap)
+)
+
+func (o *RawOutput) UnmarshalJSON(data []byte) error {
+	return enumutils.UnmarshalJSON(data, o, invRawOutputMap)
+}
+
+func (o RawOutput) MarshalJSON() ([]byte, error) {
+	return enumutils.MarshalJSON(o, rawOutputMap)
+}
+
 // Processor is a handle for the image processing API
 // and contains API configuration data.
 // WARNING: Processor holds a pointer to C-allocated memory,
@@ -44,6 +73,10 @@ type Processor struct {
 	// Preprocessing holds a list of configurations for
 	// image preprocessing operations.
 	Preprocessing []json.RawMessage `json:"preprocessing"`
+	// RawOutput is the output into which raw (camera) images are received,
+	// eg. "grayscale" to demosaic Bayer images straight to grayscale,
+	// see [Processor.ReceiveRawImageAs]. Defaults to "native".
+	RawOutput RawOutput `json:"raw_output"`
 
 	// p is a pointer to the C++ API class.
 	p C.Proc
@@ -108,6 +141,59 @@ func (ip Processor) EncodeImage(ext string) ([]byte, error) {
 	return enc, nil
 }
 
+// ExtractRotatedROIs extracts the regions of interest specified by rois,
+// each rotated by the corresponding angle in angs (in degrees) about
+// its center, in the same way as SetRotatedROI does, and returns them
+// as separate images.
+// The images are backed by C-allocated memory, and are only valid until
+// the next call to ExtractRotatedROIs.
+func (ip Processor) ExtractRotatedROIs(
+	rois []models.Rectangle,
+	angs []float64,
+) ([]models.Image, error) {
+	if len(rois) != len(angs) {
+		return nil, fmt.Errorf("imgproc.Processor.ExtractRotatedROIs: ROI/angle count mismatch: %d != %d", len(rois), len(angs))
+	}
+	if len(rois) == 0 {
+		return nil, nil
+	}
+	crois := make([]C.Rect, len(rois))
+	cangs := make([]C.double, len(angs))
+	for i := range rois {
+		crois[i].left = C.int(rois[i].Left)
+		crois[i].top = C.int(rois[i].Top)
+		crois[i].right = C.int(rois[i].Right)
+		crois[i].bottom = C.int(rois[i].Bottom)
+		cangs[i] = C.double(angs[i])
+	}
+	raw := make([]C.Img, len(rois))
+	n := int(C.Proc_ExtractRotatedROIs(
+		ip.p,
+		&crois[0],
+		&cangs[0],
+		C.size_t(len(crois)),
+		&raw[0],
+	))
+	if n != len(rois) {
+		return nil, errors.New("imgproc.Processor.ExtractRotatedROIs: could not extract ROIs")
+	}
+	now := time.Now()
+	imgs := make([]models.Image, n)
+	for i := range raw[:n] {
+		imgs[i] = models.Image{
+			ID:           uint64(raw[i].id),
+			Timestamp:    now,
+			Buffer:       raw[i].buffer,
+			Rows:         int(raw[i].rows),
+			Cols:         int(raw[i].cols),
+			PixelType:    int64(raw[i].pixelType),
+			Step:         uint64(raw[i].step),
+			BitsPerPixel: uint64(raw[i].bitsPerPixel),
+		}
+	}
+	return imgs, nil
+}
+
 // GetRawImage returns the currently stored image as a [models.Image].
 func (ip Processor) GetRawImage() models.Image {
 	raw := C.Proc_GetRawImage(ip.p)
@@ -244,8 +330,17 @@ func (ip Processor) ReadImage(filename string, readMode ReadMode) error {
 	return nil
 }
 
-// WriteAcquisitionResult writes 'r' to disc in PNG format.
+// ReceiveRawImage converts and stores a raw image, usually
+// a camera acquisition result.
 func (ip Processor) ReceiveRawImage(img models.Image) error {
+	return ip.ReceiveRawImageAs(img, RONative)
+}
+
+// ReceiveRawImageAs converts a raw image into the requested output
+// and stores it.
+// Bayer images are converted directly into the requested output,
+// i.e. without going through a full resolution color image.
+func (ip Processor) ReceiveRawImageAs(img models.Image, out RawOutput) error {
 	ri := C.Img{
 		id:           C.size_t(img.ID),
 		rows:         C.int(img.Rows),
@@ -255,12 +350,18 @@ func (ip Processor) ReceiveRawImage(img models.Image) error {
 		step:         C.size_t(img.Step),
 		bitsPerPixel: C.size_t(img.BitsPerPixel),
 	}
-	if ok := C.Proc_ReceiveRawImage(ip.p, &ri); !ok {
+	if ok := C.Proc_ReceiveRawImage(ip.p, &ri, C.int(out)); !ok {
 		return errors.New("imgproc.Processor.ReceiveRawImage: could not convert image")
 	}
 	return nil
 }
 
+// ReleaseRawImage releases the raw image viewed by the processor,
+// if any, see [Processor.ViewRawImage].
+func (ip Processor) ReleaseRawImage() {
+	C.Proc_ReleaseRawImage(ip.p)
+}
+
 // ResetROI resets the region of interest back to the whole image.
 func (ip Processor) ResetROI() {
 	C.Proc_ResetROI(ip.p)
@@ -301,6 +402,29 @@ func (ip Processor) ToGrayscale() {
 	C.Proc_ToGrayscale(ip.p)
 }
 
+// ViewRawImage stores a raw image without copying its buffer, if
+// the image needs no conversion to end up in the requested output,
+// otherwise it behaves as [Processor.ReceiveRawImageAs].
+//
+// WARNING: the image buffer MUST be kept alive until
+// [Processor.ReleaseRawImage] is called, or another image is stored,
+// eg. a camera must not acquire another image in the meantime.
+func (ip Processor) ViewRawImage(img models.Image, out RawOutput) error {
+	ri := C.Img{
+		id:           C.size_t(img.ID),
+		rows:         C.int(img.Rows),
+		cols:         C.int(img.Cols),
+		pixelType:    C.int64_t(img.PixelType),
+		buffer:       img.Buffer,
+		step:         C.size_t(img.Step),
+		bitsPerPixel: C.size_t(img.BitsPerPixel),
+	}
+	if ok := C.Proc_ViewRawImage(ip.p, &ri, C.int(out)); !ok {
+		return errors.New("imgproc.Processor.ViewRawImage: could not convert image")
+	}
+	return nil
+}
+
 // Write writes the currently held image to disc.
 // The format of the image is determined from the filename extension.
 // See [OpenCV docs] for supported formats.
@@ -0,0 +1,97 @@
+// beholder - Copyright © 2024 Philipp Milovic
+//
+// SPDX-License-Identifier: Apache-2.0
+
+package imgproc
+
+/*
+#include <stdlib.h>
+#include "imgproc.h"
+*/
+import "C"
+import (
+	"errors"
+	"fmt"
+	"unsafe"
+
+	"github.com/Milover/beholder/internal/models"
+)
+
+// Recorder records raw images, along with their metadata, to
+// a preallocated, memory-mapped segment file, from a background thread.
+// Recordings can be replayed zero-copy by a FileSource.
+//
+// WARNING: Recorder holds a pointer to C-allocated memory,
+// so when it is no longer needed, Delete must be called to release
+// the memory and clean up.
+// Record must only be called from a single goroutine at a time.
+type Recorder struct {
+	// Path is the path to the segment file, which is overwritten.
+	Path string `json:"path"`
+	// Capacity is the number of bytes reserved for image data.
+	Capacity uint64 `json:"capacity"`
+	// MaxFrames is the maximum number of images recorded.
+	MaxFrames uint64 `json:"max_frames"`
+
+	// p is a pointer to the C++ API class.
+	p C.Rec
+}
+
+// NewRecorder constructs (C call) a new recorder.
+// WARNING: Delete must be called to release the memory when no longer needed.
+func NewRecorder() *Recorder {
+	return &Recorder{p: C.Rec_New()}
+}
+
+// Close finishes writing queued images and closes the segment file.
+func (r Recorder) Close() {
+	C.Rec_Close(r.p)
+}
+
+// Delete releases C-allocated memory. Once called, r is no longer valid.
+func (r *Recorder) Delete() {
+	C.Rec_Delete(r.p)
+}
+
+// Dropped returns the number of images which could not be recorded,
+// because the recorder fell behind or the segment file is full.
+func (r Recorder) Dropped() uint64 {
+	return uint64(C.Rec_GetNoDropped(r.p))
+}
+
+// Init creates and maps the segment file.
+func (r Recorder) Init() error {
+	if r.Capacity == 0 || r.MaxFrames == 0 {
+		return errors.New("imgproc.Recorder.Init: zero capacity or max frames")
+	}
+	cs := C.CString(r.Path)
+	defer C.free(unsafe.Pointer(cs))
+	if ok := C.Rec_Open(r.p, cs, C.size_t(r.Capacity), C.size_t(r.MaxFrames)); !ok {
+		return fmt.Errorf("imgproc.Recorder.Init: could not open: %q", r.Path)
+	}
+	return nil
+}
+
+// Record records an image acquired by the camera with serial number sn.
+//
+// If pin is non-nil, it must be a pin of the image buffer, eg. from
+// camera.Frame.Pin, which Record takes ownership of, and the buffer is
+// copied in the background. Otherwise the image buffer is copied before
+// Record returns. The rest is always written in the background.
+func (r Recorder) Record(img models.Image, sn string, pin unsafe.Pointer) error {
+	ri := C.Img{
+		id:           C.size_t(img.ID),
+		rows:         C.int(img.Rows),
+		cols:         C.int(img.Cols),
+		pixelType:    C.int64_t(img.PixelType),
+		buffer:       img.Buffer,
+		step:         C.size_t(img.Step),
+		bitsPerPixel: C.size_t(img.BitsPerPixel),
+	}
+	cs := C.CString(sn)
+	defer C.free(unsafe.Pointer(cs))
+	if ok := C.Rec_Record(r.p, &ri, cs, pin); !ok {
+		return errors.New("imgproc.Recorder.Record: image dropped")
+	}
+	return nil
+}
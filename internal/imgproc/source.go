@@ -0,0 +1,95 @@
+// beholder - Copyright © 2024 Philipp Milovic
+//
+// SPDX-License-Identifier: Apache-2.0
+
+package imgproc
+
+/*
+#include <stdlib.h>
+#include "imgproc.h"
+*/
+import "C"
+import (
+	"errors"
+	"fmt"
+	"io"
+	"time"
+	"unsafe"
+
+	"github.com/Milover/beholder/internal/models"
+)
+
+// FileSource replays images from disc as raw images, the same way
+// a camera would acquire them, so that a pipeline can be run, and
+// benchmarked, without any hardware attached.
+// The source can be a single image, a directory of images, a video or
+// a raw recording made by a Recorder.
+//
+// WARNING: FileSource holds a pointer to C-allocated memory,
+// so when it is no longer needed, Delete must be called to release
+// the memory and clean up.
+type FileSource struct {
+	// Path is the path to an image, a directory of images or a video.
+	Path string `json:"path"`
+	// PixelType is the pixel type images are converted into,
+	// eg. a Bayer or packed type. If 0, images keep their natural type,
+	// i.e. Mono8/16 or BGR(A)8.
+	PixelType int64 `json:"pixel_type"`
+	// Rate is the rate, in Hz, at which images are handed out.
+	// If 0, images are handed out as fast as possible.
+	Rate float64 `json:"rate"`
+	// Loop restarts the source from the first image once exhausted.
+	Loop bool `json:"loop"`
+
+	// p is a pointer to the C++ API class.
+	p C.Src
+}
+
+// NewFileSource constructs (C call) a new file source.
+// WARNING: Delete must be called to release the memory when no longer needed.
+func NewFileSource() *FileSource {
+	return &FileSource{p: C.Src_New()}
+}
+
+// Delete releases C-allocated memory. Once called, s is no longer valid.
+func (s *FileSource) Delete() {
+	C.Src_Delete(s.p)
+}
+
+// Init opens the source and preloads its images, if any.
+func (s FileSource) Init() error {
+	if s.Rate < 0 {
+		return fmt.Errorf("imgproc.FileSource.Init: bad rate: %v", s.Rate)
+	}
+	cs := C.CString(s.Path)
+	defer C.free(unsafe.Pointer(cs))
+	ok := C.Src_Open(s.p, cs, C.int64_t(s.PixelType), C.double(s.Rate), C.bool(s.Loop))
+	if !ok {
+		return fmt.Errorf("imgproc.FileSource.Init: could not open: %q", s.Path)
+	}
+	return nil
+}
+
+// Next returns the next image, waiting until it is due, or io.EOF
+// once the source is exhausted.
+// The image is backed by C-allocated memory, and is only valid until
+// the next call to Next.
+func (s FileSource) Next() (models.Image, error) {
+	var raw C.Img
+	if ok := C.Src_Next(s.p, &raw); !ok {
+		return models.Image{}, io.EOF
+	}
+	if raw.buffer == nil {
+		return models.Image{}, errors.New("imgproc.FileSource.Next: could not get raw image data")
+	}
+	return models.Image{
+		ID:           uint64(raw.id),
+		Timestamp:    time.Now(),
+		Buffer:       raw.buffer,
+		Rows:         int(raw.rows),
+		Cols:         int(raw.cols),
+		PixelType:    int64(raw.pixelType),
+		Step:         uint64(raw.step),
+		BitsPerPixel: uint64(raw.bitsPerPixel),
+	}, nil
+}
@@ -19,8 +19,10 @@ type Image struct {
 	//
 	// TODO: change to UUIDv7 which we assign, fuck the camera.
 	ID uint64
-	// Timestamp is the time at which the image was created or acquired, i.e.
-	// received by the host machine.
+	// Timestamp is the time at which the image was created or acquired.
+	// For camera images, this is the time of exposure, if the camera's
+	// clock is synced with the host's, otherwise the time at which
+	// the image was received by the host machine.
 	//
 	// TODO: remove when ID gets changed to UUID, because UUIDv7
 	// embeds a timestamp.
@@ -34,6 +36,16 @@ type Image struct {
 	PixelType    int64  // pixel type of the image
 	Step         uint64 // number of bits per image row
 	BitsPerPixel uint64 // number of bits per pixel
+
+	// DeviceTimestamp is the camera's timestamp of the exposure,
+	// in device timestamp counter ticks, 0 if unknown.
+	DeviceTimestamp uint64
+	// FrameCounter is the camera's frame counter, 0 if unknown.
+	FrameCounter uint64
+	// TriggerCounter is the camera's trigger counter, 0 if unknown.
+	TriggerCounter uint64
+	// ExposureTime is the exposure time, 0 if unknown.
+	ExposureTime time.Duration
 }
 
 // String returns the string representation of img.
@@ -45,7 +57,11 @@ cols: %v
 step: %v
 bits per pixel: %v
 pixel type: %v
-buffer: %v`,
+buffer: %v
+device timestamp: %v
+frame counter: %v
+trigger counter: %v
+exposure time: %v`,
 		img.ID,
 		img.Timestamp,
 		img.Rows,
@@ -54,5 +70,9 @@ buffer: %v`,
 		img.BitsPerPixel,
 		img.PixelType,
 		img.Buffer,
+		img.DeviceTimestamp,
+		img.FrameCounter,
+		img.TriggerCounter,
+		img.ExposureTime,
 	)
 }
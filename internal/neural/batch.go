@@ -0,0 +1,97 @@
+// beholder - Copyright © 2024 Philipp Milovic
+//
+// SPDX-License-Identifier: Apache-2.0
+
+package neural
+
+/*
+#include <stdlib.h>
+#include "neural.h"
+*/
+import "C"
+import (
+	"errors"
+	"fmt"
+	"time"
+	"unsafe"
+
+	"github.com/Milover/beholder/internal/mem"
+	"github.com/Milover/beholder/internal/models"
+)
+
+// Batcher is a dynamic batching front-end for a [BatchNetwork], which
+// collects images submitted concurrently, eg. from several cameras,
+// and infers them in batches on a C-managed worker thread, see
+// [BatchNetwork.BatchInference].
+//
+// A batch is inferred once it holds MaxBatch images, or once its oldest
+// image has waited for Window, whichever comes first, so each image
+// trades a bounded amount of latency for the throughput of batched
+// inference.
+//
+// WARNING: the network must not be used directly, nor deleted, while
+// the Batcher is in use, and [Batcher.Delete] must be called to stop
+// the worker thread and release the resources when no longer needed.
+type Batcher struct {
+	p C.Bat // pointer to the C++ API class.
+}
+
+// cPtr returns the pointer to the C++ API class of n.
+func (n network) cPtr() C.Det {
+	return n.p
+}
+
+// NewBatcher constructs (C call) a new Batcher which infers batches of
+// up to maxBatch images through net, waiting up to window for a batch
+// to fill up. net must be initialized.
+func NewBatcher(net BatchNetwork, maxBatch int, window time.Duration) (*Batcher, error) {
+	n, ok := net.(interface{ cPtr() C.Det })
+	if !ok || n.cPtr() == (C.Det)(nil) {
+		return nil, fmt.Errorf("neural.NewBatcher: %w", ErrAPIPtr)
+	}
+	if maxBatch <= 0 {
+		return nil, errors.New("neural.NewBatcher: non-positive max. batch size")
+	}
+	if window < 0 {
+		return nil, errors.New("neural.NewBatcher: negative window")
+	}
+	p := C.Bat_New(n.cPtr(), C.size_t(maxBatch), C.size_t(window.Microseconds()))
+	if p == (C.Bat)(nil) {
+		return nil, fmt.Errorf("neural.NewBatcher: %w", ErrInit)
+	}
+	return &Batcher{p: p}, nil
+}
+
+// Delete stops the worker thread and releases C-allocated memory.
+// Images which were not inferred yet fail. Once called, b is no longer valid.
+func (b *Batcher) Delete() {
+	C.Bat_Delete(b.p)
+	b.p = nil
+}
+
+// Inference submits img for inference, waits until its batch has been
+// inferred, and stores the results into res. It is safe to call
+// Inference from several goroutines at once.
+//
+// The time img waited for its batch, and the time spent inferring
+// the batch, are recorded as the "batch-queue" and "batch-inference"
+// timings of res.
+//
+// Unlike [Network.Inference], nothing being detected is not an error.
+func (b Batcher) Inference(img models.Image, res *models.Result) error {
+	ar := &mem.Arena{}
+	defer ar.Free()
+
+	var t C.BatTiming
+	raw := toCImg(img)
+	results := (*C.ResArr)(ar.Store(
+		unsafe.Pointer(C.Bat_Detect(b.p, &raw, &t)),
+		C.ResArr_Delete))
+	if unsafe.Pointer(results) == nil {
+		return ErrInference
+	}
+	fromCRes(results, res)
+	res.Timings.Set("batch-queue", time.Duration(t.queuedNs))
+	res.Timings.Set("batch-inference", time.Duration(t.inferenceNs))
+	return nil
+}
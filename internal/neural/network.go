@@ -11,6 +11,7 @@ package neural
 import "C"
 import (
 	"errors"
+	"fmt"
 	"path"
 	"slices"
 	"unsafe"
@@ -53,6 +54,22 @@ type Network interface {
 	// TODO: do we need a Config() call?
 }
 
+// BatchNetwork is a [Network] which can perform inferencing on several
+// images at once.
+type BatchNetwork interface {
+	Network
+	// BatchInference performs inferencing on all supplied images at once,
+	// and stores the results of each image into the corresponding result.
+	// The images are packed into a single blob and passed through
+	// the network in a single forward pass, which amortizes the per-call
+	// overhead when there are many small images, eg. text crops.
+	//
+	// Unlike [Network.Inference], an image for which nothing was detected
+	// is not an error, its result is simply empty.
+	// The model has to have a dynamic batch dimension.
+	BatchInference([]models.Image, []*models.Result) error
+}
+
 // Backend is a [Network] computation backends. See the [OpenCV docs] for
 // more info.
 //
@@ -216,17 +233,41 @@ func (n *network) Delete() {
 //
 // Internally stored results are cleared by the C-API when Inference is called.
 func (n network) Inference(img models.Image, res *models.Result) error {
+	return detect(n.p, img, res)
+}
+
+// BatchInference performs inferencing on all supplied images at once.
+// Before calling BatchInference, n must be initialized by calling
+// [network.Init].
+//
+// Internally stored results are cleared by the C-API when BatchInference
+// is called.
+func (n network) BatchInference(imgs []models.Image, res []*models.Result) error {
+	if len(imgs) != len(res) {
+		return fmt.Errorf("%w: image/result count mismatch: %d != %d", ErrInference, len(imgs), len(res))
+	}
+	if len(imgs) == 0 {
+		return nil
+	}
 	ar := &mem.Arena{}
 	defer ar.Free()
 
-	raw := toCImg(img)
-	results := (*C.ResArr)(ar.Store(
-		unsafe.Pointer(C.Det_Detect(n.p, &raw)),
-		C.ResArr_Delete))
-	if unsafe.Pointer(results) == nil {
+	raw := make([]C.Img, len(imgs))
+	for i := range imgs {
+		raw[i] = toCImg(imgs[i])
+	}
+	ptrs := C.Det_DetectBatch(n.p, &raw[0], C.size_t(len(raw)))
+	if ptrs == nil {
 		return ErrInference
 	}
-	fromCRes(results, res)
+	results := (**C.ResArr)(ar.StoreArray(
+		unsafe.Pointer(ptrs),
+		C.ResArrs_Delete,
+		C.ResArr_Delete,
+		uint64(len(raw))))
+	for i, r := range unsafe.Slice(results, len(raw)) {
+		fromCRes(r, res[i])
+	}
 	return nil
 }
 
@@ -290,16 +331,33 @@ func (n network) IsValid() error {
 	return nil
 }
 
+// detect performs inferencing on img with the detector d, and stores
+// the results into res.
+func detect(d C.Det, img models.Image, res *models.Result) error {
+	ar := &mem.Arena{}
+	defer ar.Free()
+
+	raw := toCImg(img)
+	results := (*C.ResArr)(ar.Store(
+		unsafe.Pointer(C.Det_Detect(d, &raw)),
+		C.ResArr_Delete))
+	if unsafe.Pointer(results) == nil {
+		return ErrInference
+	}
+	fromCRes(results, res)
+	return nil
+}
+
 // toCImg returns a copy of img as a C-image.
 func toCImg(img models.Image) C.Img {
 	return C.Img{
-		C.size_t(img.ID),
-		C.int(img.Rows),
-		C.int(img.Cols),
-		C.int64_t(img.PixelType),
-		img.Buffer,
-		C.size_t(img.Step),
-		C.size_t(img.BitsPerPixel),
+		id:           C.size_t(img.ID),
+		rows:         C.int(img.Rows),
+		cols:         C.int(img.Cols),
+		pixelType:    C.int64_t(img.PixelType),
+		buffer:       img.Buffer,
+		step:         C.size_t(img.Step),
+		bitsPerPixel: C.size_t(img.BitsPerPixel),
 	}
 }
 
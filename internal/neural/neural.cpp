@@ -5,7 +5,10 @@
 #include "neural.h"
 
 #include <array>
+#include <chrono>
 #include <cstring>
+#include <exception>
+#include <future>
 #include <iostream>
 #include <string>
 #include <vector>
@@ -37,6 +40,54 @@ void ResArr_Delete(void* r) {
 	}
 }
 
+void ResArrs_Delete(void* r) {
+	if (r) {
+		ResArr*** ptr{static_cast<ResArr***>(r)};
+		delete[] *ptr;
+		*ptr = nullptr;
+	}
+}
+
+void Bat_Delete(Bat b) {
+	if (b) {
+		delete b;
+		b = nullptr;
+	}
+}
+
+ResArr* Bat_Detect(Bat b, const Img* img, BatTiming* t) {
+	if (!b || !img) {
+		return nullptr;
+	}
+	const auto rep{b->detect(beholder::Image{*img})};
+	if (!rep.ok) {
+		return nullptr;
+	}
+	if (t) {
+		t->queuedNs = rep.timing.queued.count();
+		t->inferenceNs = rep.timing.inference.count();
+		t->batchSize = rep.timing.batchSize;
+	}
+	Res* res{new Res[rep.results.size()]};
+	for (auto i{0ul}; i < rep.results.size(); ++i) {
+		res[i] = rep.results[i].toC();
+	}
+	return new ResArr{res, static_cast<size_t>(rep.results.size())};
+}
+
+Bat Bat_New(Det d, size_t maxBatch, size_t windowUs) {
+	if (!d) {
+		return nullptr;
+	}
+	try {
+		return new beholder::BatchScheduler{
+			*d, maxBatch, std::chrono::microseconds{windowUs}};
+	} catch (...) {
+		std::cerr << "could not start batch scheduler" << std::endl;
+	}
+	return nullptr;
+}
+
 void Det_Clear(Det d) {
 	if (d) {
 		d->clear();
@@ -65,6 +116,31 @@ ResArr* Det_Detect(Det d, const Img* img) {
 	return new ResArr{res, static_cast<size_t>(results.size())};
 }
 
+ResArr** Det_DetectBatch(Det d, const Img* imgs, size_t n) {
+	if (!d || !imgs || n == 0) {
+		return nullptr;
+	}
+	std::vector<beholder::Image> raws;
+	raws.reserve(n);
+	for (auto i{0ul}; i < n; ++i) {
+		raws.emplace_back(imgs[i]);
+	}
+	if (!d->detectBatch(raws)) {
+		return nullptr;
+	}
+	const auto& batch{d->getBatchResults()};
+	ResArr** out{new ResArr*[n]};
+	for (auto i{0ul}; i < n; ++i) {
+		const auto& results{batch[i]};
+		Res* res{new Res[results.size()]};
+		for (auto j{0ul}; j < results.size(); ++j) {
+			res[j] = results[j].toC();
+		}
+		out[i] = new ResArr{res, static_cast<size_t>(results.size())};
+	}
+	return out;
+}
+
 bool Det_Init(Det d, const DetInit* in) {
 	namespace be = beholder::enums;
 	using Bnd = beholder::NNBackend;
@@ -129,12 +205,18 @@ bool Det_ConfigurePARSeq(Det d, const char* charset) {
 	return true;
 }
 
-bool Det_ConfigureYOLOv8(Det d, const char** classes, size_t nClasses) {
+bool Det_ConfigureYOLOv8(Det d, const char** classes, size_t nClasses,
+						 const int* filter, size_t nFilter) {
 	using YOLOv8 = beholder::YOLOv8Detector;
 	YOLOv8* ptr{dynamic_cast<YOLOv8*>(d)};	// futureproofing
 	if (!ptr) {
 		return false;
 	}
+	// handle the class filter; empty is valid
+	ptr->classFilter.clear();
+	if (filter) {
+		ptr->classFilter.assign(filter, filter + nFilter);
+	}
 	if (!classes || nClasses == 0) {  // valid; nothing to do
 		return true;
 	}
@@ -147,6 +229,100 @@ bool Det_ConfigureYOLOv8(Det d, const char** classes, size_t nClasses) {
 	return true;
 }
 
+void Pipe_Delete(Pipe p) {
+	if (p) {
+		delete p;
+		p = nullptr;
+	}
+}
+
+Pipe Pipe_New(Det d, size_t depth) {
+	if (!d) {
+		return nullptr;
+	}
+	try {
+		return new beholder::DetectorPipeline{*d, depth};
+	} catch (...) {
+		std::cerr << "could not start detector pipeline" << std::endl;
+	}
+	return nullptr;
+}
+
+PipeFut Pipe_Submit(Pipe p, const Img* img) {
+	if (!p || !img) {
+		return nullptr;
+	}
+	return new std::future<beholder::PipelineReply>{
+		p->submit(beholder::Image{*img})};
+}
+
+ResArr* Pipe_Wait(PipeFut f, PipeTiming* t) {
+	if (!f) {
+		return nullptr;
+	}
+	const auto rep{f->get()};
+	delete f;
+	if (!rep.ok) {
+		return nullptr;
+	}
+	if (t) {
+		t->preprocessNs = rep.timing.preprocess.count();
+		t->forwardNs = rep.timing.forward.count();
+		t->postprocessNs = rep.timing.postprocess.count();
+		t->latencyNs = rep.timing.latency.count();
+	}
+	Res* res{new Res[rep.results.size()]};
+	for (auto i{0ul}; i < rep.results.size(); ++i) {
+		res[i] = rep.results[i].toC();
+	}
+	return new ResArr{res, static_cast<size_t>(rep.results.size())};
+}
+
+Det Pool_Acquire(Pool p) {
+	if (!p) {
+		return nullptr;
+	}
+	return p->acquire();
+}
+
+void Pool_Delete(Pool p) {
+	if (p) {
+		delete p;
+		p = nullptr;
+	}
+}
+
+Pool Pool_New(Det proto, const char* modelPath, const char* model, size_t n) {
+	if (!proto || !modelPath || !model || n == 0) {
+		return nullptr;
+	}
+	beholder::DetectorPool* p{nullptr};
+	try {
+		// the prototype may have been initialized from a temporary file,
+		// so the model file is supplied separately
+		auto cfg{proto->clone()};
+		cfg->modelPath = std::string{modelPath};
+		cfg->model = std::string{model};
+		p = new beholder::DetectorPool{};
+		if (p->init(*cfg, n)) {
+			return p;
+		}
+	} catch (const std::exception& e) {
+		std::cerr << "could not initialize detector pool: " << e.what()
+				  << std::endl;
+	} catch (...) {
+		std::cerr << "could not initialize detector pool" << std::endl;
+	}
+	delete p;
+	return nullptr;
+}
+
+void Pool_Release(Pool p, Det d) {
+	if (p) {
+		p->release(d);
+	}
+}
+
 void Tess_Clear(Tess t) {
 	if (t) {
 		t->clear();
@@ -2,6 +2,7 @@
 #define _BEHOLDER_NEURAL_SHIM_H
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>
 
 #ifdef __cplusplus
@@ -13,12 +14,20 @@ extern "C" {
 #endif
 
 #ifdef __cplusplus
+typedef beholder::BatchScheduler* Bat;
 typedef beholder::ObjDetector* Det;
+typedef beholder::DetectorPipeline* Pipe;
+typedef std::future<beholder::PipelineReply>* PipeFut;
+typedef beholder::DetectorPool* Pool;
 typedef beholder::Tesseract* Tess;
 typedef beholder::capi::Image Img;
 typedef beholder::capi::Result Res;
 #else
+typedef void* Bat;
 typedef void* Det;
+typedef void* Pipe;
+typedef void* PipeFut;
+typedef void* Pool;
 typedef void* Tess;
 typedef Image Img;
 typedef Result Res;
@@ -30,6 +39,19 @@ typedef struct {
 } ResArr;  // deallocation helper
 
 void ResArr_Delete(void* r);
+// deletes an array of result arrays, but not the result arrays
+void ResArrs_Delete(void* r);
+
+typedef struct {
+	int64_t queuedNs;
+	int64_t inferenceNs;
+	size_t batchSize;
+} BatTiming;
+
+// batch images submitted by several threads
+void Bat_Delete(Bat b);
+ResArr* Bat_Detect(Bat b, const Img* img, BatTiming* t);
+Bat Bat_New(Det d, size_t maxBatch, size_t windowUs);
 
 typedef struct {
 	const char* modelPath;
@@ -49,6 +71,7 @@ typedef struct {
 void Det_Clear(Det d);
 void Det_Delete(Det d);
 ResArr* Det_Detect(Det d, const Img* img);
+ResArr** Det_DetectBatch(Det d, const Img* imgs, size_t n);
 bool Det_Init(Det d, const DetInit* in);
 // allocate new detectors
 Det Det_NewCRAFT();
@@ -58,7 +81,28 @@ Det Det_NewYOLOv8();
 // configure a specific detector
 bool Det_ConfigureCRAFT(Det d, float txtThresh, float lnThresh, float lowTxt);
 bool Det_ConfigurePARSeq(Det d, const char* charset);
-bool Det_ConfigureYOLOv8(Det d, const char** classes, size_t nClasses);
+bool Det_ConfigureYOLOv8(Det d, const char** classes, size_t nClasses,
+						 const int* filter, size_t nFilter);
+
+typedef struct {
+	int64_t preprocessNs;
+	int64_t forwardNs;
+	int64_t postprocessNs;
+	int64_t latencyNs;
+} PipeTiming;
+
+// overlap the detection stages of consecutive images
+void Pipe_Delete(Pipe p);
+Pipe Pipe_New(Det d, size_t depth);
+PipeFut Pipe_Submit(Pipe p, const Img* img);
+// waits for the results, and deletes the future
+ResArr* Pipe_Wait(PipeFut f, PipeTiming* t);
+
+// share a model between several detector instances
+Det Pool_Acquire(Pool p);
+void Pool_Delete(Pool p);
+Pool Pool_New(Det proto, const char* modelPath, const char* model, size_t n);
+void Pool_Release(Pool p, Det d);
 
 typedef struct {
 	char* key;
@@ -66,6 +66,11 @@ func dfltYOLOv8() Network {
 	n.Config.Size = [2]int{640, 640}
 	return n
 }
+func dfltYOLOv8Person() Network {
+	n := dfltYOLOv8().(*YOLOv8)
+	n.ClassFilter = []int{0} // COCO "person" class
+	return n
+}
 
 type networkTest struct {
 	Name     string        // the name of the test
@@ -148,6 +153,21 @@ var networkTests = []networkTest{
 			Confidences: make([]float64, 2),
 		},
 	},
+	{
+		Name:    "yolov8-zidane-person",
+		Error:   nil,
+		Factory: dfltYOLOv8Person,
+		Config:  "",
+		Image:   imagePath("ultralytics_zidane.jpg"),
+		Expected: models.Result{
+			Boxes: []models.Rectangle{
+				models.Rectangle{Left: 90, Top: 170, Right: 1140, Bottom: 735},
+				models.Rectangle{Left: 730, Top: 20, Right: 1160, Bottom: 735},
+			},
+			Text:        []string{"0", "0"},
+			Confidences: make([]float64, 2),
+		},
+	},
 	// test unmarshalling
 }
 
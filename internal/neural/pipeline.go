@@ -0,0 +1,116 @@
+// beholder - Copyright © 2024 Philipp Milovic
+//
+// SPDX-License-Identifier: Apache-2.0
+
+package neural
+
+/*
+#include <stdlib.h>
+#include "neural.h"
+*/
+import "C"
+import (
+	"errors"
+	"fmt"
+	"time"
+	"unsafe"
+
+	"github.com/Milover/beholder/internal/mem"
+	"github.com/Milover/beholder/internal/models"
+)
+
+// Pipeline is an asynchronous front-end for a [Network], which runs
+// the stages of a detection, i.e. preprocessing, the forward pass and
+// postprocessing, each on a C-managed worker thread, so that consecutive
+// images overlap, eg. the next image is letterboxed and the previous one
+// is filtered while the current one is passed through the network.
+// Raw camera images, eg. Mono8 or Bayer, can be submitted as they are,
+// since images are converted to BGR while they are preprocessed.
+//
+// Images are submitted with [Pipeline.Submit], and their results are
+// collected with [Pending.Wait], in any order. At most Depth images are
+// in the pipeline at once, further submissions wait until an image
+// leaves the pipeline.
+//
+// WARNING: the network must not be used directly, nor deleted, while
+// the Pipeline is in use, and [Pipeline.Delete] must be called to stop
+// the worker threads and release the resources when no longer needed.
+type Pipeline struct {
+	p C.Pipe // pointer to the C++ API class.
+}
+
+// Pending is an image submitted to a [Pipeline], awaiting its results.
+//
+// WARNING: [Pending.Wait] must be called exactly once to release
+// the resources.
+type Pending struct {
+	f C.PipeFut // pointer to the C++ future.
+}
+
+// NewPipeline constructs (C call) a new Pipeline which passes up to
+// depth images through net at once. net must be initialized.
+func NewPipeline(net Network, depth int) (*Pipeline, error) {
+	n, ok := net.(interface{ cPtr() C.Det })
+	if !ok || n.cPtr() == (C.Det)(nil) {
+		return nil, fmt.Errorf("neural.NewPipeline: %w", ErrAPIPtr)
+	}
+	if depth <= 0 {
+		return nil, errors.New("neural.NewPipeline: non-positive depth")
+	}
+	p := C.Pipe_New(n.cPtr(), C.size_t(depth))
+	if p == (C.Pipe)(nil) {
+		return nil, fmt.Errorf("neural.NewPipeline: %w", ErrInit)
+	}
+	return &Pipeline{p: p}, nil
+}
+
+// Delete stops the worker threads and releases C-allocated memory.
+// Images which were not inferred yet fail, but their [Pending.Wait]
+// must still be called. Once called, p is no longer valid.
+func (p *Pipeline) Delete() {
+	C.Pipe_Delete(p.p)
+	p.p = nil
+}
+
+// Submit submits img for inference, waiting if the pipeline is full.
+// It is safe to call Submit from several goroutines at once.
+//
+// WARNING: the image buffer must stay valid until [Pending.Wait]
+// returns.
+func (p Pipeline) Submit(img models.Image) (*Pending, error) {
+	raw := toCImg(img)
+	f := C.Pipe_Submit(p.p, &raw)
+	if f == (C.PipeFut)(nil) {
+		return nil, ErrAPIPtr
+	}
+	return &Pending{f: f}, nil
+}
+
+// Wait waits until the image has passed through the pipeline, and stores
+// the results into res. Once called, r is no longer valid.
+//
+// The time spent in each stage, and the time from submission until
+// the results were available, are recorded as the "pipeline-preprocess",
+// "pipeline-forward", "pipeline-postprocess" and "pipeline-latency"
+// timings of res.
+//
+// Unlike [Network.Inference], nothing being detected is not an error.
+func (r *Pending) Wait(res *models.Result) error {
+	ar := &mem.Arena{}
+	defer ar.Free()
+
+	var t C.PipeTiming
+	results := (*C.ResArr)(ar.Store(
+		unsafe.Pointer(C.Pipe_Wait(r.f, &t)),
+		C.ResArr_Delete))
+	r.f = nil
+	if unsafe.Pointer(results) == nil {
+		return ErrInference
+	}
+	fromCRes(results, res)
+	res.Timings.Set("pipeline-preprocess", time.Duration(t.preprocessNs))
+	res.Timings.Set("pipeline-forward", time.Duration(t.forwardNs))
+	res.Timings.Set("pipeline-postprocess", time.Duration(t.postprocessNs))
+	res.Timings.Set("pipeline-latency", time.Duration(t.latencyNs))
+	return nil
+}
@@ -0,0 +1,96 @@
+// beholder - Copyright © 2024 Philipp Milovic
+//
+// SPDX-License-Identifier: Apache-2.0
+
+package neural
+
+/*
+#include <stdlib.h>
+#include "neural.h"
+*/
+import "C"
+import (
+	"errors"
+	"fmt"
+	"path"
+
+	"github.com/Milover/beholder/internal/mem"
+	"github.com/Milover/beholder/internal/models"
+	"github.com/Milover/beholder/internal/neural/model"
+)
+
+// Pool holds several C-managed instances of a [Network], with the same
+// configuration and model, so that several goroutines can run inference
+// at once, eg. one per physical core, see [Pool.Inference].
+//
+// The model file is read only once, and each instance is initialized
+// from the in-memory copy. Note that each instance still holds a copy
+// of the parsed weights, since OpenCV doesn't share weights between
+// networks.
+//
+// WARNING: [Pool.Delete] must be called to release the resources when
+// the Pool is no longer needed.
+type Pool struct {
+	p C.Pool // pointer to the C++ API class.
+}
+
+// modelFile returns the model file of n, see [model.Model.File].
+func (n network) modelFile() (string, model.Cleanup, error) {
+	return n.Model.File()
+}
+
+// NewPool constructs (C call) a new Pool of size instances of net,
+// i.e. networks of the same type, configuration and model.
+// net must be initialized, but is not part of the Pool, and can be
+// deleted once the Pool is constructed.
+func NewPool(net Network, size int) (*Pool, error) {
+	n, ok := net.(interface {
+		cPtr() C.Det
+		modelFile() (string, model.Cleanup, error)
+	})
+	if !ok || n.cPtr() == (C.Det)(nil) {
+		return nil, fmt.Errorf("neural.NewPool: %w", ErrAPIPtr)
+	}
+	if size <= 0 {
+		return nil, errors.New("neural.NewPool: non-positive size")
+	}
+	mfn, cleanup, err := n.modelFile()
+	if err != nil {
+		return nil, fmt.Errorf("neural.NewPool: %w", err)
+	}
+	defer cleanup() //nolint:errcheck // this could fail, but we don't care
+
+	ar := &mem.Arena{}
+	defer ar.Free()
+
+	p := C.Pool_New(
+		n.cPtr(),
+		(*C.char)(ar.CopyStr(path.Dir(mfn))),
+		(*C.char)(ar.CopyStr(path.Base(mfn))),
+		C.size_t(size))
+	if p == (C.Pool)(nil) {
+		return nil, fmt.Errorf("neural.NewPool: %w", ErrInit)
+	}
+	return &Pool{p: p}, nil
+}
+
+// Delete releases C-allocated memory. All calls to [Pool.Inference]
+// must have returned before Delete is called. Once called, p is no longer
+// valid.
+func (p *Pool) Delete() {
+	C.Pool_Delete(p.p)
+	p.p = nil
+}
+
+// Inference performs inferencing on img with an idle instance, waiting
+// for one if all of them are in use, and stores the results into res.
+// It is safe to call Inference from several goroutines at once.
+func (p Pool) Inference(img models.Image, res *models.Result) error {
+	d := C.Pool_Acquire(p.p)
+	if d == (C.Det)(nil) {
+		return ErrAPIPtr
+	}
+	defer C.Pool_Release(p.p, d)
+
+	return detect(d, img, res)
+}
@@ -34,6 +34,10 @@ type YOLOv8 struct {
 	// Classes are the friendly-names of object classes recognized by the model.
 	// If not defined, (model-defined) class indexes are used during output.
 	Classes []string `json:"classes"`
+	// ClassFilter are the IDs of the object classes which are detected.
+	// If not defined, all classes are detected. Restricting the classes
+	// also speeds up decoding the model output.
+	ClassFilter []int `json:"class_filter"`
 
 	network // the underlying network
 }
@@ -51,10 +55,20 @@ func (n *YOLOv8) Init() error {
 	ar := &mem.Arena{}
 	defer ar.Free()
 
+	filter := make([]C.int, len(n.ClassFilter))
+	for i, id := range n.ClassFilter {
+		filter[i] = C.int(id)
+	}
+	var pFilter *C.int
+	if len(filter) > 0 {
+		pFilter = &filter[0]
+	}
 	ok := C.Det_ConfigureYOLOv8(
 		n.p,
 		(**C.char)(ar.CopyStrArray(n.Classes)),
 		C.size_t(len(n.Classes)),
+		pFilter,
+		C.size_t(len(filter)),
 	)
 	if !ok {
 		return fmt.Errorf("network.YOLOv8.Init: %w", ErrInit)